@@ -235,6 +235,9 @@ static const char *get_sigtype(int nid)
      case EVP_PKEY_EC:
         return "ECDSA";
 
+     case EVP_PKEY_ED25519:
+        return "Ed25519";
+
     default:
         return NULL;
     }
@@ -268,6 +271,11 @@ static int do_print_sigalgs(BIO *out, SSL *s, int shared)
             SSL_get_sigalgs(s, i, &sign_nid, &hash_nid, NULL, &rsign, &rhash);
         if (i)
             BIO_puts(out, ":");
+        /* Ed25519 has no separate hash */
+        if (sign_nid == EVP_PKEY_ED25519) {
+            BIO_puts(out, "Ed25519");
+            continue;
+        }
         sstr = get_sigtype(sign_nid);
         if (sstr)
             BIO_printf(out, "%s+", sstr);
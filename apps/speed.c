@@ -129,13 +129,13 @@
 #define BUFSIZE (1024*16+1)
 #define MAX_MISALIGNMENT 63
 
-#define ALGOR_NUM       30
+#define ALGOR_NUM       34
 #define SIZE_NUM        6
 #define PRIME_NUM       3
 #define RSA_NUM         7
 #define DSA_NUM         3
 
-#define EC_NUM          17
+#define EC_NUM          18
 #define MAX_ECDH_SIZE   256
 #define MISALIGN        64
 
@@ -187,6 +187,12 @@ static int HMAC_loop(void *args);
 static int SHA1_loop(void *args);
 static int SHA256_loop(void *args);
 static int SHA512_loop(void *args);
+static int EVP_Digest_SHA3_256_loop(void *args);
+static int EVP_Digest_SHA3_512_loop(void *args);
+#ifndef OPENSSL_NO_BLAKE2
+static int EVP_Digest_BLAKE2b_loop(void *args);
+static int EVP_Digest_BLAKE2s_loop(void *args);
+#endif
 #ifndef OPENSSL_NO_WHIRLPOOL
 static int WHIRLPOOL_loop(void *args);
 #endif
@@ -231,6 +237,9 @@ static void pkey_print_message(const char *str, const char *str2,
 static void print_result(int alg, int run_no, int count, double time_used);
 #ifndef NO_FORK
 static int do_multi(int multi);
+#ifndef OPENSSL_NO_RSA
+static void rsa_keygen_latency(unsigned int bits, int primes, int num);
+#endif
 #endif
 
 static const char *names[ALGOR_NUM] = {
@@ -240,7 +249,8 @@ static const char *names[ALGOR_NUM] = {
     "aes-128 cbc", "aes-192 cbc", "aes-256 cbc",
     "camellia-128 cbc", "camellia-192 cbc", "camellia-256 cbc",
     "evp", "sha256", "sha512", "whirlpool",
-    "aes-128 ige", "aes-192 ige", "aes-256 ige", "ghash"
+    "aes-128 ige", "aes-192 ige", "aes-256 ige", "ghash",
+    "sha3-256", "sha3-512", "blake2b512", "blake2s256"
 };
 
 static double results[ALGOR_NUM][SIZE_NUM];
@@ -355,7 +365,8 @@ static int found(const char *name, const OPT_PAIR *pairs, int *result)
 typedef enum OPTION_choice {
     OPT_ERR = -1, OPT_EOF = 0, OPT_HELP,
     OPT_ELAPSED, OPT_EVP, OPT_DECRYPT, OPT_ENGINE, OPT_MULTI,
-    OPT_MR, OPT_MB, OPT_MISALIGN, OPT_ASYNCJOBS
+    OPT_MR, OPT_MB, OPT_MISALIGN, OPT_ASYNCJOBS, OPT_PRIMES, OPT_KEYGEN,
+    OPT_PRIME_THREADS
 } OPTION_CHOICE;
 
 const OPTIONS speed_options[] = {
@@ -380,6 +391,13 @@ const OPTIONS speed_options[] = {
 #endif
 #ifndef OPENSSL_NO_ENGINE
     {"engine", OPT_ENGINE, 's', "Use engine, possibly a hardware device"},
+#endif
+#ifndef OPENSSL_NO_RSA
+    {"primes", OPT_PRIMES, 'p', "Specify number of primes (for RSA only)"},
+    {"keygen", OPT_KEYGEN, 'p',
+     "Time this many RSA key generations per size and show the latencies"},
+    {"prime_threads", OPT_PRIME_THREADS, 'p',
+     "Number of threads searching for primes during key generation"},
 #endif
     {NULL},
 };
@@ -414,6 +432,10 @@ const OPTIONS speed_options[] = {
 #define D_IGE_192_AES   27
 #define D_IGE_256_AES   28
 #define D_GHASH         29
+#define D_SHA3_256      30
+#define D_SHA3_512      31
+#define D_BLAKE2B       32
+#define D_BLAKE2S       33
 static OPT_PAIR doit_choices[] = {
 #ifndef OPENSSL_NO_MD2
     {"md2", D_MD2},
@@ -431,6 +453,12 @@ static OPT_PAIR doit_choices[] = {
     {"sha1", D_SHA1},
     {"sha256", D_SHA256},
     {"sha512", D_SHA512},
+    {"sha3-256", D_SHA3_256},
+    {"sha3-512", D_SHA3_512},
+#ifndef OPENSSL_NO_BLAKE2
+    {"blake2b512", D_BLAKE2B},
+    {"blake2s256", D_BLAKE2S},
+#endif
 #ifndef OPENSSL_NO_WHIRLPOOL
     {"whirlpool", D_WHIRLPOOL},
 #endif
@@ -529,6 +557,7 @@ static OPT_PAIR rsa_choices[] = {
 #define R_EC_B409    14
 #define R_EC_B571    15
 #define R_EC_X25519  16
+#define R_EC_X448    17
 #ifndef OPENSSL_NO_EC
 static OPT_PAIR ecdsa_choices[] = {
     {"ecdsap160", R_EC_P160},
@@ -568,6 +597,7 @@ static OPT_PAIR ecdh_choices[] = {
     {"ecdhb409", R_EC_B409},
     {"ecdhb571", R_EC_B571},
     {"ecdhx25519", R_EC_X25519},
+    {"ecdhx448", R_EC_X448},
     {NULL}
 };
 #endif
@@ -698,6 +728,64 @@ static int SHA512_loop(void *args)
     return count;
 }
 
+static int EVP_Digest_SHA3_256_loop(void *args)
+{
+    loopargs_t *tempargs = *(loopargs_t **) args;
+    unsigned char *buf = tempargs->buf;
+    unsigned char md[EVP_MAX_MD_SIZE];
+    int count;
+    for (count = 0; COND(c[D_SHA3_256][testnum]); count++) {
+        if (!EVP_Digest(buf, (size_t)lengths[testnum], md, NULL,
+                        EVP_sha3_256(), NULL))
+            return -1;
+    }
+    return count;
+}
+
+static int EVP_Digest_SHA3_512_loop(void *args)
+{
+    loopargs_t *tempargs = *(loopargs_t **) args;
+    unsigned char *buf = tempargs->buf;
+    unsigned char md[EVP_MAX_MD_SIZE];
+    int count;
+    for (count = 0; COND(c[D_SHA3_512][testnum]); count++) {
+        if (!EVP_Digest(buf, (size_t)lengths[testnum], md, NULL,
+                        EVP_sha3_512(), NULL))
+            return -1;
+    }
+    return count;
+}
+
+#ifndef OPENSSL_NO_BLAKE2
+static int EVP_Digest_BLAKE2b_loop(void *args)
+{
+    loopargs_t *tempargs = *(loopargs_t **) args;
+    unsigned char *buf = tempargs->buf;
+    unsigned char md[EVP_MAX_MD_SIZE];
+    int count;
+    for (count = 0; COND(c[D_BLAKE2B][testnum]); count++) {
+        if (!EVP_Digest(buf, (size_t)lengths[testnum], md, NULL,
+                        EVP_blake2b512(), NULL))
+            return -1;
+    }
+    return count;
+}
+
+static int EVP_Digest_BLAKE2s_loop(void *args)
+{
+    loopargs_t *tempargs = *(loopargs_t **) args;
+    unsigned char *buf = tempargs->buf;
+    unsigned char md[EVP_MAX_MD_SIZE];
+    int count;
+    for (count = 0; COND(c[D_BLAKE2S][testnum]); count++) {
+        if (!EVP_Digest(buf, (size_t)lengths[testnum], md, NULL,
+                        EVP_blake2s256(), NULL))
+            return -1;
+    }
+    return count;
+}
+#endif
+
 #ifndef OPENSSL_NO_WHIRLPOOL
 static int WHIRLPOOL_loop(void *args)
 {
@@ -1293,6 +1381,8 @@ int speed_main(int argc, char **argv)
         sizeof(test15360)
     };
     int rsa_doit[RSA_NUM] = { 0 };
+    int primes = RSA_DEFAULT_PRIME_NUM;
+    int keygen = 0, prime_threads = 1;
 #endif
 #ifndef OPENSSL_NO_DSA
     static const unsigned int dsa_bits[DSA_NUM] = { 512, 1024, 2048 };
@@ -1314,7 +1404,7 @@ int speed_main(int argc, char **argv)
         NID_sect233r1, NID_sect283r1, NID_sect409r1,
         NID_sect571r1,
         /* Other */
-        NID_X25519
+        NID_X25519, NID_X448
     };
     static const char *test_curves_names[EC_NUM] = {
         /* Prime Curves */
@@ -1326,7 +1416,7 @@ int speed_main(int argc, char **argv)
         "nistb233", "nistb283", "nistb409",
         "nistb571",
         /* Other */
-        "X25519"
+        "X25519", "X448"
     };
     static const int test_curves_bits[EC_NUM] = {
         160, 192, 224,
@@ -1334,7 +1424,7 @@ int speed_main(int argc, char **argv)
         163, 233, 283,
         409, 571, 163,
         233, 283, 409,
-        571, 253                /* X25519 */
+        571, 253, 448           /* X25519, X448 */
     };
 
     int ecdsa_doit[EC_NUM] = { 0 };
@@ -1420,6 +1510,28 @@ int speed_main(int argc, char **argv)
                        "%s: -mb specified but multi-block support is disabled\n",
                        prog);
             goto end;
+#endif
+            break;
+        case OPT_PRIMES:
+#ifndef OPENSSL_NO_RSA
+            if (!opt_int(opt_arg(), &primes))
+                goto end;
+#endif
+            break;
+        case OPT_KEYGEN:
+#ifndef OPENSSL_NO_RSA
+            if (!opt_int(opt_arg(), &keygen) || keygen < 0)
+                goto opterr;
+#endif
+            break;
+        case OPT_PRIME_THREADS:
+#ifndef OPENSSL_NO_RSA
+            if (!opt_int(opt_arg(), &prime_threads)
+                || !BN_set_prime_search_threads(prime_threads)) {
+                BIO_printf(bio_err, "%s: thread count must be 1 to %d\n",
+                           prog, BN_MAX_PRIME_SEARCH_THREADS);
+                goto end;
+            }
 #endif
             break;
         }
@@ -1540,6 +1652,12 @@ int speed_main(int argc, char **argv)
     }
 
 #ifndef NO_FORK
+# ifndef OPENSSL_NO_RSA
+    if (multi && keygen) {
+        BIO_printf(bio_err, "%s: -keygen cannot be used with -multi\n", prog);
+        goto end;
+    }
+# endif
     if (multi && do_multi(multi))
         goto show_res;
 #endif
@@ -1676,6 +1794,10 @@ int speed_main(int argc, char **argv)
     c[D_IGE_192_AES][0] = count;
     c[D_IGE_256_AES][0] = count;
     c[D_GHASH][0] = count;
+    c[D_SHA3_256][0] = count;
+    c[D_SHA3_512][0] = count;
+    c[D_BLAKE2B][0] = count;
+    c[D_BLAKE2S][0] = count;
 
     for (i = 1; i < SIZE_NUM; i++) {
         long l0, l1;
@@ -1694,6 +1816,10 @@ int speed_main(int argc, char **argv)
         c[D_SHA512][i] = c[D_SHA512][0] * 4 * l0 / l1;
         c[D_WHIRLPOOL][i] = c[D_WHIRLPOOL][0] * 4 * l0 / l1;
         c[D_GHASH][i] = c[D_GHASH][0] * 4 * l0 / l1;
+        c[D_SHA3_256][i] = c[D_SHA3_256][0] * 4 * l0 / l1;
+        c[D_SHA3_512][i] = c[D_SHA3_512][0] * 4 * l0 / l1;
+        c[D_BLAKE2B][i] = c[D_BLAKE2B][0] * 4 * l0 / l1;
+        c[D_BLAKE2S][i] = c[D_BLAKE2S][0] * 4 * l0 / l1;
 
         l0 = (long)lengths[i - 1];
 
@@ -1828,6 +1954,8 @@ int speed_main(int argc, char **argv)
             }
         }
     }
+    ecdh_c[R_EC_X25519][0] = count / 1800;
+    ecdh_c[R_EC_X448][0] = count / 7200;
 #  endif
 
 # else
@@ -1940,6 +2068,52 @@ int speed_main(int argc, char **argv)
             print_result(D_SHA512, testnum, count, d);
         }
     }
+    if (doit[D_SHA3_256]) {
+        for (testnum = 0; testnum < SIZE_NUM; testnum++) {
+            print_message(names[D_SHA3_256], c[D_SHA3_256][testnum],
+                          lengths[testnum]);
+            Time_F(START);
+            count = run_benchmark(async_jobs, EVP_Digest_SHA3_256_loop,
+                                  loopargs);
+            d = Time_F(STOP);
+            print_result(D_SHA3_256, testnum, count, d);
+        }
+    }
+    if (doit[D_SHA3_512]) {
+        for (testnum = 0; testnum < SIZE_NUM; testnum++) {
+            print_message(names[D_SHA3_512], c[D_SHA3_512][testnum],
+                          lengths[testnum]);
+            Time_F(START);
+            count = run_benchmark(async_jobs, EVP_Digest_SHA3_512_loop,
+                                  loopargs);
+            d = Time_F(STOP);
+            print_result(D_SHA3_512, testnum, count, d);
+        }
+    }
+#ifndef OPENSSL_NO_BLAKE2
+    if (doit[D_BLAKE2B]) {
+        for (testnum = 0; testnum < SIZE_NUM; testnum++) {
+            print_message(names[D_BLAKE2B], c[D_BLAKE2B][testnum],
+                          lengths[testnum]);
+            Time_F(START);
+            count = run_benchmark(async_jobs, EVP_Digest_BLAKE2b_loop,
+                                  loopargs);
+            d = Time_F(STOP);
+            print_result(D_BLAKE2B, testnum, count, d);
+        }
+    }
+    if (doit[D_BLAKE2S]) {
+        for (testnum = 0; testnum < SIZE_NUM; testnum++) {
+            print_message(names[D_BLAKE2S], c[D_BLAKE2S][testnum],
+                          lengths[testnum]);
+            Time_F(START);
+            count = run_benchmark(async_jobs, EVP_Digest_BLAKE2s_loop,
+                                  loopargs);
+            d = Time_F(STOP);
+            print_result(D_BLAKE2S, testnum, count, d);
+        }
+    }
+#endif
 #ifndef OPENSSL_NO_WHIRLPOOL
     if (doit[D_WHIRLPOOL]) {
         for (testnum = 0; testnum < SIZE_NUM; testnum++) {
@@ -2339,6 +2513,34 @@ int speed_main(int argc, char **argv)
         int st = 0;
         if (!rsa_doit[testnum])
             continue;
+        if (primes > RSA_DEFAULT_PRIME_NUM) {
+            /* replace the built-in two-prime key by a multi-prime one */
+            RSA *rsa = RSA_new();
+            BIGNUM *bn = BN_new();
+
+            if (rsa == NULL || bn == NULL || !BN_set_word(bn, RSA_F4)
+                || !RSA_generate_multi_prime_key(rsa, rsa_bits[testnum],
+                                                 primes, bn, NULL)) {
+                BIO_printf(bio_err,
+                           "Cannot generate a %u bit RSA key with %d primes.  "
+                           "No RSA will be done for it.\n",
+                           rsa_bits[testnum], primes);
+                ERR_print_errors(bio_err);
+                RSA_free(rsa);
+                BN_free(bn);
+                rsa_doit[testnum] = 0;
+                continue;
+            }
+            BN_free(bn);
+            for (i = 0; i < loopargs_len; i++) {
+                RSA_free(loopargs[i].rsa_key[testnum]);
+                RSA_up_ref(rsa);
+                loopargs[i].rsa_key[testnum] = rsa;
+            }
+            RSA_free(rsa);
+        }
+        if (keygen > 0)
+            rsa_keygen_latency(rsa_bits[testnum], primes, keygen);
         for (i = 0; i < loopargs_len; i++) {
             st = RSA_sign(NID_md5_sha1, loopargs[i].buf, 36, loopargs[i].buf2,
                           &loopargs[i].siglen, loopargs[i].rsa_key[testnum]);
@@ -2940,6 +3142,60 @@ static void print_result(int alg, int run_no, int count, double time_used)
     results[alg][run_no] = ((double)count) / time_used * lengths[run_no];
 }
 
+#ifndef OPENSSL_NO_RSA
+static int latency_cmp(const void *a, const void *b)
+{
+    double da = *(const double *)a, db = *(const double *)b;
+
+    return da < db ? -1 : da > db;
+}
+
+/*
+ * Key generation time varies widely with the number of candidates tried,
+ * so show the spread of wall clock times rather than a rate.
+ */
+static void rsa_keygen_latency(unsigned int bits, int primes, int num)
+{
+    double *lat = app_malloc(num * sizeof(*lat), "keygen latencies");
+    double sum = 0;
+    BIGNUM *e = BN_new();
+    RSA *rsa = NULL;
+    int i;
+
+    if (e == NULL || !BN_set_word(e, RSA_F4))
+        goto end;
+    for (i = 0; i < num; i++) {
+        rsa = RSA_new();
+        app_tminterval(TM_START, 0);
+        if (rsa == NULL
+            || !RSA_generate_multi_prime_key(rsa, bits, primes, e, NULL)) {
+            BIO_printf(bio_err, "RSA key generation failure.\n");
+            ERR_print_errors(bio_err);
+            goto end;
+        }
+        lat[i] = app_tminterval(TM_STOP, 0);
+        sum += lat[i];
+        RSA_free(rsa);
+        rsa = NULL;
+    }
+    qsort(lat, num, sizeof(*lat), latency_cmp);
+
+    if (mr)
+        printf("+KG:%u:%d:%d:%f:%f:%f:%f:%f\n", bits, primes, num, lat[0],
+               lat[(num - 1) / 2], lat[(9 * num + 9) / 10 - 1], lat[num - 1],
+               sum / num);
+    else
+        printf("rsa %5u bits keygen, %d primes, %d keys: min %.3fs "
+               "median %.3fs p90 %.3fs max %.3fs mean %.3fs\n", bits, primes,
+               num, lat[0], lat[(num - 1) / 2], lat[(9 * num + 9) / 10 - 1],
+               lat[num - 1], sum / num);
+ end:
+    RSA_free(rsa);
+    BN_free(e);
+    OPENSSL_free(lat);
+}
+#endif
+
 #ifndef NO_FORK
 static char *sstrsep(char **string, const char *delim)
 {
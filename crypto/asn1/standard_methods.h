@@ -42,6 +42,7 @@ static const EVP_PKEY_ASN1_METHOD *standard_methods[] = {
 #endif
 #ifndef OPENSSL_NO_EC
     &ecx25519_asn1_meth,
+    &ecx448_asn1_meth,
 #endif
 #ifndef OPENSSL_NO_POLY1305
     &poly1305_asn1_meth,
@@ -49,5 +50,12 @@ static const EVP_PKEY_ASN1_METHOD *standard_methods[] = {
 #ifndef OPENSSL_NO_SIPHASH
     &siphash_asn1_meth,
 #endif
+#ifndef OPENSSL_NO_EC
+    &ed25519_asn1_meth,
+#endif
+#ifndef OPENSSL_NO_BLAKE2
+    &blake2b_asn1_meth,
+    &blake2s_asn1_meth,
+#endif
 };
 
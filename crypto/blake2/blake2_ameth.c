@@ -0,0 +1,97 @@
+/*
+ * Copyright 2017 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the OpenSSL license (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+#include <stdio.h>
+#include "internal/cryptlib.h"
+
+#ifndef OPENSSL_NO_BLAKE2
+
+# include <openssl/evp.h>
+# include "internal/asn1_int.h"
+# include "blake2_locl.h"
+
+/*
+ * Keyed BLAKE2 "ASN1" methods. These are just here to indicate the
+ * MAC output length and to free up a BLAKE2 key.
+ */
+
+static int blake2b_size(const EVP_PKEY *pkey)
+{
+    return BLAKE2B_DIGEST_LENGTH;
+}
+
+static int blake2s_size(const EVP_PKEY *pkey)
+{
+    return BLAKE2S_DIGEST_LENGTH;
+}
+
+static void blake2_key_free(EVP_PKEY *pkey)
+{
+    ASN1_OCTET_STRING *os = EVP_PKEY_get0(pkey);
+
+    if (os != NULL) {
+        if (os->data != NULL)
+            OPENSSL_cleanse(os->data, os->length);
+        ASN1_OCTET_STRING_free(os);
+    }
+}
+
+static int blake2_pkey_ctrl(EVP_PKEY *pkey, int op, long arg1, void *arg2)
+{
+    /* nothing (including ASN1_PKEY_CTRL_DEFAULT_MD_NID), is supported */
+    return -2;
+}
+
+static int blake2_pkey_public_cmp(const EVP_PKEY *a, const EVP_PKEY *b)
+{
+    return ASN1_OCTET_STRING_cmp(EVP_PKEY_get0(a), EVP_PKEY_get0(b));
+}
+
+const EVP_PKEY_ASN1_METHOD blake2b_asn1_meth = {
+    EVP_PKEY_BLAKE2BMAC,
+    EVP_PKEY_BLAKE2BMAC,
+    0,
+
+    "BLAKE2BMAC",
+    "OpenSSL keyed BLAKE2b method",
+
+    0, 0, blake2_pkey_public_cmp, 0,
+
+    0, 0, 0,
+
+    blake2b_size,
+    0, 0,
+    0, 0, 0, 0, 0, 0, 0,
+
+    blake2_key_free,
+    blake2_pkey_ctrl,
+    0, 0
+};
+
+const EVP_PKEY_ASN1_METHOD blake2s_asn1_meth = {
+    EVP_PKEY_BLAKE2SMAC,
+    EVP_PKEY_BLAKE2SMAC,
+    0,
+
+    "BLAKE2SMAC",
+    "OpenSSL keyed BLAKE2s method",
+
+    0, 0, blake2_pkey_public_cmp, 0,
+
+    0, 0, 0,
+
+    blake2s_size,
+    0, 0,
+    0, 0, 0, 0, 0, 0, 0,
+
+    blake2_key_free,
+    blake2_pkey_ctrl,
+    0, 0
+};
+#endif
@@ -83,9 +83,28 @@ typedef struct blake2s_ctx_st BLAKE2S_CTX;
 typedef struct blake2b_ctx_st BLAKE2B_CTX;
 
 int BLAKE2b_Init(BLAKE2B_CTX *c);
+int BLAKE2b_Init_key(BLAKE2B_CTX *c, const void *key, size_t keylen);
 int BLAKE2b_Update(BLAKE2B_CTX *c, const void *data, size_t datalen);
 int BLAKE2b_Final(unsigned char *md, BLAKE2B_CTX *c);
 
 int BLAKE2s_Init(BLAKE2S_CTX *c);
+int BLAKE2s_Init_key(BLAKE2S_CTX *c, const void *key, size_t keylen);
 int BLAKE2s_Update(BLAKE2S_CTX *c, const void *data, size_t datalen);
 int BLAKE2s_Final(unsigned char *md, BLAKE2S_CTX *c);
+
+#if defined(BLAKE2_ASM) && (defined(__x86_64) || defined(__x86_64__) || \
+                            defined(_M_AMD64) || defined(_M_X64))
+/*
+ * Compress |num| blocks, advancing the block counter by |inc| for each.
+ * Requires SSSE3 and SSE4.1; the BLAKE2b version uses AVX2 if present.
+ */
+# define BLAKE2_SIMD_ASM
+extern unsigned int OPENSSL_ia32cap_P[];
+# define BLAKE2_SIMD_CAPABLE \
+    ((OPENSSL_ia32cap_P[1] & (1 << (41 - 32) | 1 << (51 - 32))) == \
+     (1 << (41 - 32) | 1 << (51 - 32)))
+void blake2b_compress_simd(BLAKE2B_CTX *S, const uint8_t *blocks,
+                           size_t num, size_t inc);
+void blake2s_compress_simd(BLAKE2S_CTX *S, const uint8_t *blocks,
+                           size_t num, size_t inc);
+#endif
@@ -0,0 +1,232 @@
+/*
+ * Copyright 2017 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the OpenSSL license (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+#include <stdio.h>
+#include "internal/cryptlib.h"
+
+#ifndef OPENSSL_NO_BLAKE2
+
+# include <openssl/x509.h>
+# include <openssl/evp.h>
+# include "blake2_locl.h"
+# include "internal/evp_int.h"
+
+/*
+ * Keyed BLAKE2b and BLAKE2s pkey context structure. Both MAC types share
+ * the methods below and are told apart by ctx->pmeth->pkey_id.
+ */
+
+typedef struct blake2_pkey_ctx_st {
+    ASN1_OCTET_STRING ktmp;     /* Temp storage for key */
+    union {
+        BLAKE2B_CTX b;
+        BLAKE2S_CTX s;
+    } ctx;
+} BLAKE2_PKEY_CTX;
+
+static int blake2_mac_init(int type, BLAKE2_PKEY_CTX *pctx)
+{
+    const unsigned char *key = ASN1_STRING_get0_data(&pctx->ktmp);
+    size_t len = ASN1_STRING_length(&pctx->ktmp);
+
+    if (key == NULL)
+        return 0;
+    if (type == EVP_PKEY_BLAKE2BMAC)
+        return BLAKE2b_Init_key(&pctx->ctx.b, key, len);
+    return BLAKE2s_Init_key(&pctx->ctx.s, key, len);
+}
+
+static int pkey_blake2_init(EVP_PKEY_CTX *ctx)
+{
+    BLAKE2_PKEY_CTX *pctx;
+
+    pctx = OPENSSL_zalloc(sizeof(*pctx));
+    if (pctx == NULL)
+        return 0;
+    pctx->ktmp.type = V_ASN1_OCTET_STRING;
+
+    EVP_PKEY_CTX_set_data(ctx, pctx);
+    EVP_PKEY_CTX_set0_keygen_info(ctx, NULL, 0);
+    return 1;
+}
+
+static void pkey_blake2_cleanup(EVP_PKEY_CTX *ctx)
+{
+    BLAKE2_PKEY_CTX *pctx = EVP_PKEY_CTX_get_data(ctx);
+
+    if (pctx != NULL) {
+        OPENSSL_clear_free(pctx->ktmp.data, pctx->ktmp.length);
+        OPENSSL_clear_free(pctx, sizeof(*pctx));
+        EVP_PKEY_CTX_set_data(ctx, NULL);
+    }
+}
+
+static int pkey_blake2_copy(EVP_PKEY_CTX *dst, EVP_PKEY_CTX *src)
+{
+    BLAKE2_PKEY_CTX *sctx, *dctx;
+
+    if (!pkey_blake2_init(dst))
+        return 0;
+    sctx = EVP_PKEY_CTX_get_data(src);
+    dctx = EVP_PKEY_CTX_get_data(dst);
+    if (ASN1_STRING_get0_data(&sctx->ktmp) != NULL &&
+        !ASN1_STRING_copy(&dctx->ktmp, &sctx->ktmp)) {
+        pkey_blake2_cleanup(dst);
+        return 0;
+    }
+    memcpy(&dctx->ctx, &sctx->ctx, sizeof(dctx->ctx));
+    return 1;
+}
+
+static int pkey_blake2_keygen(EVP_PKEY_CTX *ctx, EVP_PKEY *pkey)
+{
+    ASN1_OCTET_STRING *key;
+    BLAKE2_PKEY_CTX *pctx = EVP_PKEY_CTX_get_data(ctx);
+
+    if (ASN1_STRING_get0_data(&pctx->ktmp) == NULL)
+        return 0;
+    key = ASN1_OCTET_STRING_dup(&pctx->ktmp);
+    if (key == NULL)
+        return 0;
+    return EVP_PKEY_assign(pkey, ctx->pmeth->pkey_id, key);
+}
+
+static int int_update_b(EVP_MD_CTX *ctx, const void *data, size_t count)
+{
+    BLAKE2_PKEY_CTX *pctx = EVP_PKEY_CTX_get_data(EVP_MD_CTX_pkey_ctx(ctx));
+
+    return BLAKE2b_Update(&pctx->ctx.b, data, count);
+}
+
+static int int_update_s(EVP_MD_CTX *ctx, const void *data, size_t count)
+{
+    BLAKE2_PKEY_CTX *pctx = EVP_PKEY_CTX_get_data(EVP_MD_CTX_pkey_ctx(ctx));
+
+    return BLAKE2s_Update(&pctx->ctx.s, data, count);
+}
+
+static int pkey_blake2_ctrl(EVP_PKEY_CTX *ctx, int type, int p1, void *p2);
+
+static int blake2_signctx_init(EVP_PKEY_CTX *ctx, EVP_MD_CTX *mctx)
+{
+    int type = ctx->pmeth->pkey_id;
+
+    EVP_MD_CTX_set_flags(mctx, EVP_MD_CTX_FLAG_NO_INIT);
+    EVP_MD_CTX_set_update_fn(mctx, type == EVP_PKEY_BLAKE2BMAC ? int_update_b
+                                                               : int_update_s);
+    /* pick up the key from the EVP_PKEY and initialize the MAC with it */
+    return pkey_blake2_ctrl(ctx, EVP_PKEY_CTRL_DIGESTINIT, 0, NULL);
+}
+
+static int blake2_signctx(EVP_PKEY_CTX *ctx, unsigned char *sig,
+                          size_t *siglen, EVP_MD_CTX *mctx)
+{
+    BLAKE2_PKEY_CTX *pctx = EVP_PKEY_CTX_get_data(ctx);
+
+    if (ctx->pmeth->pkey_id == EVP_PKEY_BLAKE2BMAC) {
+        *siglen = BLAKE2B_DIGEST_LENGTH;
+        if (sig != NULL)
+            return BLAKE2b_Final(sig, &pctx->ctx.b);
+    } else {
+        *siglen = BLAKE2S_DIGEST_LENGTH;
+        if (sig != NULL)
+            return BLAKE2s_Final(sig, &pctx->ctx.s);
+    }
+    return 1;
+}
+
+static int pkey_blake2_ctrl(EVP_PKEY_CTX *ctx, int type, int p1, void *p2)
+{
+    BLAKE2_PKEY_CTX *pctx = EVP_PKEY_CTX_get_data(ctx);
+    const ASN1_OCTET_STRING *os;
+    const unsigned char *key;
+    size_t len, maxlen;
+
+    switch (type) {
+
+    case EVP_PKEY_CTRL_MD:
+        /* ignore */
+        break;
+
+    case EVP_PKEY_CTRL_SET_MAC_KEY:
+    case EVP_PKEY_CTRL_DIGESTINIT:
+        if (type == EVP_PKEY_CTRL_SET_MAC_KEY) {
+            /* user explicitly setting the key */
+            key = p2;
+            len = p1;
+        } else {
+            /* user indirectly setting the key via EVP_DigestSignInit */
+            os = EVP_PKEY_get0(EVP_PKEY_CTX_get0_pkey(ctx));
+            key = os->data;
+            len = os->length;
+        }
+        maxlen = ctx->pmeth->pkey_id == EVP_PKEY_BLAKE2BMAC ? BLAKE2B_KEYBYTES
+                                                            : BLAKE2S_KEYBYTES;
+        if (key == NULL || len == 0 || len > maxlen ||
+            !ASN1_OCTET_STRING_set(&pctx->ktmp, key, len))
+            return 0;
+        return blake2_mac_init(ctx->pmeth->pkey_id, pctx);
+
+    default:
+        return -2;
+
+    }
+    return 1;
+}
+
+static int pkey_blake2_ctrl_str(EVP_PKEY_CTX *ctx,
+                                const char *type, const char *value)
+{
+    if (value == NULL)
+        return 0;
+    if (strcmp(type, "key") == 0)
+        return EVP_PKEY_CTX_str2ctrl(ctx, EVP_PKEY_CTRL_SET_MAC_KEY, value);
+    if (strcmp(type, "hexkey") == 0)
+        return EVP_PKEY_CTX_hex2ctrl(ctx, EVP_PKEY_CTRL_SET_MAC_KEY, value);
+    return -2;
+}
+
+# define BLAKE2_PKEY_METH(type) {               \
+    type,                                       \
+    EVP_PKEY_FLAG_SIGCTX_CUSTOM,                \
+    pkey_blake2_init,                           \
+    pkey_blake2_copy,                           \
+    pkey_blake2_cleanup,                        \
+                                                \
+    0, 0,                                       \
+                                                \
+    0,                                          \
+    pkey_blake2_keygen,                         \
+                                                \
+    0, 0,                                       \
+                                                \
+    0, 0,                                       \
+                                                \
+    0, 0,                                       \
+                                                \
+    blake2_signctx_init,                        \
+    blake2_signctx,                             \
+                                                \
+    0, 0,                                       \
+                                                \
+    0, 0,                                       \
+                                                \
+    0, 0,                                       \
+                                                \
+    0, 0,                                       \
+                                                \
+    pkey_blake2_ctrl,                           \
+    pkey_blake2_ctrl_str                        \
+}
+
+const EVP_PKEY_METHOD blake2b_pkey_meth =
+    BLAKE2_PKEY_METH(EVP_PKEY_BLAKE2BMAC);
+const EVP_PKEY_METHOD blake2s_pkey_meth =
+    BLAKE2_PKEY_METH(EVP_PKEY_BLAKE2SMAC);
+#endif
@@ -79,12 +79,12 @@ static void blake2b_init_param(BLAKE2B_CTX *S, const BLAKE2B_PARAM *P)
     }
 }
 
-/* Initialize the hashing context.  Always returns 1. */
-int BLAKE2b_Init(BLAKE2B_CTX *c)
+/* Initialize the hashing context for given key length. */
+static void blake2b_init_keylen(BLAKE2B_CTX *c, size_t keylen)
 {
     BLAKE2B_PARAM P[1];
     P->digest_length = BLAKE2B_DIGEST_LENGTH;
-    P->key_length    = 0;
+    P->key_length    = (uint8_t)keylen;
     P->fanout        = 1;
     P->depth         = 1;
     store32(P->leaf_length, 0);
@@ -95,6 +95,30 @@ int BLAKE2b_Init(BLAKE2B_CTX *c)
     memset(P->salt,     0, sizeof(P->salt));
     memset(P->personal, 0, sizeof(P->personal));
     blake2b_init_param(c, P);
+}
+
+/* Initialize the hashing context.  Always returns 1. */
+int BLAKE2b_Init(BLAKE2B_CTX *c)
+{
+    blake2b_init_keylen(c, 0);
+    return 1;
+}
+
+/*
+ * Initialize the hashing context for keyed hashing, the key is padded
+ * to a full block and processed as the first block of data.
+ */
+int BLAKE2b_Init_key(BLAKE2B_CTX *c, const void *key, size_t keylen)
+{
+    uint8_t block[BLAKE2B_BLOCKBYTES] = {0};
+
+    if (keylen == 0 || keylen > BLAKE2B_KEYBYTES)
+        return 0;
+
+    blake2b_init_keylen(c, keylen);
+    memcpy(block, key, keylen);
+    BLAKE2b_Update(c, block, sizeof(block));
+    OPENSSL_cleanse(block, sizeof(block));
     return 1;
 }
 
@@ -129,6 +153,15 @@ static void blake2b_compress(BLAKE2B_CTX *S,
      */
     increment = len < BLAKE2B_BLOCKBYTES ? len : BLAKE2B_BLOCKBYTES;
 
+#ifdef BLAKE2_SIMD_ASM
+    if (BLAKE2_SIMD_CAPABLE) {
+        size_t num = len < BLAKE2B_BLOCKBYTES ? 1 : len / BLAKE2B_BLOCKBYTES;
+
+        blake2b_compress_simd(S, blocks, num, increment);
+        return;
+    }
+#endif
+
     for (i = 0; i < 8; ++i) {
         v[i] = S->h[i];
     }
@@ -75,13 +75,13 @@ static void blake2s_init_param(BLAKE2S_CTX *S, const BLAKE2S_PARAM *P)
     }
 }
 
-/* Initialize the hashing context.  Always returns 1. */
-int BLAKE2s_Init(BLAKE2S_CTX *c)
+/* Initialize the hashing context for given key length. */
+static void blake2s_init_keylen(BLAKE2S_CTX *c, size_t keylen)
 {
     BLAKE2S_PARAM P[1];
 
     P->digest_length = BLAKE2S_DIGEST_LENGTH;
-    P->key_length    = 0;
+    P->key_length    = (uint8_t)keylen;
     P->fanout        = 1;
     P->depth         = 1;
     store32(P->leaf_length, 0);
@@ -91,6 +91,30 @@ int BLAKE2s_Init(BLAKE2S_CTX *c)
     memset(P->salt,     0, sizeof(P->salt));
     memset(P->personal, 0, sizeof(P->personal));
     blake2s_init_param(c, P);
+}
+
+/* Initialize the hashing context.  Always returns 1. */
+int BLAKE2s_Init(BLAKE2S_CTX *c)
+{
+    blake2s_init_keylen(c, 0);
+    return 1;
+}
+
+/*
+ * Initialize the hashing context for keyed hashing, the key is padded
+ * to a full block and processed as the first block of data.
+ */
+int BLAKE2s_Init_key(BLAKE2S_CTX *c, const void *key, size_t keylen)
+{
+    uint8_t block[BLAKE2S_BLOCKBYTES] = {0};
+
+    if (keylen == 0 || keylen > BLAKE2S_KEYBYTES)
+        return 0;
+
+    blake2s_init_keylen(c, keylen);
+    memcpy(block, key, keylen);
+    BLAKE2s_Update(c, block, sizeof(block));
+    OPENSSL_cleanse(block, sizeof(block));
     return 1;
 }
 
@@ -125,6 +149,15 @@ static void blake2s_compress(BLAKE2S_CTX *S,
      */
     increment = len < BLAKE2S_BLOCKBYTES ? len : BLAKE2S_BLOCKBYTES;
 
+#ifdef BLAKE2_SIMD_ASM
+    if (BLAKE2_SIMD_CAPABLE) {
+        size_t num = len < BLAKE2S_BLOCKBYTES ? 1 : len / BLAKE2S_BLOCKBYTES;
+
+        blake2s_compress_simd(S, blocks, num, increment);
+        return;
+    }
+#endif
+
     for (i = 0; i < 8; ++i) {
         v[i] = S->h[i];
     }
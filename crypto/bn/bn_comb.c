@@ -0,0 +1,203 @@
+/*
+ * Copyright 2017 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the OpenSSL license (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+#include <string.h>
+#include "internal/cryptlib.h"
+#include "internal/constant_time_locl.h"
+#include "bn_lcl.h"
+
+/*
+ * Fixed-base comb exponentiation g^e mod m for a fixed g and exponents of
+ * at most |max_bits| bits, as used for Diffie-Hellman key generation in
+ * well-known groups.
+ *
+ * The exponent is read as d columns of w "teeth" spaced d bits apart,
+ * w * d >= max_bits.  With B_i = g^(2^(i*d)), the table holds the 2^w
+ * Montgomery-form values
+ *
+ *     T[j] = prod_{i : j_i = 1} B_i
+ *
+ * where j_i is bit i of j.  An exponentiation then costs d - 1 squarings
+ * and d multiplications, the same sequence of operations for every
+ * exponent of the permitted length, and each table lookup touches every
+ * entry.
+ */
+
+#define BN_COMB_TEETH   6
+
+struct bn_comb_st {
+    int teeth;                  /* w */
+    int spacing;                /* d */
+    int max_bits;               /* longest supported exponent */
+    int words;                  /* words per table entry */
+    BN_MONT_CTX *mont;
+    BN_ULONG *table;            /* 2^w entries */
+};
+
+BN_COMB *bn_comb_new(const BIGNUM *g, const BIGNUM *m, int max_bits,
+                     BN_CTX *ctx)
+{
+    BN_COMB *comb;
+    BIGNUM *b, *t;
+    BN_ULONG *p;
+    int w = BN_COMB_TEETH, i, j, h, entries = 1 << BN_COMB_TEETH;
+
+    if (max_bits <= 0) {
+        BNerr(BN_F_BN_COMB_NEW, BN_R_INVALID_LENGTH);
+        return NULL;
+    }
+    if (!BN_is_odd(m)) {
+        BNerr(BN_F_BN_COMB_NEW, BN_R_CALLED_WITH_EVEN_MODULUS);
+        return NULL;
+    }
+
+    comb = OPENSSL_zalloc(sizeof(*comb));
+    if (comb == NULL) {
+        BNerr(BN_F_BN_COMB_NEW, ERR_R_MALLOC_FAILURE);
+        return NULL;
+    }
+    comb->teeth = w;
+    comb->spacing = (max_bits + w - 1) / w;
+    comb->max_bits = max_bits;
+    comb->words = bn_get_top(m);
+
+    BN_CTX_start(ctx);
+    b = BN_CTX_get(ctx);
+    t = BN_CTX_get(ctx);
+    comb->table = OPENSSL_zalloc(sizeof(*comb->table) * entries * comb->words);
+    if (t == NULL || comb->table == NULL) {
+        BNerr(BN_F_BN_COMB_NEW, ERR_R_MALLOC_FAILURE);
+        goto err;
+    }
+    if ((comb->mont = BN_MONT_CTX_new()) == NULL
+        || !BN_MONT_CTX_set(comb->mont, m, ctx))
+        goto err;
+
+    /* T[0] = 1 and b = B_0 = g, both in Montgomery form */
+    if (!BN_to_montgomery(t, BN_value_one(), comb->mont, ctx)
+        || !bn_copy_words(comb->table, t, comb->words)
+        || !BN_nnmod(b, g, m, ctx)
+        || !BN_to_montgomery(b, b, comb->mont, ctx))
+        goto err;
+
+    /* Setting bit h of the index multiplies in B_h */
+    for (j = 1, h = -1; j < entries; j++) {
+        if (j == 1 << (h + 1)) {
+            h++;
+            for (i = 0; h > 0 && i < comb->spacing; i++) {
+                if (!BN_mod_mul_montgomery(b, b, b, comb->mont, ctx))
+                    goto err;
+            }
+        }
+        p = comb->table + (size_t)(j ^ (1 << h)) * comb->words;
+        if (!bn_set_words(t, p, comb->words)
+            || !BN_mod_mul_montgomery(t, t, b, comb->mont, ctx)
+            || !bn_copy_words(comb->table + (size_t)j * comb->words, t,
+                              comb->words))
+            goto err;
+    }
+
+    BN_CTX_end(ctx);
+    return comb;
+
+ err:
+    BN_CTX_end(ctx);
+    bn_comb_free(comb);
+    return NULL;
+}
+
+void bn_comb_free(BN_COMB *comb)
+{
+    if (comb == NULL)
+        return;
+    OPENSSL_clear_free(comb->table, sizeof(*comb->table)
+                       * ((size_t)1 << comb->teeth) * comb->words);
+    BN_MONT_CTX_free(comb->mont);
+    OPENSSL_free(comb);
+}
+
+/* Loads T[idx] into |v| without branching on idx */
+static int bn_comb_select(const BN_COMB *comb, BN_ULONG *sel, BIGNUM *v,
+                          unsigned int idx)
+{
+    int i, nw = comb->words;
+    size_t j, entries = (size_t)1 << comb->teeth;
+    BN_ULONG mask;
+    const BN_ULONG *p;
+
+    memset(sel, 0, sizeof(*sel) * nw);
+    for (j = 0, p = comb->table; j < entries; j++, p += nw) {
+        mask = (BN_ULONG)0 - (BN_ULONG)(constant_time_eq_int((int)j,
+                                                             (int)idx) & 1);
+        for (i = 0; i < nw; i++)
+            sel[i] |= p[i] & mask;
+    }
+    return bn_set_words(v, sel, nw);
+}
+
+/*
+ * Computes r = g^e mod m using |comb|.  Returns 1 on success, 0 on error
+ * and -1 if |e| is negative or too long for the comb, in which case the
+ * caller falls back to the generic code.
+ */
+int bn_comb_mod_exp(BIGNUM *r, const BIGNUM *e, const BN_COMB *comb,
+                    BN_CTX *ctx)
+{
+    BIGNUM *acc, *v;
+    BN_ULONG *ew = NULL, *sel = NULL;
+    int w = comb->teeth, d = comb->spacing, ewords, col, t, ret = 0;
+    unsigned int idx;
+
+    if (BN_is_negative(e) || BN_num_bits(e) > comb->max_bits)
+        return -1;
+
+    ewords = (w * d + BN_BITS2 - 1) / BN_BITS2;
+
+    BN_CTX_start(ctx);
+    acc = BN_CTX_get(ctx);
+    v = BN_CTX_get(ctx);
+    ew = OPENSSL_zalloc(sizeof(*ew) * ewords);
+    sel = OPENSSL_malloc(sizeof(*sel) * comb->words);
+    if (v == NULL || ew == NULL || sel == NULL) {
+        BNerr(BN_F_BN_COMB_MOD_EXP, ERR_R_MALLOC_FAILURE);
+        goto err;
+    }
+    if (!bn_copy_words(ew, e, ewords))
+        goto err;
+
+#define COMB_BIT(i) ((unsigned int)(ew[(i) / BN_BITS2] >> ((i) % BN_BITS2)) & 1)
+
+    for (col = d - 1; col >= 0; col--) {
+        idx = 0;
+        for (t = 0; t < w; t++)
+            idx |= COMB_BIT(col + t * d) << t;
+
+        if (!bn_comb_select(comb, sel, v, idx))
+            goto err;
+        if (col == d - 1) {
+            if (BN_copy(acc, v) == NULL)
+                goto err;
+        } else if (!BN_mod_mul_montgomery(acc, acc, acc, comb->mont, ctx)
+                   || !BN_mod_mul_montgomery(acc, acc, v, comb->mont, ctx)) {
+            goto err;
+        }
+    }
+
+#undef COMB_BIT
+
+    if (!BN_from_montgomery(r, acc, comb->mont, ctx))
+        goto err;
+    ret = 1;
+
+ err:
+    OPENSSL_clear_free(ew, sizeof(*ew) * ewords);
+    OPENSSL_clear_free(sel, sizeof(*sel) * comb->words);
+    BN_CTX_end(ctx);
+    return ret;
+}
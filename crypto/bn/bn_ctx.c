@@ -7,7 +7,8 @@
  * https://www.openssl.org/source/license.html
  */
 
-#include "internal/cryptlib.h"
+#include "internal/cryptlib_int.h"
+#include "internal/thread_once.h"
 #include "bn_lcl.h"
 
 /*-
@@ -27,6 +28,8 @@
 #define BN_CTX_POOL_SIZE        16
 /* The stack frame info is resizing, set a first-time expansion size; */
 #define BN_CTX_START_FRAMES     32
+/* Contexts with more bignums than this are not kept in the thread cache */
+#define BN_CTX_CACHE_MAX_BIGNUMS        (4 * BN_CTX_POOL_SIZE)
 
 /***********/
 /* BN_POOL */
@@ -85,8 +88,40 @@ struct bignum_ctx {
     int too_many;
     /* Flags. */
     int flags;
+    /* Next context in the thread cache */
+    struct bignum_ctx *next;
 };
 
+/*
+ * Per-thread cache of released contexts.
+ *
+ * Many callers create a BN_CTX for a single operation and free it right
+ * after, which costs an allocation for the context, its stack frames, each
+ * pool item and each pooled BIGNUM.  Instead, BN_CTX_free() keeps up to
+ * |bn_ctx_cache_size| contexts per thread, with their BIGNUMs cleansed but
+ * still expanded, and BN_CTX_new() hands them out again.  Only the owning
+ * thread ever touches a cache, so no locks are needed.  Secure contexts are
+ * never cached.
+ */
+typedef struct {
+    BN_CTX *head;
+    size_t num;
+    uint64_t hits, misses;
+} BN_CTX_CACHE;
+
+static CRYPTO_ONCE bn_ctx_cache_init = CRYPTO_ONCE_STATIC_INIT;
+static CRYPTO_THREAD_LOCAL bn_ctx_cache_local;
+static int bn_ctx_cache_inited = 0;
+static size_t bn_ctx_cache_size = BN_CTX_CACHE_DEFAULT_SIZE;
+
+DEFINE_RUN_ONCE_STATIC(do_bn_ctx_cache_init)
+{
+    if (!CRYPTO_THREAD_init_local(&bn_ctx_cache_local, NULL))
+        return 0;
+    bn_ctx_cache_inited = 1;
+    return 1;
+}
+
 /* Enable this to find BN_CTX bugs */
 #ifdef BN_CTX_DEBUG
 static const char *ctxdbg_cur = NULL;
@@ -131,7 +166,7 @@ static void ctxdbg(BN_CTX *ctx)
 #endif
 
 
-BN_CTX *BN_CTX_new(void)
+static BN_CTX *bn_ctx_new_int(void)
 {
     BN_CTX *ret;
 
@@ -145,19 +180,8 @@ BN_CTX *BN_CTX_new(void)
     return ret;
 }
 
-BN_CTX *BN_CTX_secure_new(void)
+static void bn_ctx_free_int(BN_CTX *ctx)
 {
-    BN_CTX *ret = BN_CTX_new();
-
-    if (ret != NULL)
-        ret->flags = BN_FLG_SECURE;
-    return ret;
-}
-
-void BN_CTX_free(BN_CTX *ctx)
-{
-    if (ctx == NULL)
-        return;
 #ifdef BN_CTX_DEBUG
     {
         BN_POOL_ITEM *pool = ctx->pool.head;
@@ -178,6 +202,191 @@ void BN_CTX_free(BN_CTX *ctx)
     OPENSSL_free(ctx);
 }
 
+/* Returns the cache of the calling thread, setting it up if necessary */
+static BN_CTX_CACHE *bn_ctx_cache_get(void)
+{
+    BN_CTX_CACHE *cache;
+
+    if (bn_ctx_cache_size == 0
+        || !RUN_ONCE(&bn_ctx_cache_init, do_bn_ctx_cache_init)
+        || !bn_ctx_cache_inited)
+        return NULL;
+
+    cache = CRYPTO_THREAD_get_local(&bn_ctx_cache_local);
+    if (cache == NULL) {
+        cache = OPENSSL_zalloc(sizeof(*cache));
+        if (cache == NULL)
+            return NULL;
+        if (!CRYPTO_THREAD_set_local(&bn_ctx_cache_local, cache)) {
+            OPENSSL_free(cache);
+            return NULL;
+        }
+        /* Ignore failures from these */
+        OPENSSL_init_crypto(0, NULL);
+        ossl_init_thread_start(OPENSSL_INIT_THREAD_BN_CTX);
+    }
+    return cache;
+}
+
+/* Returns the cache of the calling thread if it has one */
+static BN_CTX_CACHE *bn_ctx_cache_peek(void)
+{
+    if (!bn_ctx_cache_inited)
+        return NULL;
+    return CRYPTO_THREAD_get_local(&bn_ctx_cache_local);
+}
+
+/* Frees cached contexts until at most |num| are left */
+static void bn_ctx_cache_trim(BN_CTX_CACHE *cache, size_t num)
+{
+    BN_CTX *ctx;
+
+    while (cache->num > num) {
+        ctx = cache->head;
+        cache->head = ctx->next;
+        cache->num--;
+        bn_ctx_free_int(ctx);
+    }
+}
+
+/* Returns a context from the thread cache, or NULL if there is none */
+static BN_CTX *bn_ctx_cache_pop(void)
+{
+    BN_CTX_CACHE *cache = bn_ctx_cache_get();
+    BN_CTX *ctx;
+
+    if (cache == NULL)
+        return NULL;
+    if ((ctx = cache->head) == NULL) {
+        cache->misses++;
+        return NULL;
+    }
+    cache->head = ctx->next;
+    cache->num--;
+    cache->hits++;
+    ctx->next = NULL;
+    return ctx;
+}
+
+/*
+ * Cleanses |ctx| and puts it into the thread cache.  Returns 1 if it was
+ * taken and 0 if the caller has to free it.
+ */
+static int bn_ctx_cache_push(BN_CTX *ctx)
+{
+    BN_CTX_CACHE *cache;
+    BN_POOL_ITEM *item;
+    BIGNUM *bn;
+    unsigned int loop;
+    size_t size = bn_ctx_cache_size;
+
+    if (ctx->flags != 0 || ctx->pool.size > BN_CTX_CACHE_MAX_BIGNUMS)
+        return 0;
+    if (size == 0 || (cache = bn_ctx_cache_get()) == NULL
+        || cache->num >= size) {
+        /* The size may have been lowered by another thread, apply it here */
+        if ((cache = bn_ctx_cache_peek()) != NULL)
+            bn_ctx_cache_trim(cache, size);
+        return 0;
+    }
+
+    for (item = ctx->pool.head; item != NULL; item = item->next) {
+        for (loop = 0, bn = item->vals; loop++ < BN_CTX_POOL_SIZE; bn++) {
+            if (bn->d != NULL)
+                OPENSSL_cleanse(bn->d, sizeof(*bn->d) * bn->dmax);
+            bn->top = 0;
+            bn->neg = 0;
+            bn->flags &= BN_FLG_SECURE;
+        }
+    }
+    ctx->pool.current = ctx->pool.head;
+    ctx->pool.used = 0;
+    ctx->stack.depth = 0;
+    ctx->used = 0;
+    ctx->err_stack = 0;
+    ctx->too_many = 0;
+
+    ctx->next = cache->head;
+    cache->head = ctx;
+    cache->num++;
+    return 1;
+}
+
+BN_CTX *BN_CTX_new(void)
+{
+    BN_CTX *ret = bn_ctx_cache_pop();
+
+    return ret != NULL ? ret : bn_ctx_new_int();
+}
+
+BN_CTX *BN_CTX_secure_new(void)
+{
+    BN_CTX *ret = bn_ctx_new_int();
+
+    if (ret != NULL)
+        ret->flags = BN_FLG_SECURE;
+    return ret;
+}
+
+void BN_CTX_free(BN_CTX *ctx)
+{
+    if (ctx == NULL || bn_ctx_cache_push(ctx))
+        return;
+    bn_ctx_free_int(ctx);
+}
+
+int BN_CTX_set_cache_size(size_t num)
+{
+    BN_CTX_CACHE *cache;
+
+    bn_ctx_cache_size = num;
+    /* Other threads trim their caches when they next free a context */
+    if ((cache = bn_ctx_cache_peek()) != NULL)
+        bn_ctx_cache_trim(cache, num);
+    return 1;
+}
+
+size_t BN_CTX_get_cache_size(void)
+{
+    return bn_ctx_cache_size;
+}
+
+void BN_CTX_get_cache_stats(uint64_t *hits, uint64_t *misses)
+{
+    BN_CTX_CACHE *cache = NULL;
+
+    if (bn_ctx_cache_inited)
+        cache = CRYPTO_THREAD_get_local(&bn_ctx_cache_local);
+    if (hits != NULL)
+        *hits = cache != NULL ? cache->hits : 0;
+    if (misses != NULL)
+        *misses = cache != NULL ? cache->misses : 0;
+}
+
+void bn_ctx_thread_cache_cleanup(void)
+{
+    BN_CTX_CACHE *cache;
+
+    if (!bn_ctx_cache_inited)
+        return;
+
+    cache = CRYPTO_THREAD_get_local(&bn_ctx_cache_local);
+    if (cache == NULL)
+        return;
+    CRYPTO_THREAD_set_local(&bn_ctx_cache_local, NULL);
+    bn_ctx_cache_trim(cache, 0);
+    OPENSSL_free(cache);
+}
+
+void bn_ctx_cache_cleanup_int(void)
+{
+    if (!bn_ctx_cache_inited)
+        return;
+    bn_ctx_thread_cache_cleanup();
+    CRYPTO_THREAD_cleanup_local(&bn_ctx_cache_local);
+    bn_ctx_cache_inited = 0;
+}
+
 void BN_CTX_start(BN_CTX *ctx)
 {
     CTXDBG_ENTRY("BN_CTX_start", ctx);
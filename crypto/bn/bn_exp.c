@@ -326,6 +326,14 @@ int BN_mod_exp_mont(BIGNUM *rr, const BIGNUM *a, const BIGNUM *p,
         return ret;
     }
 
+    /*
+     * The usual RSA public exponent has a fixed-width path that needs
+     * neither allocations nor a BN_CTX, see crypto/bn/bn_fixed.c.
+     */
+    if (in_mont != NULL && BN_is_word(p, 65537)
+        && (i = bn_mod_exp_mont_f4(rr, a, in_mont)) >= 0)
+        return i;
+
     BN_CTX_start(ctx);
     d = BN_CTX_get(ctx);
     r = BN_CTX_get(ctx);
@@ -675,6 +683,18 @@ int BN_mod_exp_mont_consttime(BIGNUM *rr, const BIGNUM *a, const BIGNUM *p,
     }
 #endif
 
+#if !defined(OPENSSL_BN_ASM_MONT5)
+    /*
+     * The common RSA moduli have a fixed-width path that needs neither
+     * allocations nor a BN_CTX, see crypto/bn/bn_fixed.c.  Where the
+     * scatter/gather assembly below is available it is at least as fast.
+     */
+    if ((i = bn_mod_exp_mont_fixed(rr, a, p, mont)) >= 0) {
+        ret = i;
+        goto err;
+    }
+#endif
+
     /* Get the window size to use with size of p. */
     window = BN_window_bits_for_ctime_exponent_size(bits);
 #if defined(SPARC_T4_MONT)
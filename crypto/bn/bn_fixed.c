@@ -0,0 +1,500 @@
+/*
+ * Copyright 2017 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the OpenSSL license (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+#include <string.h>
+#include "internal/cryptlib.h"
+#include "internal/constant_time_locl.h"
+#include "bn_lcl.h"
+
+/*
+ * Fixed-width constant-time modular exponentiation for 1024, 1536 and
+ * 2048-bit moduli, i.e. the CRT halves of 2048, 3072 and 4096-bit RSA keys,
+ * and exponentiation to the public exponent 65537 for the full moduli.
+ *
+ * Each supported width gets its own instance of the code below with the
+ * number of words known at compile time.  All operands, the table of
+ * powers and the scratch space live on the stack, so there is no BN_CTX,
+ * no allocation and no dependency on the top of the operands: every
+ * exponent is processed as a full-width number in windows of
+ * BN_FIXED_WINDOW bits and every table lookup reads all entries.
+ */
+
+#define BN_FIXED_WINDOW 5
+#define BN_FIXED_POWERS (1 << BN_FIXED_WINDOW)
+
+/*
+ * r = (carry:t[nw..2nw-1]) mod n for a value below 2n: subtracts n unless
+ * the value was already smaller than n.
+ */
+static ossl_inline void fixed_mont_final(BN_ULONG *r, const BN_ULONG *t,
+                                         const BN_ULONG *n, BN_ULONG carry,
+                                         int nw)
+{
+    BN_ULONG borrow, mask;
+    int i;
+
+    borrow = bn_sub_words(r, t + nw, n, nw);
+    mask = (BN_ULONG)0 - (borrow & (carry ^ 1));
+    for (i = 0; i < nw; i++)
+        r[i] = (t[i + nw] & mask) | (r[i] & ~mask);
+}
+
+/*
+ * r = a * b / R mod n, with |t| providing 4 * nw words of scratch space.
+ * r may alias a or b.
+ */
+static ossl_inline void fixed_mont_mul(BN_ULONG *r, const BN_ULONG *a,
+                                       const BN_ULONG *b, const BN_ULONG *n,
+                                       const BN_ULONG *n0, BN_ULONG *t,
+                                       int nw)
+{
+    BN_ULONG v, carry;
+    int i;
+
+#ifdef OPENSSL_BN_ASM_MONT
+    if (bn_mul_mont(r, a, b, n, n0, nw))
+        return;
+#endif
+
+    if (a == b) {
+        bn_sqr_normal(t, a, nw, t + 2 * nw);
+    } else {
+        memset(t, 0, sizeof(*t) * 2 * nw);
+        for (i = 0; i < nw; i++)
+            t[i + nw] = bn_mul_add_words(t + i, a, nw, b[i]);
+    }
+
+    for (carry = 0, i = 0; i < nw; i++) {
+        v = bn_mul_add_words(t + i, n, nw, (t[i] * n0[0]) & BN_MASK2);
+        v = (v + carry + t[i + nw]) & BN_MASK2;
+        carry |= (v != t[i + nw]);
+        carry &= (v <= t[i + nw]);
+        t[i + nw] = v;
+    }
+
+    fixed_mont_final(r, t, n, carry, nw);
+}
+
+/*
+ * A second lane only pays off when the multiply-accumulate loop below is
+ * plain C with a double-word multiply: bn_mul_mont() assembly beats two
+ * interleaved C lanes, and so do the half-word products of the generic code.
+ */
+#if !defined(OPENSSL_BN_ASM_MONT) \
+    && (defined(BN_LLONG) || defined(BN_UMULT_LOHI) || defined(BN_UMULT_HIGH))
+# define BN_FIXED_F4_X2
+#endif
+
+#ifdef BN_FIXED_F4_X2
+/*
+ * Two independent multiply-accumulate rows: r0 += a0 * w0 and
+ * r1 += a1 * w1, nw words each.  The carries are returned in c0 and c1.
+ * Both carry chains advance in the same loop, so one lane can use the
+ * multiplier while the other waits for its carry.
+ */
+static ossl_inline void fixed_mul_add_words_x2(BN_ULONG *r0,
+                                               const BN_ULONG *a0,
+                                               BN_ULONG w0, BN_ULONG *r1,
+                                               const BN_ULONG *a1,
+                                               BN_ULONG w1, int nw,
+                                               BN_ULONG *c0, BN_ULONG *c1)
+{
+    BN_ULONG l0 = 0, l1 = 0;
+    int i;
+
+    for (i = 0; i < nw; i++) {
+        mul_add(r0[i], a0[i], w0, l0);
+        mul_add(r1[i], a1[i], w1, l1);
+    }
+    *c0 = l0;
+    *c1 = l1;
+}
+
+/*
+ * t0 = a0^2 and t1 = a1^2, 2 * nw words each, with |v| providing 2 * nw
+ * words of scratch space.  As in bn_sqr_normal(), the products above the
+ * diagonal are summed and doubled before the squares of the words are
+ * added.
+ */
+static ossl_inline void fixed_sqr_x2(BN_ULONG *t0, const BN_ULONG *a0,
+                                     BN_ULONG *t1, const BN_ULONG *a1,
+                                     BN_ULONG *v, int nw)
+{
+    int i;
+
+    memset(t0, 0, sizeof(*t0) * 2 * nw);
+    memset(t1, 0, sizeof(*t1) * 2 * nw);
+    for (i = 0; i < nw - 1; i++)
+        fixed_mul_add_words_x2(t0 + 2 * i + 1, a0 + i + 1, a0[i],
+                               t1 + 2 * i + 1, a1 + i + 1, a1[i],
+                               nw - i - 1, &t0[i + nw], &t1[i + nw]);
+
+    bn_add_words(t0, t0, t0, 2 * nw);
+    bn_sqr_words(v, a0, nw);
+    bn_add_words(t0, t0, v, 2 * nw);
+    bn_add_words(t1, t1, t1, 2 * nw);
+    bn_sqr_words(v, a1, nw);
+    bn_add_words(t1, t1, v, 2 * nw);
+}
+
+/*
+ * r0 = a0 * b0 / R mod n and r1 = a1 * b1 / R mod n, computed together
+ * with fixed_mul_add_words_x2().  |t| provides 6 * nw words of scratch
+ * space.  r0 may alias a0 or b0, and r1 may alias a1 or b1.
+ */
+static ossl_inline void fixed_mont_mul_x2(BN_ULONG *r0, const BN_ULONG *a0,
+                                          const BN_ULONG *b0, BN_ULONG *r1,
+                                          const BN_ULONG *a1,
+                                          const BN_ULONG *b1,
+                                          const BN_ULONG *n,
+                                          const BN_ULONG *n0, BN_ULONG *t,
+                                          int nw)
+{
+    BN_ULONG *t0 = t, *t1 = t + 2 * nw;
+    BN_ULONG v0, v1, carry0, carry1;
+    int i;
+
+    if (a0 == b0 && a1 == b1) {
+        fixed_sqr_x2(t0, a0, t1, a1, t + 4 * nw, nw);
+    } else {
+        memset(t, 0, sizeof(*t) * 4 * nw);
+        for (i = 0; i < nw; i++)
+            fixed_mul_add_words_x2(t0 + i, a0, b0[i], t1 + i, a1, b1[i], nw,
+                                   &t0[i + nw], &t1[i + nw]);
+    }
+
+    for (carry0 = carry1 = 0, i = 0; i < nw; i++) {
+        fixed_mul_add_words_x2(t0 + i, n, (t0[i] * n0[0]) & BN_MASK2,
+                               t1 + i, n, (t1[i] * n0[0]) & BN_MASK2, nw,
+                               &v0, &v1);
+        v0 = (v0 + carry0 + t0[i + nw]) & BN_MASK2;
+        v1 = (v1 + carry1 + t1[i + nw]) & BN_MASK2;
+        carry0 |= (v0 != t0[i + nw]);
+        carry0 &= (v0 <= t0[i + nw]);
+        carry1 |= (v1 != t1[i + nw]);
+        carry1 &= (v1 <= t1[i + nw]);
+        t0[i + nw] = v0;
+        t1[i + nw] = v1;
+    }
+
+    fixed_mont_final(r0, t0, n, carry0, nw);
+    fixed_mont_final(r1, t1, n, carry1, nw);
+}
+#endif
+
+/* Loads table entry |idx| into |r| without branching on idx */
+static ossl_inline void fixed_select(BN_ULONG *r, const BN_ULONG *table,
+                                     unsigned int idx, int nw)
+{
+    BN_ULONG mask;
+    int i, j;
+
+    memset(r, 0, sizeof(*r) * nw);
+    for (j = 0; j < BN_FIXED_POWERS; j++, table += nw) {
+        mask = (BN_ULONG)0 - (BN_ULONG)(constant_time_eq_int(j, idx) & 1);
+        for (i = 0; i < nw; i++)
+            r[i] |= table[i] & mask;
+    }
+}
+
+/* Returns the |w| exponent bits starting at bit |pos| */
+static ossl_inline unsigned int fixed_window(const BN_ULONG *e, int pos,
+                                             int w, int nw)
+{
+    int i = pos / BN_BITS2, s = pos % BN_BITS2;
+    BN_ULONG v = e[i] >> s;
+
+    if (s + w > BN_BITS2 && i + 1 < nw)
+        v |= e[i + 1] << (BN_BITS2 - s);
+    return (unsigned int)v & ((1U << w) - 1);
+}
+
+/*
+ * r = a^e mod n for a < n, all nw words long.  |table| holds
+ * BN_FIXED_POWERS * nw words, |v| nw words and |t| 4 * nw words.
+ */
+static ossl_inline void fixed_mod_exp(BN_ULONG *r, const BN_ULONG *a,
+                                      const BN_ULONG *e, const BN_ULONG *n,
+                                      const BN_ULONG *n0, const BN_ULONG *rr,
+                                      BN_ULONG *table, BN_ULONG *v,
+                                      BN_ULONG *t, int nw)
+{
+    int i, pos, w;
+
+    /* table[i] = a^i in Montgomery form */
+    memset(v, 0, sizeof(*v) * nw);
+    v[0] = 1;
+    fixed_mont_mul(table, v, rr, n, n0, t, nw);
+    fixed_mont_mul(table + nw, a, rr, n, n0, t, nw);
+    for (i = 2; i < BN_FIXED_POWERS; i++)
+        fixed_mont_mul(table + i * nw, table + (i - 1) * nw, table + nw,
+                       n, n0, t, nw);
+
+    w = (nw * BN_BITS2) % BN_FIXED_WINDOW;
+    if (w == 0)
+        w = BN_FIXED_WINDOW;
+    pos = nw * BN_BITS2 - w;
+    fixed_select(r, table, fixed_window(e, pos, w, nw), nw);
+
+    while (pos > 0) {
+        pos -= BN_FIXED_WINDOW;
+        for (i = 0; i < BN_FIXED_WINDOW; i++)
+            fixed_mont_mul(r, r, r, n, n0, t, nw);
+        fixed_select(v, table, fixed_window(e, pos, BN_FIXED_WINDOW, nw), nw);
+        fixed_mont_mul(r, r, v, n, n0, t, nw);
+    }
+
+    /* Convert back from Montgomery form */
+    memset(v, 0, sizeof(*v) * nw);
+    v[0] = 1;
+    fixed_mont_mul(r, r, v, n, n0, t, nw);
+}
+
+#define BN_FIXED_MOD_EXP(bits)                                              \
+static void fixed_mod_exp_##bits(BN_ULONG *r, const BN_ULONG *a,            \
+                                 const BN_ULONG *e, const BN_ULONG *n,      \
+                                 const BN_ULONG *n0, const BN_ULONG *rr)    \
+{                                                                           \
+    BN_ULONG table[BN_FIXED_POWERS * ((bits) / BN_BITS2)];                  \
+    BN_ULONG v[(bits) / BN_BITS2], t[4 * ((bits) / BN_BITS2)];              \
+                                                                            \
+    fixed_mod_exp(r, a, e, n, n0, rr, table, v, t, (bits) / BN_BITS2);      \
+    OPENSSL_cleanse(table, sizeof(table));                                  \
+    OPENSSL_cleanse(v, sizeof(v));                                          \
+    OPENSSL_cleanse(t, sizeof(t));                                          \
+}
+
+BN_FIXED_MOD_EXP(1024)
+BN_FIXED_MOD_EXP(1536)
+BN_FIXED_MOD_EXP(2048)
+
+/*
+ * r = a^65537 mod n for a < n.  a is converted to Montgomery form and
+ * squared 16 times; the final multiplication by the plain a also converts
+ * the result back.  |t| holds 4 * nw words.
+ */
+static ossl_inline void fixed_mod_exp_f4(BN_ULONG *r, const BN_ULONG *a,
+                                         const BN_ULONG *n,
+                                         const BN_ULONG *n0,
+                                         const BN_ULONG *rr, BN_ULONG *t,
+                                         int nw)
+{
+    int i;
+
+    fixed_mont_mul(r, a, rr, n, n0, t, nw);
+    for (i = 0; i < 16; i++)
+        fixed_mont_mul(r, r, r, n, n0, t, nw);
+    fixed_mont_mul(r, r, a, n, n0, t, nw);
+}
+
+#define BN_FIXED_MOD_EXP_F4(bits)                                           \
+static void fixed_mod_exp_f4_##bits(BN_ULONG *r, const BN_ULONG *a,         \
+                                    const BN_ULONG *n, const BN_ULONG *n0,  \
+                                    const BN_ULONG *rr)                     \
+{                                                                           \
+    BN_ULONG t[4 * ((bits) / BN_BITS2)];                                    \
+                                                                            \
+    fixed_mod_exp_f4(r, a, n, n0, rr, t, (bits) / BN_BITS2);                \
+}
+
+BN_FIXED_MOD_EXP_F4(1024)
+BN_FIXED_MOD_EXP_F4(2048)
+BN_FIXED_MOD_EXP_F4(3072)
+BN_FIXED_MOD_EXP_F4(4096)
+
+#ifdef BN_FIXED_F4_X2
+/* As fixed_mod_exp_f4(), for two bases at once.  |t| holds 6 * nw words. */
+static ossl_inline void fixed_mod_exp_f4_x2(BN_ULONG *r0, const BN_ULONG *a0,
+                                            BN_ULONG *r1, const BN_ULONG *a1,
+                                            const BN_ULONG *n,
+                                            const BN_ULONG *n0,
+                                            const BN_ULONG *rr, BN_ULONG *t,
+                                            int nw)
+{
+    int i;
+
+    fixed_mont_mul_x2(r0, a0, rr, r1, a1, rr, n, n0, t, nw);
+    for (i = 0; i < 16; i++)
+        fixed_mont_mul_x2(r0, r0, r0, r1, r1, r1, n, n0, t, nw);
+    fixed_mont_mul_x2(r0, r0, a0, r1, r1, a1, n, n0, t, nw);
+}
+
+#define BN_FIXED_MOD_EXP_F4_X2(bits)                                        \
+static void fixed_mod_exp_f4_x2_##bits(BN_ULONG *r0, const BN_ULONG *a0,    \
+                                       BN_ULONG *r1, const BN_ULONG *a1,    \
+                                       const BN_ULONG *n,                   \
+                                       const BN_ULONG *n0,                  \
+                                       const BN_ULONG *rr)                  \
+{                                                                           \
+    BN_ULONG t[6 * ((bits) / BN_BITS2)];                                    \
+                                                                            \
+    fixed_mod_exp_f4_x2(r0, a0, r1, a1, n, n0, rr, t, (bits) / BN_BITS2);   \
+}
+
+BN_FIXED_MOD_EXP_F4_X2(1024)
+BN_FIXED_MOD_EXP_F4_X2(2048)
+BN_FIXED_MOD_EXP_F4_X2(3072)
+BN_FIXED_MOD_EXP_F4_X2(4096)
+#endif
+
+#define BN_FIXED_MAX_WORDS (2048 / BN_BITS2)
+#define BN_FIXED_F4_MAX_WORDS (4096 / BN_BITS2)
+
+/*
+ * Computes rr = a^p mod m, where m is the modulus of |mont|.  Returns 1 on
+ * success, 0 on error and -1 if the operands are not suitable, in which
+ * case the caller falls back to the generic code.
+ */
+int bn_mod_exp_mont_fixed(BIGNUM *rr, const BIGNUM *a, const BIGNUM *p,
+                          const BN_MONT_CTX *mont)
+{
+    void (*fixed)(BN_ULONG *, const BN_ULONG *, const BN_ULONG *,
+                  const BN_ULONG *, const BN_ULONG *, const BN_ULONG *);
+    BN_ULONG av[BN_FIXED_MAX_WORDS], ev[BN_FIXED_MAX_WORDS];
+    BN_ULONG rrv[BN_FIXED_MAX_WORDS];
+    const BIGNUM *m = &mont->N;
+    int nw = m->top;
+
+    switch (BN_num_bits(m)) {
+    case 1024:
+        fixed = fixed_mod_exp_1024;
+        break;
+    case 1536:
+        fixed = fixed_mod_exp_1536;
+        break;
+    case 2048:
+        fixed = fixed_mod_exp_2048;
+        break;
+    default:
+        return -1;
+    }
+    if (a->neg || p->neg || BN_ucmp(a, m) >= 0 || p->top > nw)
+        return -1;
+
+    if (bn_wexpand(rr, nw) == NULL)
+        return 0;
+    if (!bn_copy_words(av, a, nw)
+        || !bn_copy_words(ev, p, nw)
+        || !bn_copy_words(rrv, &mont->RR, nw))
+        return -1;
+
+    fixed(rr->d, av, ev, m->d, mont->n0, rrv);
+    rr->top = nw;
+    rr->neg = 0;
+    bn_correct_top(rr);
+
+    OPENSSL_cleanse(ev, sizeof(ev));
+    return 1;
+}
+
+/*
+ * Computes rr = a^65537 mod m, where m is the modulus of |mont|.  Returns 1
+ * on success, 0 on error and -1 if the operands are not suitable, in which
+ * case the caller falls back to the generic code.  Only public values may
+ * be passed: the running time depends on the size of m.
+ */
+int bn_mod_exp_mont_f4(BIGNUM *rr, const BIGNUM *a, const BN_MONT_CTX *mont)
+{
+    void (*f4)(BN_ULONG *, const BN_ULONG *, const BN_ULONG *,
+               const BN_ULONG *, const BN_ULONG *);
+    BN_ULONG av[BN_FIXED_F4_MAX_WORDS], rrv[BN_FIXED_F4_MAX_WORDS];
+    const BIGNUM *m = &mont->N;
+    int nw = m->top;
+
+    switch (nw * BN_BITS2) {
+    case 1024:
+        f4 = fixed_mod_exp_f4_1024;
+        break;
+    case 2048:
+        f4 = fixed_mod_exp_f4_2048;
+        break;
+    case 3072:
+        f4 = fixed_mod_exp_f4_3072;
+        break;
+    case 4096:
+        f4 = fixed_mod_exp_f4_4096;
+        break;
+    default:
+        return -1;
+    }
+    if (a->neg || BN_ucmp(a, m) >= 0)
+        return -1;
+
+    if (bn_wexpand(rr, nw) == NULL)
+        return 0;
+    if (!bn_copy_words(av, a, nw) || !bn_copy_words(rrv, &mont->RR, nw))
+        return -1;
+
+    f4(rr->d, av, m->d, mont->n0, rrv);
+    rr->top = nw;
+    rr->neg = 0;
+    bn_correct_top(rr);
+    return 1;
+}
+
+/*
+ * Computes rr0 = a0^65537 and rr1 = a1^65537 mod m, where m is the modulus
+ * of |mont|, with the two exponentiations interleaved where that is faster.
+ * Returns 1 on success, 0 on error and -1 if the operands are not suitable,
+ * in which case the caller handles the two bases one at a time.  As for
+ * bn_mod_exp_mont_f4(), only public values may be passed.
+ */
+int bn_mod_exp_mont_f4_x2(BIGNUM *rr0, const BIGNUM *a0, BIGNUM *rr1,
+                          const BIGNUM *a1, const BN_MONT_CTX *mont)
+{
+#ifdef BN_FIXED_F4_X2
+    void (*f4)(BN_ULONG *, const BN_ULONG *, BN_ULONG *, const BN_ULONG *,
+               const BN_ULONG *, const BN_ULONG *, const BN_ULONG *);
+    BN_ULONG av0[BN_FIXED_F4_MAX_WORDS], av1[BN_FIXED_F4_MAX_WORDS];
+    BN_ULONG rrv[BN_FIXED_F4_MAX_WORDS];
+    const BIGNUM *m = &mont->N;
+    int nw = m->top;
+
+    switch (nw * BN_BITS2) {
+    case 1024:
+        f4 = fixed_mod_exp_f4_x2_1024;
+        break;
+    case 2048:
+        f4 = fixed_mod_exp_f4_x2_2048;
+        break;
+    case 3072:
+        f4 = fixed_mod_exp_f4_x2_3072;
+        break;
+    case 4096:
+        f4 = fixed_mod_exp_f4_x2_4096;
+        break;
+    default:
+        return -1;
+    }
+    if (rr0 == rr1 || a0->neg || BN_ucmp(a0, m) >= 0
+        || a1->neg || BN_ucmp(a1, m) >= 0)
+        return -1;
+
+    if (bn_wexpand(rr0, nw) == NULL || bn_wexpand(rr1, nw) == NULL)
+        return 0;
+    if (!bn_copy_words(av0, a0, nw) || !bn_copy_words(av1, a1, nw)
+        || !bn_copy_words(rrv, &mont->RR, nw))
+        return -1;
+
+    f4(rr0->d, av0, rr1->d, av1, m->d, mont->n0, rrv);
+    rr0->top = rr1->top = nw;
+    rr0->neg = rr1->neg = 0;
+    bn_correct_top(rr0);
+    bn_correct_top(rr1);
+    return 1;
+#else
+    int ret;
+
+    if (rr0 == rr1)
+        return -1;
+    if ((ret = bn_mod_exp_mont_f4(rr0, a0, mont)) <= 0)
+        return ret;
+    return bn_mod_exp_mont_f4(rr1, a1, mont);
+#endif
+}
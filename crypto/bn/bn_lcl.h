@@ -328,6 +328,12 @@ struct bn_gencb_st {
 # define BN_MUL_LOW_RECURSIVE_SIZE_NORMAL        (32)/* 32 */
 # define BN_MONT_CTX_SET_SIZE_WORD               (64)/* 32 */
 
+/* Default number of moduli in the Montgomery context cache */
+# define BN_MONT_CACHE_DEFAULT_SIZE              256
+
+/* Default number of released BN_CTXs kept per thread */
+# define BN_CTX_CACHE_DEFAULT_SIZE               4
+
 /*
  * 2011-02-22 SMS. In various places, a size_t variable or a type cast to
  * size_t was used to perform integer-only operations on pointers.  This
@@ -650,13 +656,19 @@ BN_ULONG bn_sub_part_words(BN_ULONG *r, const BN_ULONG *a, const BN_ULONG *b,
 int bn_mul_mont(BN_ULONG *rp, const BN_ULONG *ap, const BN_ULONG *bp,
                 const BN_ULONG *np, const BN_ULONG *n0, int num);
 
+int bn_mod_exp_mont_fixed(BIGNUM *rr, const BIGNUM *a, const BIGNUM *p,
+                          const BN_MONT_CTX *mont);
+int bn_mod_exp_mont_f4(BIGNUM *rr, const BIGNUM *a, const BN_MONT_CTX *mont);
+
+int bn_mont_cache_get(BN_MONT_CTX *mont, const BIGNUM *mod);
+void bn_mont_cache_add(BN_MONT_CTX *mont);
+
+void bn_ctx_cache_cleanup_int(void);
+
 BIGNUM *int_bn_mod_inverse(BIGNUM *in,
                            const BIGNUM *a, const BIGNUM *n, BN_CTX *ctx,
                            int *noinv);
 
-int bn_probable_prime_dh(BIGNUM *rnd, int bits,
-                         const BIGNUM *add, const BIGNUM *rem, BN_CTX *ctx);
-
 static ossl_inline BIGNUM *bn_expand(BIGNUM *a, int bits)
 {
     if (bits > (INT_MAX - BN_BITS2 + 1))
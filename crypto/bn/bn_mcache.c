@@ -0,0 +1,242 @@
+/*
+ * Copyright 2017 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the OpenSSL license (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+#include <openssl/lhash.h>
+#include "internal/cryptlib.h"
+#include "internal/thread_once.h"
+#include "bn_lcl.h"
+
+/*
+ * A process-wide cache of Montgomery contexts for public moduli, so that
+ * key objects that are created over and over again for the same key, as
+ * when verifying many signatures made with a few keys, do not have to
+ * redo the setup each time.  Entries are kept in least recently used
+ * order and the oldest one is dropped once the cache is full.
+ */
+
+typedef struct bn_mont_cache_entry_st BN_MONT_CACHE_ENTRY;
+
+struct bn_mont_cache_entry_st {
+    unsigned long hash;
+    const BIGNUM *mod;          /* N of |mont|, or the key of a lookup */
+    BN_MONT_CTX *mont;
+    BN_MONT_CACHE_ENTRY *prev, *next; /* most recently used first */
+};
+
+DEFINE_LHASH_OF(BN_MONT_CACHE_ENTRY);
+
+static LHASH_OF(BN_MONT_CACHE_ENTRY) *mont_cache = NULL;
+static BN_MONT_CACHE_ENTRY *mont_cache_head = NULL, *mont_cache_tail = NULL;
+static size_t mont_cache_size = BN_MONT_CACHE_DEFAULT_SIZE;
+static CRYPTO_ONCE mont_cache_init = CRYPTO_ONCE_STATIC_INIT;
+static CRYPTO_RWLOCK *mont_cache_lock = NULL;
+static uint64_t mont_cache_hits = 0, mont_cache_misses = 0;
+
+static unsigned long mont_cache_hash(const BN_MONT_CACHE_ENTRY *a)
+{
+    return a->hash;
+}
+
+static int mont_cache_cmp(const BN_MONT_CACHE_ENTRY *a,
+                          const BN_MONT_CACHE_ENTRY *b)
+{
+    if (a->hash != b->hash)
+        return a->hash < b->hash ? -1 : 1;
+    return BN_ucmp(a->mod, b->mod);
+}
+
+DEFINE_RUN_ONCE_STATIC(do_mont_cache_init)
+{
+    mont_cache_lock = CRYPTO_THREAD_lock_new();
+    if (mont_cache_lock == NULL)
+        return 0;
+    mont_cache = lh_BN_MONT_CACHE_ENTRY_new(mont_cache_hash, mont_cache_cmp);
+    if (mont_cache == NULL) {
+        CRYPTO_THREAD_lock_free(mont_cache_lock);
+        mont_cache_lock = NULL;
+        return 0;
+    }
+    return 1;
+}
+
+static int mont_cache_ready(void)
+{
+    return RUN_ONCE(&mont_cache_init, do_mont_cache_init)
+        && mont_cache_lock != NULL;
+}
+
+/* FNV-1a over the words of |mod| */
+static unsigned long mont_cache_hash_bn(const BIGNUM *mod)
+{
+    unsigned long h = 2166136261UL;
+    int i;
+
+    for (i = 0; i < mod->top; i++) {
+        h ^= (unsigned long)mod->d[i];
+#if BN_BITS2 == 64
+        h ^= (unsigned long)(mod->d[i] >> 32);
+#endif
+        h *= 16777619UL;
+    }
+    return h;
+}
+
+static void mont_cache_unlink(BN_MONT_CACHE_ENTRY *e)
+{
+    if (e->prev != NULL)
+        e->prev->next = e->next;
+    else
+        mont_cache_head = e->next;
+    if (e->next != NULL)
+        e->next->prev = e->prev;
+    else
+        mont_cache_tail = e->prev;
+    e->prev = e->next = NULL;
+}
+
+static void mont_cache_link_head(BN_MONT_CACHE_ENTRY *e)
+{
+    e->prev = NULL;
+    e->next = mont_cache_head;
+    if (mont_cache_head != NULL)
+        mont_cache_head->prev = e;
+    else
+        mont_cache_tail = e;
+    mont_cache_head = e;
+}
+
+static void mont_cache_entry_free(BN_MONT_CACHE_ENTRY *e)
+{
+    BN_MONT_CTX_free(e->mont);
+    OPENSSL_free(e);
+}
+
+/* Drops the least recently used entries down to |num|, lock held */
+static void mont_cache_trim(size_t num)
+{
+    BN_MONT_CACHE_ENTRY *e;
+
+    while (lh_BN_MONT_CACHE_ENTRY_num_items(mont_cache) > num) {
+        e = mont_cache_tail;
+        mont_cache_unlink(e);
+        (void)lh_BN_MONT_CACHE_ENTRY_delete(mont_cache, e);
+        mont_cache_entry_free(e);
+    }
+}
+
+/*
+ * Copies the cached context for |mod| into |mont|.  Returns 1 if there
+ * was one and 0 otherwise.
+ */
+int bn_mont_cache_get(BN_MONT_CTX *mont, const BIGNUM *mod)
+{
+    BN_MONT_CACHE_ENTRY key, *e;
+    int ret = 0;
+
+    if (mont_cache_size == 0 || !mont_cache_ready())
+        return 0;
+
+    key.hash = mont_cache_hash_bn(mod);
+    key.mod = mod;
+
+    /* A hit updates the list, so even lookups take the write lock */
+    CRYPTO_THREAD_write_lock(mont_cache_lock);
+    e = lh_BN_MONT_CACHE_ENTRY_retrieve(mont_cache, &key);
+    if (e != NULL && BN_MONT_CTX_copy(mont, e->mont) != NULL) {
+        mont_cache_unlink(e);
+        mont_cache_link_head(e);
+        ret = 1;
+        mont_cache_hits++;
+    } else {
+        mont_cache_misses++;
+    }
+    CRYPTO_THREAD_unlock(mont_cache_lock);
+    return ret;
+}
+
+/* Adds a copy of |mont| to the cache.  Failures are silently ignored. */
+void bn_mont_cache_add(BN_MONT_CTX *mont)
+{
+    BN_MONT_CACHE_ENTRY *e;
+
+    if (mont_cache_size == 0 || !mont_cache_ready())
+        return;
+
+    if ((e = OPENSSL_zalloc(sizeof(*e))) == NULL)
+        return;
+    if ((e->mont = BN_MONT_CTX_new()) == NULL
+        || BN_MONT_CTX_copy(e->mont, mont) == NULL) {
+        mont_cache_entry_free(e);
+        return;
+    }
+    e->mod = &e->mont->N;
+    e->hash = mont_cache_hash_bn(e->mod);
+
+    CRYPTO_THREAD_write_lock(mont_cache_lock);
+    if (mont_cache_size == 0
+        || lh_BN_MONT_CACHE_ENTRY_retrieve(mont_cache, e) != NULL) {
+        /* Disabled or added by another thread in the meantime */
+        CRYPTO_THREAD_unlock(mont_cache_lock);
+        mont_cache_entry_free(e);
+        return;
+    }
+    if (lh_BN_MONT_CACHE_ENTRY_insert(mont_cache, e) == NULL
+        && lh_BN_MONT_CACHE_ENTRY_error(mont_cache)) {
+        CRYPTO_THREAD_unlock(mont_cache_lock);
+        mont_cache_entry_free(e);
+        return;
+    }
+    mont_cache_link_head(e);
+    mont_cache_trim(mont_cache_size);
+    CRYPTO_THREAD_unlock(mont_cache_lock);
+}
+
+int BN_MONT_CTX_set_cache_size(size_t num)
+{
+    if (!mont_cache_ready())
+        return 0;
+    CRYPTO_THREAD_write_lock(mont_cache_lock);
+    mont_cache_size = num;
+    mont_cache_trim(num);
+    CRYPTO_THREAD_unlock(mont_cache_lock);
+    return 1;
+}
+
+size_t BN_MONT_CTX_get_cache_size(void)
+{
+    return mont_cache_size;
+}
+
+void BN_MONT_CTX_get_cache_stats(uint64_t *hits, uint64_t *misses)
+{
+    uint64_t h = 0, m = 0;
+
+    if (mont_cache_ready()) {
+        CRYPTO_THREAD_read_lock(mont_cache_lock);
+        h = mont_cache_hits;
+        m = mont_cache_misses;
+        CRYPTO_THREAD_unlock(mont_cache_lock);
+    }
+    if (hits != NULL)
+        *hits = h;
+    if (misses != NULL)
+        *misses = m;
+}
+
+void bn_cleanup_int(void)
+{
+    bn_ctx_cache_cleanup_int();
+    if (mont_cache != NULL) {
+        mont_cache_trim(0);
+        lh_BN_MONT_CACHE_ENTRY_free(mont_cache);
+        mont_cache = NULL;
+    }
+    CRYPTO_THREAD_lock_free(mont_cache_lock);
+    mont_cache_lock = NULL;
+}
@@ -395,8 +395,10 @@ BN_MONT_CTX *BN_MONT_CTX_copy(BN_MONT_CTX *to, BN_MONT_CTX *from)
     return (to);
 }
 
-BN_MONT_CTX *BN_MONT_CTX_set_locked(BN_MONT_CTX **pmont, CRYPTO_RWLOCK *lock,
-                                    const BIGNUM *mod, BN_CTX *ctx)
+static BN_MONT_CTX *mont_ctx_set_locked(BN_MONT_CTX **pmont,
+                                        CRYPTO_RWLOCK *lock,
+                                        const BIGNUM *mod, BN_CTX *ctx,
+                                        int cached)
 {
     BN_MONT_CTX *ret;
 
@@ -417,9 +419,13 @@ BN_MONT_CTX *BN_MONT_CTX_set_locked(BN_MONT_CTX **pmont, CRYPTO_RWLOCK *lock,
     ret = BN_MONT_CTX_new();
     if (ret == NULL)
         return NULL;
-    if (!BN_MONT_CTX_set(ret, mod, ctx)) {
-        BN_MONT_CTX_free(ret);
-        return NULL;
+    if (!cached || !bn_mont_cache_get(ret, mod)) {
+        if (!BN_MONT_CTX_set(ret, mod, ctx)) {
+            BN_MONT_CTX_free(ret);
+            return NULL;
+        }
+        if (cached)
+            bn_mont_cache_add(ret);
     }
 
     /* The locked compare-and-set, after the local work is done. */
@@ -432,3 +438,16 @@ BN_MONT_CTX *BN_MONT_CTX_set_locked(BN_MONT_CTX **pmont, CRYPTO_RWLOCK *lock,
     CRYPTO_THREAD_unlock(lock);
     return ret;
 }
+
+BN_MONT_CTX *BN_MONT_CTX_set_locked(BN_MONT_CTX **pmont, CRYPTO_RWLOCK *lock,
+                                    const BIGNUM *mod, BN_CTX *ctx)
+{
+    return mont_ctx_set_locked(pmont, lock, mod, ctx, 0);
+}
+
+BN_MONT_CTX *bn_mont_ctx_set_locked_cached(BN_MONT_CTX **pmont,
+                                           CRYPTO_RWLOCK *lock,
+                                           const BIGNUM *mod, BN_CTX *ctx)
+{
+    return mont_ctx_set_locked(pmont, lock, mod, ctx, 1);
+}
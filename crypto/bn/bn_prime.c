@@ -11,7 +11,7 @@
 
 #include <stdio.h>
 #include <time.h>
-#include "internal/cryptlib.h"
+#include "internal/cryptlib_int.h"
 #include "bn_lcl.h"
 
 /*
@@ -21,13 +21,49 @@
  */
 #include "bn_prime.h"
 
+/*
+ * Candidates are sieved in windows of SIEVE_SIZE numbers spaced |step|
+ * apart, which at RSA sizes holds several primes.  A candidate survives
+ * if it is not 0 or 1 modulo any of the small primes.
+ */
+#define SIEVE_SIZE      4096
+
+typedef struct {
+    BIGNUM *base;               /* first candidate of the window */
+    const BIGNUM *step;         /* distance between candidates */
+    int next;                   /* index of the next candidate to try */
+    unsigned char composite[SIEVE_SIZE];
+    prime_t mods[NUMPRIMES];    /* single word candidates only */
+} PRIME_SIEVE;
+
+/*
+ * State shared by the threads of a parallel prime search.  |done| is set
+ * once a prime has been found or the search was abandoned.
+ */
+typedef struct {
+    CRYPTO_RWLOCK *lock;
+    int done;
+    int found;
+    BIGNUM *ret;
+    int bits, safe;
+    const BIGNUM *add, *rem;
+} PRIME_SEARCH;
+
+static int prime_search_threads = 1;
+
 static int witness(BIGNUM *w, const BIGNUM *a, const BIGNUM *a1,
                    const BIGNUM *a1_odd, int k, BN_CTX *ctx,
                    BN_MONT_CTX *mont);
-static int probable_prime(BIGNUM *rnd, int bits, prime_t *mods);
+static int generate_prime(BIGNUM *ret, int bits, int safe,
+                          const BIGNUM *add, const BIGNUM *rem,
+                          BN_GENCB *cb, PRIME_SEARCH *search);
+static int probable_prime(BIGNUM *rnd, int bits, PRIME_SIEVE *sv);
+static int probable_prime_dh(BIGNUM *rnd, int bits, const BIGNUM *add,
+                             const BIGNUM *rem, PRIME_SIEVE *sv,
+                             BN_CTX *ctx);
 static int probable_prime_dh_safe(BIGNUM *rnd, int bits,
                                   const BIGNUM *add, const BIGNUM *rem,
-                                  BN_CTX *ctx);
+                                  PRIME_SIEVE *sv, BN_CTX *ctx);
 
 int BN_GENCB_call(BN_GENCB *cb, int a, int b)
 {
@@ -51,15 +87,105 @@ int BN_GENCB_call(BN_GENCB *cb, int a, int b)
     return 0;
 }
 
+int BN_set_prime_search_threads(int num)
+{
+    if (num < 1 || num > BN_MAX_PRIME_SEARCH_THREADS)
+        return 0;
+    prime_search_threads = num;
+    return 1;
+}
+
+int BN_get_prime_search_threads(void)
+{
+    return prime_search_threads;
+}
+
+static int search_done(PRIME_SEARCH *search)
+{
+    int done = 1;
+
+    if (CRYPTO_THREAD_read_lock(search->lock)) {
+        done = search->done;
+        CRYPTO_THREAD_unlock(search->lock);
+    }
+    return done;
+}
+
+/* Report |p| as the result unless another thread got there first */
+static void search_finish(PRIME_SEARCH *search, const BIGNUM *p)
+{
+    if (!CRYPTO_THREAD_write_lock(search->lock))
+        return;
+    if (!search->done && p != NULL && BN_copy(search->ret, p) != NULL)
+        search->found = 1;
+    search->done = 1;
+    CRYPTO_THREAD_unlock(search->lock);
+}
+
+static void search_worker(void *arg)
+{
+    PRIME_SEARCH *search = arg;
+    BIGNUM *p = BN_new();
+
+    if (p != NULL
+        && generate_prime(p, search->bits, search->safe, search->add,
+                          search->rem, NULL, search))
+        search_finish(search, p);
+    BN_free(p);
+}
+
+/*
+ * Search with up to |nthreads| threads, the calling one included.  Only
+ * the calling thread reports progress through |cb|, and an abort from the
+ * callback stops the other threads.  Returns -1 if no thread could be
+ * started, so that the caller can search on its own.
+ */
+static int generate_prime_parallel(BIGNUM *ret, int bits, int safe,
+                                   const BIGNUM *add, const BIGNUM *rem,
+                                   BN_GENCB *cb, int nthreads)
+{
+    PRIME_SEARCH search;
+    OSSL_THREAD *threads[BN_MAX_PRIME_SEARCH_THREADS];
+    BIGNUM *p = NULL;
+    int i, n = 0;
+
+    memset(&search, 0, sizeof(search));
+    search.ret = ret;
+    search.bits = bits;
+    search.safe = safe;
+    search.add = add;
+    search.rem = rem;
+    if ((search.lock = CRYPTO_THREAD_lock_new()) == NULL)
+        return -1;
+
+    for (i = 1; i < nthreads; i++) {
+        if ((threads[n] = ossl_thread_start(search_worker, &search)) == NULL)
+            break;
+        n++;
+    }
+    if (n == 0) {
+        CRYPTO_THREAD_lock_free(search.lock);
+        return -1;
+    }
+
+    if ((p = BN_new()) != NULL
+        && generate_prime(p, bits, safe, add, rem, cb, &search))
+        search_finish(&search, p);
+    else
+        search_finish(&search, NULL);
+
+    for (i = 0; i < n; i++)
+        ossl_thread_join(threads[i]);
+    BN_free(p);
+    CRYPTO_THREAD_lock_free(search.lock);
+    bn_check_top(ret);
+    return search.found;
+}
+
 int BN_generate_prime_ex(BIGNUM *ret, int bits, int safe,
                          const BIGNUM *add, const BIGNUM *rem, BN_GENCB *cb)
 {
-    BIGNUM *t;
-    int found = 0;
-    int i, j, c1 = 0;
-    BN_CTX *ctx = NULL;
-    prime_t *mods = NULL;
-    int checks = BN_prime_checks_for_size(bits);
+    int nthreads = prime_search_threads;
 
     if (bits < 2) {
         /* There are no prime numbers this small. */
@@ -71,8 +197,29 @@ int BN_generate_prime_ex(BIGNUM *ret, int bits, int safe,
         return 0;
     }
 
-    mods = OPENSSL_zalloc(sizeof(*mods) * NUMPRIMES);
-    if (mods == NULL)
+    if (nthreads > 1) {
+        int found = generate_prime_parallel(ret, bits, safe, add, rem, cb,
+                                            nthreads);
+
+        if (found != -1)
+            return found;
+    }
+    return generate_prime(ret, bits, safe, add, rem, cb, NULL);
+}
+
+static int generate_prime(BIGNUM *ret, int bits, int safe,
+                          const BIGNUM *add, const BIGNUM *rem,
+                          BN_GENCB *cb, PRIME_SEARCH *search)
+{
+    BIGNUM *t, *two;
+    int found = 0;
+    int i, j, c1 = 0;
+    BN_CTX *ctx = NULL;
+    PRIME_SIEVE *sv = NULL;
+    int checks = BN_prime_checks_for_size(bits);
+
+    sv = OPENSSL_zalloc(sizeof(*sv));
+    if (sv == NULL)
         goto err;
 
     ctx = BN_CTX_new();
@@ -80,19 +227,26 @@ int BN_generate_prime_ex(BIGNUM *ret, int bits, int safe,
         goto err;
     BN_CTX_start(ctx);
     t = BN_CTX_get(ctx);
-    if (!t)
+    two = BN_CTX_get(ctx);
+    sv->base = BN_CTX_get(ctx);
+    if (sv->base == NULL || !BN_set_word(two, 2))
         goto err;
+    sv->step = add == NULL ? two : add;
+    sv->next = SIEVE_SIZE;
  loop:
-    /* make a random number and set the top and bottom bits */
+    if (search != NULL && search_done(search))
+        goto err;
+
+    /* take the next candidate that survives the sieve */
     if (add == NULL) {
-        if (!probable_prime(ret, bits, mods))
+        if (!probable_prime(ret, bits, sv))
             goto err;
     } else {
         if (safe) {
-            if (!probable_prime_dh_safe(ret, bits, add, rem, ctx))
+            if (!probable_prime_dh_safe(ret, bits, add, rem, sv, ctx))
                 goto err;
         } else {
-            if (!bn_probable_prime_dh(ret, bits, add, rem, ctx))
+            if (!probable_prime_dh(ret, bits, add, rem, sv, ctx))
                 goto err;
         }
     }
@@ -136,7 +290,7 @@ int BN_generate_prime_ex(BIGNUM *ret, int bits, int safe,
     /* we have a prime :-) */
     found = 1;
  err:
-    OPENSSL_free(mods);
+    OPENSSL_free(sv);
     if (ctx != NULL)
         BN_CTX_end(ctx);
     BN_CTX_free(ctx);
@@ -285,12 +439,86 @@ static int witness(BIGNUM *w, const BIGNUM *a, const BIGNUM *a1,
     return 1;
 }
 
-static int probable_prime(BIGNUM *rnd, int bits, prime_t *mods)
+static BN_ULONG inverse_word(BN_ULONG a, BN_ULONG p)
+{
+    long r0 = p, r1 = a, t0 = 0, t1 = 1, q, tmp;
+
+    while (r1 != 0) {
+        q = r0 / r1;
+        tmp = r0 - q * r1;
+        r0 = r1;
+        r1 = tmp;
+        tmp = t0 - q * t1;
+        t0 = t1;
+        t1 = tmp;
+    }
+    return (BN_ULONG)(t0 < 0 ? t0 + (long)p : t0);
+}
+
+/*
+ * Strike the candidates of the window starting at |sv->base| that are 0
+ * or 1 modulo a small prime.  For a prime p not dividing the step, those
+ * are found every p candidates from the solution of base + j * step = 0
+ * (resp. 1) mod p, so the whole window costs one division of the base per
+ * small prime.
+ */
+static int sieve_window(PRIME_SIEVE *sv)
 {
     int i;
-    BN_ULONG delta;
+    BN_ULONG p, r, s, j;
+
+    memset(sv->composite, 0, sizeof(sv->composite));
+    sv->next = 0;
+    for (i = 1; i < NUMPRIMES; i++) {
+        p = primes[i];
+        r = BN_mod_word(sv->base, p);
+        s = BN_mod_word(sv->step, p);
+        if (r == (BN_ULONG)-1 || s == (BN_ULONG)-1)
+            return 0;
+        if (s == 0) {
+            /* all candidates have the same residue */
+            if (r <= 1) {
+                sv->next = SIEVE_SIZE;
+                return 1;
+            }
+            continue;
+        }
+        s = inverse_word(s, p);
+        for (j = (p - r) * s % p; j < SIEVE_SIZE; j += p)
+            sv->composite[j] = 1;
+        for (j = (p + 1 - r) * s % p; j < SIEVE_SIZE; j += p)
+            sv->composite[j] = 1;
+    }
+    return 1;
+}
+
+/*
+ * Set |rnd| to the next candidate of the window that survived the sieve.
+ * Returns 0 once the window is exhausted and -1 on error.
+ */
+static int sieve_next(PRIME_SIEVE *sv, BIGNUM *rnd)
+{
+    int j;
+
+    while (sv->next < SIEVE_SIZE && sv->composite[sv->next])
+        sv->next++;
+    if (sv->next == SIEVE_SIZE)
+        return 0;
+    j = sv->next++;
+
+    if (BN_copy(rnd, sv->step) == NULL
+        || !BN_mul_word(rnd, (BN_ULONG)j)
+        || !BN_add(rnd, rnd, sv->base))
+        return -1;
+    return 1;
+}
+
+/* Incremental search for a candidate of at most BN_BITS2 bits */
+static int probable_prime_word(BIGNUM *rnd, int bits, prime_t *mods)
+{
+    int i;
+    BN_ULONG delta, size_limit, rnd_word;
     BN_ULONG maxdelta = BN_MASK2 - primes[NUMPRIMES - 1];
-    char is_single_word = bits <= BN_BITS2;
 
  again:
     if (!BN_rand(rnd, bits, BN_RAND_TOP_TWO, BN_RAND_BOTTOM_ODD))
@@ -302,61 +530,39 @@ static int probable_prime(BIGNUM *rnd, int bits, prime_t *mods)
             return 0;
         mods[i] = (prime_t) mod;
     }
-    /*
-     * If bits is so small that it fits into a single word then we
-     * additionally don't want to exceed that many bits.
-     */
-    if (is_single_word) {
-        BN_ULONG size_limit;
-
-        if (bits == BN_BITS2) {
-            /*
-             * Shifting by this much has undefined behaviour so we do it a
-             * different way
-             */
-            size_limit = ~((BN_ULONG)0) - BN_get_word(rnd);
-        } else {
-            size_limit = (((BN_ULONG)1) << bits) - BN_get_word(rnd) - 1;
-        }
-        if (size_limit < maxdelta)
-            maxdelta = size_limit;
+    /* we don't want to exceed that many bits */
+    if (bits == BN_BITS2) {
+        /*
+         * Shifting by this much has undefined behaviour so we do it a
+         * different way
+         */
+        size_limit = ~((BN_ULONG)0) - BN_get_word(rnd);
+    } else {
+        size_limit = (((BN_ULONG)1) << bits) - BN_get_word(rnd) - 1;
     }
+    if (size_limit < maxdelta)
+        maxdelta = size_limit;
     delta = 0;
  loop:
-    if (is_single_word) {
-        BN_ULONG rnd_word = BN_get_word(rnd);
-
-        /*-
-         * In the case that the candidate prime is a single word then
-         * we check that:
-         *   1) It's greater than primes[i] because we shouldn't reject
-         *      3 as being a prime number because it's a multiple of
-         *      three.
-         *   2) That it's not a multiple of a known prime. We don't
-         *      check that rnd-1 is also coprime to all the known
-         *      primes because there aren't many small primes where
-         *      that's true.
-         */
-        for (i = 1; i < NUMPRIMES && primes[i] < rnd_word; i++) {
-            if ((mods[i] + delta) % primes[i] == 0) {
-                delta += 2;
-                if (delta > maxdelta)
-                    goto again;
-                goto loop;
-            }
-        }
-    } else {
-        for (i = 1; i < NUMPRIMES; i++) {
-            /*
-             * check that rnd is not a prime and also that gcd(rnd-1,primes)
-             * == 1 (except for 2)
-             */
-            if (((mods[i] + delta) % primes[i]) <= 1) {
-                delta += 2;
-                if (delta > maxdelta)
-                    goto again;
-                goto loop;
-            }
+    rnd_word = BN_get_word(rnd);
+
+    /*-
+     * In the case that the candidate prime is a single word then
+     * we check that:
+     *   1) It's greater than primes[i] because we shouldn't reject
+     *      3 as being a prime number because it's a multiple of
+     *      three.
+     *   2) That it's not a multiple of a known prime. We don't
+     *      check that rnd-1 is also coprime to all the known
+     *      primes because there aren't many small primes where
+     *      that's true.
+     */
+    for (i = 1; i < NUMPRIMES && primes[i] < rnd_word; i++) {
+        if ((mods[i] + delta) % primes[i] == 0) {
+            delta += 2;
+            if (delta > maxdelta)
+                goto again;
+            goto loop;
         }
     }
     if (!BN_add_word(rnd, delta))
@@ -367,8 +573,35 @@ static int probable_prime(BIGNUM *rnd, int bits, prime_t *mods)
     return (1);
 }
 
-int bn_probable_prime_dh(BIGNUM *rnd, int bits,
-                         const BIGNUM *add, const BIGNUM *rem, BN_CTX *ctx)
+static int probable_prime(BIGNUM *rnd, int bits, PRIME_SIEVE *sv)
+{
+    int i;
+
+    /*
+     * A single word candidate does not need to clash with the small primes
+     * as a multiple of them, so it keeps the incremental search.
+     */
+    if (bits <= BN_BITS2)
+        return probable_prime_word(rnd, bits, sv->mods);
+
+    for (;;) {
+        i = sieve_next(sv, rnd);
+        if (i == -1)
+            return 0;
+        if (i == 1 && BN_num_bits(rnd) == bits)
+            break;
+        /* the window is used up or ran past |bits|, start a new one */
+        if (!BN_rand(sv->base, bits, BN_RAND_TOP_TWO, BN_RAND_BOTTOM_ODD)
+            || !sieve_window(sv))
+            return 0;
+    }
+    bn_check_top(rnd);
+    return 1;
+}
+
+static int probable_prime_dh(BIGNUM *rnd, int bits, const BIGNUM *add,
+                             const BIGNUM *rem, PRIME_SIEVE *sv,
+                             BN_CTX *ctx)
 {
     int i, ret = 0;
     BIGNUM *t1;
@@ -377,38 +610,27 @@ int bn_probable_prime_dh(BIGNUM *rnd, int bits,
     if ((t1 = BN_CTX_get(ctx)) == NULL)
         goto err;
 
-    if (!BN_rand(rnd, bits, BN_RAND_TOP_ONE, BN_RAND_BOTTOM_ODD))
-        goto err;
-
-    /* we need ((rnd-rem) % add) == 0 */
-
-    if (!BN_mod(t1, rnd, add, ctx))
-        goto err;
-    if (!BN_sub(rnd, rnd, t1))
-        goto err;
-    if (rem == NULL) {
-        if (!BN_add_word(rnd, 1))
-            goto err;
-    } else {
-        if (!BN_add(rnd, rnd, rem))
+    while ((i = sieve_next(sv, rnd)) == 0) {
+        if (!BN_rand(sv->base, bits, BN_RAND_TOP_ONE, BN_RAND_BOTTOM_ODD))
             goto err;
-    }
-
-    /* we now have a random number 'rand' to test. */
 
- loop:
-    for (i = 1; i < NUMPRIMES; i++) {
-        /* check that rnd is a prime */
-        BN_ULONG mod = BN_mod_word(rnd, (BN_ULONG)primes[i]);
-        if (mod == (BN_ULONG)-1)
+        /* we need ((base-rem) % add) == 0 */
+        if (!BN_mod(t1, sv->base, add, ctx))
+            goto err;
+        if (!BN_sub(sv->base, sv->base, t1))
             goto err;
-        if (mod <= 1) {
-            if (!BN_add(rnd, rnd, add))
+        if (rem == NULL) {
+            if (!BN_add_word(sv->base, 1))
+                goto err;
+        } else {
+            if (!BN_add(sv->base, sv->base, rem))
                 goto err;
-            goto loop;
         }
+
+        if (!sieve_window(sv))
+            goto err;
     }
-    ret = 1;
+    ret = i == 1;
 
  err:
     BN_CTX_end(ctx);
@@ -416,13 +638,17 @@ int bn_probable_prime_dh(BIGNUM *rnd, int bits,
     return (ret);
 }
 
+/*
+ * For p = 2q + 1 and an odd small prime, q = 0 exactly when p = 1, so
+ * sieving p alone also rules out the q with small factors.
+ */
 static int probable_prime_dh_safe(BIGNUM *p, int bits, const BIGNUM *padd,
-                                  const BIGNUM *rem, BN_CTX *ctx)
+                                  const BIGNUM *rem, PRIME_SIEVE *sv,
+                                  BN_CTX *ctx)
 {
     int i, ret = 0;
     BIGNUM *t1, *qadd, *q;
 
-    bits--;
     BN_CTX_start(ctx);
     t1 = BN_CTX_get(ctx);
     q = BN_CTX_get(ctx);
@@ -430,52 +656,38 @@ static int probable_prime_dh_safe(BIGNUM *p, int bits, const BIGNUM *padd,
     if (qadd == NULL)
         goto err;
 
-    if (!BN_rshift1(qadd, padd))
-        goto err;
-
-    if (!BN_rand(q, bits, BN_RAND_TOP_ONE, BN_RAND_BOTTOM_ODD))
-        goto err;
-
-    /* we need ((rnd-rem) % add) == 0 */
-    if (!BN_mod(t1, q, qadd, ctx))
-        goto err;
-    if (!BN_sub(q, q, t1))
-        goto err;
-    if (rem == NULL) {
-        if (!BN_add_word(q, 1))
-            goto err;
-    } else {
-        if (!BN_rshift1(t1, rem))
-            goto err;
-        if (!BN_add(q, q, t1))
+    while ((i = sieve_next(sv, p)) == 0) {
+        if (!BN_rshift1(qadd, padd))
             goto err;
-    }
 
-    /* we now have a random number 'rand' to test. */
-    if (!BN_lshift1(p, q))
-        goto err;
-    if (!BN_add_word(p, 1))
-        goto err;
+        if (!BN_rand(q, bits - 1, BN_RAND_TOP_ONE, BN_RAND_BOTTOM_ODD))
+            goto err;
 
- loop:
-    for (i = 1; i < NUMPRIMES; i++) {
-        /* check that p and q are prime */
-        /*
-         * check that for p and q gcd(p-1,primes) == 1 (except for 2)
-         */
-        BN_ULONG pmod = BN_mod_word(p, (BN_ULONG)primes[i]);
-        BN_ULONG qmod = BN_mod_word(q, (BN_ULONG)primes[i]);
-        if (pmod == (BN_ULONG)-1 || qmod == (BN_ULONG)-1)
+        /* we need ((rnd-rem) % add) == 0 */
+        if (!BN_mod(t1, q, qadd, ctx))
             goto err;
-        if (pmod == 0 || qmod == 0) {
-            if (!BN_add(p, p, padd))
+        if (!BN_sub(q, q, t1))
+            goto err;
+        if (rem == NULL) {
+            if (!BN_add_word(q, 1))
                 goto err;
-            if (!BN_add(q, q, qadd))
+        } else {
+            if (!BN_rshift1(t1, rem))
+                goto err;
+            if (!BN_add(q, q, t1))
                 goto err;
-            goto loop;
         }
+
+        /* the window starts at p = 2q + 1 and steps by padd */
+        if (!BN_lshift1(sv->base, q))
+            goto err;
+        if (!BN_add_word(sv->base, 1))
+            goto err;
+
+        if (!sieve_window(sv))
+            goto err;
     }
-    ret = 1;
+    ret = i == 1;
 
  err:
     BN_CTX_end(ctx);
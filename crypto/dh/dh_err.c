@@ -28,6 +28,7 @@ static ERR_STRING_DATA DH_str_functs[] = {
     {ERR_FUNC(DH_F_DH_METH_DUP), "DH_meth_dup"},
     {ERR_FUNC(DH_F_DH_METH_NEW), "DH_meth_new"},
     {ERR_FUNC(DH_F_DH_METH_SET1_NAME), "DH_meth_set1_name"},
+    {ERR_FUNC(DH_F_DH_NEW_BY_NID), "DH_new_by_nid"},
     {ERR_FUNC(DH_F_DH_NEW_METHOD), "DH_new_method"},
     {ERR_FUNC(DH_F_DH_PARAM_DECODE), "dh_param_decode"},
     {ERR_FUNC(DH_F_DH_PRIV_DECODE), "dh_priv_decode"},
@@ -46,6 +47,7 @@ static ERR_STRING_DATA DH_str_reasons[] = {
     {ERR_REASON(DH_R_BN_DECODE_ERROR), "bn decode error"},
     {ERR_REASON(DH_R_BN_ERROR), "bn error"},
     {ERR_REASON(DH_R_DECODE_ERROR), "decode error"},
+    {ERR_REASON(DH_R_INVALID_PARAMETER_NID), "invalid parameter nid"},
     {ERR_REASON(DH_R_INVALID_PUBKEY), "invalid public key"},
     {ERR_REASON(DH_R_KDF_PARAMETER_ERROR), "kdf parameter error"},
     {ERR_REASON(DH_R_KEYS_NOT_SET), "keys not set"},
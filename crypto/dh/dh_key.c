@@ -102,8 +102,8 @@ static int generate_key(DH *dh)
         pub_key = dh->pub_key;
 
     if (dh->flags & DH_FLAG_CACHE_MONT_P) {
-        mont = BN_MONT_CTX_set_locked(&dh->method_mont_p,
-                                      dh->lock, dh->p, ctx);
+        mont = bn_mont_ctx_set_locked_cached(&dh->method_mont_p,
+                                             dh->lock, dh->p, ctx);
         if (!mont)
             goto err;
     }
@@ -125,12 +125,18 @@ static int generate_key(DH *dh)
 
     {
         BIGNUM *prk = BN_new();
+        int r = -1;
 
         if (prk == NULL)
             goto err;
         BN_with_flags(prk, priv_key, BN_FLG_CONSTTIME);
 
-        if (!dh->meth->bn_mod_exp(dh, pub_key, dh->g, prk, dh->p, ctx, mont)) {
+        /* The well-known groups have a precomputed table for g */
+        if (dh->meth->bn_mod_exp == dh_bn_mod_exp)
+            r = dh_named_group_mod_exp(dh, pub_key, prk, ctx);
+        if (r == 0
+            || (r < 0 && !dh->meth->bn_mod_exp(dh, pub_key, dh->g, prk,
+                                               dh->p, ctx, mont))) {
             BN_free(prk);
             goto err;
         }
@@ -180,8 +186,8 @@ static int compute_key(unsigned char *key, const BIGNUM *pub_key, DH *dh)
     }
 
     if (dh->flags & DH_FLAG_CACHE_MONT_P) {
-        mont = BN_MONT_CTX_set_locked(&dh->method_mont_p,
-                                      dh->lock, dh->p, ctx);
+        mont = bn_mont_ctx_set_locked_cached(&dh->method_mont_p,
+                                             dh->lock, dh->p, ctx);
         BN_set_flags(dh->priv_key, BN_FLG_CONSTTIME);
         if (!mont)
             goto err;
@@ -37,6 +37,9 @@ struct dh_st {
     CRYPTO_RWLOCK *lock;
 };
 
+int dh_named_group_mod_exp(const DH *dh, BIGNUM *r, const BIGNUM *e,
+                           BN_CTX *ctx);
+
 struct dh_method {
     char *name;
     /* Methods here */
@@ -0,0 +1,174 @@
+/*
+ * Copyright 2017 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the OpenSSL license (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+#include <stdio.h>
+#include "internal/cryptlib.h"
+#include "internal/thread_once.h"
+#include "internal/bn_int.h"
+#include "internal/dh.h"
+#include "dh_locl.h"
+#include <openssl/bn.h>
+#include <openssl/objects.h>
+#include "internal/bn_dh.h"
+
+/*
+ * The RFC 7919 groups.  |length| is the private exponent size from section
+ * 5.2 of the RFC, which gives at least twice the security level of the
+ * group.
+ */
+typedef struct {
+    int nid;
+    const BIGNUM *p;
+    int32_t length;
+} DH_NAMED_GROUP;
+
+static const DH_NAMED_GROUP dh_named_groups[] = {
+    {NID_ffdhe2048, &_bignum_ffdhe2048_p, 225},
+    {NID_ffdhe3072, &_bignum_ffdhe3072_p, 275},
+    {NID_ffdhe4096, &_bignum_ffdhe4096_p, 325},
+    {NID_ffdhe6144, &_bignum_ffdhe6144_p, 375},
+    {NID_ffdhe8192, &_bignum_ffdhe8192_p, 400}
+};
+
+/*
+ * Fixed-base comb tables for the generator of each group, built on first
+ * use and shared by every DH object using the group.
+ */
+static BN_COMB *dh_named_combs[OSSL_NELEM(dh_named_groups)];
+static int dh_named_combs_failed[OSSL_NELEM(dh_named_groups)];
+static CRYPTO_ONCE dh_named_combs_init = CRYPTO_ONCE_STATIC_INIT;
+static CRYPTO_RWLOCK *dh_named_combs_lock = NULL;
+
+DEFINE_RUN_ONCE_STATIC(do_dh_named_combs_init)
+{
+    dh_named_combs_lock = CRYPTO_THREAD_lock_new();
+    return dh_named_combs_lock != NULL;
+}
+
+DH *DH_new_by_nid(int nid)
+{
+    size_t i;
+    DH *dh;
+
+    for (i = 0; i < OSSL_NELEM(dh_named_groups); i++) {
+        if (dh_named_groups[i].nid == nid)
+            break;
+    }
+    if (i == OSSL_NELEM(dh_named_groups)) {
+        DHerr(DH_F_DH_NEW_BY_NID, DH_R_INVALID_PARAMETER_NID);
+        return NULL;
+    }
+
+    if ((dh = DH_new()) == NULL)
+        return NULL;
+    dh->p = BN_dup(dh_named_groups[i].p);
+    dh->g = BN_dup(&_bignum_const_2);
+    if (dh->p == NULL || dh->g == NULL) {
+        DH_free(dh);
+        return NULL;
+    }
+    dh->length = dh_named_groups[i].length;
+    return dh;
+}
+
+static int dh_named_group_index(const DH *dh)
+{
+    BIGNUM *q;
+    size_t i;
+    int ok;
+
+    if (dh->p == NULL || dh->g == NULL
+        || BN_cmp(dh->g, &_bignum_const_2) != 0)
+        return -1;
+
+    for (i = 0; i < OSSL_NELEM(dh_named_groups); i++) {
+        if (BN_cmp(dh->p, dh_named_groups[i].p) == 0)
+            break;
+    }
+    if (i == OSSL_NELEM(dh_named_groups))
+        return -1;
+
+    if (dh->q != NULL) {
+        /* The order of the generator is (p - 1) / 2 */
+        q = BN_dup(dh->p);
+        ok = q != NULL && BN_rshift1(q, q) && BN_cmp(dh->q, q) == 0;
+        BN_free(q);
+        if (!ok)
+            return -1;
+    }
+    return (int)i;
+}
+
+int DH_get_nid(const DH *dh)
+{
+    int i = dh_named_group_index(dh);
+
+    return i < 0 ? NID_undef : dh_named_groups[i].nid;
+}
+
+/* Returns the comb for group |i|, building it if necessary */
+static const BN_COMB *dh_named_group_comb(int i, BN_CTX *ctx)
+{
+    BN_COMB *comb;
+    int failed;
+
+    if (!RUN_ONCE(&dh_named_combs_init, do_dh_named_combs_init)
+        || dh_named_combs_lock == NULL)
+        return NULL;
+
+    CRYPTO_THREAD_read_lock(dh_named_combs_lock);
+    comb = dh_named_combs[i];
+    failed = dh_named_combs_failed[i];
+    CRYPTO_THREAD_unlock(dh_named_combs_lock);
+    if (comb != NULL || failed)
+        return comb;
+
+    CRYPTO_THREAD_write_lock(dh_named_combs_lock);
+    if (dh_named_combs[i] == NULL && !dh_named_combs_failed[i]) {
+        dh_named_combs[i] = bn_comb_new(&_bignum_const_2,
+                                        dh_named_groups[i].p,
+                                        dh_named_groups[i].length, ctx);
+        if (dh_named_combs[i] == NULL)
+            dh_named_combs_failed[i] = 1;
+    }
+    comb = dh_named_combs[i];
+    CRYPTO_THREAD_unlock(dh_named_combs_lock);
+    return comb;
+}
+
+/*
+ * Computes r = g^e mod p with the comb of the group if |dh| uses one of the
+ * RFC 7919 groups.  Returns 1 on success, 0 on error and -1 if the comb
+ * cannot be used, in which case the caller falls back to the generic code.
+ */
+int dh_named_group_mod_exp(const DH *dh, BIGNUM *r, const BIGNUM *e,
+                           BN_CTX *ctx)
+{
+    const BN_COMB *comb;
+    int i = dh_named_group_index(dh);
+
+    if (i < 0 || BN_num_bits(e) > dh_named_groups[i].length)
+        return -1;
+    if ((comb = dh_named_group_comb(i, ctx)) == NULL)
+        return -1;
+    return bn_comb_mod_exp(r, e, comb, ctx);
+}
+
+void dh_cleanup_int(void)
+{
+    size_t i;
+
+    for (i = 0; i < OSSL_NELEM(dh_named_combs); i++) {
+        bn_comb_free(dh_named_combs[i]);
+        dh_named_combs[i] = NULL;
+        dh_named_combs_failed[i] = 0;
+    }
+    CRYPTO_THREAD_lock_free(dh_named_combs_lock);
+    dh_named_combs_lock = NULL;
+}
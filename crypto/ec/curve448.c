@@ -0,0 +1,431 @@
+/*
+ * Copyright 2017 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the OpenSSL license (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+/*
+ * X448 (RFC 7748) over the field GF(p), p = 2^448 - 2^224 - 1.
+ *
+ * Field elements are kept in NLIMBS unsigned limbs of LIMB_BITS bits each.
+ * Because 2^448 = 2^224 + 1 (mod p) and 224 is a multiple of the limb size,
+ * products are reduced by folding their high halves onto the limbs half a
+ * field element and a whole field element below, with no multiplications at
+ * all. Limbs are only loosely reduced between operations: products are
+ * carried back to LIMB_BITS bits plus a small excess, which is all that
+ * fe_mul() needs to stay within its double width accumulators.
+ *
+ * On 64-bit platforms with a 128-bit integer type 8 limbs of 56 bits are
+ * used, which leaves enough headroom to multiply sums and differences without
+ * carrying them first. Elsewhere 16 limbs of 28 bits are used with 64-bit
+ * accumulators.
+ */
+
+#include <string.h>
+#include "ec_lcl.h"
+
+#if !defined(PEDANTIC) && \
+    (defined(__SIZEOF_INT128__) && __SIZEOF_INT128__ == 16) && \
+    (defined(__SIZEOF_LONG__) && __SIZEOF_LONG__ == 8)
+typedef uint64_t limb;
+typedef unsigned __int128 dlimb;
+typedef __int128 sdlimb;
+# define NLIMBS         8
+# define LIMB_BITS      56
+#else
+typedef uint32_t limb;
+typedef uint64_t dlimb;
+typedef int64_t sdlimb;
+# define NLIMBS         16
+# define LIMB_BITS      28
+/*
+ * A product of sums would overflow the 64-bit column accumulators, so sums
+ * and differences are carried straight away.
+ */
+# define CARRY_SUMS
+#endif
+
+#define LIMB_MASK       (((limb)1 << LIMB_BITS) - 1)
+/* Number of limbs making up 2^224 */
+#define HALF            (NLIMBS / 2)
+
+#define X448_LEN        56
+
+typedef limb fe[NLIMBS];
+
+/*
+ * Propagate carries so that every limb fits in LIMB_BITS bits, except that
+ * limbs 1 and HALF + 1 may be a little larger. The carry out of the top limb
+ * is worth 2^448 = 2^224 + 1, so it goes into limbs 0 and HALF, and only
+ * those two need carrying again.
+ */
+static void fe_carry_wide(fe out, dlimb t[NLIMBS])
+{
+    dlimb c;
+    int i;
+
+    for (i = 0; i < NLIMBS - 1; i++) {
+        t[i + 1] += t[i] >> LIMB_BITS;
+        t[i] &= LIMB_MASK;
+    }
+    c = t[NLIMBS - 1] >> LIMB_BITS;
+    t[NLIMBS - 1] &= LIMB_MASK;
+    t[0] += c;
+    t[HALF] += c;
+    t[1] += t[0] >> LIMB_BITS;
+    t[0] &= LIMB_MASK;
+    t[HALF + 1] += t[HALF] >> LIMB_BITS;
+    t[HALF] &= LIMB_MASK;
+
+    for (i = 0; i < NLIMBS; i++)
+        out[i] = (limb)t[i];
+}
+
+static void fe_carry(fe a)
+{
+    dlimb t[NLIMBS];
+    int i;
+
+    for (i = 0; i < NLIMBS; i++)
+        t[i] = a[i];
+    fe_carry_wide(a, t);
+}
+
+/*
+ * Carry the columns of a product, given as the low halves |lo| and high halves
+ * |hi| of each 2^224 block, into |out|. The carry out of the low block goes
+ * into limb HALF and the carry out of the high block, worth 2^448 = 2^224 + 1,
+ * into limbs 0 and HALF. Limbs 1 and HALF + 1 may be left a little larger
+ * than LIMB_BITS bits, as with fe_carry_wide().
+ */
+#define FE_CARRY_COLUMNS(out, lo, hi, k, c0, c1) \
+    do { \
+        c0 += lo; \
+        c1 += hi; \
+        out[k] = (limb)c0 & LIMB_MASK; \
+        out[k + HALF] = (limb)c1 & LIMB_MASK; \
+        c0 >>= LIMB_BITS; \
+        c1 >>= LIMB_BITS; \
+    } while (0)
+
+static void fe_carry_top(fe out, dlimb c0, dlimb c1)
+{
+    c0 += c1 + out[HALF];
+    c1 += out[0];
+    out[HALF] = (limb)c0 & LIMB_MASK;
+    out[0] = (limb)c1 & LIMB_MASK;
+    out[HALF + 1] += (limb)(c0 >> LIMB_BITS);
+    out[1] += (limb)(c1 >> LIMB_BITS);
+}
+
+/*
+ * Multiplication splits each input into halves, a = a0 + a1 * 2^224, and uses
+ * 2^448 = 2^224 + 1 to fold the product back as it is formed:
+ *
+ *   a * b = (l(a0 * b0) + l(a1 * b1) + h(m) - h(a0 * b0))
+ *         + (l(m) - l(a0 * b0) + h(a1 * b1) + h(m)) * 2^224
+ *
+ * where m = (a0 + a1) * (b0 + b1) and l() and h() are the low and high
+ * NLIMBS / 2 columns of a half size product. That is three half size products
+ * (Karatsuba) rather than four. Each term of m is at least as large as the
+ * matching term of a0 * b0, so every column stays non-negative. Columns are
+ * formed one at a time so that they can be carried as they are completed;
+ * |out| may be the same as |a| or |b|.
+ */
+static void fe_mul(fe out, const fe a, const fe b)
+{
+    dlimb lo, hi, c0 = 0, c1 = 0, p00, p11, pm;
+    limb as[HALF], bs[HALF];
+    fe r;
+    int i, j, k;
+
+    for (i = 0; i < HALF; i++) {
+        as[i] = a[i] + a[i + HALF];
+        bs[i] = b[i] + b[i + HALF];
+    }
+
+    for (k = 0; k < HALF; k++) {
+        lo = hi = 0;
+        for (i = 0; i < HALF; i++) {
+            j = i <= k ? k - i : k - i + HALF;
+            p00 = (dlimb)a[i] * b[j];
+            p11 = (dlimb)a[i + HALF] * b[j + HALF];
+            pm = (dlimb)as[i] * bs[j];
+            if (i <= k) {
+                lo += p00 + p11;
+                hi += pm - p00;
+            } else {
+                lo += pm - p00;
+                hi += p11 + pm;
+            }
+        }
+        FE_CARRY_COLUMNS(r, lo, hi, k, c0, c1);
+    }
+    fe_carry_top(r, c0, c1);
+    memcpy(out, r, sizeof(fe));
+}
+
+/* As fe_mul() with a == b, computing each cross term once */
+static void fe_sq(fe out, const fe a)
+{
+    dlimb lo, hi, c0 = 0, c1 = 0, p00, p11, pm;
+    limb as[HALF];
+    fe r;
+    int i, j, k, d;
+
+    for (i = 0; i < HALF; i++)
+        as[i] = a[i] + a[i + HALF];
+
+    for (k = 0; k < HALF; k++) {
+        lo = hi = 0;
+        for (i = 0; i < HALF; i++) {
+            j = i <= k ? k - i : k - i + HALF;
+            if (i > j)
+                continue;
+            d = i < j;
+            p00 = (dlimb)a[i] * a[j] << d;
+            p11 = (dlimb)a[i + HALF] * a[j + HALF] << d;
+            pm = (dlimb)as[i] * as[j] << d;
+            if (i <= k) {
+                lo += p00 + p11;
+                hi += pm - p00;
+            } else {
+                lo += pm - p00;
+                hi += p11 + pm;
+            }
+        }
+        FE_CARRY_COLUMNS(r, lo, hi, k, c0, c1);
+    }
+    fe_carry_top(r, c0, c1);
+    memcpy(out, r, sizeof(fe));
+}
+
+static void fe_sq_n(fe out, const fe a, int n)
+{
+    fe_sq(out, a);
+    while (--n > 0)
+        fe_sq(out, out);
+}
+
+static void fe_mul_small(fe out, const fe a, limb b)
+{
+    dlimb t[NLIMBS];
+    int i;
+
+    for (i = 0; i < NLIMBS; i++)
+        t[i] = (dlimb)a[i] * b;
+    fe_carry_wide(out, t);
+}
+
+static void fe_add(fe out, const fe a, const fe b)
+{
+    int i;
+
+    for (i = 0; i < NLIMBS; i++)
+        out[i] = a[i] + b[i];
+#ifdef CARRY_SUMS
+    fe_carry(out);
+#endif
+}
+
+/*
+ * out = a - b, computed as a + 2p - b so that no limb goes negative. |b| must
+ * be loosely reduced, the output of fe_mul(), fe_sq() or fe_carry(), so that
+ * each of its limbs is below the matching limb of 2p.
+ */
+static void fe_sub(fe out, const fe a, const fe b)
+{
+    int i;
+
+    for (i = 0; i < NLIMBS; i++)
+        out[i] = a[i] + ((i == HALF ? LIMB_MASK - 1 : LIMB_MASK) << 1) - b[i];
+#ifdef CARRY_SUMS
+    fe_carry(out);
+#endif
+}
+
+/* Swap |a| and |b| if |swap| is 1, in constant time */
+static void fe_cswap(fe a, fe b, limb swap)
+{
+    limb mask = 0 - swap, x;
+    int i;
+
+    for (i = 0; i < NLIMBS; i++) {
+        x = (a[i] ^ b[i]) & mask;
+        a[i] ^= x;
+        b[i] ^= x;
+    }
+}
+
+static void fe_frombytes(fe out, const uint8_t in[X448_LEN])
+{
+    dlimb acc = 0;
+    int i, j = 0, bits = 0;
+
+    for (i = 0; i < X448_LEN; i++) {
+        acc |= (dlimb)in[i] << bits;
+        bits += 8;
+        if (bits >= LIMB_BITS) {
+            out[j++] = (limb)acc & LIMB_MASK;
+            acc >>= LIMB_BITS;
+            bits -= LIMB_BITS;
+        }
+    }
+}
+
+/* Fully reduce |a| modulo p and write it out in little endian order */
+static void fe_tobytes(uint8_t out[X448_LEN], const fe a)
+{
+    fe t;
+    sdlimb scarry = 0;
+    dlimb carry = 0;
+    limb mask;
+    int i, j, bits = 0;
+
+    memcpy(t, a, sizeof(fe));
+    fe_carry(t);
+
+    /*
+     * t < 2p now. Subtract p, leaving a borrow of -1 in |scarry| if that went
+     * negative, then add p back in that case. The final carry out of the
+     * addition cancels the borrow.
+     */
+    for (i = 0; i < NLIMBS; i++) {
+        scarry += (sdlimb)t[i] - (i == HALF ? LIMB_MASK - 1 : LIMB_MASK);
+        t[i] = (limb)scarry & LIMB_MASK;
+        scarry >>= LIMB_BITS;
+    }
+    mask = (limb)scarry;
+    for (i = 0; i < NLIMBS; i++) {
+        carry += (dlimb)t[i] + ((i == HALF ? LIMB_MASK - 1 : LIMB_MASK) & mask);
+        t[i] = (limb)carry & LIMB_MASK;
+        carry >>= LIMB_BITS;
+    }
+
+    carry = 0;
+    for (i = 0, j = 0; i < X448_LEN; i++) {
+        if (bits < 8) {
+            carry |= (dlimb)t[j++] << bits;
+            bits += LIMB_BITS;
+        }
+        out[i] = (uint8_t)carry;
+        carry >>= 8;
+        bits -= 8;
+    }
+}
+
+/* out = z^(p - 2) = z^-1 */
+static void fe_invert(fe out, const fe z)
+{
+    fe x3, x6, x27, x54, t;
+
+    /*
+     * p - 2 = (2^223 - 1) * 2^225 + (2^222 - 1) * 4 + 1. Build z^(2^222 - 1)
+     * from runs of ones.
+     */
+    fe_sq(t, z);
+    fe_mul(t, t, z);                    /* 2^2 - 1 */
+    fe_sq(t, t);
+    fe_mul(x3, t, z);                   /* 2^3 - 1 */
+    fe_sq_n(t, x3, 3);
+    fe_mul(x6, t, x3);                  /* 2^6 - 1 */
+    fe_sq_n(t, x6, 6);
+    fe_mul(t, t, x6);                   /* 2^12 - 1 */
+    fe_sq_n(x27, t, 12);
+    fe_mul(t, x27, t);                  /* 2^24 - 1 */
+    fe_sq_n(t, t, 3);
+    fe_mul(x27, t, x3);                 /* 2^27 - 1 */
+    fe_sq_n(t, x27, 27);
+    fe_mul(x54, t, x27);                /* 2^54 - 1 */
+    fe_sq_n(t, x54, 54);
+    fe_mul(t, t, x54);                  /* 2^108 - 1 */
+    fe_sq_n(x54, t, 108);
+    fe_mul(t, x54, t);                  /* 2^216 - 1 */
+    fe_sq_n(t, t, 6);
+    fe_mul(x54, t, x6);                 /* x54 = z^(2^222 - 1) */
+    fe_sq(t, x54);
+    fe_mul(t, t, z);                    /* 2^223 - 1 */
+    fe_sq_n(t, t, 223);
+    fe_mul(t, t, x54);
+    fe_sq_n(t, t, 2);
+    fe_mul(out, t, z);
+}
+
+/* The Montgomery ladder of RFC 7748, section 5 */
+static void x448_scalar_mult(uint8_t out[X448_LEN],
+                             const uint8_t scalar[X448_LEN],
+                             const uint8_t point[X448_LEN])
+{
+    uint8_t e[X448_LEN];
+    fe x1, x2, z2, x3, z3, a, aa, b, bb, c, d, da, cb, ee;
+    limb swap = 0, bit;
+    int i;
+
+    memcpy(e, scalar, X448_LEN);
+    e[0] &= 252;
+    e[55] |= 128;
+
+    fe_frombytes(x1, point);
+    memset(x2, 0, sizeof(fe));
+    x2[0] = 1;
+    memset(z2, 0, sizeof(fe));
+    memcpy(x3, x1, sizeof(fe));
+    memset(z3, 0, sizeof(fe));
+    z3[0] = 1;
+
+    for (i = 447; i >= 0; i--) {
+        bit = (e[i >> 3] >> (i & 7)) & 1;
+        swap ^= bit;
+        fe_cswap(x2, x3, swap);
+        fe_cswap(z2, z3, swap);
+        swap = bit;
+
+        fe_add(a, x2, z2);
+        fe_sq(aa, a);
+        fe_sub(b, x2, z2);
+        fe_sq(bb, b);
+        fe_sub(ee, aa, bb);
+        fe_add(c, x3, z3);
+        fe_sub(d, x3, z3);
+        fe_mul(da, d, a);
+        fe_mul(cb, c, b);
+        fe_add(x3, da, cb);
+        fe_sq(x3, x3);
+        fe_sub(z3, da, cb);
+        fe_sq(z3, z3);
+        fe_mul(z3, z3, x1);
+        fe_mul(x2, aa, bb);
+        fe_mul_small(z2, ee, 39081);
+        fe_add(z2, z2, aa);
+        fe_mul(z2, z2, ee);
+    }
+    fe_cswap(x2, x3, swap);
+    fe_cswap(z2, z3, swap);
+
+    fe_invert(z2, z2);
+    fe_mul(x2, x2, z2);
+    fe_tobytes(out, x2);
+
+    OPENSSL_cleanse(e, sizeof(e));
+}
+
+int X448(uint8_t out_shared_key[56], const uint8_t private_key[56],
+         const uint8_t peer_public_value[56])
+{
+    static const uint8_t kZeros[X448_LEN] = {0};
+
+    x448_scalar_mult(out_shared_key, private_key, peer_public_value);
+    /* The all-zero output results when the input is a point of small order. */
+    return CRYPTO_memcmp(kZeros, out_shared_key, X448_LEN) != 0;
+}
+
+void X448_public_from_private(uint8_t out_public_value[56],
+                              const uint8_t private_key[56])
+{
+    static const uint8_t basepoint[X448_LEN] = {5};
+
+    x448_scalar_mult(out_public_value, private_key, basepoint);
+}
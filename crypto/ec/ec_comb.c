@@ -0,0 +1,460 @@
+/*
+ * Copyright 2017 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the OpenSSL license (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+#include <string.h>
+#include <openssl/err.h>
+
+#include "internal/bn_int.h"
+#include "internal/constant_time_locl.h"
+#include "ec_lcl.h"
+
+/*
+ * Fixed-base comb multiplication of the generator for curves over GF(p)
+ * that have no dedicated implementation.
+ *
+ * The scalar is recoded into L = w * d signed digits in {-1, +1} (see
+ * below) which are read as d columns of w "teeth" spaced d bits apart.
+ * With B_i = 2^(i*d) * G, the table holds the 2^(w-1) affine points
+ *
+ *     T[j] = B_(w-1) + sum_{i < w-1} (2 * j_i - 1) * B_i
+ *
+ * where j_i is bit i of j; every column value is then +T[j] or -T[~j].
+ * A multiplication costs d - 1 doublings and d - 1 mixed additions, the
+ * same sequence of operations for every scalar, and each table lookup
+ * touches every entry.
+ *
+ * The table only depends on the group, so it is built on first use and
+ * shared by every EC_GROUP copied from it; EC_GROUP_new_by_curve_name()
+ * hands out one table per built-in curve.
+ *
+ * The same object also holds the affine odd multiples of G used by the
+ * variable-time wNAF code in ec_mult.c when the generator is combined with
+ * other points, as in ECDSA verification.
+ */
+
+struct ec_comb_st {
+    int teeth;                  /* w, or 0 if the comb is disabled */
+    int spacing;                /* d */
+    int field_words;            /* words per field element */
+    int failed;                 /* the table cannot be built for this group */
+    size_t table_len;           /* number of words in |table| */
+    BN_ULONG *table;            /* 2^(w-1) entries of X, Y and -Y */
+    int odd_failed;             /* |odd| cannot be built for this group */
+    EC_POINT **odd;             /* G, 3G, ..., (2^EC_COMB_ODD_WINDOW - 1)G */
+    CRYPTO_REF_COUNT references;
+    CRYPTO_RWLOCK *lock;
+};
+
+EC_COMB *ec_comb_new(int teeth)
+{
+    EC_COMB *ret;
+
+    if (teeth != 0
+        && (teeth < EC_COMB_MIN_TEETH || teeth > EC_COMB_MAX_TEETH)) {
+        ECerr(EC_F_EC_COMB_NEW, EC_R_INVALID_COMB_TEETH);
+        return NULL;
+    }
+
+    ret = OPENSSL_zalloc(sizeof(*ret));
+    if (ret == NULL) {
+        ECerr(EC_F_EC_COMB_NEW, ERR_R_MALLOC_FAILURE);
+        return NULL;
+    }
+    ret->teeth = teeth;
+    ret->references = 1;
+    ret->lock = CRYPTO_THREAD_lock_new();
+    if (ret->lock == NULL) {
+        ECerr(EC_F_EC_COMB_NEW, ERR_R_MALLOC_FAILURE);
+        OPENSSL_free(ret);
+        return NULL;
+    }
+    return ret;
+}
+
+EC_COMB *ec_comb_dup(EC_COMB *comb)
+{
+    int i;
+
+    if (comb != NULL)
+        CRYPTO_UP_REF(&comb->references, &i, comb->lock);
+    return comb;
+}
+
+void ec_comb_free(EC_COMB *comb)
+{
+    int i;
+
+    if (comb == NULL)
+        return;
+
+    CRYPTO_DOWN_REF(&comb->references, &i, comb->lock);
+    REF_PRINT_COUNT("EC_comb", comb);
+    if (i > 0)
+        return;
+    REF_ASSERT_ISNT(i < 0);
+
+    OPENSSL_clear_free(comb->table, comb->table_len * sizeof(BN_ULONG));
+    if (comb->odd != NULL) {
+        EC_POINT **p;
+
+        for (p = comb->odd; *p != NULL; p++)
+            EC_POINT_free(*p);
+        OPENSSL_free(comb->odd);
+    }
+    CRYPTO_THREAD_lock_free(comb->lock);
+    OPENSSL_free(comb);
+}
+
+int ec_comb_teeth(const EC_COMB *comb)
+{
+    return comb == NULL ? 0 : comb->teeth;
+}
+
+/*
+ * Replaces the comb of |group| with an empty one of the same width; called
+ * whenever the curve or the generator changes.
+ */
+int ec_comb_reset(EC_GROUP *group)
+{
+    EC_COMB *comb = ec_comb_new(ec_comb_teeth(group->comb));
+
+    if (comb == NULL)
+        return 0;
+    ec_comb_free(group->comb);
+    group->comb = comb;
+    return 1;
+}
+
+/* Computes the table for |group|.  Called with the write lock held. */
+static int ec_comb_build(EC_COMB *comb, const EC_GROUP *group, BN_CTX *ctx)
+{
+    EC_POINT **base = NULL, **table = NULL;
+    BIGNUM *negy;
+    BN_ULONG *words = NULL, *p;
+    int w = comb->teeth, nw = bn_get_top(group->field);
+    size_t i, j, h, entries = (size_t)1 << (w - 1), len;
+    int ret = 0;
+
+    comb->spacing = (BN_num_bits(group->order) + 2 + w - 1) / w;
+    comb->field_words = nw;
+    len = entries * 3 * nw;
+
+    BN_CTX_start(ctx);
+    negy = BN_CTX_get(ctx);
+    base = OPENSSL_zalloc(sizeof(*base) * (2 * w - 1));
+    table = OPENSSL_zalloc(sizeof(*table) * entries);
+    words = OPENSSL_zalloc(sizeof(*words) * len);
+    if (negy == NULL || base == NULL || table == NULL || words == NULL) {
+        ECerr(EC_F_EC_COMB_BUILD, ERR_R_MALLOC_FAILURE);
+        goto err;
+    }
+
+    /* base[i] = 2^(i*d) * G and base[w + i] = 2 * base[i] for i < w - 1 */
+    for (i = 0; i < (size_t)(2 * w - 1); i++) {
+        if ((base[i] = EC_POINT_new(group)) == NULL)
+            goto err;
+    }
+    if (!EC_POINT_copy(base[0], group->generator))
+        goto err;
+    for (i = 1; i < (size_t)w; i++) {
+        if (!EC_POINT_dbl(group, base[i], base[i - 1], ctx))
+            goto err;
+        for (j = 1; j < (size_t)comb->spacing; j++) {
+            if (!EC_POINT_dbl(group, base[i], base[i], ctx))
+                goto err;
+        }
+    }
+    for (i = 0; i < (size_t)(w - 1); i++) {
+        if (!EC_POINT_dbl(group, base[w + i], base[i], ctx))
+            goto err;
+    }
+
+    for (j = 0; j < entries; j++) {
+        if ((table[j] = EC_POINT_new(group)) == NULL)
+            goto err;
+    }
+
+    /* T[0] = B_(w-1) - B_(w-2) - ... - B_0 */
+    if (!EC_POINT_copy(table[0], base[w - 1]))
+        goto err;
+    for (i = 0; i < (size_t)(w - 1); i++) {
+        if (!EC_POINT_invert(group, base[i], ctx)
+            || !EC_POINT_add(group, table[0], table[0], base[i], ctx))
+            goto err;
+    }
+
+    /* Setting bit h of the index turns -B_h into +B_h */
+    for (j = 1, h = 0; j < entries; j++) {
+        if (j == (size_t)2 << h)
+            h++;
+        if (!EC_POINT_add(group, table[j], table[j ^ ((size_t)1 << h)],
+                          base[w + h], ctx))
+            goto err;
+    }
+
+    for (j = 0; j < entries; j++) {
+        if (EC_POINT_is_at_infinity(group, table[j])) {
+            /* Cannot be represented in affine form; use the generic code */
+            comb->failed = 1;
+            ret = 1;
+            goto err;
+        }
+    }
+    if (!EC_POINTs_make_affine(group, entries, table, ctx))
+        goto err;
+
+    for (j = 0, p = words; j < entries; j++, p += 3 * nw) {
+        if (!BN_usub(negy, group->field, table[j]->Y)
+            || !bn_copy_words(p, table[j]->X, nw)
+            || !bn_copy_words(p + nw, table[j]->Y, nw)
+            || !bn_copy_words(p + 2 * nw, negy, nw))
+            goto err;
+    }
+
+    comb->table = words;
+    comb->table_len = len;
+    words = NULL;
+    ret = 1;
+
+ err:
+    if (base != NULL) {
+        for (i = 0; i < (size_t)(2 * w - 1); i++)
+            EC_POINT_free(base[i]);
+        OPENSSL_free(base);
+    }
+    if (table != NULL) {
+        for (j = 0; j < entries; j++)
+            EC_POINT_clear_free(table[j]);
+        OPENSSL_free(table);
+    }
+    OPENSSL_clear_free(words, sizeof(*words) * len);
+    BN_CTX_end(ctx);
+    return ret;
+}
+
+/* Returns the table of |comb|, building it if necessary */
+static const BN_ULONG *ec_comb_get_table(EC_COMB *comb, const EC_GROUP *group,
+                                         BN_CTX *ctx)
+{
+    const BN_ULONG *table;
+    int failed;
+
+    CRYPTO_THREAD_read_lock(comb->lock);
+    table = comb->table;
+    failed = comb->failed;
+    CRYPTO_THREAD_unlock(comb->lock);
+    if (table != NULL || failed)
+        return table;
+
+    CRYPTO_THREAD_write_lock(comb->lock);
+    if (comb->table == NULL && !comb->failed
+        && !ec_comb_build(comb, group, ctx))
+        comb->failed = 1;
+    table = comb->table;
+    CRYPTO_THREAD_unlock(comb->lock);
+    return table;
+}
+
+/* Computes the odd multiples of G.  Called with the write lock held. */
+static int ec_comb_build_odd(EC_COMB *comb, const EC_GROUP *group,
+                             BN_CTX *ctx)
+{
+    size_t i, num = (size_t)1 << (EC_COMB_ODD_WINDOW - 1);
+    EC_POINT **odd, *dbl = NULL;
+    int ret = 0;
+
+    odd = OPENSSL_zalloc(sizeof(*odd) * (num + 1));
+    if (odd == NULL) {
+        ECerr(EC_F_EC_COMB_BUILD_ODD, ERR_R_MALLOC_FAILURE);
+        return 0;
+    }
+    for (i = 0; i < num; i++) {
+        if ((odd[i] = EC_POINT_new(group)) == NULL)
+            goto err;
+    }
+    if ((dbl = EC_POINT_new(group)) == NULL
+        || !EC_POINT_copy(odd[0], group->generator)
+        || !EC_POINT_dbl(group, dbl, odd[0], ctx))
+        goto err;
+    for (i = 1; i < num; i++) {
+        if (!EC_POINT_add(group, odd[i], odd[i - 1], dbl, ctx))
+            goto err;
+    }
+    if (!EC_POINTs_make_affine(group, num, odd, ctx))
+        goto err;
+
+    comb->odd = odd;
+    odd = NULL;
+    ret = 1;
+
+ err:
+    if (odd != NULL) {
+        for (i = 0; i < num; i++)
+            EC_POINT_free(odd[i]);
+        OPENSSL_free(odd);
+    }
+    EC_POINT_free(dbl);
+    return ret;
+}
+
+/*
+ * Returns the NULL-terminated array of affine points G, 3G, 5G, ...,
+ * (2^EC_COMB_ODD_WINDOW - 1)G, building it if necessary, or NULL if it is
+ * not available.  The points must not be modified.
+ */
+EC_POINT **ec_comb_odd_multiples(const EC_GROUP *group, BN_CTX *ctx)
+{
+    EC_COMB *comb = group->comb;
+    EC_POINT **odd;
+    int failed;
+
+    if (comb == NULL || group->generator == NULL
+        || group->meth->points_make_affine == 0)
+        return NULL;
+
+    CRYPTO_THREAD_read_lock(comb->lock);
+    odd = comb->odd;
+    failed = comb->odd_failed;
+    CRYPTO_THREAD_unlock(comb->lock);
+    if (odd != NULL || failed)
+        return odd;
+
+    CRYPTO_THREAD_write_lock(comb->lock);
+    if (comb->odd == NULL && !comb->odd_failed
+        && !ec_comb_build_odd(comb, group, ctx))
+        comb->odd_failed = 1;
+    odd = comb->odd;
+    CRYPTO_THREAD_unlock(comb->lock);
+    return odd;
+}
+
+/* Loads column value +T[idx] or -T[idx] into |v| without branching on idx */
+static int ec_comb_select(const EC_COMB *comb, const BN_ULONG *table,
+                          BN_ULONG *sel, EC_POINT *v, unsigned int idx,
+                          unsigned int neg)
+{
+    int i, nw = comb->field_words;
+    size_t j, entries = (size_t)1 << (comb->teeth - 1);
+    BN_ULONG mask, negmask = (BN_ULONG)0 - (BN_ULONG)(neg & 1);
+    unsigned int eq;
+    const BN_ULONG *p;
+
+    memset(sel, 0, sizeof(*sel) * 2 * nw);
+    for (j = 0, p = table; j < entries; j++, p += 3 * nw) {
+        eq = constant_time_eq_int((int)j, (int)idx);
+        mask = (BN_ULONG)0 - (BN_ULONG)(eq & 1);
+        for (i = 0; i < nw; i++) {
+            sel[i] |= p[i] & mask;
+            sel[nw + i] |= ((p[nw + i] & ~negmask)
+                            | (p[2 * nw + i] & negmask)) & mask;
+        }
+    }
+    return bn_set_words(v->X, sel, nw) && bn_set_words(v->Y, sel + nw, nw);
+}
+
+/*
+ * Computes r = scalar * G using the comb of |group|.  Returns 1 on success,
+ * 0 on error and -1 if the comb cannot be used, in which case the caller
+ * falls back to the generic code.
+ */
+int ec_comb_mul(const EC_GROUP *group, EC_POINT *r, const BIGNUM *scalar,
+                BN_CTX *ctx)
+{
+    EC_COMB *comb = group->comb;
+    const BN_ULONG *table;
+    BIGNUM *k, *kp, *c;
+    BN_ULONG *cw = NULL, *sel = NULL;
+    EC_POINT *v = NULL;
+    int w, d, L, cwords, col, t, ret = 0;
+    unsigned int idx, top;
+
+    if (comb == NULL || comb->teeth == 0 || group->generator == NULL
+        || group->meth->field_type != NID_X9_62_prime_field
+        || group->meth->points_make_affine == 0
+        || !BN_is_odd(group->order)
+        || BN_is_negative(scalar)
+        || BN_num_bits(scalar) > BN_num_bits(group->order) + 1)
+        return -1;
+
+    if ((table = ec_comb_get_table(comb, group, ctx)) == NULL)
+        return -1;
+    if (comb->field_words != bn_get_top(group->field))
+        return -1;
+
+    w = comb->teeth;
+    d = comb->spacing;
+    L = w * d;
+    cwords = (L + BN_BITS2 - 1) / BN_BITS2;
+
+    BN_CTX_start(ctx);
+    k = BN_CTX_get(ctx);
+    kp = BN_CTX_get(ctx);
+    c = BN_CTX_get(ctx);
+    cw = OPENSSL_malloc(sizeof(*cw) * cwords);
+    sel = OPENSSL_malloc(sizeof(*sel) * 2 * comb->field_words);
+    if (c == NULL || cw == NULL || sel == NULL) {
+        ECerr(EC_F_EC_COMB_MUL, ERR_R_MALLOC_FAILURE);
+        goto err;
+    }
+    if ((v = EC_POINT_new(group)) == NULL
+        || !EC_POINT_copy(v, group->generator)
+        || !EC_POINT_make_affine(group, v, ctx))
+        goto err;
+
+    /*
+     * The digits encode odd values only, so use k + order if k is even.
+     * Either way k < 2^L and c = (k + 2^L - 1) / 2 is an L-bit value whose
+     * bits c_i give the digits 2 * c_i - 1 of k.
+     */
+    if (BN_copy(k, scalar) == NULL
+        || !BN_add(kp, scalar, group->order)
+        || bn_wexpand(k, cwords) == NULL
+        || bn_wexpand(kp, cwords) == NULL)
+        goto err;
+    BN_consttime_swap(!BN_is_odd(k), k, kp, cwords);
+    BN_zero(c);
+    if (!BN_set_bit(c, L)
+        || !BN_sub_word(c, 1)
+        || !BN_add(c, c, k)
+        || !BN_rshift1(c, c)
+        || !bn_copy_words(cw, c, cwords))
+        goto err;
+
+#define COMB_BIT(i) ((unsigned int)(cw[(i) / BN_BITS2] >> ((i) % BN_BITS2)) & 1)
+
+    for (col = d - 1; col >= 0; col--) {
+        idx = 0;
+        for (t = 0; t < w - 1; t++)
+            idx |= COMB_BIT(col + t * d) << t;
+        top = COMB_BIT(col + (w - 1) * d);
+        /* A negative top digit flips the sign of every digit */
+        idx = constant_time_select(top - 1, ~idx, idx) & ((1U << (w - 1)) - 1);
+
+        if (!ec_comb_select(comb, table, sel, v, idx, top ^ 1))
+            goto err;
+        if (col == d - 1) {
+            if (!EC_POINT_copy(r, v))
+                goto err;
+        } else if (!EC_POINT_dbl(group, r, r, ctx)
+                   || !EC_POINT_add(group, r, r, v, ctx)) {
+            goto err;
+        }
+    }
+
+#undef COMB_BIT
+
+    ret = 1;
+
+ err:
+    EC_POINT_clear_free(v);
+    OPENSSL_clear_free(cw, sizeof(*cw) * cwords);
+    OPENSSL_clear_free(sel, sizeof(*sel) * 2 * comb->field_words);
+    BN_CTX_end(ctx);
+    return ret;
+}
@@ -23,6 +23,8 @@
 
 #include <string.h>
 #include "ec_lcl.h"
+#include "internal/ec.h"
+#include "internal/thread_once.h"
 #include <openssl/err.h>
 #include <openssl/obj_mac.h>
 #include <openssl/opensslconf.h>
@@ -2803,8 +2805,13 @@ static const ec_list_element curve_list[] = {
     {NID_secp256k1, &_EC_SECG_PRIME_256K1.h, 0,
      "SECG curve over a 256 bit prime field"},
     /* SECG secp256r1 is the same as X9.62 prime256v1 and hence omitted */
+#ifndef OPENSSL_NO_EC_NISTP_64_GCC_128
+    {NID_secp384r1, &_EC_NIST_PRIME_384.h, EC_GFp_nistp384_method,
+     "NIST/SECG curve over a 384 bit prime field"},
+#else
     {NID_secp384r1, &_EC_NIST_PRIME_384.h, 0,
      "NIST/SECG curve over a 384 bit prime field"},
+#endif
 #ifndef OPENSSL_NO_EC_NISTP_64_GCC_128
     {NID_secp521r1, &_EC_NIST_PRIME_521.h, EC_GFp_nistp521_method,
      "NIST/SECG curve over a 521 bit prime field"},
@@ -2977,6 +2984,50 @@ static const ec_list_element curve_list[] = {
 
 #define curve_list_length OSSL_NELEM(curve_list)
 
+/*
+ * Generator comb tables of the built-in curves, indexed like curve_list, so
+ * that all groups made by EC_GROUP_new_by_curve_name() share one table.
+ */
+static EC_COMB *curve_combs[OSSL_NELEM(curve_list)];
+static CRYPTO_ONCE curve_combs_init = CRYPTO_ONCE_STATIC_INIT;
+static CRYPTO_RWLOCK *curve_combs_lock = NULL;
+
+DEFINE_RUN_ONCE_STATIC(do_curve_combs_init)
+{
+    curve_combs_lock = CRYPTO_THREAD_lock_new();
+    return curve_combs_lock != NULL;
+}
+
+static void ec_group_share_curve_comb(EC_GROUP *group, size_t i)
+{
+    EC_COMB *comb;
+
+    if (!RUN_ONCE(&curve_combs_init, do_curve_combs_init)
+        || curve_combs_lock == NULL)
+        return;
+
+    CRYPTO_THREAD_write_lock(curve_combs_lock);
+    if (curve_combs[i] == NULL)
+        curve_combs[i] = ec_comb_dup(group->comb);
+    comb = ec_comb_dup(curve_combs[i]);
+    CRYPTO_THREAD_unlock(curve_combs_lock);
+
+    ec_comb_free(group->comb);
+    group->comb = comb;
+}
+
+void ec_cleanup_int(void)
+{
+    size_t i;
+
+    for (i = 0; i < curve_list_length; i++) {
+        ec_comb_free(curve_combs[i]);
+        curve_combs[i] = NULL;
+    }
+    CRYPTO_THREAD_lock_free(curve_combs_lock);
+    curve_combs_lock = NULL;
+}
+
 static EC_GROUP *ec_group_new_from_data(const ec_list_element curve)
 {
     EC_GROUP *group = NULL;
@@ -3101,6 +3152,8 @@ EC_GROUP *EC_GROUP_new_by_curve_name(int nid)
         return NULL;
     }
 
+    ec_group_share_curve_comb(ret, i);
+
     EC_GROUP_set_curve_name(ret, nid);
 
     return ret;
@@ -170,6 +170,14 @@ struct ec_method_st {
     /* custom ECDH operation */
     int (*ecdh_compute_key)(unsigned char **pout, size_t *poutlen,
                             const EC_POINT *pub_key, const EC_KEY *ecdh);
+    /*
+     * used by ec_point_mul_public: like 'mul' with a single point, but all
+     * inputs are public so it need not run in constant time (EC_POINT_mul is
+     * used if 'mul_public' is 0)
+     */
+    int (*mul_public)(const EC_GROUP *group, EC_POINT *r,
+                      const BIGNUM *g_scalar, const EC_POINT *point,
+                      const BIGNUM *p_scalar, BN_CTX *ctx);
 };
 
 /*
@@ -177,9 +185,11 @@ struct ec_method_st {
  */
 typedef struct nistp224_pre_comp_st NISTP224_PRE_COMP;
 typedef struct nistp256_pre_comp_st NISTP256_PRE_COMP;
+typedef struct nistp384_pre_comp_st NISTP384_PRE_COMP;
 typedef struct nistp521_pre_comp_st NISTP521_PRE_COMP;
 typedef struct nistz256_pre_comp_st NISTZ256_PRE_COMP;
 typedef struct ec_pre_comp_st EC_PRE_COMP;
+typedef struct ec_comb_st EC_COMB;
 
 struct ec_group_st {
     const EC_METHOD *meth;
@@ -236,16 +246,20 @@ struct ec_group_st {
      */
     enum {
         PCT_none,
-        PCT_nistp224, PCT_nistp256, PCT_nistp521, PCT_nistz256,
+        PCT_nistp224, PCT_nistp256, PCT_nistp384, PCT_nistp521,
+        PCT_nistz256,
         PCT_ec
     } pre_comp_type;
     union {
         NISTP224_PRE_COMP *nistp224;
         NISTP256_PRE_COMP *nistp256;
+        NISTP384_PRE_COMP *nistp384;
         NISTP521_PRE_COMP *nistp521;
         NISTZ256_PRE_COMP *nistz256;
         EC_PRE_COMP *ec;
     } pre_comp;
+    /* Fixed-base comb for the generator, see ec_comb.c */
+    EC_COMB *comb;
 };
 
 #define SETPRECOMP(g, type, pre) \
@@ -253,6 +267,13 @@ struct ec_group_st {
 #define HAVEPRECOMP(g, type) \
     g->pre_comp_type == PCT_##type && g->pre_comp.type != NULL
 
+/* A precomputed (kinv, r) pair for ECDSA signing */
+typedef struct ec_sign_setup_st {
+    BIGNUM *kinv;
+    BIGNUM *r;
+    struct ec_sign_setup_st *next;
+} EC_SIGN_SETUP;
+
 struct ec_key_st {
     const EC_KEY_METHOD *meth;
     ENGINE *engine;
@@ -266,6 +287,9 @@ struct ec_key_st {
     int flags;
     CRYPTO_EX_DATA ex_data;
     CRYPTO_RWLOCK *lock;
+    /* pool filled by ECDSA_sign_setup_batch(), protected by |lock| */
+    EC_SIGN_SETUP *sign_setup;
+    size_t sign_setup_num;
 };
 
 struct ec_point_st {
@@ -284,6 +308,7 @@ struct ec_point_st {
 
 NISTP224_PRE_COMP *EC_nistp224_pre_comp_dup(NISTP224_PRE_COMP *);
 NISTP256_PRE_COMP *EC_nistp256_pre_comp_dup(NISTP256_PRE_COMP *);
+NISTP384_PRE_COMP *EC_nistp384_pre_comp_dup(NISTP384_PRE_COMP *);
 NISTP521_PRE_COMP *EC_nistp521_pre_comp_dup(NISTP521_PRE_COMP *);
 NISTZ256_PRE_COMP *EC_nistz256_pre_comp_dup(NISTZ256_PRE_COMP *);
 NISTP256_PRE_COMP *EC_nistp256_pre_comp_dup(NISTP256_PRE_COMP *);
@@ -292,6 +317,7 @@ EC_PRE_COMP *EC_ec_pre_comp_dup(EC_PRE_COMP *);
 void EC_pre_comp_free(EC_GROUP *group);
 void EC_nistp224_pre_comp_free(NISTP224_PRE_COMP *);
 void EC_nistp256_pre_comp_free(NISTP256_PRE_COMP *);
+void EC_nistp384_pre_comp_free(NISTP384_PRE_COMP *);
 void EC_nistp521_pre_comp_free(NISTP521_PRE_COMP *);
 void EC_nistz256_pre_comp_free(NISTZ256_PRE_COMP *);
 void EC_ec_pre_comp_free(EC_PRE_COMP *);
@@ -306,6 +332,20 @@ int ec_wNAF_mul(const EC_GROUP *group, EC_POINT *r, const BIGNUM *scalar,
 int ec_wNAF_precompute_mult(EC_GROUP *group, BN_CTX *);
 int ec_wNAF_have_precompute_mult(const EC_GROUP *group);
 
+/* functions in ec_comb.c */
+#define EC_COMB_MIN_TEETH       2
+#define EC_COMB_MAX_TEETH       8
+#define EC_COMB_DEFAULT_TEETH   6
+#define EC_COMB_ODD_WINDOW      6
+EC_COMB *ec_comb_new(int teeth);
+EC_COMB *ec_comb_dup(EC_COMB *comb);
+void ec_comb_free(EC_COMB *comb);
+int ec_comb_teeth(const EC_COMB *comb);
+int ec_comb_reset(EC_GROUP *group);
+int ec_comb_mul(const EC_GROUP *group, EC_POINT *r, const BIGNUM *scalar,
+                BN_CTX *ctx);
+EC_POINT **ec_comb_odd_multiples(const EC_GROUP *group, BN_CTX *ctx);
+
 /* method functions in ecp_smpl.c */
 int ec_GFp_simple_group_init(EC_GROUP *);
 void ec_GFp_simple_group_finish(EC_GROUP *);
@@ -486,6 +526,22 @@ int ec_GFp_nistp256_points_mul(const EC_GROUP *group, EC_POINT *r,
 int ec_GFp_nistp256_precompute_mult(EC_GROUP *group, BN_CTX *ctx);
 int ec_GFp_nistp256_have_precompute_mult(const EC_GROUP *group);
 
+/* method functions in ecp_nistp384.c */
+int ec_GFp_nistp384_group_init(EC_GROUP *group);
+int ec_GFp_nistp384_group_set_curve(EC_GROUP *group, const BIGNUM *p,
+                                    const BIGNUM *a, const BIGNUM *n,
+                                    BN_CTX *);
+int ec_GFp_nistp384_point_get_affine_coordinates(const EC_GROUP *group,
+                                                 const EC_POINT *point,
+                                                 BIGNUM *x, BIGNUM *y,
+                                                 BN_CTX *ctx);
+int ec_GFp_nistp384_points_mul(const EC_GROUP *group, EC_POINT *r,
+                               const BIGNUM *scalar, size_t num,
+                               const EC_POINT *points[],
+                               const BIGNUM *scalars[], BN_CTX *ctx);
+int ec_GFp_nistp384_precompute_mult(EC_GROUP *group, BN_CTX *ctx);
+int ec_GFp_nistp384_have_precompute_mult(const EC_GROUP *group);
+
 /* method functions in ecp_nistp521.c */
 int ec_GFp_nistp521_group_init(EC_GROUP *group);
 int ec_GFp_nistp521_group_set_curve(EC_GROUP *group, const BIGNUM *p,
@@ -536,6 +592,9 @@ void ec_GFp_nistp_recode_scalar_bits(unsigned char *sign,
                                      unsigned char *digit, unsigned char in);
 #endif
 int ec_precompute_mont_data(EC_GROUP *);
+int ec_point_mul_public(const EC_GROUP *group, EC_POINT *r,
+                        const BIGNUM *g_scalar, const EC_POINT *point,
+                        const BIGNUM *p_scalar, BN_CTX *ctx);
 int ec_group_simple_order_bits(const EC_GROUP *group);
 
 #ifdef ECP_NISTZ256_ASM
@@ -597,6 +656,9 @@ struct ECDSA_SIG_st {
 
 int ossl_ecdsa_sign_setup(EC_KEY *eckey, BN_CTX *ctx_in, BIGNUM **kinvp,
                           BIGNUM **rp);
+int ossl_ecdsa_sign_setup_batch(EC_KEY *eckey, BN_CTX *ctx_in, size_t num);
+size_t ossl_ecdsa_sign_setup_count(const EC_KEY *eckey);
+void ossl_ecdsa_sign_setup_clear(EC_KEY *eckey);
 int ossl_ecdsa_sign(int type, const unsigned char *dgst, int dlen,
                     unsigned char *sig, unsigned int *siglen,
                     const BIGNUM *kinv, const BIGNUM *r, EC_KEY *eckey);
@@ -607,8 +669,24 @@ int ossl_ecdsa_verify(int type, const unsigned char *dgst, int dgst_len,
                       const unsigned char *sigbuf, int sig_len, EC_KEY *eckey);
 int ossl_ecdsa_verify_sig(const unsigned char *dgst, int dgst_len,
                           const ECDSA_SIG *sig, EC_KEY *eckey);
+int ossl_ecdsa_verify_batch(const unsigned char *const dgsts[],
+                            const int dgst_lens[],
+                            const ECDSA_SIG *const sigs[],
+                            EC_KEY *const keys[], size_t num, int results[]);
 
 int X25519(uint8_t out_shared_key[32], const uint8_t private_key[32],
            const uint8_t peer_public_value[32]);
 void X25519_public_from_private(uint8_t out_public_value[32],
                                 const uint8_t private_key[32]);
+
+int X448(uint8_t out_shared_key[56], const uint8_t private_key[56],
+         const uint8_t peer_public_value[56]);
+void X448_public_from_private(uint8_t out_public_value[56],
+                              const uint8_t private_key[56]);
+
+int ED25519_sign(uint8_t *out_sig, const uint8_t *message, size_t message_len,
+                 const uint8_t public_key[32], const uint8_t private_key[32]);
+int ED25519_verify(const uint8_t *message, size_t message_len,
+                   const uint8_t signature[64], const uint8_t public_key[32]);
+void ED25519_public_from_private(uint8_t out_public_key[32],
+                                 const uint8_t private_key[32]);
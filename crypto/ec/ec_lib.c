@@ -52,11 +52,15 @@ EC_GROUP *EC_GROUP_new(const EC_METHOD *meth)
     }
     ret->asn1_flag = OPENSSL_EC_NAMED_CURVE;
     ret->asn1_form = POINT_CONVERSION_UNCOMPRESSED;
+    ret->comb = ec_comb_new(EC_COMB_DEFAULT_TEETH);
+    if (ret->comb == NULL)
+        goto err;
     if (!meth->group_init(ret))
         goto err;
     return ret;
 
  err:
+    ec_comb_free(ret->comb);
     BN_free(ret->order);
     BN_free(ret->cofactor);
     OPENSSL_free(ret);
@@ -80,12 +84,16 @@ void EC_pre_comp_free(EC_GROUP *group)
     case PCT_nistp256:
         EC_nistp256_pre_comp_free(group->pre_comp.nistp256);
         break;
+    case PCT_nistp384:
+        EC_nistp384_pre_comp_free(group->pre_comp.nistp384);
+        break;
     case PCT_nistp521:
         EC_nistp521_pre_comp_free(group->pre_comp.nistp521);
         break;
 #else
     case PCT_nistp224:
     case PCT_nistp256:
+    case PCT_nistp384:
     case PCT_nistp521:
         break;
 #endif
@@ -105,6 +113,7 @@ void EC_GROUP_free(EC_GROUP *group)
         group->meth->group_finish(group);
 
     EC_pre_comp_free(group);
+    ec_comb_free(group->comb);
     BN_MONT_CTX_free(group->mont_data);
     EC_POINT_free(group->generator);
     BN_free(group->order);
@@ -124,6 +133,7 @@ void EC_GROUP_clear_free(EC_GROUP *group)
         group->meth->group_finish(group);
 
     EC_pre_comp_free(group);
+    ec_comb_free(group->comb);
     BN_MONT_CTX_free(group->mont_data);
     EC_POINT_clear_free(group->generator);
     BN_clear_free(group->order);
@@ -163,12 +173,16 @@ int EC_GROUP_copy(EC_GROUP *dest, const EC_GROUP *src)
     case PCT_nistp256:
         dest->pre_comp.nistp256 = EC_nistp256_pre_comp_dup(src->pre_comp.nistp256);
         break;
+    case PCT_nistp384:
+        dest->pre_comp.nistp384 = EC_nistp384_pre_comp_dup(src->pre_comp.nistp384);
+        break;
     case PCT_nistp521:
         dest->pre_comp.nistp521 = EC_nistp521_pre_comp_dup(src->pre_comp.nistp521);
         break;
 #else
     case PCT_nistp224:
     case PCT_nistp256:
+    case PCT_nistp384:
     case PCT_nistp521:
         break;
 #endif
@@ -177,6 +191,10 @@ int EC_GROUP_copy(EC_GROUP *dest, const EC_GROUP *src)
         break;
     }
 
+    /* The comb table is shared with |src| */
+    ec_comb_free(dest->comb);
+    dest->comb = ec_comb_dup(src->comb);
+
     if (src->mont_data != NULL) {
         if (dest->mont_data == NULL) {
             dest->mont_data = BN_MONT_CTX_new();
@@ -294,6 +312,9 @@ int EC_GROUP_set_generator(EC_GROUP *group, const EC_POINT *generator,
     } else
         BN_zero(group->cofactor);
 
+    if (!ec_comb_reset(group))
+        return 0;
+
     /*
      * Some groups have an order with
      * factors of two, which makes the Montgomery setup fail.
@@ -422,6 +443,8 @@ int EC_GROUP_set_curve_GFp(EC_GROUP *group, const BIGNUM *p, const BIGNUM *a,
         ECerr(EC_F_EC_GROUP_SET_CURVE_GFP, ERR_R_SHOULD_NOT_HAVE_BEEN_CALLED);
         return 0;
     }
+    if (!ec_comb_reset(group))
+        return 0;
     return group->meth->group_set_curve(group, p, a, b, ctx);
 }
 
@@ -938,6 +961,26 @@ int EC_POINT_mul(const EC_GROUP *group, EC_POINT *r, const BIGNUM *g_scalar,
                           && p_scalar != NULL), points, scalars, ctx);
 }
 
+/*
+ * Computes r = g_scalar * generator + p_scalar * point where none of the
+ * inputs is secret, e.g. for signature verification, which lets methods use
+ * faster variable-time code.
+ */
+int ec_point_mul_public(const EC_GROUP *group, EC_POINT *r,
+                        const BIGNUM *g_scalar, const EC_POINT *point,
+                        const BIGNUM *p_scalar, BN_CTX *ctx)
+{
+    if (group->meth->mul_public == 0)
+        return EC_POINT_mul(group, r, g_scalar, point, p_scalar, ctx);
+
+    if (group->meth != r->meth
+        || (point != NULL && group->meth != point->meth)) {
+        ECerr(EC_F_EC_POINT_MUL_PUBLIC, EC_R_INCOMPATIBLE_OBJECTS);
+        return 0;
+    }
+    return group->meth->mul_public(group, r, g_scalar, point, p_scalar, ctx);
+}
+
 int EC_GROUP_precompute_mult(EC_GROUP *group, BN_CTX *ctx)
 {
     if (group->meth->mul == 0)
@@ -963,6 +1006,24 @@ int EC_GROUP_have_precompute_mult(const EC_GROUP *group)
                                  * been performed */
 }
 
+int EC_GROUP_set_comb_teeth(EC_GROUP *group, int teeth)
+{
+    EC_COMB *comb;
+
+    if (teeth == ec_comb_teeth(group->comb))
+        return 1;
+    if ((comb = ec_comb_new(teeth)) == NULL)
+        return 0;
+    ec_comb_free(group->comb);
+    group->comb = comb;
+    return 1;
+}
+
+int EC_GROUP_get_comb_teeth(const EC_GROUP *group)
+{
+    return ec_comb_teeth(group->comb);
+}
+
 /*
  * ec_precompute_mont_data sets |group->mont_data| from |group->order| and
  * returns one on success. On error it returns zero.
@@ -146,6 +146,7 @@ int ec_wNAF_mul(const EC_GROUP *group, EC_POINT *r, const BIGNUM *scalar,
     EC_POINT ***val_sub = NULL; /* pointers to sub-arrays of 'val' or
                                  * 'pre_comp->points' */
     const EC_PRE_COMP *pre_comp = NULL;
+    EC_POINT **gen_odd = NULL;  /* shared odd multiples of the generator */
     int num_scalar = 0;         /* flag: will be set to 1 if 'scalar' must be
                                  * treated like other scalars, i.e.
                                  * precomputation is not available */
@@ -180,6 +181,14 @@ int ec_wNAF_mul(const EC_GROUP *group, EC_POINT *r, const BIGNUM *scalar,
             goto err;
         }
 
+        /*
+         * A multiple of the generator alone goes through the fixed-base
+         * comb unless it has been disabled for this group.
+         */
+        if (num == 0 && (ret = ec_comb_mul(group, r, scalar, ctx)) >= 0)
+            goto err;
+        ret = 0;
+
         /* look if we can use precomputed multiples of generator */
 
         pre_comp = group->pre_comp.ec;
@@ -213,6 +222,11 @@ int ec_wNAF_mul(const EC_GROUP *group, EC_POINT *r, const BIGNUM *scalar,
             numblocks = 1;
             num_scalar = 1;     /* treat 'scalar' like 'num'-th element of
                                  * 'scalars' */
+            /*
+             * but the odd multiples of the generator need not be computed
+             * again if the group already has them
+             */
+            gen_odd = ec_comb_odd_multiples(group, ctx);
         }
     }
 
@@ -242,8 +256,12 @@ int ec_wNAF_mul(const EC_GROUP *group, EC_POINT *r, const BIGNUM *scalar,
         size_t bits;
 
         bits = i < num ? BN_num_bits(scalars[i]) : BN_num_bits(scalar);
-        wsize[i] = EC_window_bits_for_scalar_size(bits);
-        num_val += (size_t)1 << (wsize[i] - 1);
+        if (i == num && gen_odd != NULL) {
+            wsize[i] = EC_COMB_ODD_WINDOW;
+        } else {
+            wsize[i] = EC_window_bits_for_scalar_size(bits);
+            num_val += (size_t)1 << (wsize[i] - 1);
+        }
         wNAF[i + 1] = NULL;     /* make sure we always have a pivot */
         wNAF[i] =
             bn_compute_wNAF((i < num ? scalars[i] : scalar), wsize[i],
@@ -378,6 +396,10 @@ int ec_wNAF_mul(const EC_GROUP *group, EC_POINT *r, const BIGNUM *scalar,
     /* allocate points for precomputation */
     v = val;
     for (i = 0; i < num + num_scalar; i++) {
+        if (i == num && gen_odd != NULL) {
+            val_sub[i] = gen_odd;
+            continue;
+        }
         val_sub[i] = v;
         for (j = 0; j < ((size_t)1 << (wsize[i] - 1)); j++) {
             *v = EC_POINT_new(group);
@@ -402,6 +424,8 @@ int ec_wNAF_mul(const EC_GROUP *group, EC_POINT *r, const BIGNUM *scalar,
      *    ...
      */
     for (i = 0; i < num + num_scalar; i++) {
+        if (i == num && gen_odd != NULL)
+            continue;
         if (i < num) {
             if (!EC_POINT_copy(val_sub[i][0], points[i]))
                 goto err;
@@ -31,50 +31,21 @@ int ossl_ecdsa_sign(int type, const unsigned char *dgst, int dlen,
     return 1;
 }
 
-static int ecdsa_sign_setup(EC_KEY *eckey, BN_CTX *ctx_in,
-                            BIGNUM **kinvp, BIGNUM **rp,
+/*
+ * Picks a random nonce k, or one derived from |dgst| if it is not NULL, and
+ * computes r, the x coordinate of k * generator reduced modulo the order.
+ * On return k has been padded to a fixed bit length.
+ */
+static int ecdsa_sign_nonce(EC_KEY *eckey, BN_CTX *ctx, BIGNUM *k, BIGNUM *r,
+                            BIGNUM *X, EC_POINT *tmp_point,
                             const unsigned char *dgst, int dlen)
 {
-    BN_CTX *ctx = NULL;
-    BIGNUM *k = NULL, *r = NULL, *X = NULL;
-    const BIGNUM *order;
-    EC_POINT *tmp_point = NULL;
-    const EC_GROUP *group;
-    int ret = 0;
-
-    if (eckey == NULL || (group = EC_KEY_get0_group(eckey)) == NULL) {
-        ECerr(EC_F_ECDSA_SIGN_SETUP, ERR_R_PASSED_NULL_PARAMETER);
-        return 0;
-    }
-
-    if (!EC_KEY_can_sign(eckey)) {
-        ECerr(EC_F_ECDSA_SIGN_SETUP, EC_R_CURVE_DOES_NOT_SUPPORT_SIGNING);
-        return 0;
-    }
-
-    if (ctx_in == NULL) {
-        if ((ctx = BN_CTX_new()) == NULL) {
-            ECerr(EC_F_ECDSA_SIGN_SETUP, ERR_R_MALLOC_FAILURE);
-            return 0;
-        }
-    } else
-        ctx = ctx_in;
+    const EC_GROUP *group = EC_KEY_get0_group(eckey);
+    const BIGNUM *order = EC_GROUP_get0_order(group);
 
-    k = BN_new();               /* this value is later returned in *kinvp */
-    r = BN_new();               /* this value is later returned in *rp */
-    X = BN_new();
-    if (k == NULL || r == NULL || X == NULL) {
-        ECerr(EC_F_ECDSA_SIGN_SETUP, ERR_R_MALLOC_FAILURE);
-        goto err;
-    }
-    if ((tmp_point = EC_POINT_new(group)) == NULL) {
-        ECerr(EC_F_ECDSA_SIGN_SETUP, ERR_R_EC_LIB);
-        goto err;
-    }
-    order = EC_GROUP_get0_order(group);
     if (order == NULL) {
         ECerr(EC_F_ECDSA_SIGN_SETUP, ERR_R_EC_LIB);
-        goto err;
+        return 0;
     }
 
     do {
@@ -86,13 +57,13 @@ static int ecdsa_sign_setup(EC_KEY *eckey, BN_CTX *ctx_in,
                      ctx)) {
                     ECerr(EC_F_ECDSA_SIGN_SETUP,
                              EC_R_RANDOM_NUMBER_GENERATION_FAILED);
-                    goto err;
+                    return 0;
                 }
             } else {
                 if (!BN_rand_range(k, order)) {
                     ECerr(EC_F_ECDSA_SIGN_SETUP,
                              EC_R_RANDOM_NUMBER_GENERATION_FAILED);
-                    goto err;
+                    return 0;
                 }
             }
         while (BN_is_zero(k));
@@ -103,22 +74,22 @@ static int ecdsa_sign_setup(EC_KEY *eckey, BN_CTX *ctx_in,
          */
 
         if (!BN_add(k, k, order))
-            goto err;
+            return 0;
         if (BN_num_bits(k) <= BN_num_bits(order))
             if (!BN_add(k, k, order))
-                goto err;
+                return 0;
 
         /* compute r the x-coordinate of generator * k */
         if (!EC_POINT_mul(group, tmp_point, k, NULL, NULL, ctx)) {
             ECerr(EC_F_ECDSA_SIGN_SETUP, ERR_R_EC_LIB);
-            goto err;
+            return 0;
         }
         if (EC_METHOD_get_field_type(EC_GROUP_method_of(group)) ==
             NID_X9_62_prime_field) {
             if (!EC_POINT_get_affine_coordinates_GFp
                 (group, tmp_point, X, NULL, ctx)) {
                 ECerr(EC_F_ECDSA_SIGN_SETUP, ERR_R_EC_LIB);
-                goto err;
+                return 0;
             }
         }
 #ifndef OPENSSL_NO_EC2M
@@ -128,44 +99,108 @@ static int ecdsa_sign_setup(EC_KEY *eckey, BN_CTX *ctx_in,
                                                       tmp_point, X, NULL,
                                                       ctx)) {
                 ECerr(EC_F_ECDSA_SIGN_SETUP, ERR_R_EC_LIB);
-                goto err;
+                return 0;
             }
         }
 #endif
         if (!BN_nnmod(r, X, order, ctx)) {
             ECerr(EC_F_ECDSA_SIGN_SETUP, ERR_R_BN_LIB);
-            goto err;
+            return 0;
         }
     }
     while (BN_is_zero(r));
 
-    /* compute the inverse of k */
-    if (EC_GROUP_get_mont_data(group) != NULL) {
-        /*
-         * We want inverse in constant time, therefore we utilize the fact
-         * order must be prime and use Fermats Little Theorem instead.
-         */
-        if (!BN_set_word(X, 2)) {
-            ECerr(EC_F_ECDSA_SIGN_SETUP, ERR_R_BN_LIB);
-            goto err;
-        }
-        if (!BN_mod_sub(X, order, X, order, ctx)) {
-            ECerr(EC_F_ECDSA_SIGN_SETUP, ERR_R_BN_LIB);
-            goto err;
-        }
-        BN_set_flags(X, BN_FLG_CONSTTIME);
-        if (!BN_mod_exp_mont_consttime
-            (k, k, X, order, ctx, EC_GROUP_get_mont_data(group))) {
+    return 1;
+}
+
+/* Computes r = a^-1 modulo the order of |group| */
+static int ecdsa_inverse(const EC_GROUP *group, BIGNUM *r, const BIGNUM *a,
+                         BN_CTX *ctx)
+{
+    const BIGNUM *order = EC_GROUP_get0_order(group);
+    BIGNUM *e;
+    int ret = 0;
+
+    if (EC_GROUP_get_mont_data(group) == NULL) {
+        if (!BN_mod_inverse(r, a, order, ctx)) {
             ECerr(EC_F_ECDSA_SIGN_SETUP, ERR_R_BN_LIB);
-            goto err;
+            return 0;
         }
-    } else {
-        if (!BN_mod_inverse(k, k, order, ctx)) {
-            ECerr(EC_F_ECDSA_SIGN_SETUP, ERR_R_BN_LIB);
-            goto err;
+        return 1;
+    }
+
+    /*
+     * We want inverse in constant time, therefore we utilize the fact
+     * order must be prime and use Fermats Little Theorem instead.
+     */
+    BN_CTX_start(ctx);
+    if ((e = BN_CTX_get(ctx)) == NULL || !BN_set_word(e, 2)) {
+        ECerr(EC_F_ECDSA_SIGN_SETUP, ERR_R_BN_LIB);
+        goto err;
+    }
+    if (!BN_mod_sub(e, order, e, order, ctx)) {
+        ECerr(EC_F_ECDSA_SIGN_SETUP, ERR_R_BN_LIB);
+        goto err;
+    }
+    BN_set_flags(e, BN_FLG_CONSTTIME);
+    if (!BN_mod_exp_mont_consttime
+        (r, a, e, order, ctx, EC_GROUP_get_mont_data(group))) {
+        ECerr(EC_F_ECDSA_SIGN_SETUP, ERR_R_BN_LIB);
+        goto err;
+    }
+    ret = 1;
+ err:
+    BN_CTX_end(ctx);
+    return ret;
+}
+
+static int ecdsa_sign_setup(EC_KEY *eckey, BN_CTX *ctx_in,
+                            BIGNUM **kinvp, BIGNUM **rp,
+                            const unsigned char *dgst, int dlen)
+{
+    BN_CTX *ctx = NULL;
+    BIGNUM *k = NULL, *r = NULL, *X = NULL;
+    EC_POINT *tmp_point = NULL;
+    const EC_GROUP *group;
+    int ret = 0;
+
+    if (eckey == NULL || (group = EC_KEY_get0_group(eckey)) == NULL) {
+        ECerr(EC_F_ECDSA_SIGN_SETUP, ERR_R_PASSED_NULL_PARAMETER);
+        return 0;
+    }
+
+    if (!EC_KEY_can_sign(eckey)) {
+        ECerr(EC_F_ECDSA_SIGN_SETUP, EC_R_CURVE_DOES_NOT_SUPPORT_SIGNING);
+        return 0;
+    }
+
+    if (ctx_in == NULL) {
+        if ((ctx = BN_CTX_new()) == NULL) {
+            ECerr(EC_F_ECDSA_SIGN_SETUP, ERR_R_MALLOC_FAILURE);
+            return 0;
         }
+    } else
+        ctx = ctx_in;
+
+    k = BN_new();               /* this value is later returned in *kinvp */
+    r = BN_new();               /* this value is later returned in *rp */
+    X = BN_new();
+    if (k == NULL || r == NULL || X == NULL) {
+        ECerr(EC_F_ECDSA_SIGN_SETUP, ERR_R_MALLOC_FAILURE);
+        goto err;
+    }
+    if ((tmp_point = EC_POINT_new(group)) == NULL) {
+        ECerr(EC_F_ECDSA_SIGN_SETUP, ERR_R_EC_LIB);
+        goto err;
     }
 
+    if (!ecdsa_sign_nonce(eckey, ctx, k, r, X, tmp_point, dgst, dlen))
+        goto err;
+
+    /* compute the inverse of k */
+    if (!ecdsa_inverse(group, k, k, ctx))
+        goto err;
+
     /* clear old values if necessary */
     BN_clear_free(*rp);
     BN_clear_free(*kinvp);
@@ -191,6 +226,224 @@ int ossl_ecdsa_sign_setup(EC_KEY *eckey, BN_CTX *ctx_in, BIGNUM **kinvp,
     return ecdsa_sign_setup(eckey, ctx_in, kinvp, rp, NULL, 0);
 }
 
+/*
+ * Adds |num| (kinv, r) pairs to the pool of |eckey|.  The nonces are
+ * inverted together with a single modular inversion (Montgomery's trick):
+ * with p_i = k_0 * ... * k_i, k_i^-1 = p_i^-1 * p_(i-1) and
+ * p_(i-1)^-1 = p_i^-1 * k_i.
+ */
+int ossl_ecdsa_sign_setup_batch(EC_KEY *eckey, BN_CTX *ctx_in, size_t num)
+{
+    BN_CTX *ctx = NULL;
+    BIGNUM **k = NULL, *inv = NULL, *X = NULL;
+    EC_SIGN_SETUP **pairs = NULL, *tail;
+    EC_POINT *tmp_point = NULL;
+    const EC_GROUP *group;
+    const BIGNUM *order;
+    BN_MONT_CTX *mont;
+    size_t i;
+    int ret = 0;
+
+    if (eckey == NULL || (group = EC_KEY_get0_group(eckey)) == NULL) {
+        ECerr(EC_F_OSSL_ECDSA_SIGN_SETUP_BATCH, ERR_R_PASSED_NULL_PARAMETER);
+        return 0;
+    }
+
+    if (!EC_KEY_can_sign(eckey)) {
+        ECerr(EC_F_OSSL_ECDSA_SIGN_SETUP_BATCH,
+              EC_R_CURVE_DOES_NOT_SUPPORT_SIGNING);
+        return 0;
+    }
+
+    if (num == 0)
+        return 1;
+
+    if (ctx_in == NULL) {
+        if ((ctx = BN_CTX_new()) == NULL) {
+            ECerr(EC_F_OSSL_ECDSA_SIGN_SETUP_BATCH, ERR_R_MALLOC_FAILURE);
+            return 0;
+        }
+    } else
+        ctx = ctx_in;
+
+    k = OPENSSL_zalloc(sizeof(*k) * num);
+    pairs = OPENSSL_zalloc(sizeof(*pairs) * num);
+    inv = BN_new();
+    X = BN_new();
+    if (k == NULL || pairs == NULL || inv == NULL || X == NULL) {
+        ECerr(EC_F_OSSL_ECDSA_SIGN_SETUP_BATCH, ERR_R_MALLOC_FAILURE);
+        goto err;
+    }
+    if ((tmp_point = EC_POINT_new(group)) == NULL) {
+        ECerr(EC_F_OSSL_ECDSA_SIGN_SETUP_BATCH, ERR_R_EC_LIB);
+        goto err;
+    }
+    order = EC_GROUP_get0_order(group);
+    mont = EC_GROUP_get_mont_data(group);
+    BN_set_flags(inv, BN_FLG_CONSTTIME);
+
+    /*
+     * Pick k_i and compute r_i, with kinv holding p_i = k_0 * ... * k_i for
+     * now.  The nonces and their products are kept in Montgomery form when
+     * the group has a Montgomery context for its order, so that no plain
+     * (variable time) modular multiplication ever sees them.
+     */
+    for (i = 0; i < num; i++) {
+        if ((pairs[i] = OPENSSL_zalloc(sizeof(**pairs))) == NULL
+            || (pairs[i]->kinv = BN_new()) == NULL
+            || (pairs[i]->r = BN_new()) == NULL
+            || (k[i] = BN_new()) == NULL) {
+            ECerr(EC_F_OSSL_ECDSA_SIGN_SETUP_BATCH, ERR_R_MALLOC_FAILURE);
+            goto err;
+        }
+        BN_set_flags(k[i], BN_FLG_CONSTTIME);
+        BN_set_flags(pairs[i]->kinv, BN_FLG_CONSTTIME);
+        if (!ecdsa_sign_nonce(eckey, ctx, k[i], pairs[i]->r, X, tmp_point,
+                              NULL, 0))
+            goto err;
+        if (!BN_nnmod(k[i], k[i], order, ctx)
+            || (mont != NULL && !BN_to_montgomery(k[i], k[i], mont, ctx))) {
+            ECerr(EC_F_OSSL_ECDSA_SIGN_SETUP_BATCH, ERR_R_BN_LIB);
+            goto err;
+        }
+        if (i == 0) {
+            if (BN_copy(pairs[i]->kinv, k[i]) == NULL) {
+                ECerr(EC_F_OSSL_ECDSA_SIGN_SETUP_BATCH, ERR_R_BN_LIB);
+                goto err;
+            }
+        } else if (!(mont != NULL
+                     ? BN_mod_mul_montgomery(pairs[i]->kinv,
+                                             pairs[i - 1]->kinv, k[i],
+                                             mont, ctx)
+                     : BN_mod_mul(pairs[i]->kinv, pairs[i - 1]->kinv, k[i],
+                                  order, ctx))) {
+            ECerr(EC_F_OSSL_ECDSA_SIGN_SETUP_BATCH, ERR_R_BN_LIB);
+            goto err;
+        }
+    }
+
+    /* Invert p_{num-1}, taking it out of Montgomery form and back */
+    if (mont != NULL
+        && !BN_from_montgomery(pairs[num - 1]->kinv, pairs[num - 1]->kinv,
+                               mont, ctx)) {
+        ECerr(EC_F_OSSL_ECDSA_SIGN_SETUP_BATCH, ERR_R_BN_LIB);
+        goto err;
+    }
+    if (!ecdsa_inverse(group, inv, pairs[num - 1]->kinv, ctx))
+        goto err;
+    if (mont != NULL && !BN_to_montgomery(inv, inv, mont, ctx)) {
+        ECerr(EC_F_OSSL_ECDSA_SIGN_SETUP_BATCH, ERR_R_BN_LIB);
+        goto err;
+    }
+
+    /* Now inv = p_i^-1, so k_i^-1 = inv * p_{i-1} and p_{i-1}^-1 = inv * k_i */
+    for (i = num - 1; i > 0; i--) {
+        if (mont != NULL) {
+            if (!BN_mod_mul_montgomery(pairs[i]->kinv, inv, pairs[i - 1]->kinv,
+                                       mont, ctx)
+                || !BN_from_montgomery(pairs[i]->kinv, pairs[i]->kinv, mont,
+                                       ctx)
+                || !BN_mod_mul_montgomery(inv, inv, k[i], mont, ctx)) {
+                ECerr(EC_F_OSSL_ECDSA_SIGN_SETUP_BATCH, ERR_R_BN_LIB);
+                goto err;
+            }
+        } else if (!BN_mod_mul(pairs[i]->kinv, inv, pairs[i - 1]->kinv,
+                               order, ctx)
+                   || !BN_mod_mul(inv, inv, k[i], order, ctx)) {
+            ECerr(EC_F_OSSL_ECDSA_SIGN_SETUP_BATCH, ERR_R_BN_LIB);
+            goto err;
+        }
+    }
+    if (!(mont != NULL ? BN_from_montgomery(pairs[0]->kinv, inv, mont, ctx)
+                       : BN_copy(pairs[0]->kinv, inv) != NULL)) {
+        ECerr(EC_F_OSSL_ECDSA_SIGN_SETUP_BATCH, ERR_R_BN_LIB);
+        goto err;
+    }
+
+    for (i = 0; i + 1 < num; i++)
+        pairs[i]->next = pairs[i + 1];
+    tail = pairs[num - 1];
+
+    CRYPTO_THREAD_write_lock(eckey->lock);
+    tail->next = eckey->sign_setup;
+    eckey->sign_setup = pairs[0];
+    eckey->sign_setup_num += num;
+    CRYPTO_THREAD_unlock(eckey->lock);
+    ret = 1;
+
+ err:
+    if (k != NULL) {
+        for (i = 0; i < num; i++)
+            BN_clear_free(k[i]);
+        OPENSSL_free(k);
+    }
+    if (pairs != NULL) {
+        for (i = 0; !ret && i < num; i++) {
+            if (pairs[i] != NULL) {
+                BN_clear_free(pairs[i]->kinv);
+                BN_clear_free(pairs[i]->r);
+                OPENSSL_free(pairs[i]);
+            }
+        }
+        OPENSSL_free(pairs);
+    }
+    if (ctx != ctx_in)
+        BN_CTX_free(ctx);
+    EC_POINT_free(tmp_point);
+    BN_clear_free(inv);
+    BN_clear_free(X);
+    return ret;
+}
+
+/*
+ * Takes a (kinv, r) pair from the pool of |eckey| in the manner of
+ * ecdsa_sign_setup().  Returns 0 if the pool is empty.
+ */
+static int ecdsa_sign_setup_pop(EC_KEY *eckey, BIGNUM **kinvp, BIGNUM **rp)
+{
+    EC_SIGN_SETUP *pair;
+
+    CRYPTO_THREAD_write_lock(eckey->lock);
+    if ((pair = eckey->sign_setup) != NULL) {
+        eckey->sign_setup = pair->next;
+        eckey->sign_setup_num--;
+    }
+    CRYPTO_THREAD_unlock(eckey->lock);
+    if (pair == NULL)
+        return 0;
+
+    BN_clear_free(*rp);
+    BN_clear_free(*kinvp);
+    *rp = pair->r;
+    *kinvp = pair->kinv;
+    OPENSSL_free(pair);
+    return 1;
+}
+
+size_t ossl_ecdsa_sign_setup_count(const EC_KEY *eckey)
+{
+    size_t num;
+
+    CRYPTO_THREAD_read_lock(eckey->lock);
+    num = eckey->sign_setup_num;
+    CRYPTO_THREAD_unlock(eckey->lock);
+    return num;
+}
+
+/* Discards the pool of |eckey|, which must not be in use by other threads */
+void ossl_ecdsa_sign_setup_clear(EC_KEY *eckey)
+{
+    EC_SIGN_SETUP *pair;
+
+    while ((pair = eckey->sign_setup) != NULL) {
+        eckey->sign_setup = pair->next;
+        BN_clear_free(pair->kinv);
+        BN_clear_free(pair->r);
+        OPENSSL_free(pair);
+    }
+    eckey->sign_setup_num = 0;
+}
+
 ECDSA_SIG *ossl_ecdsa_sign_sig(const unsigned char *dgst, int dgst_len,
                                const BIGNUM *in_kinv, const BIGNUM *in_r,
                                EC_KEY *eckey)
@@ -257,7 +510,10 @@ ECDSA_SIG *ossl_ecdsa_sign_sig(const unsigned char *dgst, int dgst_len,
     }
     do {
         if (in_kinv == NULL || in_r == NULL) {
-            if (!ecdsa_sign_setup(eckey, ctx, &kinv, &ret->r, dgst, dgst_len)) {
+            /* Use a precomputed pair if there is one */
+            if (!ecdsa_sign_setup_pop(eckey, &kinv, &ret->r)
+                && !ecdsa_sign_setup(eckey, ctx, &kinv, &ret->r, dgst,
+                                     dgst_len)) {
                 ECerr(EC_F_OSSL_ECDSA_SIGN_SIG, ERR_R_ECDSA_LIB);
                 goto err;
             }
@@ -341,62 +597,68 @@ int ossl_ecdsa_verify(int type, const unsigned char *dgst, int dgst_len,
     return (ret);
 }
 
-int ossl_ecdsa_verify_sig(const unsigned char *dgst, int dgst_len,
-                          const ECDSA_SIG *sig, EC_KEY *eckey)
+/*
+ * Checks that |eckey| can verify and that r and s are in range.  Returns 1
+ * if they are, 0 if the signature is invalid and -1 on error.
+ */
+static int ecdsa_verify_check(const ECDSA_SIG *sig, EC_KEY *eckey)
 {
-    int ret = -1, i;
-    BN_CTX *ctx;
-    const BIGNUM *order;
-    BIGNUM *u1, *u2, *m, *X;
-    EC_POINT *point = NULL;
     const EC_GROUP *group;
-    const EC_POINT *pub_key;
+    const BIGNUM *order;
 
-    /* check input values */
     if (eckey == NULL || (group = EC_KEY_get0_group(eckey)) == NULL ||
-        (pub_key = EC_KEY_get0_public_key(eckey)) == NULL || sig == NULL) {
-        ECerr(EC_F_OSSL_ECDSA_VERIFY_SIG, EC_R_MISSING_PARAMETERS);
+        EC_KEY_get0_public_key(eckey) == NULL || sig == NULL) {
+        ECerr(EC_F_ECDSA_VERIFY_CHECK, EC_R_MISSING_PARAMETERS);
         return -1;
     }
 
     if (!EC_KEY_can_sign(eckey)) {
-        ECerr(EC_F_OSSL_ECDSA_VERIFY_SIG, EC_R_CURVE_DOES_NOT_SUPPORT_SIGNING);
+        ECerr(EC_F_ECDSA_VERIFY_CHECK, EC_R_CURVE_DOES_NOT_SUPPORT_SIGNING);
         return -1;
     }
 
-    ctx = BN_CTX_new();
-    if (ctx == NULL) {
-        ECerr(EC_F_OSSL_ECDSA_VERIFY_SIG, ERR_R_MALLOC_FAILURE);
+    order = EC_GROUP_get0_order(group);
+    if (order == NULL) {
+        ECerr(EC_F_ECDSA_VERIFY_CHECK, ERR_R_EC_LIB);
         return -1;
     }
+
+    if (BN_is_zero(sig->r) || BN_is_negative(sig->r) ||
+        BN_ucmp(sig->r, order) >= 0 || BN_is_zero(sig->s) ||
+        BN_is_negative(sig->s) || BN_ucmp(sig->s, order) >= 0) {
+        ECerr(EC_F_ECDSA_VERIFY_CHECK, EC_R_BAD_SIGNATURE);
+        return 0;               /* signature is invalid */
+    }
+    return 1;
+}
+
+/*
+ * Completes the verification of a signature that passed ecdsa_verify_check()
+ * given |sinv| = s^-1 mod order.  Returns 1 if the signature is valid, 0 if
+ * it is not and -1 on error.
+ */
+static int ecdsa_verify_sinv(const unsigned char *dgst, int dgst_len,
+                             const ECDSA_SIG *sig, const BIGNUM *sinv,
+                             EC_KEY *eckey, BN_CTX *ctx)
+{
+    int ret = -1, i;
+    const BIGNUM *order;
+    BIGNUM *u1, *u2, *m, *X;
+    EC_POINT *point = NULL;
+    const EC_GROUP *group = EC_KEY_get0_group(eckey);
+    const EC_POINT *pub_key = EC_KEY_get0_public_key(eckey);
+
     BN_CTX_start(ctx);
     u1 = BN_CTX_get(ctx);
     u2 = BN_CTX_get(ctx);
     m = BN_CTX_get(ctx);
     X = BN_CTX_get(ctx);
     if (X == NULL) {
-        ECerr(EC_F_OSSL_ECDSA_VERIFY_SIG, ERR_R_BN_LIB);
+        ECerr(EC_F_ECDSA_VERIFY_SINV, ERR_R_BN_LIB);
         goto err;
     }
 
     order = EC_GROUP_get0_order(group);
-    if (order == NULL) {
-        ECerr(EC_F_OSSL_ECDSA_VERIFY_SIG, ERR_R_EC_LIB);
-        goto err;
-    }
-
-    if (BN_is_zero(sig->r) || BN_is_negative(sig->r) ||
-        BN_ucmp(sig->r, order) >= 0 || BN_is_zero(sig->s) ||
-        BN_is_negative(sig->s) || BN_ucmp(sig->s, order) >= 0) {
-        ECerr(EC_F_OSSL_ECDSA_VERIFY_SIG, EC_R_BAD_SIGNATURE);
-        ret = 0;                /* signature is invalid */
-        goto err;
-    }
-    /* calculate tmp1 = inv(S) mod order */
-    if (!BN_mod_inverse(u2, sig->s, order, ctx)) {
-        ECerr(EC_F_OSSL_ECDSA_VERIFY_SIG, ERR_R_BN_LIB);
-        goto err;
-    }
     /* digest -> m */
     i = BN_num_bits(order);
     /*
@@ -405,37 +667,38 @@ int ossl_ecdsa_verify_sig(const unsigned char *dgst, int dgst_len,
     if (8 * dgst_len > i)
         dgst_len = (i + 7) / 8;
     if (!BN_bin2bn(dgst, dgst_len, m)) {
-        ECerr(EC_F_OSSL_ECDSA_VERIFY_SIG, ERR_R_BN_LIB);
+        ECerr(EC_F_ECDSA_VERIFY_SINV, ERR_R_BN_LIB);
         goto err;
     }
     /* If still too long truncate remaining bits with a shift */
     if ((8 * dgst_len > i) && !BN_rshift(m, m, 8 - (i & 0x7))) {
-        ECerr(EC_F_OSSL_ECDSA_VERIFY_SIG, ERR_R_BN_LIB);
+        ECerr(EC_F_ECDSA_VERIFY_SINV, ERR_R_BN_LIB);
         goto err;
     }
     /* u1 = m * tmp mod order */
-    if (!BN_mod_mul(u1, m, u2, order, ctx)) {
-        ECerr(EC_F_OSSL_ECDSA_VERIFY_SIG, ERR_R_BN_LIB);
+    if (!BN_mod_mul(u1, m, sinv, order, ctx)) {
+        ECerr(EC_F_ECDSA_VERIFY_SINV, ERR_R_BN_LIB);
         goto err;
     }
     /* u2 = r * w mod q */
-    if (!BN_mod_mul(u2, sig->r, u2, order, ctx)) {
-        ECerr(EC_F_OSSL_ECDSA_VERIFY_SIG, ERR_R_BN_LIB);
+    if (!BN_mod_mul(u2, sig->r, sinv, order, ctx)) {
+        ECerr(EC_F_ECDSA_VERIFY_SINV, ERR_R_BN_LIB);
         goto err;
     }
 
     if ((point = EC_POINT_new(group)) == NULL) {
-        ECerr(EC_F_OSSL_ECDSA_VERIFY_SIG, ERR_R_MALLOC_FAILURE);
+        ECerr(EC_F_ECDSA_VERIFY_SINV, ERR_R_MALLOC_FAILURE);
         goto err;
     }
-    if (!EC_POINT_mul(group, point, u1, pub_key, u2, ctx)) {
-        ECerr(EC_F_OSSL_ECDSA_VERIFY_SIG, ERR_R_EC_LIB);
+    /* Everything here is public, so variable-time code may be used */
+    if (!ec_point_mul_public(group, point, u1, pub_key, u2, ctx)) {
+        ECerr(EC_F_ECDSA_VERIFY_SINV, ERR_R_EC_LIB);
         goto err;
     }
     if (EC_METHOD_get_field_type(EC_GROUP_method_of(group)) ==
         NID_X9_62_prime_field) {
         if (!EC_POINT_get_affine_coordinates_GFp(group, point, X, NULL, ctx)) {
-            ECerr(EC_F_OSSL_ECDSA_VERIFY_SIG, ERR_R_EC_LIB);
+            ECerr(EC_F_ECDSA_VERIFY_SINV, ERR_R_EC_LIB);
             goto err;
         }
     }
@@ -443,20 +706,180 @@ int ossl_ecdsa_verify_sig(const unsigned char *dgst, int dgst_len,
     else {                      /* NID_X9_62_characteristic_two_field */
 
         if (!EC_POINT_get_affine_coordinates_GF2m(group, point, X, NULL, ctx)) {
-            ECerr(EC_F_OSSL_ECDSA_VERIFY_SIG, ERR_R_EC_LIB);
+            ECerr(EC_F_ECDSA_VERIFY_SINV, ERR_R_EC_LIB);
             goto err;
         }
     }
 #endif
     if (!BN_nnmod(u1, X, order, ctx)) {
-        ECerr(EC_F_OSSL_ECDSA_VERIFY_SIG, ERR_R_BN_LIB);
+        ECerr(EC_F_ECDSA_VERIFY_SINV, ERR_R_BN_LIB);
         goto err;
     }
     /*  if the signature is correct u1 is equal to sig->r */
     ret = (BN_ucmp(u1, sig->r) == 0);
  err:
     BN_CTX_end(ctx);
-    BN_CTX_free(ctx);
     EC_POINT_free(point);
     return ret;
 }
+
+int ossl_ecdsa_verify_sig(const unsigned char *dgst, int dgst_len,
+                          const ECDSA_SIG *sig, EC_KEY *eckey)
+{
+    int ret;
+    BN_CTX *ctx;
+    BIGNUM *sinv;
+
+    if ((ret = ecdsa_verify_check(sig, eckey)) != 1)
+        return ret;
+
+    ctx = BN_CTX_new();
+    if (ctx == NULL) {
+        ECerr(EC_F_OSSL_ECDSA_VERIFY_SIG, ERR_R_MALLOC_FAILURE);
+        return -1;
+    }
+    BN_CTX_start(ctx);
+    ret = -1;
+    if ((sinv = BN_CTX_get(ctx)) == NULL) {
+        ECerr(EC_F_OSSL_ECDSA_VERIFY_SIG, ERR_R_BN_LIB);
+        goto err;
+    }
+    /* calculate tmp1 = inv(S) mod order */
+    if (!BN_mod_inverse(sinv, sig->s, EC_GROUP_get0_order(eckey->group),
+                        ctx)) {
+        ECerr(EC_F_OSSL_ECDSA_VERIFY_SIG, ERR_R_BN_LIB);
+        goto err;
+    }
+    ret = ecdsa_verify_sinv(dgst, dgst_len, sig, sinv, eckey, ctx);
+ err:
+    BN_CTX_end(ctx);
+    BN_CTX_free(ctx);
+    return ret;
+}
+
+/*
+ * Verifies |num| signatures.  Signatures whose keys use the default method
+ * and share a group order have their s values inverted together, with one
+ * modular inversion in total (Montgomery's trick); the rest go through
+ * ECDSA_do_verify().  results[i] receives the outcome for signature i.
+ */
+int ossl_ecdsa_verify_batch(const unsigned char *const dgsts[],
+                            const int dgst_lens[],
+                            const ECDSA_SIG *const sigs[],
+                            EC_KEY *const keys[], size_t num, int results[])
+{
+    BN_CTX *ctx = NULL;
+    BIGNUM **prod = NULL, *inv, *sinv;
+    const BIGNUM *order;
+    size_t *idx = NULL, i, j, n;
+    int *pending = NULL, ret = -1;
+
+    if ((ctx = BN_CTX_new()) == NULL) {
+        ECerr(EC_F_OSSL_ECDSA_VERIFY_BATCH, ERR_R_MALLOC_FAILURE);
+        return -1;
+    }
+    BN_CTX_start(ctx);
+    prod = OPENSSL_zalloc(sizeof(*prod) * num);
+    idx = OPENSSL_malloc(sizeof(*idx) * num);
+    pending = OPENSSL_zalloc(sizeof(*pending) * num);
+    if (prod == NULL || idx == NULL || pending == NULL) {
+        ECerr(EC_F_OSSL_ECDSA_VERIFY_BATCH, ERR_R_MALLOC_FAILURE);
+        goto err;
+    }
+    inv = BN_CTX_get(ctx);
+    sinv = BN_CTX_get(ctx);
+    if (sinv == NULL) {
+        ECerr(EC_F_OSSL_ECDSA_VERIFY_BATCH, ERR_R_BN_LIB);
+        goto err;
+    }
+
+    for (i = 0; i < num; i++) {
+        if (keys[i] != NULL
+            && keys[i]->meth->verify_sig != ossl_ecdsa_verify_sig)
+            results[i] = ECDSA_do_verify(dgsts[i], dgst_lens[i], sigs[i],
+                                         keys[i]);
+        else if ((results[i] = ecdsa_verify_check(sigs[i], keys[i])) == 1)
+            pending[i] = 1;
+    }
+
+    for (i = 0; i < num; i++) {
+        if (!pending[i])
+            continue;
+
+        /* Collect the pending signatures with the same order as this one */
+        order = EC_GROUP_get0_order(keys[i]->group);
+        for (j = i, n = 0; j < num; j++) {
+            if (pending[j]
+                && BN_cmp(EC_GROUP_get0_order(keys[j]->group), order) == 0) {
+                idx[n++] = j;
+                pending[j] = 0;
+            }
+        }
+
+        /* prod[j] = s_0 * ... * s_j */
+        for (j = 0; j < n; j++) {
+            if (prod[j] == NULL && (prod[j] = BN_new()) == NULL) {
+                ECerr(EC_F_OSSL_ECDSA_VERIFY_BATCH, ERR_R_MALLOC_FAILURE);
+                goto err;
+            }
+            if (!(j == 0 ? BN_copy(prod[j], sigs[idx[j]]->s) != NULL
+                         : BN_mod_mul(prod[j], prod[j - 1], sigs[idx[j]]->s,
+                                      order, ctx))) {
+                ECerr(EC_F_OSSL_ECDSA_VERIFY_BATCH, ERR_R_BN_LIB);
+                goto err;
+            }
+        }
+
+        if (BN_mod_inverse(inv, prod[n - 1], order, ctx) == NULL) {
+            /* Some s is not invertible: fall back to one at a time */
+            ERR_clear_error();
+            for (j = 0; j < n; j++)
+                results[idx[j]] = ossl_ecdsa_verify_sig(dgsts[idx[j]],
+                                                        dgst_lens[idx[j]],
+                                                        sigs[idx[j]],
+                                                        keys[idx[j]]);
+            continue;
+        }
+
+        /* Walk back: s_j^-1 = inv * prod[j - 1], then inv = inv * s_j */
+        for (j = n; j-- > 0; ) {
+            if (j == 0) {
+                if (BN_copy(sinv, inv) == NULL) {
+                    ECerr(EC_F_OSSL_ECDSA_VERIFY_BATCH, ERR_R_BN_LIB);
+                    goto err;
+                }
+            } else if (!BN_mod_mul(sinv, inv, prod[j - 1], order, ctx)
+                       || !BN_mod_mul(inv, inv, sigs[idx[j]]->s, order,
+                                      ctx)) {
+                ECerr(EC_F_OSSL_ECDSA_VERIFY_BATCH, ERR_R_BN_LIB);
+                goto err;
+            }
+            results[idx[j]] = ecdsa_verify_sinv(dgsts[idx[j]],
+                                                dgst_lens[idx[j]],
+                                                sigs[idx[j]], sinv,
+                                                keys[idx[j]], ctx);
+        }
+    }
+
+    ret = 1;
+    for (i = 0; i < num; i++) {
+        if (results[i] < 0) {
+            ret = -1;
+            break;
+        }
+        if (results[i] == 0)
+            ret = 0;
+    }
+
+ err:
+    if (prod != NULL) {
+        for (i = 0; i < num; i++)
+            BN_free(prod[i]);
+        OPENSSL_free(prod);
+    }
+    OPENSSL_free(idx);
+    OPENSSL_free(pending);
+    BN_CTX_end(ctx);
+    BN_CTX_free(ctx);
+    return ret;
+}
@@ -50,3 +50,20 @@ int ECDSA_sign_setup(EC_KEY *eckey, BN_CTX *ctx_in, BIGNUM **kinvp,
     ECerr(EC_F_ECDSA_SIGN_SETUP, EC_R_OPERATION_NOT_SUPPORTED);
     return 0;
 }
+
+/*
+ * The pool is only consumed by the built-in signing code, so other methods
+ * cannot use it.
+ */
+int ECDSA_sign_setup_batch(EC_KEY *eckey, BN_CTX *ctx, size_t num)
+{
+    if (eckey->meth->sign_sig == ossl_ecdsa_sign_sig)
+        return ossl_ecdsa_sign_setup_batch(eckey, ctx, num);
+    ECerr(EC_F_ECDSA_SIGN_SETUP_BATCH, EC_R_OPERATION_NOT_SUPPORTED);
+    return 0;
+}
+
+size_t ECDSA_sign_setup_count(const EC_KEY *eckey)
+{
+    return ossl_ecdsa_sign_setup_count(eckey);
+}
@@ -26,6 +26,34 @@ int ECDSA_do_verify(const unsigned char *dgst, int dgst_len,
     return 0;
 }
 
+/*-
+ * returns
+ *      1: all signatures are correct
+ *      0: at least one signature is incorrect
+ *     -1: error
+ */
+int ECDSA_do_verify_batch(const unsigned char *const dgsts[],
+                          const int dgst_lens[], const ECDSA_SIG *const sigs[],
+                          EC_KEY *const keys[], size_t num, int results[])
+{
+    int *res = results, ret;
+
+    if (num == 0)
+        return 1;
+    if (dgsts == NULL || dgst_lens == NULL || sigs == NULL || keys == NULL) {
+        ECerr(EC_F_ECDSA_DO_VERIFY_BATCH, ERR_R_PASSED_NULL_PARAMETER);
+        return -1;
+    }
+    if (res == NULL && (res = OPENSSL_malloc(sizeof(*res) * num)) == NULL) {
+        ECerr(EC_F_ECDSA_DO_VERIFY_BATCH, ERR_R_MALLOC_FAILURE);
+        return -1;
+    }
+    ret = ossl_ecdsa_verify_batch(dgsts, dgst_lens, sigs, keys, num, res);
+    if (res != results)
+        OPENSSL_free(res);
+    return ret;
+}
+
 /*-
  * returns
  *      1: correct signature
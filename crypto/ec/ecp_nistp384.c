@@ -0,0 +1,1751 @@
+/*
+ * Copyright 2017 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the OpenSSL license (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+/*
+ * A 64-bit implementation of the NIST P-384 elliptic curve point multiplication
+ *
+ * The point arithmetic, the precomputation and the OpenSSL integration follow
+ * ecp_nistp256.c and ecp_nistp521.c. Unlike those, field elements are kept in
+ * Montgomery form in six full 64-bit limbs and are fully reduced after every
+ * operation, so there are no limb bounds to track.
+ */
+
+#include <openssl/opensslconf.h>
+#ifdef OPENSSL_NO_EC_NISTP_64_GCC_128
+NON_EMPTY_TRANSLATION_UNIT
+#else
+
+# include <stdint.h>
+# include <string.h>
+# include <openssl/err.h>
+# include "ec_lcl.h"
+
+# if defined(__GNUC__) && (__GNUC__ > 3 || (__GNUC__ == 3 && __GNUC_MINOR__ >= 1))
+  /* even with gcc, the typedef won't work for 32-bit platforms */
+typedef __uint128_t uint128_t;  /* nonstandard; implemented by gcc on 64-bit
+                                 * platforms */
+# else
+#  error "Need GCC 3.1 or later to define type uint128_t"
+# endif
+
+typedef uint8_t u8;
+typedef uint64_t u64;
+
+/*
+ * The underlying field. P384 operates over GF(2^384 - 2^128 - 2^96 + 2^32 -
+ * 1). We can serialise an element of this field into 48 bytes. We call this
+ * an felem_bytearray.
+ */
+
+typedef u8 felem_bytearray[48];
+
+/*
+ * These are the parameters of P384, taken from FIPS 186-3, section D.1.2.4.
+ * These values are big-endian.
+ */
+static const felem_bytearray nistp384_curve_params[5] = {
+    {0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, /* p */
+     0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+     0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+     0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfe,
+     0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff},
+    {0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, /* a = -3 */
+     0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+     0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+     0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfe,
+     0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0x00,
+     0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xfc},
+    {0xb3, 0x31, 0x2f, 0xa7, 0xe2, 0x3e, 0xe7, 0xe4, /* b */
+     0x98, 0x8e, 0x05, 0x6b, 0xe3, 0xf8, 0x2d, 0x19,
+     0x18, 0x1d, 0x9c, 0x6e, 0xfe, 0x81, 0x41, 0x12,
+     0x03, 0x14, 0x08, 0x8f, 0x50, 0x13, 0x87, 0x5a,
+     0xc6, 0x56, 0x39, 0x8d, 0x8a, 0x2e, 0xd1, 0x9d,
+     0x2a, 0x85, 0xc8, 0xed, 0xd3, 0xec, 0x2a, 0xef},
+    {0xaa, 0x87, 0xca, 0x22, 0xbe, 0x8b, 0x05, 0x37, /* x */
+     0x8e, 0xb1, 0xc7, 0x1e, 0xf3, 0x20, 0xad, 0x74,
+     0x6e, 0x1d, 0x3b, 0x62, 0x8b, 0xa7, 0x9b, 0x98,
+     0x59, 0xf7, 0x41, 0xe0, 0x82, 0x54, 0x2a, 0x38,
+     0x55, 0x02, 0xf2, 0x5d, 0xbf, 0x55, 0x29, 0x6c,
+     0x3a, 0x54, 0x5e, 0x38, 0x72, 0x76, 0x0a, 0xb7},
+    {0x36, 0x17, 0xde, 0x4a, 0x96, 0x26, 0x2c, 0x6f, /* y */
+     0x5d, 0x9e, 0x98, 0xbf, 0x92, 0x92, 0xdc, 0x29,
+     0xf8, 0xf4, 0x1d, 0xbd, 0x28, 0x9a, 0x14, 0x7c,
+     0xe9, 0xda, 0x31, 0x13, 0xb5, 0xf0, 0xb8, 0xc0,
+     0x0a, 0x60, 0xb1, 0xce, 0x1d, 0x7e, 0x81, 0x9d,
+     0x7a, 0x43, 0x1d, 0x7c, 0x90, 0xea, 0x0e, 0x5f}
+};
+
+/*-
+ * The representation of field elements.
+ * ------------------------------------
+ *
+ * A field element a is represented by a * 2^384 mod p (its Montgomery form)
+ * in six 64-bit limbs, least significant first:
+ *   v[0]*2^0 + v[1]*2^64 + v[2]*2^128 + ... + v[5]*2^320
+ * Every operation below takes and returns fully reduced values, i.e.
+ * 0 <= v < p, and runs in time independent of the values involved.
+ */
+
+# define NLIMBS 6
+
+typedef uint64_t limb;
+typedef limb felem[NLIMBS];
+
+static const felem kPrime = {
+    0x00000000ffffffff, 0xffffffff00000000, 0xfffffffffffffffe,
+    0xffffffffffffffff, 0xffffffffffffffff, 0xffffffffffffffff
+};
+
+/* -p^-1 mod 2^64 */
+static const limb kPrimeInv = 0x0000000100000001;
+
+/* 2^768 mod p, used to convert into Montgomery form */
+static const felem kRR = {
+    0xfffffffe00000001, 0x0000000200000000, 0xfffffffe00000000,
+    0x0000000200000000, 0x0000000000000001, 0x0000000000000000
+};
+
+/* 2^384 mod p, i.e. 1 in Montgomery form */
+static const felem kOne = {
+    0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+    0x0000000000000000, 0x0000000000000000, 0x0000000000000000
+};
+
+/*-
+ * Field operations
+ * ----------------
+ */
+
+static void felem_one(felem out)
+{
+    memcpy(out, kOne, sizeof(felem));
+}
+
+static void felem_assign(felem out, const felem in)
+{
+    memcpy(out, in, sizeof(felem));
+}
+
+/*
+ * felem_reduce_once sets out = (carry:in) - p if that is not negative and
+ * out = in otherwise. |carry| is the bit above the top limb of |in|.
+ */
+static void felem_reduce_once(felem out, const felem in, limb carry)
+{
+    felem tmp;
+    uint128_t t;
+    limb borrow = 0, mask;
+    unsigned i;
+
+    for (i = 0; i < NLIMBS; i++) {
+        t = (uint128_t)in[i] - kPrime[i] - borrow;
+        tmp[i] = (limb)t;
+        borrow = (limb)(t >> 64) & 1;
+    }
+    /* all ones if the subtraction went below zero */
+    mask = 0 - (borrow & (carry ^ 1));
+    for (i = 0; i < NLIMBS; i++)
+        out[i] = (in[i] & mask) | (tmp[i] & ~mask);
+}
+
+/* felem_add sets out = in1 + in2 */
+static void felem_add(felem out, const felem in1, const felem in2)
+{
+    felem tmp;
+    uint128_t t = 0;
+    unsigned i;
+
+    for (i = 0; i < NLIMBS; i++) {
+        t += (uint128_t)in1[i] + in2[i];
+        tmp[i] = (limb)t;
+        t >>= 64;
+    }
+    felem_reduce_once(out, tmp, (limb)t);
+}
+
+/* felem_sub sets out = in1 - in2 */
+static void felem_sub(felem out, const felem in1, const felem in2)
+{
+    uint128_t t;
+    limb borrow = 0, carry = 0, mask;
+    unsigned i;
+
+    for (i = 0; i < NLIMBS; i++) {
+        t = (uint128_t)in1[i] - in2[i] - borrow;
+        out[i] = (limb)t;
+        borrow = (limb)(t >> 64) & 1;
+    }
+    /* add p back if the subtraction went below zero */
+    mask = 0 - borrow;
+    for (i = 0; i < NLIMBS; i++) {
+        t = (uint128_t)out[i] + (kPrime[i] & mask) + carry;
+        out[i] = (limb)t;
+        carry = (limb)(t >> 64);
+    }
+}
+
+/* felem_neg sets out = -in */
+static void felem_neg(felem out, const felem in)
+{
+    static const felem zero = { 0 };
+
+    felem_sub(out, zero, in);
+}
+
+/*-
+ * felem_mont_reduce sets out = t * 2^-384 (mod p), where |t| is a 768-bit
+ * value less than p * 2^384. |t| is overwritten.
+ *
+ * Each round adds a multiple of p that clears the lowest remaining limb, so
+ * after NLIMBS rounds the result is in the top half of |t| and below 2p.
+ */
+static void felem_mont_reduce(felem out, limb t[2 * NLIMBS])
+{
+    limb m, carry = 0;
+    uint128_t acc;
+    unsigned i, j;
+
+    for (i = 0; i < NLIMBS; i++) {
+        m = t[i] * kPrimeInv;
+        acc = (uint128_t)m * kPrime[0] + t[i];
+        acc >>= 64;
+        for (j = 1; j < NLIMBS; j++) {
+            acc += (uint128_t)m * kPrime[j] + t[i + j];
+            t[i + j] = (limb)acc;
+            acc >>= 64;
+        }
+        acc += (uint128_t)t[i + NLIMBS] + carry;
+        t[i + NLIMBS] = (limb)acc;
+        carry = (limb)(acc >> 64);
+    }
+    felem_reduce_once(out, t + NLIMBS, carry);
+}
+
+/*-
+ * felem_mul sets out = in1 * in2 * 2^-384 (mod p), which is the Montgomery
+ * form of the product if the inputs are in Montgomery form.
+ */
+static void felem_mul(felem out, const felem in1, const felem in2)
+{
+    limb t[2 * NLIMBS];
+    uint128_t acc;
+    unsigned i, j;
+
+    acc = 0;
+    for (j = 0; j < NLIMBS; j++) {
+        acc += (uint128_t)in1[0] * in2[j];
+        t[j] = (limb)acc;
+        acc >>= 64;
+    }
+    t[NLIMBS] = (limb)acc;
+    for (i = 1; i < NLIMBS; i++) {
+        acc = 0;
+        for (j = 0; j < NLIMBS; j++) {
+            acc += (uint128_t)in1[i] * in2[j] + t[i + j];
+            t[i + j] = (limb)acc;
+            acc >>= 64;
+        }
+        t[i + NLIMBS] = (limb)acc;
+    }
+    felem_mont_reduce(out, t);
+}
+
+/* felem_square sets out = in^2 * 2^-384 (mod p) */
+static void felem_square(felem out, const felem in)
+{
+    limb t[2 * NLIMBS], lo, hi, top;
+    uint128_t acc;
+    unsigned i, j;
+
+    /* the products in[i] * in[j] for i < j, in t[1] .. t[2 * NLIMBS - 2] */
+    acc = 0;
+    for (j = 1; j < NLIMBS; j++) {
+        acc += (uint128_t)in[0] * in[j];
+        t[j] = (limb)acc;
+        acc >>= 64;
+    }
+    t[NLIMBS] = (limb)acc;
+    for (i = 1; i < NLIMBS - 1; i++) {
+        acc = 0;
+        for (j = i + 1; j < NLIMBS; j++) {
+            acc += (uint128_t)in[i] * in[j] + t[i + j];
+            t[i + j] = (limb)acc;
+            acc >>= 64;
+        }
+        t[i + NLIMBS] = (limb)acc;
+    }
+    t[0] = 0;
+    t[2 * NLIMBS - 1] = 0;
+    /* double them while adding the squares in[i]^2, two limbs at a time */
+    acc = 0;
+    top = 0;
+    for (i = 0; i < NLIMBS; i++) {
+        lo = (t[2 * i] << 1) | top;
+        hi = (t[2 * i + 1] << 1) | (t[2 * i] >> 63);
+        top = t[2 * i + 1] >> 63;
+        acc += (uint128_t)in[i] * in[i] + lo;
+        t[2 * i] = (limb)acc;
+        acc >>= 64;
+        acc += hi;
+        t[2 * i + 1] = (limb)acc;
+        acc >>= 64;
+    }
+    felem_mont_reduce(out, t);
+}
+
+/* felem_scalar sets out = in * scalar for a small public |scalar| > 0 */
+static void felem_scalar(felem out, const felem in, unsigned int scalar)
+{
+    felem tmp;
+    int i;
+
+    felem_assign(tmp, in);
+    for (i = 0; (scalar >> (i + 1)) != 0; i++)
+        continue;
+    felem_assign(out, tmp);
+    while (--i >= 0) {
+        felem_add(out, out, out);
+        if ((scalar >> i) & 1)
+            felem_add(out, out, tmp);
+    }
+}
+
+/* felem_square_n sets out = in^(2^n), with the Montgomery factors */
+static void felem_square_n(felem out, const felem in, unsigned int n)
+{
+    felem_assign(out, in);
+    while (n-- > 0)
+        felem_square(out, out);
+}
+
+/*-
+ * felem_inv calculates |out| = |in|^{-1}
+ *
+ * Based on Fermat's Little Theorem:
+ *   a^p = a (mod p)
+ *   a^{p-1} = 1 (mod p)
+ *   a^{p-2} = a^{-1} (mod p)
+ *
+ * In binary, p - 2 is 255 ones, a zero, 32 ones, 64 zeros, 30 ones, a zero
+ * and a one. The chain below builds in^(2^k - 1) for the run lengths that
+ * are needed, taking 385 squarings and 14 multiplications.
+ */
+static void felem_inv(felem out, const felem in)
+{
+    felem x2, x3, x6, x12, x15, x30, x32, t, u;
+
+    felem_square(x2, in);
+    felem_mul(x2, x2, in);              /* 2^2 - 1 */
+    felem_square(x3, x2);
+    felem_mul(x3, x3, in);              /* 2^3 - 1 */
+    felem_square_n(x6, x3, 3);
+    felem_mul(x6, x6, x3);              /* 2^6 - 1 */
+    felem_square_n(x12, x6, 6);
+    felem_mul(x12, x12, x6);            /* 2^12 - 1 */
+    felem_square_n(x15, x12, 3);
+    felem_mul(x15, x15, x3);            /* 2^15 - 1 */
+    felem_square_n(x30, x15, 15);
+    felem_mul(x30, x30, x15);           /* 2^30 - 1 */
+    felem_square_n(x32, x30, 2);
+    felem_mul(x32, x32, x2);            /* 2^32 - 1 */
+    felem_square_n(t, x30, 30);
+    felem_mul(t, t, x30);               /* 2^60 - 1 */
+    felem_square_n(u, t, 60);
+    felem_mul(t, u, t);                 /* 2^120 - 1 */
+    felem_square_n(u, t, 120);
+    felem_mul(t, u, t);                 /* 2^240 - 1 */
+    felem_square_n(t, t, 15);
+    felem_mul(t, t, x15);               /* 2^255 - 1 */
+    felem_square_n(t, t, 1 + 32);
+    felem_mul(t, t, x32);
+    felem_square_n(t, t, 64 + 30);
+    felem_mul(t, t, x30);
+    felem_square_n(t, t, 2);
+    felem_mul(out, t, in);
+}
+
+/*
+ * felem_is_zero returns a limb with all bits set if |in| == 0 (mod p) and 0
+ * otherwise.
+ */
+static limb felem_is_zero(const felem in)
+{
+    limb is_zero = 0;
+    unsigned i;
+
+    for (i = 0; i < NLIMBS; i++)
+        is_zero |= in[i];
+    /* the top bit of (x | -x) is set iff x != 0 */
+    is_zero = ((is_zero | (0 - is_zero)) >> 63) ^ 1;
+    return 0 - is_zero;
+}
+
+static int felem_is_zero_int(const felem in)
+{
+    return (int)(felem_is_zero(in) & ((limb) 1));
+}
+
+/*
+ * felem_contract converts |in| to its unique, minimal representation. Field
+ * elements are always fully reduced, so this is a copy.
+ */
+static void felem_contract(felem out, const felem in)
+{
+    felem_assign(out, in);
+}
+
+/* To preserve endianness when using BN_bn2bin and BN_bin2bn */
+static void flip_endian(u8 *out, const u8 *in, unsigned len)
+{
+    unsigned i;
+    for (i = 0; i < len; ++i)
+        out[i] = in[len - 1 - i];
+}
+
+/* BN_to_felem converts an OpenSSL BIGNUM into an felem */
+static int BN_to_felem(felem out, const BIGNUM *bn)
+{
+    felem_bytearray b_in;
+    felem_bytearray b_out;
+    felem tmp;
+    unsigned num_bytes, i, j;
+
+    /* BN_bn2bin eats leading zeroes */
+    memset(b_out, 0, sizeof(b_out));
+    num_bytes = BN_num_bytes(bn);
+    if (num_bytes > sizeof b_out) {
+        ECerr(EC_F_BN_TO_FELEM, EC_R_BIGNUM_OUT_OF_RANGE);
+        return 0;
+    }
+    if (BN_is_negative(bn)) {
+        ECerr(EC_F_BN_TO_FELEM, EC_R_BIGNUM_OUT_OF_RANGE);
+        return 0;
+    }
+    num_bytes = BN_bn2bin(bn, b_in);
+    flip_endian(b_out, b_in, num_bytes);
+    for (i = 0; i < NLIMBS; i++) {
+        tmp[i] = 0;
+        for (j = 0; j < 8; j++)
+            tmp[i] |= (limb)b_out[8 * i + j] << (8 * j);
+    }
+    /* tmp < 2^384, so the product below is reduced mod p */
+    felem_mul(out, tmp, kRR);
+    return 1;
+}
+
+/* felem_to_BN converts an felem into an OpenSSL BIGNUM */
+static BIGNUM *felem_to_BN(BIGNUM *out, const felem in)
+{
+    static const felem one = { 1 };
+    felem_bytearray b_in, b_out;
+    felem tmp;
+    unsigned i, j;
+
+    /* leave Montgomery form */
+    felem_mul(tmp, in, one);
+    for (i = 0; i < NLIMBS; i++)
+        for (j = 0; j < 8; j++)
+            b_in[8 * i + j] = (u8)(tmp[i] >> (8 * j));
+    flip_endian(b_out, b_in, sizeof b_out);
+    return BN_bin2bn(b_out, sizeof b_out, out);
+}
+
+static void felem_square_reduce(felem out, const felem in)
+{
+    felem_square(out, in);
+}
+
+static void felem_mul_reduce(felem out, const felem in1, const felem in2)
+{
+    felem_mul(out, in1, in2);
+}
+
+/*-
+ * Group operations
+ * ----------------
+ *
+ * Building on top of the field operations we have the operations on the
+ * elliptic curve group itself. Points on the curve are represented in Jacobian
+ * coordinates */
+
+/*-
+ * point_double calculates 2*(x_in, y_in, z_in)
+ *
+ * The method is taken from:
+ *   http://hyperelliptic.org/EFD/g1p/auto-shortw-jacobian-3.html#doubling-dbl-2001-b
+ *
+ * Outputs can equal corresponding inputs, i.e., x_out == x_in is allowed.
+ * while x_out == y_in is not (maybe this works, but it's not tested). */
+static void
+point_double(felem x_out, felem y_out, felem z_out,
+             const felem x_in, const felem y_in, const felem z_in)
+{
+    felem delta, gamma, beta, alpha, ftmp, ftmp2;
+
+    /* delta = z^2 */
+    felem_square(delta, z_in);
+
+    /* gamma = y^2 */
+    felem_square(gamma, y_in);
+
+    /* beta = x*gamma */
+    felem_mul(beta, x_in, gamma);
+
+    /* alpha = 3*(x-delta)*(x+delta) */
+    felem_sub(ftmp, x_in, delta);
+    felem_add(ftmp2, x_in, delta);
+    felem_scalar(ftmp2, ftmp2, 3);
+    felem_mul(alpha, ftmp, ftmp2);
+
+    /* x' = alpha^2 - 8*beta */
+    felem_square(ftmp, alpha);
+    felem_scalar(ftmp2, beta, 8);
+    felem_sub(ftmp, ftmp, ftmp2);
+
+    /* z' = (y + z)^2 - gamma - delta */
+    felem_add(delta, gamma, delta);
+    felem_add(ftmp2, y_in, z_in);
+    felem_square(z_out, ftmp2);
+    felem_sub(z_out, z_out, delta);
+
+    /* y' = alpha*(4*beta - x') - 8*gamma^2 */
+    felem_assign(x_out, ftmp);
+    felem_scalar(beta, beta, 4);
+    felem_sub(beta, beta, x_out);
+    felem_mul(ftmp, alpha, beta);
+    felem_square(ftmp2, gamma);
+    felem_scalar(ftmp2, ftmp2, 8);
+    felem_sub(y_out, ftmp, ftmp2);
+}
+
+/* copy_conditional copies in to out iff mask is all ones. */
+static void copy_conditional(felem out, const felem in, limb mask)
+{
+    unsigned i;
+    for (i = 0; i < NLIMBS; ++i) {
+        const limb tmp = mask & (in[i] ^ out[i]);
+        out[i] ^= tmp;
+    }
+}
+
+/*-
+ * point_add calculates (x1, y1, z1) + (x2, y2, z2)
+ *
+ * The method is taken from
+ *   http://hyperelliptic.org/EFD/g1p/auto-shortw-jacobian-3.html#addition-add-2007-bl,
+ * adapted for mixed addition (z2 = 1, or z2 = 0 for the point at infinity).
+ *
+ * This function includes a branch for checking whether the two input points
+ * are equal (while not equal to the point at infinity). This case never
+ * happens during single point multiplication, so there is no timing leak for
+ * ECDH or ECDSA signing. */
+static void point_add(felem x3, felem y3, felem z3,
+                      const felem x1, const felem y1, const felem z1,
+                      const int mixed, const felem x2, const felem y2,
+                      const felem z2)
+{
+    felem ftmp, ftmp2, ftmp3, ftmp4, ftmp5, ftmp6, x_out, y_out, z_out;
+    limb x_equal, y_equal, z1_is_zero, z2_is_zero;
+
+    z1_is_zero = felem_is_zero(z1);
+    z2_is_zero = felem_is_zero(z2);
+
+    /* ftmp = z1z1 = z1**2 */
+    felem_square(ftmp, z1);
+
+    if (!mixed) {
+        /* ftmp2 = z2z2 = z2**2 */
+        felem_square(ftmp2, z2);
+
+        /* u1 = ftmp3 = x1*z2z2 */
+        felem_mul(ftmp3, x1, ftmp2);
+
+        /* ftmp5 = (z1 + z2)**2 - z1z1 - z2z2 = 2*z1z2 */
+        felem_add(ftmp5, z1, z2);
+        felem_square(ftmp5, ftmp5);
+        felem_sub(ftmp5, ftmp5, ftmp);
+        felem_sub(ftmp5, ftmp5, ftmp2);
+
+        /* ftmp2 = z2 * z2z2 */
+        felem_mul(ftmp2, ftmp2, z2);
+
+        /* s1 = ftmp6 = y1 * z2**3 */
+        felem_mul(ftmp6, y1, ftmp2);
+    } else {
+        /*
+         * We'll assume z2 = 1 (special case z2 = 0 is handled later)
+         */
+
+        /* u1 = ftmp3 = x1*z2z2 */
+        felem_assign(ftmp3, x1);
+
+        /* ftmp5 = 2*z1z2 */
+        felem_add(ftmp5, z1, z1);
+
+        /* s1 = ftmp6 = y1 * z2**3 */
+        felem_assign(ftmp6, y1);
+    }
+
+    /* u2 = x2*z1z1 */
+    felem_mul(ftmp4, x2, ftmp);
+
+    /* h = ftmp4 = u2 - u1 */
+    felem_sub(ftmp4, ftmp4, ftmp3);
+
+    x_equal = felem_is_zero(ftmp4);
+
+    /* z_out = ftmp5 * h */
+    felem_mul(z_out, ftmp5, ftmp4);
+
+    /* ftmp = z1 * z1z1 */
+    felem_mul(ftmp, ftmp, z1);
+
+    /* s2 = ftmp5 = y2 * z1**3 */
+    felem_mul(ftmp5, y2, ftmp);
+
+    /* r = ftmp5 = (s2 - s1)*2 */
+    felem_sub(ftmp5, ftmp5, ftmp6);
+    y_equal = felem_is_zero(ftmp5);
+    felem_add(ftmp5, ftmp5, ftmp5);
+
+    if (x_equal && y_equal && !z1_is_zero && !z2_is_zero) {
+        point_double(x3, y3, z3, x1, y1, z1);
+        return;
+    }
+
+    /* I = ftmp = (2h)**2 */
+    felem_add(ftmp, ftmp4, ftmp4);
+    felem_square(ftmp, ftmp);
+
+    /* J = ftmp2 = h * I */
+    felem_mul(ftmp2, ftmp4, ftmp);
+
+    /* V = ftmp4 = U1 * I */
+    felem_mul(ftmp4, ftmp3, ftmp);
+
+    /* x_out = r**2 - J - 2V */
+    felem_square(x_out, ftmp5);
+    felem_sub(x_out, x_out, ftmp2);
+    felem_sub(x_out, x_out, ftmp4);
+    felem_sub(x_out, x_out, ftmp4);
+
+    /* y_out = r(V-x_out) - 2 * s1 * J */
+    felem_sub(ftmp4, ftmp4, x_out);
+    felem_mul(y_out, ftmp5, ftmp4);
+    felem_mul(ftmp2, ftmp6, ftmp2);
+    felem_add(ftmp2, ftmp2, ftmp2);
+    felem_sub(y_out, y_out, ftmp2);
+
+    copy_conditional(x_out, x2, z1_is_zero);
+    copy_conditional(x_out, x1, z2_is_zero);
+    copy_conditional(y_out, y2, z1_is_zero);
+    copy_conditional(y_out, y1, z2_is_zero);
+    copy_conditional(z_out, z2, z1_is_zero);
+    copy_conditional(z_out, z1, z2_is_zero);
+    felem_assign(x3, x_out);
+    felem_assign(y3, y_out);
+    felem_assign(z3, z_out);
+}
+
+/*-
+ * Base point pre computation
+ * --------------------------
+ *
+ * Two different sorts of precomputed tables are used in the following code.
+ * Each contain various points on the curve, where each point is three field
+ * elements (x, y, z).
+ *
+ * For the base point table, z is usually 1 (0 for the point at infinity).
+ * This table has 4 * 16 elements, starting with the following:
+ * index | bits    | point
+ * ------+---------+------------------------------
+ *     0 | 0 0 0 0 | 0G
+ *     1 | 0 0 0 1 | 1G
+ *     2 | 0 0 1 0 | 2^96G
+ *     3 | 0 0 1 1 | (2^96 + 1)G
+ *     4 | 0 1 0 0 | 2^192G
+ *     5 | 0 1 0 1 | (2^192 + 1)G
+ *     6 | 0 1 1 0 | (2^192 + 2^96)G
+ *     7 | 0 1 1 1 | (2^192 + 2^96 + 1)G
+ *     8 | 1 0 0 0 | 2^288G
+ *     9 | 1 0 0 1 | (2^288 + 1)G
+ *    10 | 1 0 1 0 | (2^288 + 2^96)G
+ *    11 | 1 0 1 1 | (2^288 + 2^96 + 1)G
+ *    12 | 1 1 0 0 | (2^288 + 2^192)G
+ *    13 | 1 1 0 1 | (2^288 + 2^192 + 1)G
+ *    14 | 1 1 1 0 | (2^288 + 2^192 + 2^96)G
+ *    15 | 1 1 1 1 | (2^288 + 2^192 + 2^96 + 1)G
+ * followed by three copies of this with each element multiplied by 2^24,
+ * 2^48 and 2^72 respectively.
+ *
+ * The reason for this is so that we can clock bits into four different
+ * locations when doing simple scalar multiplies against the base point,
+ * and then another four locations using each of the other sets of 16
+ * elements. This covers all 384 bits of a scalar in 24 doublings.
+ *
+ * The coordinates are in Montgomery form, like all field elements here.
+ *
+ * Tables for other points have table[i] = iG for i in 0 .. 16. */
+
+/* gmul is the table of precomputed base points */
+static const felem gmul[4][16][3] = {
+    {{{0, 0, 0, 0, 0, 0},
+      {0, 0, 0, 0, 0, 0},
+      {0, 0, 0, 0, 0, 0}},
+     {{0x3dd0756649c0b528, 0x20e378e2a0d6ce38, 0x879c3afc541b4d6e,
+       0x6454868459a30eff, 0x812ff723614ede2b, 0x4d3aadc2299e1513},
+      {0x23043dad4b03a4fe, 0xa1bfa8bf7bb4a9ac, 0x8bade7562e83b050,
+       0xc6c3521968f4ffd9, 0xdd8002263969a840, 0x2b78abc25a15c5e9},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}},
+     {{0x24480c57f26feef9, 0xc31a26943a0e1240, 0x735002c3273e2bc7,
+       0x8c42e9c53ef1ed4c, 0x028babf67f4948e8, 0x6a502f438a978632},
+      {0xf5f13a46b74536fe, 0x1d218babd8a9f0eb, 0x30f36bcc37232768,
+       0xc5317b31576e8c18, 0xef1d57a69bbcb766, 0x917c4930b3e3d4dc},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}},
+     {{0x11426e2ee349ddd0, 0x9f117ef99b2fc250, 0xff36b480ec0174a6,
+       0x4f4bde7618458466, 0x2f2edb6d05806049, 0x8adc75d119dfca92},
+      {0xa619d097b7d5a7ce, 0x874275e5a34411e9, 0x5403e0470da4b4ef,
+       0x2ebaafd977901d8f, 0x5e63ebcea747170f, 0x12a369447f9d8036},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}},
+     {{0x378205de2f9fbe67, 0xc4afcb837f728e44, 0xdbcec06c682e00f1,
+       0xf2a145c3114d5423, 0xa01d98747a52463e, 0xfc0935b17d717b0a},
+      {0x9653bc4fd4d01f95, 0x9aa83ea89560ad34, 0xf77943dcaf8e3f3f,
+       0x70774a10e86fe16e, 0x6b62e6f1bf9ffdcf, 0x8a72f39e588745c9},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}},
+     {{0x73ade4da2341c342, 0xdd326e54ea704422, 0x336c7d983741cef3,
+       0x1eafa00d59e61549, 0xcd3ed892bd9a3efd, 0x03faf26cc5c6c7e4},
+      {0x087e2fcf3045f8ac, 0x14a65532174f1e73, 0x2cf84f28fe0af9a7,
+       0xddfd7a842cdc935b, 0x4c0f117b6929c895, 0x356572d64c8bcfcc},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}},
+     {{0xfab086073f3b236f, 0x19e9d41d81e221da, 0xf3f6571e3927b428,
+       0x4348a9337550f1f6, 0x7167b996a85e62f0, 0x62d437597f5452bf},
+      {0xd85feb9ef2955926, 0x440a561f6df78353, 0x389668ec9ca36b59,
+       0x052bf1a1a22da016, 0xbdfbff72f6093254, 0x94e50f28e22209f3},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}},
+     {{0x90b2e5b33062e8af, 0xa8572375e8a3d369, 0x3fe1b00b201db7b1,
+       0xe926def0ee651aa2, 0x6542c9beb9b10ad7, 0x098e309ba2fcbe74},
+      {0x779deeb3fff1d63f, 0x23d0e80a20bfd374, 0x8452bb3b8768f797,
+       0xcf75bb4d1f952856, 0x8fe6b40029ea3faa, 0x12bd3e4081373a53},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}},
+     {{0x070d34e116973cf4, 0x20aee08b7e4f34f7, 0x269af9b95eb8ad29,
+       0xdde0a036a6a45dda, 0xa18b528e63df41e0, 0x03cc71b2a260df2a},
+      {0x24a6770aa06b1dd7, 0x5bfa9c119d2675d3, 0x73c1e2a196844432,
+       0x3660558d131a6cf0, 0xb0289c832ee79454, 0xa6aefb01c6d8ddcd},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}},
+     {{0xba1464b401ab5245, 0x9b8d0b6dc48d93ff, 0x939867dc93ad272c,
+       0xbebe085eae9fdc77, 0x73ae5103894ea8bd, 0x740fc89a39ac22e1},
+      {0x5e28b0a328e23b23, 0x2352722ee13104d0, 0xf4667a18b0a2640d,
+       0xac74a72e49bb37c3, 0x79f734f0e81e183a, 0xbffe5b6c3fd9c0eb},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}},
+     {{0x03cf292200623f3b, 0x095c71115f29ebff, 0x42d7224780aa6823,
+       0x044c7ba17458c0b0, 0xca62f7ef0959ec20, 0x40ae2ab7f8ca929f},
+      {0xb8c5377aa927b102, 0x398a86a0dc031771, 0x04908f9dc216a406,
+       0xb423a73a918d3300, 0x634b0ff1e0b94739, 0xe29de7252d69f697},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}},
+     {{0x744d14008435af04, 0x5f255b1dfec192da, 0x1f17dc12336dc542,
+       0x5c90c2a7636a68a8, 0x960c9eb77704ca1e, 0x9de8cf1e6fb3d65a},
+      {0xc60fee0d511d3d06, 0x466e2313f9eb52c7, 0x743c0f5f206b0914,
+       0x42f55bac2191aa4d, 0xcefc7c8fffebdbc2, 0xd4fa6081e6e8ed1c},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}},
+     {{0x867db63998683186, 0xfb5cf424ddcc4ea9, 0xcc9a7ffed4f0e7bd,
+       0x7c57f71c7a779f7e, 0x90774079d6b25ef2, 0x90eae903b4081680},
+      {0xdf2aae5e0ee1fceb, 0x3ff1da24e86c1a1f, 0x80f587d6ca193edf,
+       0xa5695523dc9b9d6a, 0x7b84090085920303, 0x1efa4dfcba6dbdef},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}},
+     {{0xfbd838f9e0540015, 0x2c323946c39077dc, 0x8b1fb9e6ad619124,
+       0x9612440c0ca62ea8, 0x9ad9b52c2dbe00ff, 0xf52abaa1ae197643},
+      {0xd0e898942cac32ad, 0xdfb79e4262a98f91, 0x65452ecf276f55cb,
+       0xdb1ac0d27ad23e12, 0xf68c5f6ade4986f0, 0x389ac37b82ce327d},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}},
+     {{0xcd96866db8a9e8c9, 0xa11963b85bb8091e, 0xc7f90d53045b3cd2,
+       0x755a72b580f36504, 0x46f8b39921d3751c, 0x4bffdc9153c193de},
+      {0xcd15c049b89554e7, 0x353c6754f7a26be6, 0x79602370bd41d970,
+       0xde16470b12b176c0, 0x56ba117540c8809d, 0xe2db35c3e435fb1e},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}},
+     {{0xd71e4aab6328e33f, 0x5486782baf8136d1, 0x07a4995f86d57231,
+       0xf1f0a5bd1651a968, 0xa5dc5b2476803b6d, 0x5c587cbc42dda935},
+      {0x2b6cdb32bae8b4c0, 0x66d1598bb1331138, 0x4a23b2d25d7e9614,
+       0x93e402a674a8c05d, 0x45ac94e6da7ce82e, 0xeb9f8281e463d465},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}}},
+    {{{0, 0, 0, 0, 0, 0},
+      {0, 0, 0, 0, 0, 0},
+      {0, 0, 0, 0, 0, 0}},
+     {{0x7d27d71fd186cb09, 0x67cb7f4e3bc213c7, 0x418cafeb6075b2cf,
+       0xc0d691e6d93a06f7, 0xc16a95259dd001b9, 0xa0583230026f17b9},
+      {0x4c1041b07845900b, 0x2874079147a22aae, 0x8d08efd62c1758e9,
+       0x9cc6f207e6c3229a, 0xec69e902082d8924, 0x9cfa1deaf331dfe7},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}},
+     {{0x2af8ed8170d4d7bc, 0xabc3e15fb632435c, 0x4c0e726f78219356,
+       0x8c1962a1b87254c4, 0x30796a71c9e7691a, 0xd453ef19a75a12ee},
+      {0x535f42c213ae4964, 0x86831c3c0da9586a, 0xb7f1ef35e39a7a58,
+       0xa2789ae2d459b91a, 0xeadbca7f02fd429d, 0x94f215d465290f57},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}},
+     {{0x80855672957f806a, 0x1458611b2ee4d548, 0x4306f80b5c050437,
+       0x93b76f1cabdcd718, 0xea9ab31154ce4ce3, 0xaeb363b046590447},
+      {0x853d9ce96129e532, 0x4ca1aee36e6a6058, 0x6f9f475719cd69d7,
+       0xe4c87b3eb93b3256, 0x638ae5af6f5785fb, 0x986289410586beda},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}},
+     {{0x9b23ab4e94d0864f, 0x46356266009c9fc1, 0xdbe99e51e798edf9,
+       0x38547449307675c7, 0x23ffaf55628c0fb6, 0x56ccd2a31698c372},
+      {0x39f45a578347ce95, 0xe0aaec744f2c6118, 0x2a89079e4af138fc,
+       0xb86371ea2ee4ecc0, 0x076d256a06bbf92f, 0x9073adb8ae3c4c51},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}},
+     {{0x884ad7a0ef0663a8, 0x894c04fcef912205, 0x46a8a5df20068767,
+       0x04afe77691a8f2e7, 0xe89e46a77fb12771, 0xf7b635a383346844},
+      {0x3bb51e8dbd2c240f, 0xf1589e9b5910f8d6, 0x40eacc0a66e8ea66,
+       0x38819cf811866e28, 0x067f967986950da3, 0xe268a76f2db713c4},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}},
+     {{0x2ef044c2684de09f, 0x4ecd1581c34864c8, 0x6ca81092fd9f3f33,
+       0x80d5c90aa70aeb44, 0x399c4f299f9c06f8, 0xf8d7a76e460eed4f},
+      {0xd7185266b32c7dc0, 0x4246821cfc5ce5c6, 0xf717a648cefe98a6,
+       0x9a6b70dd5ee49f38, 0x0373fbd2b8ba907b, 0x06e2a1d5b320d24a},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}},
+     {{0xfc189c0ab48f1236, 0x511eeb59b93e2565, 0xbe405edf5a1302cb,
+       0xa63ceb0be29386ef, 0xd4e46f07b1823278, 0x5f895744935ed6b7},
+      {0x08bca58f726a0d18, 0xcab59629a3983bdf, 0x4db789ea60d11f9d,
+       0x663a12d9182ef35e, 0x14a7569f902ff292, 0x8b6cd435cb061314},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}},
+     {{0x1e34781aa6a1913d, 0x9a8f32287d0adc38, 0xfc185ccc28af85ba,
+       0xc923d78b3ae9ba11, 0x7d494d7ea7bdb313, 0xf774dfa5af8f8b87},
+      {0xc178ccc116e863b8, 0x2d472f2aa8899691, 0x608747cc80a50372,
+       0x8147aa90e6f90197, 0x4683d4c978c2f216, 0x8323652c552f3b51},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}},
+     {{0xdebae1bab55f8b80, 0xd021f3214c42f148, 0xc4a208a69ef7f395,
+       0x9f1b82ecd93a97a5, 0x211b85dd83d6ab99, 0xf9797406798e4105},
+      {0x006073ac900691f3, 0x8d8cb3cd8c60c564, 0x6bdb2b6e88638301,
+       0x4651fb430769617c, 0x61aa71e697e0ffb0, 0xe3258782e652e328},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}},
+     {{0xc2d8e475a7946f53, 0xecf38492cb886120, 0xad547c3d842676aa,
+       0x1630d2cf3c44c548, 0x6af4e3c701d235a5, 0x77a8955fbbfb29ee},
+      {0x8c02e385a731bdce, 0x37b57e1b9c9d328c, 0xa6871c2c79b8306e,
+       0x0a2f637ec7c3bb41, 0x8eee103cd1350ffd, 0xa9db506442bdefd1},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}},
+     {{0x25db1ca8b1b0a14d, 0xdb1ad7125710d76f, 0xd42ee012ee3f392c,
+       0x04224ece44ac3cd5, 0x5baef7192e7d6e6d, 0xdd2a0e40d1b0f89e},
+      {0xc5b45c76bf68752d, 0x08be347dbb6a53e1, 0xf7bae8b5407d7fa5,
+       0x152e6be83c81e6b5, 0x6c59a8cd0917e4e1, 0x71e2b6a1dc0f0ce5},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}},
+     {{0x39b5486294c37b12, 0xd3bd92c23078209b, 0xc96aef0978e31f7d,
+       0x8760415ca7a7e982, 0xa93eaffc9b1f09a5, 0x8a8eee33897de93e},
+      {0x5933eef017105edd, 0x27ccf1faef11a321, 0xfe0e76e17593a8d1,
+       0x1170a3645b841aaf, 0x96a32f8f0f4a9db4, 0x9bd14e3bd640d44d},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}},
+     {{0x1c6b31a9dabb725c, 0x6cc294f85082b361, 0xd7d0f6225d32bc3f,
+       0xef3b95c0f7032c1c, 0xb2c35c7315de8649, 0x3616fb1993ddc023},
+      {0x0f00149d00f1e982, 0x2a9c39d97a614817, 0xfa65554736d93c72,
+       0xe57908a72af6b2b4, 0x6234191075b9616d, 0xc263a9a480e4391b},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}},
+     {{0xde631163e767ab25, 0x110a05d4efc7f5cb, 0x8800f65f5aa357a2,
+       0xbc04ffd09e66cba2, 0x2881418ac54b19d5, 0x7055f01cb24d0100},
+      {0x1f5637005fc24a76, 0xd660da828890dca5, 0xd26402fdab970655,
+       0x6ca6acd0f0e8c563, 0x5240b0809bc15397, 0xbc4e7b7394fec620},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}},
+     {{0xfa7f9dcde6dd34b4, 0x29728b6f0b478a78, 0x27278279fb1d37a8,
+       0xf436bff503063217, 0xa1553f18258f3d1c, 0x1db76fba4d3edcbf},
+      {0xb5def29400a9345b, 0xb5ca314a47429b71, 0x92a17e88f2e6327c,
+       0xad7e1da4eefaf809, 0xe097189a4d27b265, 0x4e4f3a9e67ee59ac},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}}},
+    {{{0, 0, 0, 0, 0, 0},
+      {0, 0, 0, 0, 0, 0},
+      {0, 0, 0, 0, 0, 0}},
+     {{0x298647532b0c535b, 0x90dd695370506296, 0x038cd6b4216ab9ac,
+       0x3df9b7b7be12d76a, 0x13f4d9785f347bdb, 0x222c5c9c13e94489},
+      {0x5f8e796f2680dc64, 0x120e7cb758352417, 0x254b5d8ad10740b8,
+       0xc38b8efb5337dee6, 0xf688c2e194f02247, 0x7b5c75f36c25bc4c},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}},
+     {{0x5584cbb3893b9a2d, 0x820c660b00850c5d, 0x4126d8267df2d43d,
+       0xdd5bbbf00109e801, 0x85b92ee338172f1c, 0x609d4f93f31430d9},
+      {0x1e059a07eadaf9d6, 0x70e6536c0f125fb0, 0xd6220751560f20e7,
+       0xa59489ae7aaf3a9a, 0x7b70e2f664bae14e, 0x0dd0370176d08249},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}},
+     {{0xc07611f4df5bdf53, 0x45d331a758b11a6d, 0x58965daf1c4ee394,
+       0xba8bebe75a5878d1, 0xaecc0a1882dd3025, 0xcf2a3899a923eb8b},
+      {0xf98c9281d24fd048, 0x841bfb598bbb025d, 0xb8ddf8cec9ab9d53,
+       0x538a4cb67fef044e, 0x092ac21f23236662, 0xa919d3850b66f065},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}},
+     {{0xc0426b775e3c647b, 0xbfcbd9398cf05348, 0x31d312e3172c0d3d,
+       0x5f49fde6ee754737, 0x895530f06da7ee61, 0xcf281b0ae8b3a5fb},
+      {0xfd14973541b8a543, 0x41a625a73080dd30, 0xe2baae07653908cf,
+       0xc3d01436ba02a278, 0xa0d0222e7b21b8f8, 0xfdc270e9d7ec1297},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}},
+     {{0x4e50430efc14ab48, 0x195b7f4f26706a74, 0x2fe8a228cc881ff6,
+       0xb1b968e2d945013d, 0x936aa5794b92162b, 0x4fb766b7364e754a},
+      {0x13f93bca31e1ff7f, 0x696eb5cace4f2691, 0xff754bf8a2b09e02,
+       0x58f13c9ce58e3ff8, 0xb757346f1678c0b0, 0xd54200dba86692b3},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}},
+     {{0x5cd9f5a87237cac0, 0x93f0b59d43586794, 0x4384a764e94f6c4e,
+       0x8304ed2bb62782d3, 0x0b8db8b3cde06015, 0x4336dd535dbe190f},
+      {0x5744355392ab473a, 0x031c7275be5ed046, 0x3e78678c21909aa4,
+       0x4ab7e04f99202ddb, 0x2648d2066977e635, 0xd427d184093198be},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}},
+     {{0x8e74dc3579efdc58, 0x456bd3694ff68ddb, 0x724e74ccd32096a5,
+       0xe41cff42386783d0, 0xa04c7f217c70d8a4, 0x41199d2fe61a19a2},
+      {0xd389a3e029c05dd2, 0x535f2a6be7e3fda9, 0x26ecf72d7c2b4df8,
+       0x678275f4fe745294, 0x6319c9cc9d23f519, 0x1e05a02d88048fc4},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}},
+     {{0x87c7dd7d139b3239, 0x8b57824e4d833bae, 0xbcbc48789fff0015,
+       0x8ffcef8b909eaf1a, 0x9905f4eef1443a78, 0x020dd4a2e15cbfed},
+      {0xca2969eca306d695, 0xdf940cadb93caf60, 0x67f7fab787ea6e39,
+       0x0d0ee10ff98c4fe5, 0xc646879ac19cb91e, 0x4b4ea50c7d1d7ab4},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}},
+     {{0xd6d9aec823e4712c, 0x7ca8376cc3c198ee, 0xe6d8318731bebd8a,
+       0xed57aff3d88bfef3, 0x72a645eecf44edc7, 0xd4e63d0b5cbb1517},
+      {0x98ce7a1cceee0ecf, 0x8f0126335383ee8e, 0x3b879078a6b455e8,
+       0xcbcd3d96c7658c06, 0x721d6fe70783336a, 0xf21a72635a677136},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}},
+     {{0x18482cec9b3f5034, 0x962d445acd9e68fd, 0x266fb1d695746f23,
+       0xc66ade5a58c94a4b, 0xdbbda826ed68a5b6, 0x05664a4d7ab0d6ae},
+      {0xbcd4fe51025e32fc, 0x61a5aebfa96df252, 0xd88a07e231592a31,
+       0x5d9d94de98905517, 0x96bb40105fd440e7, 0x1b0c47a2e807db4c},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}},
+     {{0xc1004cff44b2e045, 0x91b5e1364b1c05d4, 0x53ae409088a48a07,
+       0x73fb2995ea11bb1a, 0x320485703d93a4ea, 0xcce45de83bfc8a5f},
+      {0xaff4a97ec2b3106e, 0x9069c630b6848b4f, 0xeda837a6ed76241c,
+       0x8a0daf136cc3f6cf, 0x199d049d3da018a8, 0xf867c6b1d9093ba3},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}},
+     {{0x5285d116141d161c, 0x67cd2e0e93c4ed17, 0x12c62a647c36187e,
+       0xf5329539ed2584ca, 0xc4c777c442fbbd69, 0x107de7761bdfc50a},
+      {0x9976dcc5e96beebd, 0xbe2aff95a865a151, 0x0e0a9da19d8872af,
+       0x5e357a3da63c17cc, 0xd31fdfd8e15cc67c, 0xc44bbefd7970c6d8},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}},
+     {{0x1a60d1522ca8f2fe, 0x61640948491bd41f, 0x6dae29a558dfe035,
+       0x9a615bea278e4863, 0xbbdb44779ad7c8e5, 0x1c7066302ceac2fc},
+      {0x5e2b54c699699b4b, 0xb509ca6d239e17e8, 0x728165feea063a82,
+       0x6b5e609db6a22e02, 0x12813905b26ee1df, 0x07b9f722439491fa},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}},
+     {{0xaa9da167b8153a9d, 0xa49fe3ac9e83ecf0, 0x14c18f8e1b661384,
+       0x61c24dab38434de1, 0x3d973c3a283dae96, 0xc99baa0182754fc9},
+      {0x477d198f4c26b1e3, 0x12e8e186a7516202, 0x386e52f6362addfa,
+       0x31e8f695c3962853, 0xdec2af136aaedb60, 0xfcfdb4c629cf74ac},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}},
+     {{0xe361a1987ffa0a5f, 0xf4b26102c63fe109, 0x264acbc56c74e111,
+       0x4af445fa77abebaf, 0x448c4fdd24cddb75, 0x0b13157d44506eea},
+      {0x22a6b15972e9993d, 0x2c3c57e485e5ecbe, 0xa673560bfd83e1a1,
+       0x6be23f82c3b8c83b, 0x40b13a9640bbe38e, 0x66eea033ad17399b},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}}},
+    {{{0, 0, 0, 0, 0, 0},
+      {0, 0, 0, 0, 0, 0},
+      {0, 0, 0, 0, 0, 0}},
+     {{0x9ded9b0d744ec273, 0x5bdfe5472e79e4d5, 0x94f3aaf539393728,
+       0x22136862a438413e, 0x449286da373c7de3, 0xa709d85d29aa1540},
+      {0x1bd13e410284a4f6, 0x37b54d69f0799c8b, 0xd43b558f6bcd0cb2,
+       0xf5757c0e9e610369, 0x15c80b23c16e0651, 0xacb2cf64001820aa},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}},
+     {{0x0869457a01a8eb44, 0x522239857a7bedd7, 0x2c04b0c600057505,
+       0x468be6e80b09adeb, 0x2f3bf32b6f81474f, 0xf54f949da712ccce},
+      {0x292cee424cdd8f2a, 0x3d9fdf6b9c221be1, 0xe54da66156f47b2a,
+       0x2ca76835840b5d1b, 0xb52adb6a8a6e8cf6, 0x8b416a6bdade153e},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}},
+     {{0xc7d9d3de751fa30c, 0xd303c59d4bc5daae, 0x0d1b6c323f8f6f9b,
+       0xba44f0aca31218df, 0x1e1057a88f4201ff, 0xac71ae1dacb04b1a},
+      {0xbd007d670bbb422a, 0xe8c542af9ebd6ad3, 0x22b423a5041d7c1c,
+       0x137798f41662088b, 0x783350095f547427, 0x7271ecc963a3c450},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}},
+     {{0x114a25c844922386, 0xdd084d446d4e8b57, 0xc49b68411e7bd7de,
+       0x5b0359fad6da54db, 0xa6e6e5f93f0da321, 0xb65ec55cd640a87e},
+      {0xc1a4f6ceae64020e, 0x91e29cd2088e1337, 0xf44ceb8e3c0a631c,
+       0x0205b11db756445f, 0x04844e845bc8880e, 0xb630ddc0b85e00d3},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}},
+     {{0x17de61446812e780, 0xb1c7b4d8d243b0d5, 0xd413df6d245c0793,
+       0xc9ecf8dbf85e8293, 0x27f4d6b42d33d6fe, 0xba81769fd7c40b93},
+      {0x6d9fac69dee05415, 0xc5469e6ffcf8e567, 0xb8f29bf00e08c52c,
+       0xd6fc24af591a708f, 0x311e375361d18bdc, 0x036d0c8821d4d884},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}},
+     {{0x7784652ec20bbb3d, 0x6618bfa53f6571de, 0xe3ef0e8ebad0e35e,
+       0x9140d12f47c65761, 0xd8bda7c098455b2f, 0x87016ab10cfb4738},
+      {0xa1611dfb5c2e85f9, 0x716b36dbaafbb2bd, 0xd34d19c7fd5c68a4,
+       0x020d497e3edf4079, 0xdd84d00fb3a61005, 0x5db7dd0b2b44b845},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}},
+     {{0xc3e8f6ed0343552b, 0xa065a083e9d22e75, 0x603a617e208d51fc,
+       0x4df8f481e40e15e5, 0xa45985408eed5bd3, 0xc678515c12d13823},
+      {0x85da409a305e9e35, 0xdb5614451179239d, 0x0c3f0d6eab29e86e,
+       0x79aab395a37fae7d, 0xa4681a1870cd2bee, 0x7f3d1a054b6d1485},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}},
+     {{0xc32730e8dd14d47e, 0xcdc1fd42c0f01e0f, 0x2bacfdbf3f5cd846,
+       0x45f364167272d4dd, 0xdd813a795eb75776, 0xb57885e450997be2},
+      {0xda054e2bdb8c9829, 0x4161d820aab5a594, 0x4c428f31026116a3,
+       0x372af9a0dcd85e91, 0xfda6e903673adc2d, 0x4526b8aca8db59e6},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}},
+     {{0x8ca500763b9997ed, 0x33aec9f82ec272de, 0x6bc1fbef9fe3a987,
+       0xc1d2769a597872ba, 0x265ff2127397dd07, 0x4930ca11d995d8b7},
+      {0x1fd14f00263f7e46, 0xff7c36b55053cfd5, 0xa4466e51779b1fce,
+       0x9ac8f112f38fd2ec, 0xff531834caf39589, 0x66d3a933f8153981},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}},
+     {{0xe09b6388492fe002, 0xa52a2153403f15be, 0x73802096588c2819,
+       0x3ff3a99e89595ed4, 0xadabd530d87dbdcc, 0x12c9997fb4f9aef2},
+      {0x807f58511c2b3ebf, 0x4ddb0309ebc87b0f, 0x4396a3b526dc0170,
+       0x7b42e0c18b4b8bc8, 0x0a120d39b602aa57, 0x4d0f123295c986b6},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}},
+     {{0x437ed9951d9572c3, 0xc9095b256507ec0b, 0x2cf5dd1b6df488be,
+       0x0224850dbcf9048f, 0x7170ce6f4541395e, 0x114037bdf8b9adec},
+      {0xceadb9eef7d637bf, 0x37e0208c2d371721, 0xfab8369113a01252,
+       0xed524e6332d98679, 0x0691a1b11aeafe93, 0xdb2157188f9d3767},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}},
+     {{0x62d7ec284b26090d, 0xe5f42111fd58bd0c, 0xf70c3202001852e1,
+       0xb794ab2b4062c0cd, 0x47b006885eb3ab9e, 0xcf8cf4a99bb54b3c},
+      {0x65f1cf67128f1b36, 0x405decf6cc4cd245, 0x89c7b0cfe180ab15,
+       0x4e1e77a89f04fac3, 0x62df7334119fc1dd, 0x39f5205196751054},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}},
+     {{0x24c6f02f7704ac4e, 0x1b7fd9cda95806f6, 0xd9a56cc10176ee5a,
+       0x7c1ce37b3f788421, 0x57ac9f962c4133dc, 0x947580814cd87491},
+      {0xe2b637b1b79c1c9a, 0x0c6b2ae4cf92c54a, 0xed3d41c8d9eb45a9,
+       0x48a56205939c10b6, 0x5664c783d5524c67, 0x6fd4df46fca016ac},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}},
+     {{0x69c1a72df9b72198, 0xcb69d0c3710c5f9a, 0xc9b2d9acf1741756,
+       0xfa6776f7a5a40d73, 0x0c30eb2d86b49dd0, 0x0d0dc995ee4bd1ca},
+      {0x8e5f19e2c28bbf1f, 0xe83d161cc0b5c7d6, 0xd036bf04a5ea9592,
+       0xef7698d98bece468, 0xeaff920546530ee5, 0x693f5b41f6315cd9},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}},
+     {{0x54e7b7d217535093, 0xea0fe4dc9fd34f34, 0x79686048c759bd21,
+       0xb3a4150d9cc71d31, 0x5bd495331944bb4d, 0xc28cba43ca493cd4},
+      {0x92c6728e4acd026b, 0x678218a9398611d7, 0xff2fb846d844c9d5,
+       0xebe1c30ab5421c2b, 0x5fbf6b7289f725a8, 0x1b754adddbdc3da4},
+      {0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+       0x0000000000000000, 0x0000000000000000, 0x0000000000000000}}}
+};
+
+/*
+ * select_point selects the |idx|th point from a precomputation table and
+ * copies it to out.
+ */
+ /* pre_comp below is of the size provided in |size| */
+static void select_point(const limb idx, unsigned int size,
+                         const felem pre_comp[][3], felem out[3])
+{
+    unsigned i, j;
+    limb *outlimbs = &out[0][0];
+
+    memset(out, 0, sizeof(*out) * 3);
+
+    for (i = 0; i < size; i++) {
+        const limb *inlimbs = &pre_comp[i][0][0];
+        limb mask = i ^ idx;
+        mask |= mask >> 4;
+        mask |= mask >> 2;
+        mask |= mask >> 1;
+        mask &= 1;
+        mask--;
+        for (j = 0; j < NLIMBS * 3; j++)
+            outlimbs[j] |= inlimbs[j] & mask;
+    }
+}
+
+/* get_bit returns the |i|th bit in |in| */
+static char get_bit(const felem_bytearray in, int i)
+{
+    if ((i < 0) || (i >= 384))
+        return 0;
+    return (in[i >> 3] >> (i & 7)) & 1;
+}
+
+/*
+ * Interleaved point multiplication using precomputed point multiples: The
+ * small point multiples 0*P, 1*P, ..., 16*P are in pre_comp[], the scalars
+ * in scalars[]. If g_scalar is non-NULL, we also add this multiple of the
+ * generator, using certain (large) precomputed multiples in g_pre_comp.
+ * Output point (X, Y, Z) is stored in x_out, y_out, z_out
+ */
+static void batch_mul(felem x_out, felem y_out, felem z_out,
+                      const felem_bytearray scalars[],
+                      const unsigned num_points, const u8 *g_scalar,
+                      const int mixed, const felem pre_comp[][17][3],
+                      const felem g_pre_comp[4][16][3])
+{
+    int i, j, skip;
+    unsigned num, gen_mul = (g_scalar != NULL);
+    felem nq[3], tmp[4];
+    limb bits;
+    u8 sign, digit;
+
+    /* set nq to the point at infinity */
+    memset(nq, 0, sizeof(nq));
+
+    /*
+     * Loop over all scalars msb-to-lsb, interleaving additions of multiples
+     * of the generator (four in each of the last 24 rounds) and additions of
+     * other points multiples (every 5th round).
+     */
+    skip = 1;                   /* save two point operations in the first
+                                 * round */
+    for (i = (num_points ? 383 : 23); i >= 0; --i) {
+        /* double */
+        if (!skip)
+            point_double(nq[0], nq[1], nq[2], nq[0], nq[1], nq[2]);
+
+        /* add multiples of the generator */
+        if (gen_mul && (i <= 23)) {
+            for (j = 3; j >= 0; j--) {
+                /* look 24 * j bits upwards */
+                bits = get_bit(g_scalar, i + 24 * j + 288) << 3;
+                bits |= get_bit(g_scalar, i + 24 * j + 192) << 2;
+                bits |= get_bit(g_scalar, i + 24 * j + 96) << 1;
+                bits |= get_bit(g_scalar, i + 24 * j);
+                /* select the point to add, in constant time */
+                select_point(bits, 16, g_pre_comp[j], tmp);
+
+                if (!skip) {
+                    /* Arg 1 below is for "mixed" */
+                    point_add(nq[0], nq[1], nq[2],
+                              nq[0], nq[1], nq[2], 1, tmp[0], tmp[1], tmp[2]);
+                } else {
+                    memcpy(nq, tmp, 3 * sizeof(felem));
+                    skip = 0;
+                }
+            }
+        }
+
+        /* do other additions every 5 doublings */
+        if (num_points && (i % 5 == 0)) {
+            /* loop over all scalars */
+            for (num = 0; num < num_points; ++num) {
+                bits = get_bit(scalars[num], i + 4) << 5;
+                bits |= get_bit(scalars[num], i + 3) << 4;
+                bits |= get_bit(scalars[num], i + 2) << 3;
+                bits |= get_bit(scalars[num], i + 1) << 2;
+                bits |= get_bit(scalars[num], i) << 1;
+                bits |= get_bit(scalars[num], i - 1);
+                ec_GFp_nistp_recode_scalar_bits(&sign, &digit, bits);
+
+                /*
+                 * select the point to add or subtract, in constant time
+                 */
+                select_point(digit, 17, pre_comp[num], tmp);
+                felem_neg(tmp[3], tmp[1]); /* (X, -Y, Z) is the negative
+                                            * point */
+                copy_conditional(tmp[1], tmp[3], (-(limb) sign));
+
+                if (!skip) {
+                    point_add(nq[0], nq[1], nq[2],
+                              nq[0], nq[1], nq[2],
+                              mixed, tmp[0], tmp[1], tmp[2]);
+                } else {
+                    memcpy(nq, tmp, 3 * sizeof(felem));
+                    skip = 0;
+                }
+            }
+        }
+    }
+    felem_assign(x_out, nq[0]);
+    felem_assign(y_out, nq[1]);
+    felem_assign(z_out, nq[2]);
+}
+
+/* Precomputation for the group generator. */
+struct nistp384_pre_comp_st {
+    felem g_pre_comp[4][16][3];
+    CRYPTO_REF_COUNT references;
+    CRYPTO_RWLOCK *lock;
+};
+
+const EC_METHOD *EC_GFp_nistp384_method(void)
+{
+    static const EC_METHOD ret = {
+        EC_FLAGS_DEFAULT_OCT,
+        NID_X9_62_prime_field,
+        ec_GFp_nistp384_group_init,
+        ec_GFp_simple_group_finish,
+        ec_GFp_simple_group_clear_finish,
+        ec_GFp_nist_group_copy,
+        ec_GFp_nistp384_group_set_curve,
+        ec_GFp_simple_group_get_curve,
+        ec_GFp_simple_group_get_degree,
+        ec_group_simple_order_bits,
+        ec_GFp_simple_group_check_discriminant,
+        ec_GFp_simple_point_init,
+        ec_GFp_simple_point_finish,
+        ec_GFp_simple_point_clear_finish,
+        ec_GFp_simple_point_copy,
+        ec_GFp_simple_point_set_to_infinity,
+        ec_GFp_simple_set_Jprojective_coordinates_GFp,
+        ec_GFp_simple_get_Jprojective_coordinates_GFp,
+        ec_GFp_simple_point_set_affine_coordinates,
+        ec_GFp_nistp384_point_get_affine_coordinates,
+        0 /* point_set_compressed_coordinates */ ,
+        0 /* point2oct */ ,
+        0 /* oct2point */ ,
+        ec_GFp_simple_add,
+        ec_GFp_simple_dbl,
+        ec_GFp_simple_invert,
+        ec_GFp_simple_is_at_infinity,
+        ec_GFp_simple_is_on_curve,
+        ec_GFp_simple_cmp,
+        ec_GFp_simple_make_affine,
+        ec_GFp_simple_points_make_affine,
+        ec_GFp_nistp384_points_mul,
+        ec_GFp_nistp384_precompute_mult,
+        ec_GFp_nistp384_have_precompute_mult,
+        ec_GFp_nist_field_mul,
+        ec_GFp_nist_field_sqr,
+        0 /* field_div */ ,
+        0 /* field_encode */ ,
+        0 /* field_decode */ ,
+        0,                      /* field_set_to_one */
+        ec_key_simple_priv2oct,
+        ec_key_simple_oct2priv,
+        0, /* set private */
+        ec_key_simple_generate_key,
+        ec_key_simple_check_key,
+        ec_key_simple_generate_public_key,
+        0, /* keycopy */
+        0, /* keyfinish */
+        ecdh_simple_compute_key,
+        0 /* mul_public */
+    };
+
+    return &ret;
+}
+
+/******************************************************************************/
+/*
+ * FUNCTIONS TO MANAGE PRECOMPUTATION
+ */
+
+static NISTP384_PRE_COMP *nistp384_pre_comp_new()
+{
+    NISTP384_PRE_COMP *ret = OPENSSL_zalloc(sizeof(*ret));
+
+    if (ret == NULL) {
+        ECerr(EC_F_NISTP384_PRE_COMP_NEW, ERR_R_MALLOC_FAILURE);
+        return ret;
+    }
+
+    ret->references = 1;
+
+    ret->lock = CRYPTO_THREAD_lock_new();
+    if (ret->lock == NULL) {
+        ECerr(EC_F_NISTP384_PRE_COMP_NEW, ERR_R_MALLOC_FAILURE);
+        OPENSSL_free(ret);
+        return NULL;
+    }
+    return ret;
+}
+
+NISTP384_PRE_COMP *EC_nistp384_pre_comp_dup(NISTP384_PRE_COMP *p)
+{
+    int i;
+    if (p != NULL)
+        CRYPTO_UP_REF(&p->references, &i, p->lock);
+    return p;
+}
+
+void EC_nistp384_pre_comp_free(NISTP384_PRE_COMP *p)
+{
+    int i;
+
+    if (p == NULL)
+        return;
+
+    CRYPTO_DOWN_REF(&p->references, &i, p->lock);
+    REF_PRINT_COUNT("EC_nistp384", x);
+    if (i > 0)
+        return;
+    REF_ASSERT_ISNT(i < 0);
+
+    CRYPTO_THREAD_lock_free(p->lock);
+    OPENSSL_free(p);
+}
+
+/******************************************************************************/
+/*
+ * OPENSSL EC_METHOD FUNCTIONS
+ */
+
+int ec_GFp_nistp384_group_init(EC_GROUP *group)
+{
+    int ret;
+    ret = ec_GFp_simple_group_init(group);
+    group->a_is_minus3 = 1;
+    return ret;
+}
+
+int ec_GFp_nistp384_group_set_curve(EC_GROUP *group, const BIGNUM *p,
+                                    const BIGNUM *a, const BIGNUM *b,
+                                    BN_CTX *ctx)
+{
+    int ret = 0;
+    BN_CTX *new_ctx = NULL;
+    BIGNUM *curve_p, *curve_a, *curve_b;
+
+    if (ctx == NULL)
+        if ((ctx = new_ctx = BN_CTX_new()) == NULL)
+            return 0;
+    BN_CTX_start(ctx);
+    if (((curve_p = BN_CTX_get(ctx)) == NULL) ||
+        ((curve_a = BN_CTX_get(ctx)) == NULL) ||
+        ((curve_b = BN_CTX_get(ctx)) == NULL))
+        goto err;
+    BN_bin2bn(nistp384_curve_params[0], sizeof(felem_bytearray), curve_p);
+    BN_bin2bn(nistp384_curve_params[1], sizeof(felem_bytearray), curve_a);
+    BN_bin2bn(nistp384_curve_params[2], sizeof(felem_bytearray), curve_b);
+    if ((BN_cmp(curve_p, p)) || (BN_cmp(curve_a, a)) || (BN_cmp(curve_b, b))) {
+        ECerr(EC_F_EC_GFP_NISTP384_GROUP_SET_CURVE,
+              EC_R_WRONG_CURVE_PARAMETERS);
+        goto err;
+    }
+    group->field_mod_func = BN_nist_mod_384;
+    ret = ec_GFp_simple_group_set_curve(group, p, a, b, ctx);
+ err:
+    BN_CTX_end(ctx);
+    BN_CTX_free(new_ctx);
+    return ret;
+}
+
+/*
+ * Takes the Jacobian coordinates (X, Y, Z) of a point and returns (X', Y') =
+ * (X/Z^2, Y/Z^3)
+ */
+int ec_GFp_nistp384_point_get_affine_coordinates(const EC_GROUP *group,
+                                                 const EC_POINT *point,
+                                                 BIGNUM *x, BIGNUM *y,
+                                                 BN_CTX *ctx)
+{
+    felem z1, z2, x_in, y_in, x_out, y_out;
+
+    if (EC_POINT_is_at_infinity(group, point)) {
+        ECerr(EC_F_EC_GFP_NISTP384_POINT_GET_AFFINE_COORDINATES,
+              EC_R_POINT_AT_INFINITY);
+        return 0;
+    }
+    if ((!BN_to_felem(x_in, point->X)) || (!BN_to_felem(y_in, point->Y)) ||
+        (!BN_to_felem(z1, point->Z)))
+        return 0;
+    felem_inv(z2, z1);
+    felem_square(z1, z2);
+    felem_mul(x_in, x_in, z1);
+    felem_contract(x_out, x_in);
+    if (x != NULL) {
+        if (!felem_to_BN(x, x_out)) {
+            ECerr(EC_F_EC_GFP_NISTP384_POINT_GET_AFFINE_COORDINATES,
+                  ERR_R_BN_LIB);
+            return 0;
+        }
+    }
+    felem_mul(z1, z1, z2);
+    felem_mul(y_in, y_in, z1);
+    felem_contract(y_out, y_in);
+    if (y != NULL) {
+        if (!felem_to_BN(y, y_out)) {
+            ECerr(EC_F_EC_GFP_NISTP384_POINT_GET_AFFINE_COORDINATES,
+                  ERR_R_BN_LIB);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/* points below is of size |num|, and tmp_felems is of size |num+1/ */
+static void make_points_affine(size_t num, felem points[][3],
+                               felem tmp_felems[])
+{
+    /*
+     * Runs in constant time, unless an input is the point at infinity (which
+     * normally shouldn't happen).
+     */
+    ec_GFp_nistp_points_make_affine_internal(num,
+                                             points,
+                                             sizeof(felem),
+                                             tmp_felems,
+                                             (void (*)(void *))felem_one,
+                                             (int (*)(const void *))
+                                             felem_is_zero_int,
+                                             (void (*)(void *, const void *))
+                                             felem_assign,
+                                             (void (*)(void *, const void *))
+                                             felem_square_reduce, (void (*)
+                                                                   (void *,
+                                                                    const void
+                                                                    *,
+                                                                    const void
+                                                                    *))
+                                             felem_mul_reduce,
+                                             (void (*)(void *, const void *))
+                                             felem_inv,
+                                             (void (*)(void *, const void *))
+                                             felem_contract);
+}
+
+/*
+ * Computes scalar*generator + \sum scalars[i]*points[i], ignoring NULL
+ * values Result is stored in r (r can equal one of the inputs).
+ */
+int ec_GFp_nistp384_points_mul(const EC_GROUP *group, EC_POINT *r,
+                               const BIGNUM *scalar, size_t num,
+                               const EC_POINT *points[],
+                               const BIGNUM *scalars[], BN_CTX *ctx)
+{
+    int ret = 0;
+    int j;
+    int mixed = 0;
+    BN_CTX *new_ctx = NULL;
+    BIGNUM *x, *y, *z, *tmp_scalar;
+    felem_bytearray g_secret;
+    felem_bytearray *secrets = NULL;
+    felem (*pre_comp)[17][3] = NULL;
+    felem *tmp_felems = NULL;
+    felem_bytearray tmp;
+    unsigned i, num_bytes;
+    int have_pre_comp = 0;
+    size_t num_points = num;
+    felem x_in, y_in, z_in, x_out, y_out, z_out;
+    NISTP384_PRE_COMP *pre = NULL;
+    const felem(*g_pre_comp)[16][3] = NULL;
+    EC_POINT *generator = NULL;
+    const EC_POINT *p = NULL;
+    const BIGNUM *p_scalar = NULL;
+
+    if (ctx == NULL)
+        if ((ctx = new_ctx = BN_CTX_new()) == NULL)
+            return 0;
+    BN_CTX_start(ctx);
+    if (((x = BN_CTX_get(ctx)) == NULL) ||
+        ((y = BN_CTX_get(ctx)) == NULL) ||
+        ((z = BN_CTX_get(ctx)) == NULL) ||
+        ((tmp_scalar = BN_CTX_get(ctx)) == NULL))
+        goto err;
+
+    if (scalar != NULL) {
+        pre = group->pre_comp.nistp384;
+        if (pre)
+            /* we have precomputation, try to use it */
+            g_pre_comp = (const felem(*)[16][3])pre->g_pre_comp;
+        else
+            /* try to use the standard precomputation */
+            g_pre_comp = &gmul[0];
+        generator = EC_POINT_new(group);
+        if (generator == NULL)
+            goto err;
+        /* get the generator from precomputation */
+        if (!felem_to_BN(x, g_pre_comp[0][1][0]) ||
+            !felem_to_BN(y, g_pre_comp[0][1][1]) ||
+            !felem_to_BN(z, g_pre_comp[0][1][2])) {
+            ECerr(EC_F_EC_GFP_NISTP384_POINTS_MUL, ERR_R_BN_LIB);
+            goto err;
+        }
+        if (!EC_POINT_set_Jprojective_coordinates_GFp(group,
+                                                      generator, x, y, z,
+                                                      ctx))
+            goto err;
+        if (0 == EC_POINT_cmp(group, generator, group->generator, ctx))
+            /* precomputation matches generator */
+            have_pre_comp = 1;
+        else
+            /*
+             * we don't have valid precomputation: treat the generator as a
+             * random point
+             */
+            num_points++;
+    }
+
+    if (num_points > 0) {
+        if (num_points >= 2) {
+            /*
+             * unless we precompute multiples for just one point, converting
+             * those into affine form is time well spent
+             */
+            mixed = 1;
+        }
+        secrets = OPENSSL_zalloc(sizeof(*secrets) * num_points);
+        pre_comp = OPENSSL_zalloc(sizeof(*pre_comp) * num_points);
+        if (mixed)
+            tmp_felems =
+                OPENSSL_malloc(sizeof(*tmp_felems) * (num_points * 17 + 1));
+        if ((secrets == NULL) || (pre_comp == NULL)
+            || (mixed && (tmp_felems == NULL))) {
+            ECerr(EC_F_EC_GFP_NISTP384_POINTS_MUL, ERR_R_MALLOC_FAILURE);
+            goto err;
+        }
+
+        /*
+         * we treat NULL scalars as 0, and NULL points as points at infinity,
+         * i.e., they contribute nothing to the linear combination
+         */
+        for (i = 0; i < num_points; ++i) {
+            if (i == num)
+                /*
+                 * we didn't have a valid precomputation, so we pick the
+                 * generator
+                 */
+            {
+                p = EC_GROUP_get0_generator(group);
+                p_scalar = scalar;
+            } else
+                /* the i^th point */
+            {
+                p = points[i];
+                p_scalar = scalars[i];
+            }
+            if ((p_scalar != NULL) && (p != NULL)) {
+                /* reduce scalar to 0 <= scalar < 2^384 */
+                if ((BN_num_bits(p_scalar) > 384)
+                    || (BN_is_negative(p_scalar))) {
+                    /*
+                     * this is an unusual input, and we don't guarantee
+                     * constant-timeness
+                     */
+                    if (!BN_nnmod(tmp_scalar, p_scalar, group->order, ctx)) {
+                        ECerr(EC_F_EC_GFP_NISTP384_POINTS_MUL, ERR_R_BN_LIB);
+                        goto err;
+                    }
+                    num_bytes = BN_bn2bin(tmp_scalar, tmp);
+                } else
+                    num_bytes = BN_bn2bin(p_scalar, tmp);
+                flip_endian(secrets[i], tmp, num_bytes);
+                /* precompute multiples */
+                if ((!BN_to_felem(x_out, p->X)) ||
+                    (!BN_to_felem(y_out, p->Y)) ||
+                    (!BN_to_felem(z_out, p->Z)))
+                    goto err;
+                memcpy(pre_comp[i][1][0], x_out, sizeof(felem));
+                memcpy(pre_comp[i][1][1], y_out, sizeof(felem));
+                memcpy(pre_comp[i][1][2], z_out, sizeof(felem));
+                for (j = 2; j <= 16; ++j) {
+                    if (j & 1) {
+                        point_add(pre_comp[i][j][0], pre_comp[i][j][1],
+                                  pre_comp[i][j][2], pre_comp[i][1][0],
+                                  pre_comp[i][1][1], pre_comp[i][1][2], 0,
+                                  pre_comp[i][j - 1][0],
+                                  pre_comp[i][j - 1][1],
+                                  pre_comp[i][j - 1][2]);
+                    } else {
+                        point_double(pre_comp[i][j][0], pre_comp[i][j][1],
+                                     pre_comp[i][j][2], pre_comp[i][j / 2][0],
+                                     pre_comp[i][j / 2][1],
+                                     pre_comp[i][j / 2][2]);
+                    }
+                }
+            }
+        }
+        if (mixed)
+            make_points_affine(num_points * 17, pre_comp[0], tmp_felems);
+    }
+
+    /* the scalar for the generator */
+    if ((scalar != NULL) && (have_pre_comp)) {
+        memset(g_secret, 0, sizeof(g_secret));
+        /* reduce scalar to 0 <= scalar < 2^384 */
+        if ((BN_num_bits(scalar) > 384) || (BN_is_negative(scalar))) {
+            /*
+             * this is an unusual input, and we don't guarantee
+             * constant-timeness
+             */
+            if (!BN_nnmod(tmp_scalar, scalar, group->order, ctx)) {
+                ECerr(EC_F_EC_GFP_NISTP384_POINTS_MUL, ERR_R_BN_LIB);
+                goto err;
+            }
+            num_bytes = BN_bn2bin(tmp_scalar, tmp);
+        } else
+            num_bytes = BN_bn2bin(scalar, tmp);
+        flip_endian(g_secret, tmp, num_bytes);
+        /* do the multiplication with generator precomputation */
+        batch_mul(x_out, y_out, z_out,
+                  (const felem_bytearray(*))secrets, num_points,
+                  g_secret,
+                  mixed, (const felem(*)[17][3])pre_comp,
+                  g_pre_comp);
+    } else
+        /* do the multiplication without generator precomputation */
+        batch_mul(x_out, y_out, z_out,
+                  (const felem_bytearray(*))secrets, num_points,
+                  NULL, mixed, (const felem(*)[17][3])pre_comp, NULL);
+    /* reduce the output to its unique minimal representation */
+    felem_contract(x_in, x_out);
+    felem_contract(y_in, y_out);
+    felem_contract(z_in, z_out);
+    if ((!felem_to_BN(x, x_in)) || (!felem_to_BN(y, y_in)) ||
+        (!felem_to_BN(z, z_in))) {
+        ECerr(EC_F_EC_GFP_NISTP384_POINTS_MUL, ERR_R_BN_LIB);
+        goto err;
+    }
+    ret = EC_POINT_set_Jprojective_coordinates_GFp(group, r, x, y, z, ctx);
+
+ err:
+    BN_CTX_end(ctx);
+    EC_POINT_free(generator);
+    BN_CTX_free(new_ctx);
+    OPENSSL_free(secrets);
+    OPENSSL_free(pre_comp);
+    OPENSSL_free(tmp_felems);
+    return ret;
+}
+
+int ec_GFp_nistp384_precompute_mult(EC_GROUP *group, BN_CTX *ctx)
+{
+    int ret = 0;
+    NISTP384_PRE_COMP *pre = NULL;
+    int i, j;
+    BN_CTX *new_ctx = NULL;
+    BIGNUM *x, *y;
+    EC_POINT *generator = NULL;
+    felem tmp_felems[64];
+
+    /* throw away old precomputation */
+    EC_pre_comp_free(group);
+    if (ctx == NULL)
+        if ((ctx = new_ctx = BN_CTX_new()) == NULL)
+            return 0;
+    BN_CTX_start(ctx);
+    if (((x = BN_CTX_get(ctx)) == NULL) || ((y = BN_CTX_get(ctx)) == NULL))
+        goto err;
+    /* get the generator */
+    if (group->generator == NULL)
+        goto err;
+    generator = EC_POINT_new(group);
+    if (generator == NULL)
+        goto err;
+    BN_bin2bn(nistp384_curve_params[3], sizeof(felem_bytearray), x);
+    BN_bin2bn(nistp384_curve_params[4], sizeof(felem_bytearray), y);
+    if (!EC_POINT_set_affine_coordinates_GFp(group, generator, x, y, ctx))
+        goto err;
+    if ((pre = nistp384_pre_comp_new()) == NULL)
+        goto err;
+    /*
+     * if the generator is the standard one, use built-in precomputation
+     */
+    if (0 == EC_POINT_cmp(group, generator, group->generator, ctx)) {
+        memcpy(pre->g_pre_comp, gmul, sizeof(pre->g_pre_comp));
+        goto done;
+    }
+    if ((!BN_to_felem(pre->g_pre_comp[0][1][0], group->generator->X)) ||
+        (!BN_to_felem(pre->g_pre_comp[0][1][1], group->generator->Y)) ||
+        (!BN_to_felem(pre->g_pre_comp[0][1][2], group->generator->Z)))
+        goto err;
+    /*
+     * compute 2^(24*n)*G for n = 1 .. 15; it is entry 2^(n / 4) of table
+     * n % 4, so that table i holds sums of 2^(24*i)*G, 2^(24*i+96)*G,
+     * 2^(24*i+192)*G and 2^(24*i+288)*G
+     */
+    for (i = 1; i < 16; i++) {
+        felem *prev = pre->g_pre_comp[(i - 1) & 3][1 << ((i - 1) >> 2)];
+        felem *cur = pre->g_pre_comp[i & 3][1 << (i >> 2)];
+
+        point_double(cur[0], cur[1], cur[2], prev[0], prev[1], prev[2]);
+        for (j = 0; j < 23; ++j)
+            point_double(cur[0], cur[1], cur[2], cur[0], cur[1], cur[2]);
+    }
+    for (i = 0; i < 4; i++) {
+        /* g_pre_comp[i][0] is the point at infinity */
+        memset(pre->g_pre_comp[i][0], 0, sizeof(pre->g_pre_comp[i][0]));
+        /* the remaining multiples, with B = 2^(24*i)*G */
+        /* 2^96*B + 2^192*B */
+        point_add(pre->g_pre_comp[i][6][0], pre->g_pre_comp[i][6][1],
+                  pre->g_pre_comp[i][6][2], pre->g_pre_comp[i][4][0],
+                  pre->g_pre_comp[i][4][1], pre->g_pre_comp[i][4][2],
+                  0, pre->g_pre_comp[i][2][0], pre->g_pre_comp[i][2][1],
+                  pre->g_pre_comp[i][2][2]);
+        /* 2^96*B + 2^288*B */
+        point_add(pre->g_pre_comp[i][10][0], pre->g_pre_comp[i][10][1],
+                  pre->g_pre_comp[i][10][2], pre->g_pre_comp[i][8][0],
+                  pre->g_pre_comp[i][8][1], pre->g_pre_comp[i][8][2],
+                  0, pre->g_pre_comp[i][2][0], pre->g_pre_comp[i][2][1],
+                  pre->g_pre_comp[i][2][2]);
+        /* 2^192*B + 2^288*B */
+        point_add(pre->g_pre_comp[i][12][0], pre->g_pre_comp[i][12][1],
+                  pre->g_pre_comp[i][12][2], pre->g_pre_comp[i][8][0],
+                  pre->g_pre_comp[i][8][1], pre->g_pre_comp[i][8][2],
+                  0, pre->g_pre_comp[i][4][0], pre->g_pre_comp[i][4][1],
+                  pre->g_pre_comp[i][4][2]);
+        /* 2^96*B + 2^192*B + 2^288*B */
+        point_add(pre->g_pre_comp[i][14][0], pre->g_pre_comp[i][14][1],
+                  pre->g_pre_comp[i][14][2], pre->g_pre_comp[i][12][0],
+                  pre->g_pre_comp[i][12][1], pre->g_pre_comp[i][12][2],
+                  0, pre->g_pre_comp[i][2][0], pre->g_pre_comp[i][2][1],
+                  pre->g_pre_comp[i][2][2]);
+        for (j = 1; j < 8; ++j) {
+            /* odd multiples: add B */
+            point_add(pre->g_pre_comp[i][2 * j + 1][0],
+                      pre->g_pre_comp[i][2 * j + 1][1],
+                      pre->g_pre_comp[i][2 * j + 1][2],
+                      pre->g_pre_comp[i][2 * j][0],
+                      pre->g_pre_comp[i][2 * j][1],
+                      pre->g_pre_comp[i][2 * j][2],
+                      0, pre->g_pre_comp[i][1][0],
+                      pre->g_pre_comp[i][1][1],
+                      pre->g_pre_comp[i][1][2]);
+        }
+    }
+    make_points_affine(63, &(pre->g_pre_comp[0][1]), tmp_felems);
+
+ done:
+    SETPRECOMP(group, nistp384, pre);
+    ret = 1;
+    pre = NULL;
+ err:
+    BN_CTX_end(ctx);
+    EC_POINT_free(generator);
+    BN_CTX_free(new_ctx);
+    EC_nistp384_pre_comp_free(pre);
+    return ret;
+}
+
+int ec_GFp_nistp384_have_precompute_mult(const EC_GROUP *group)
+{
+    return HAVEPRECOMP(group, nistp384);
+}
+
+#endif
@@ -1402,6 +1402,114 @@ err:
     return ret;
 }
 
+/* acc += digit * P, where |table| holds P, 3P, 5P, ... */
+static void ecp_nistz256_wnaf_add(P256_POINT *acc, int *acc_is_infinity,
+                                  const P256_POINT *table, int digit)
+{
+    const P256_POINT *p = &table[(digit < 0 ? -digit : digit) >> 1];
+    ALIGN32 P256_POINT t;
+
+    memcpy(&t, p, sizeof(t));
+    if (digit < 0)
+        ecp_nistz256_neg(t.Y, p->Y);
+
+    if (*acc_is_infinity) {
+        memcpy(acc, &t, sizeof(*acc));
+        *acc_is_infinity = 0;
+    } else {
+        ecp_nistz256_point_add(acc, acc, &t);
+    }
+}
+
+/*
+ * r = g_scalar*G + p_scalar*point for public inputs, as in signature
+ * verification.  Both scalars are recoded as wNAF and processed together
+ * (Straus-Shamir), so the two multiplications share one chain of doublings.
+ * The odd multiples of G come from the table that ec_comb.c keeps with the
+ * group; those of |point| are computed here.  This is variable time and
+ * must not be used with secret scalars.
+ */
+__owur static int ecp_nistz256_mul_public(const EC_GROUP *group, EC_POINT *r,
+                                          const BIGNUM *g_scalar,
+                                          const EC_POINT *point,
+                                          const BIGNUM *p_scalar,
+                                          BN_CTX *ctx)
+{
+    const int window_size = 5;
+    ALIGN32 P256_POINT ptable[16];
+    ALIGN32 P256_POINT gtable[1 << (EC_COMB_ODD_WINDOW - 1)];
+    ALIGN32 P256_POINT acc;
+    EC_POINT **gen_odd = NULL;
+    signed char *p_wNAF = NULL, *g_wNAF = NULL;
+    size_t p_len = 0, g_len = 0, i;
+    int k, acc_is_infinity = 1, ret = 0;
+
+    if (point == NULL || p_scalar == NULL
+        || BN_num_bits(p_scalar) > 256 || BN_is_negative(p_scalar)
+        || (g_scalar != NULL
+            && (BN_num_bits(g_scalar) > 256 || BN_is_negative(g_scalar)
+                || (gen_odd = ec_comb_odd_multiples(group, ctx)) == NULL)))
+        return EC_POINT_mul(group, r, g_scalar, point, p_scalar, ctx);
+
+    if (!ecp_nistz256_bignum_to_field_elem(ptable[0].X, point->X)
+        || !ecp_nistz256_bignum_to_field_elem(ptable[0].Y, point->Y)
+        || !ecp_nistz256_bignum_to_field_elem(ptable[0].Z, point->Z)) {
+        ECerr(EC_F_ECP_NISTZ256_MUL_PUBLIC, EC_R_COORDINATES_OUT_OF_RANGE);
+        return 0;
+    }
+
+    if (gen_odd != NULL) {
+        for (i = 0; i < OSSL_NELEM(gtable); i++) {
+            if (!ecp_nistz256_bignum_to_field_elem(gtable[i].X,
+                                                   gen_odd[i]->X)
+                || !ecp_nistz256_bignum_to_field_elem(gtable[i].Y,
+                                                      gen_odd[i]->Y)) {
+                ECerr(EC_F_ECP_NISTZ256_MUL_PUBLIC,
+                      EC_R_COORDINATES_OUT_OF_RANGE);
+                return 0;
+            }
+            memcpy(gtable[i].Z, ONE, sizeof(ONE));
+        }
+        if ((g_wNAF = bn_compute_wNAF(g_scalar, EC_COMB_ODD_WINDOW,
+                                      &g_len)) == NULL)
+            goto err;
+    }
+
+    if ((p_wNAF = bn_compute_wNAF(p_scalar, window_size, &p_len)) == NULL)
+        goto err;
+
+    /* ptable[i] = (2*i + 1) * point */
+    ecp_nistz256_point_double(&acc, &ptable[0]);
+    for (i = 1; i < OSSL_NELEM(ptable); i++)
+        ecp_nistz256_point_add(&ptable[i], &ptable[i - 1], &acc);
+
+    for (k = (int)(p_len > g_len ? p_len : g_len) - 1; k >= 0; k--) {
+        if (!acc_is_infinity)
+            ecp_nistz256_point_double(&acc, &acc);
+
+        if ((size_t)k < p_len && p_wNAF[k] != 0)
+            ecp_nistz256_wnaf_add(&acc, &acc_is_infinity, ptable, p_wNAF[k]);
+        if ((size_t)k < g_len && g_wNAF[k] != 0)
+            ecp_nistz256_wnaf_add(&acc, &acc_is_infinity, gtable, g_wNAF[k]);
+    }
+    if (acc_is_infinity)
+        memset(&acc, 0, sizeof(acc));
+
+    if (!bn_set_words(r->X, acc.X, P256_LIMBS) ||
+        !bn_set_words(r->Y, acc.Y, P256_LIMBS) ||
+        !bn_set_words(r->Z, acc.Z, P256_LIMBS)) {
+        goto err;
+    }
+    r->Z_is_one = is_one(r->Z) & 1;
+
+    ret = 1;
+
+err:
+    OPENSSL_free(p_wNAF);
+    OPENSSL_free(g_wNAF);
+    return ret;
+}
+
 __owur static int ecp_nistz256_get_affine(const EC_GROUP *group,
                                           const EC_POINT *point,
                                           BIGNUM *x, BIGNUM *y, BN_CTX *ctx)
@@ -1562,7 +1670,8 @@ const EC_METHOD *EC_GFp_nistz256_method(void)
         ec_key_simple_generate_public_key,
         0, /* keycopy */
         0, /* keyfinish */
-        ecdh_simple_compute_key
+        ecdh_simple_compute_key,
+        ecp_nistz256_mul_public
     };
 
     return &ret;
@@ -8,11 +8,13 @@
  */
 
 #include <stdio.h>
+#include <limits.h>
 #include "internal/cryptlib.h"
 #include <openssl/objects.h>
 #include <openssl/evp.h>
 #include <openssl/engine.h>
 #include "internal/evp_int.h"
+#include "internal/sha.h"
 #include "evp_locl.h"
 
 /* This call frees resources associated with the context */
@@ -174,6 +176,27 @@ int EVP_DigestFinal_ex(EVP_MD_CTX *ctx, unsigned char *md, unsigned int *size)
     return ret;
 }
 
+int EVP_DigestFinalXOF(EVP_MD_CTX *ctx, unsigned char *md, size_t size)
+{
+    int ret = 0;
+
+    if (ctx->digest->flags & EVP_MD_FLAG_XOF
+        && size <= INT_MAX
+        && ctx->digest->md_ctrl(ctx, EVP_MD_CTRL_XOF_LEN, (int)size, NULL)) {
+        ret = ctx->digest->final(ctx, md);
+
+        if (ctx->digest->cleanup != NULL) {
+            ctx->digest->cleanup(ctx);
+            EVP_MD_CTX_set_flags(ctx, EVP_MD_CTX_FLAG_CLEANED);
+        }
+        OPENSSL_cleanse(ctx->md_data, ctx->digest->ctx_size);
+    } else {
+        EVPerr(EVP_F_EVP_DIGESTFINALXOF, EVP_R_NOT_XOF_OR_INVALID_LENGTH);
+    }
+
+    return ret;
+}
+
 int EVP_MD_CTX_copy(EVP_MD_CTX *out, const EVP_MD_CTX *in)
 {
     EVP_MD_CTX_reset(out);
@@ -257,6 +280,47 @@ int EVP_Digest(const void *data, size_t count,
     return ret;
 }
 
+/*
+ * Only built-in digests that are not overridden by an ENGINE are
+ * eligible for multi-buffer processing.
+ */
+static int digest_batch_multi_block(const EVP_MD *type, ENGINE *impl)
+{
+#ifndef OPENSSL_NO_ENGINE
+    ENGINE *e;
+#endif
+
+    if (impl != NULL)
+        return 0;
+    if (type != EVP_sha1() && type != EVP_sha224() && type != EVP_sha256()
+        && type != EVP_sha384() && type != EVP_sha512())
+        return 0;
+#ifndef OPENSSL_NO_ENGINE
+    if ((e = ENGINE_get_digest_engine(type->type)) != NULL) {
+        ENGINE_finish(e);
+        return 0;
+    }
+#endif
+    return 1;
+}
+
+int EVP_Digest_batch(const void *const data[], const size_t count[],
+                     unsigned char *const md[], size_t n,
+                     const EVP_MD *type, ENGINE *impl)
+{
+    size_t i;
+
+    if (digest_batch_multi_block(type, impl)
+        && sha_multi_block_digest(type->type, data, count, md, n))
+        return 1;
+
+    for (i = 0; i < n; i++)
+        if (!EVP_Digest(data[i], count[i], md[i], NULL, type, impl))
+            return 0;
+
+    return 1;
+}
+
 int EVP_MD_CTX_ctrl(EVP_MD_CTX *ctx, int cmd, int p1, void *p2)
 {
     if (ctx->digest && ctx->digest->md_ctrl) {
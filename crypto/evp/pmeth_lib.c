@@ -47,6 +47,7 @@ static const EVP_PKEY_METHOD *standard_methods[] = {
     &tls1_prf_pkey_meth,
 #ifndef OPENSSL_NO_EC
     &ecx25519_pkey_meth,
+    &ecx448_pkey_meth,
 #endif
     &hkdf_pkey_meth,
 #ifndef OPENSSL_NO_POLY1305
@@ -55,6 +56,13 @@ static const EVP_PKEY_METHOD *standard_methods[] = {
 #ifndef OPENSSL_NO_SIPHASH
     &siphash_pkey_meth,
 #endif
+#ifndef OPENSSL_NO_EC
+    &ed25519_pkey_meth,
+#endif
+#ifndef OPENSSL_NO_BLAKE2
+    &blake2b_pkey_meth,
+    &blake2s_pkey_meth,
+#endif
 };
 
 DECLARE_OBJ_BSEARCH_CMP_FN(const EVP_PKEY_METHOD *, const EVP_PKEY_METHOD *,
@@ -212,6 +220,9 @@ void EVP_PKEY_meth_copy(EVP_PKEY_METHOD *dst, const EVP_PKEY_METHOD *src)
 
     dst->ctrl = src->ctrl;
     dst->ctrl_str = src->ctrl_str;
+
+    dst->digestsign = src->digestsign;
+    dst->digestverify = src->digestverify;
 }
 
 void EVP_PKEY_meth_free(EVP_PKEY_METHOD *pmeth)
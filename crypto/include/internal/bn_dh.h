@@ -15,3 +15,10 @@
 declare_dh_bn(1024_160)
 declare_dh_bn(2048_224)
 declare_dh_bn(2048_256)
+
+const extern BIGNUM _bignum_ffdhe2048_p;
+const extern BIGNUM _bignum_ffdhe3072_p;
+const extern BIGNUM _bignum_ffdhe4096_p;
+const extern BIGNUM _bignum_ffdhe6144_p;
+const extern BIGNUM _bignum_ffdhe8192_p;
+const extern BIGNUM _bignum_const_2;
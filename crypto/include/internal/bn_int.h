@@ -64,6 +64,38 @@ void bn_set_static_words(BIGNUM *a, BN_ULONG *words, int size);
  */
 int bn_set_words(BIGNUM *a, BN_ULONG *words, int num_words);
 
+/*
+ * As BN_MONT_CTX_set_locked(), but the context is taken from, or added to,
+ * a process-wide cache.  Only to be used for public moduli.
+ */
+BN_MONT_CTX *bn_mont_ctx_set_locked_cached(BN_MONT_CTX **pmont,
+                                           CRYPTO_RWLOCK *lock,
+                                           const BIGNUM *mod, BN_CTX *ctx);
+
+/*
+ * Computes rr0 = a0^65537 and rr1 = a1^65537 modulo the modulus of |mont|
+ * in one interleaved pass.  Returns 1 on success, 0 on error and -1 if the
+ * operands are not suitable.  Only for public values.
+ */
+int bn_mod_exp_mont_f4_x2(BIGNUM *rr0, const BIGNUM *a0, BIGNUM *rr1,
+                          const BIGNUM *a1, const BN_MONT_CTX *mont);
+
+void bn_cleanup_int(void);
+void bn_ctx_thread_cache_cleanup(void);
+
+/*
+ * Fixed-base comb tables for g^e mod m with a fixed g and odd m, and
+ * exponents of at most |max_bits| bits.  bn_comb_mod_exp() returns 1 on
+ * success, 0 on error and -1 if |e| cannot be handled by |comb|.
+ */
+typedef struct bn_comb_st BN_COMB;
+
+BN_COMB *bn_comb_new(const BIGNUM *g, const BIGNUM *m, int max_bits,
+                     BN_CTX *ctx);
+void bn_comb_free(BN_COMB *comb);
+int bn_comb_mod_exp(BIGNUM *r, const BIGNUM *e, const BN_COMB *comb,
+                    BN_CTX *ctx);
+
 #ifdef  __cplusplus
 }
 #endif
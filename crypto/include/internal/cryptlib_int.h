@@ -14,10 +14,31 @@
 struct thread_local_inits_st {
     int async;
     int err_state;
+    int rsa_blinding;
+    int bn_ctx;
+    int rand_drbg;
 };
 
 int ossl_init_thread_start(uint64_t opts);
 
+/*
+ * Worker threads for routines that split their work.  ossl_thread_start()
+ * returns NULL when threads are unavailable, and the caller is expected to
+ * do the work itself.  The thread's local state is released when |start|
+ * returns.  ossl_thread_join() waits for the thread and frees it.
+ */
+typedef struct ossl_thread_st OSSL_THREAD;
+
+OSSL_THREAD *ossl_thread_start(void (*start)(void *), void *arg);
+int ossl_thread_join(OSSL_THREAD *thread);
+
+/*
+ * Registers the handlers that keep state consistent across fork().
+ * Returns 1 if the child will run them and 0 if fork() cannot be detected
+ * this way.  To be called once only.
+ */
+int ossl_init_fork_handlers(void);
+
 /*
  * OPENSSL_INIT flags. The primary list of these is in crypto.h. Flags below
  * are those omitted from crypto.h because they are "reserved for internal
@@ -28,5 +49,8 @@ int ossl_init_thread_start(uint64_t opts);
 /* OPENSSL_INIT_THREAD flags */
 # define OPENSSL_INIT_THREAD_ASYNC           0x01
 # define OPENSSL_INIT_THREAD_ERR_STATE       0x02
+# define OPENSSL_INIT_THREAD_RSA_BLINDING    0x04
+# define OPENSSL_INIT_THREAD_BN_CTX          0x08
+# define OPENSSL_INIT_THREAD_RAND_DRBG       0x10
 
 void ossl_malloc_setup_failures(void);
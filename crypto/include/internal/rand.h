@@ -18,3 +18,6 @@
 #include <openssl/rand.h>
 
 void rand_cleanup_int(void);
+void rand_drbg_thread_cleanup(void);
+int rand_drbg_priv_bytes(unsigned char *buf, int num);
+void rand_fork(void);
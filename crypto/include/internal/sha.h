@@ -0,0 +1,25 @@
+/*
+ * Copyright 2017 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the OpenSSL license (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+#ifndef HEADER_INTERNAL_SHA_H
+# define HEADER_INTERNAL_SHA_H
+
+# include <stddef.h>
+
+/*
+ * Hash |n| independent messages with the digest identified by |nid| using
+ * multi-buffer code. Returns 1 on success and 0 if the digest or the
+ * processor is not supported, in which case the caller should hash the
+ * messages one by one.
+ */
+int sha_multi_block_digest(int nid, const void *const data[],
+                           const size_t count[], unsigned char *const md[],
+                           size_t n);
+
+#endif
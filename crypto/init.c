@@ -19,6 +19,10 @@
 #include <internal/comp.h>
 #include <internal/err.h>
 #include <internal/err_int.h>
+#include <internal/rsa.h>
+#include <internal/ec.h>
+#include <internal/dh.h>
+#include <internal/bn_int.h>
 #include <internal/objects.h>
 #include <stdlib.h>
 #include <assert.h>
@@ -346,6 +350,32 @@ static void ossl_init_thread_stop(struct thread_local_inits_st *locals)
         err_delete_thread_state();
     }
 
+#ifndef OPENSSL_NO_RSA
+    if (locals->rsa_blinding) {
+# ifdef OPENSSL_INIT_DEBUG
+        fprintf(stderr, "OPENSSL_INIT: ossl_init_thread_stop: "
+                        "rsa_thread_blinding_cleanup()\n");
+# endif
+        rsa_thread_blinding_cleanup();
+    }
+#endif
+
+    if (locals->bn_ctx) {
+#ifdef OPENSSL_INIT_DEBUG
+        fprintf(stderr, "OPENSSL_INIT: ossl_init_thread_stop: "
+                        "bn_ctx_thread_cache_cleanup()\n");
+#endif
+        bn_ctx_thread_cache_cleanup();
+    }
+
+    if (locals->rand_drbg) {
+#ifdef OPENSSL_INIT_DEBUG
+        fprintf(stderr, "OPENSSL_INIT: ossl_init_thread_stop: "
+                        "rand_drbg_thread_cleanup()\n");
+#endif
+        rand_drbg_thread_cleanup();
+    }
+
     OPENSSL_free(locals);
 }
 
@@ -378,6 +408,30 @@ int ossl_init_thread_start(uint64_t opts)
         locals->err_state = 1;
     }
 
+    if (opts & OPENSSL_INIT_THREAD_RSA_BLINDING) {
+#ifdef OPENSSL_INIT_DEBUG
+        fprintf(stderr, "OPENSSL_INIT: ossl_init_thread_start: "
+                        "marking thread for rsa_blinding\n");
+#endif
+        locals->rsa_blinding = 1;
+    }
+
+    if (opts & OPENSSL_INIT_THREAD_BN_CTX) {
+#ifdef OPENSSL_INIT_DEBUG
+        fprintf(stderr, "OPENSSL_INIT: ossl_init_thread_start: "
+                        "marking thread for bn_ctx\n");
+#endif
+        locals->bn_ctx = 1;
+    }
+
+    if (opts & OPENSSL_INIT_THREAD_RAND_DRBG) {
+#ifdef OPENSSL_INIT_DEBUG
+        fprintf(stderr, "OPENSSL_INIT: ossl_init_thread_start: "
+                        "marking thread for rand_drbg\n");
+#endif
+        locals->rand_drbg = 1;
+    }
+
     return 1;
 }
 
@@ -449,6 +503,20 @@ void OPENSSL_cleanup(void)
                     "rand_cleanup_int()\n");
     fprintf(stderr, "OPENSSL_INIT: OPENSSL_cleanup: "
                     "conf_modules_free_int()\n");
+#ifndef OPENSSL_NO_RSA
+    fprintf(stderr, "OPENSSL_INIT: OPENSSL_cleanup: "
+                    "rsa_cleanup_int()\n");
+#endif
+#ifndef OPENSSL_NO_EC
+    fprintf(stderr, "OPENSSL_INIT: OPENSSL_cleanup: "
+                    "ec_cleanup_int()\n");
+#endif
+#ifndef OPENSSL_NO_DH
+    fprintf(stderr, "OPENSSL_INIT: OPENSSL_cleanup: "
+                    "dh_cleanup_int()\n");
+#endif
+    fprintf(stderr, "OPENSSL_INIT: OPENSSL_cleanup: "
+                    "bn_cleanup_int()\n");
 #ifndef OPENSSL_NO_ENGINE
     fprintf(stderr, "OPENSSL_INIT: OPENSSL_cleanup: "
                     "engine_cleanup_int()\n");
@@ -479,6 +547,16 @@ void OPENSSL_cleanup(void)
      */
     rand_cleanup_int();
     conf_modules_free_int();
+#ifndef OPENSSL_NO_RSA
+    rsa_cleanup_int();
+#endif
+#ifndef OPENSSL_NO_EC
+    ec_cleanup_int();
+#endif
+#ifndef OPENSSL_NO_DH
+    dh_cleanup_int();
+#endif
+    bn_cleanup_int();
 #ifndef OPENSSL_NO_ENGINE
     engine_cleanup_int();
 #endif
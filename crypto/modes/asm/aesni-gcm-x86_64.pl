@@ -51,12 +51,12 @@ die "can't locate x86_64-xlate.pl";
 
 if (`$ENV{CC} -Wa,-v -c -o /dev/null -x assembler /dev/null 2>&1`
 		=~ /GNU assembler version ([2-9]\.[0-9]+)/) {
-	$avx = ($1>=2.20) + ($1>=2.22);
+	$avx = ($1>=2.20) + ($1>=2.22) + ($1>=2.30);
 }
 
 if (!$avx && $win64 && ($flavour =~ /nasm/ || $ENV{ASM} =~ /nasm/) &&
 	    `nasm -v 2>&1` =~ /NASM version ([2-9]\.[0-9]+)/) {
-	$avx = ($1>=2.09) + ($1>=2.10);
+	$avx = ($1>=2.09) + ($1>=2.10) + ($1>=2.14);
 }
 
 if (!$avx && $win64 && ($flavour =~ /masm/ || $ENV{ASM} =~ /ml64/) &&
@@ -85,6 +85,8 @@ if ($avx>1) {{{
 $code=<<___;
 .text
 
+.extern	OPENSSL_ia32cap_P
+
 .type	_aesni_ctr32_ghash_6x,\@abi-omnipotent
 .align	32
 _aesni_ctr32_ghash_6x:
@@ -416,6 +418,293 @@ _aesni_ctr32_ghash_6x:
 ___
 ######################################################################
 #
+# VAES/VPCLMULQDQ code path for Ice Lake and later processors.
+#
+# Processes 16 blocks per iteration as four 512-bit "lanes" of counter
+# blocks, and hashes them with aggregated reduction using H^16..H^1.
+# H^1..H^8 are taken from Htable, which is initialized by gcm_init_avx,
+# while H^9..H^16 are calculated upon every call, which is why this
+# path is taken only for inputs of at least 256 bytes. Unlike 6x code
+# it's not explicitly stitched: encrypt hashes previous iteration's
+# output, while decrypt hashes the input, and in either case GHASH is
+# interleaved with independent AES rounds, out-of-order execution
+# taking care of the rest.
+#
+# _aesni_gcm_[en|de]crypt_vaes are leaf subroutines called by
+# aesni_gcm_[en|de]crypt after they have set up the frame, and they
+# process |len| rounded down to a multiple of 256 bytes, leaving the
+# rest to the caller. Return value is placed in $ret.
+#
+if ($avx>2) {
+my ($inp,$out,$len,$key,$ivp,$Xip)=("%rdi","%rsi","%rdx","%rcx","%r8","%r9");
+my @K=map("%zmm$_",(16..30));	# round keys, last one is reused
+my $Klast="%zmm30";		# for last round key regardless of size
+my $bswap="%zmm31";
+my @S=map("%zmm$_",(0..3));	# AES state
+my @H=map("%zmm$_",(4..7));	# H^16..H^13, H^12..H^9, H^8..H^5, H^4..H^1
+my ($ctr,$inc,$lo,$hi,$mid,$D,$T1,$T2)=map("%zmm$_",(8..15));
+my ($xlo,$xhi,$xT1,$xT2)=map("%xmm$_",(10,11,14,15));
+my ($ylo,$yhi,$yT1,$yT2)=map("%ymm$_",(10,11,14,15));
+my $lbl=0;
+
+sub reduction_vaes {	# same as reduction_avx in ghash-x86_64.pl
+my ($Xhi,$Xi,$T1,$T2,$xor)=@_;
+    (
+	"vpsllq		\$57,$Xi,$T1",		# 1st phase
+	"vpsllq		\$62,$Xi,$T2",
+	"$xor		$T1,$T2,$T2",
+	"vpsllq		\$63,$Xi,$T1",
+	"$xor		$T1,$T2,$T2",
+	"vpslldq	\$8,$T2,$T1",
+	"vpsrldq	\$8,$T2,$T2",
+	"$xor		$T1,$Xi,$Xi",
+	"$xor		$T2,$Xhi,$Xhi",
+
+	"vpsrlq		\$1,$Xi,$T2",		# 2nd phase
+	"$xor		$Xi,$Xhi,$Xhi",
+	"$xor		$T2,$Xi,$Xi",
+	"vpsrlq		\$5,$T2,$T2",
+	"$xor		$T2,$Xi,$Xi",
+	"vpsrlq		\$1,$Xi,$Xi",
+	"$xor		$Xhi,$Xi,$Xi"
+    );
+}
+
+sub ghash16 {		# hash 16 blocks at $off($src), Xi is in $lo
+my ($src,$off)=@_;
+my @ret;
+
+    for (my $i=0; $i<4; $i++) {
+	push @ret,
+	"vmovdqu64	`$off+64*$i`($src),$D",
+	"vpshufb	$bswap,$D,$D";
+	if ($i==0) {
+	    push @ret,
+	    "vpxorq		$lo,$D,$D",		# accumulate Xi
+	    "vpclmulqdq	\$0x00,$H[$i],$D,$lo",
+	    "vpclmulqdq	\$0x11,$H[$i],$D,$hi",
+	    "vpclmulqdq	\$0x01,$H[$i],$D,$mid",
+	    "vpclmulqdq	\$0x10,$H[$i],$D,$T1",
+	    "vpxorq		$T1,$mid,$mid";
+	} else {
+	    push @ret,
+	    "vpclmulqdq	\$0x00,$H[$i],$D,$T1",
+	    "vpclmulqdq	\$0x11,$H[$i],$D,$T2",
+	    "vpxorq		$T1,$lo,$lo",
+	    "vpxorq		$T2,$hi,$hi",
+	    "vpclmulqdq	\$0x01,$H[$i],$D,$T1",
+	    "vpclmulqdq	\$0x10,$H[$i],$D,$T2",
+	    "vpternlogq	\$0x96,$T2,$T1,$mid";
+	}
+    }
+    @ret;
+}
+
+sub fold_reduce {	# fold lanes and reduce, Xi ends up in $xlo
+    (
+	"vpslldq	\$8,$mid,$T1",
+	"vpsrldq	\$8,$mid,$mid",
+	"vpxorq		$T1,$lo,$lo",
+	"vpxorq		$mid,$hi,$hi",
+	"vextracti64x4	\$1,$lo,$yT1",
+	"vextracti64x4	\$1,$hi,$yT2",
+	"vpxor		$yT1,$ylo,$ylo",
+	"vpxor		$yT2,$yhi,$yhi",
+	"vextracti128	\$1,$ylo,$xT1",
+	"vextracti128	\$1,$yhi,$xT2",
+	"vpxor		$xT1,$xlo,$xlo",
+	"vpxor		$xT2,$xhi,$xhi",
+	&reduction_vaes($xhi,$xlo,$xT1,$xT2,"vpxor")
+    );
+}
+
+sub aes_init {		# generate counter blocks and xor 0th round key
+my @ret;
+
+    for (my $i=0; $i<4; $i++) {
+	push @ret,
+	"vpshufb	$bswap,$ctr,$S[$i]",
+	"vpaddd		$inc,$ctr,$ctr";
+    }
+    for (my $i=0; $i<4; $i++) {
+	push @ret, "vpxorq		$K[0],$S[$i],$S[$i]";
+    }
+    @ret;
+}
+
+sub aes_rounds {	# rounds common to all key sizes
+my @ret;
+
+    for (my $r=1; $r<10; $r++) {
+	for (my $i=0; $i<4; $i++) {
+	    push @ret, "vaesenc	$K[$r],$S[$i],$S[$i]";
+	}
+    }
+    @ret;
+}
+
+sub aes_tail {		# remaining rounds, and xor with input
+my $l=".Lvaes_last".$lbl++;
+my @ret=("cmp		\$11,%ebp","jb		$l");
+
+    for (my $r=10; $r<14; $r++) {
+	for (my $i=0; $i<4; $i++) {
+	    push @ret, "vaesenc	$K[$r],$S[$i],$S[$i]";
+	}
+	push @ret, "je		$l" if ($r==11);
+    }
+    push @ret, "$l:";
+    for (my $i=0; $i<4; $i++) {
+	push @ret, "vaesenclast	$Klast,$S[$i],$S[$i]";
+    }
+    for (my $i=0; $i<4; $i++) {
+	push @ret,
+	"vpxorq		`64*$i`($inp),$S[$i],$S[$i]",
+	"vmovdqu64	$S[$i],`64*$i`($out)";
+    }
+    @ret;
+}
+
+sub interleave {	# spread @b evenly among @a
+my ($a,$b)=@_;
+my @ret;
+my ($na,$nb)=(scalar(@$a),scalar(@$b));
+
+    for (my ($i,$j)=(0,0); $i<$na || $j<$nb; ) {
+	push @ret, $$a[$i++] if ($i<$na);
+	push @ret, $$b[$j++] while ($j<$nb && $j*$na<$i*$nb);
+    }
+    @ret;
+}
+
+sub emit {
+my $c="\t".join("\n\t",@_)."\n";
+    $c =~ s/\t(\.L\w+:)/$1/gm;
+    $code.=$c;
+}
+
+sub vaes_setup {
+    $code.=<<___;
+	vbroadcasti32x4	.Lbswap_mask(%rip),$bswap
+	mov		240($key),%ebp		# 9, 11 or 13
+	and		\$-0x100,$len
+	mov		$len,$ret
+___
+    for (my $r=0; $r<15; $r++) {
+	$code.="\tvbroadcasti32x4	`16*$r`($key),$K[$r]\n";
+    }
+    $code.=<<___;
+	mov		%ebp,%r11d
+	shl		\$4,%r11
+	vbroadcasti32x4	0x10($key,%r11),$Klast	# last round key
+
+	vmovdqu		0x60($Xip),%xmm7	# H^4
+	vinserti32x4	\$1,0x50($Xip),$H[3],$H[3]
+	vinserti32x4	\$2,0x30($Xip),$H[3],$H[3]
+	vinserti32x4	\$3,0x20($Xip),$H[3],$H[3]
+	vmovdqu		0xc0($Xip),%xmm6	# H^8
+	vinserti32x4	\$1,0xb0($Xip),$H[2],$H[2]
+	vinserti32x4	\$2,0x90($Xip),$H[2],$H[2]
+	vinserti32x4	\$3,0x80($Xip),$H[2],$H[2]
+	vbroadcasti32x4	0xc0($Xip),$D		# H^8 in every lane
+___
+    # H^12..H^9 = H^4..H^1 * H^8 and H^16..H^13 = H^8..H^5 * H^8
+    for my $i (1,0) {
+	&emit(
+	"vpclmulqdq	\$0x00,$D,$H[$i+2],$lo",
+	"vpclmulqdq	\$0x11,$D,$H[$i+2],$hi",
+	"vpclmulqdq	\$0x01,$D,$H[$i+2],$mid",
+	"vpclmulqdq	\$0x10,$D,$H[$i+2],$T1",
+	"vpxorq		$T1,$mid,$mid",
+	"vpslldq	\$8,$mid,$T1",
+	"vpsrldq	\$8,$mid,$mid",
+	"vpxorq		$T1,$lo,$lo",
+	"vpxorq		$mid,$hi,$hi",
+	&reduction_vaes($hi,$lo,$T1,$T2,"vpxorq"),
+	"vmovdqa64	$lo,$H[$i]");
+    }
+    $code.=<<___;
+
+	vbroadcasti32x4	($ivp),$ctr		# load counter
+	vpshufb		$bswap,$ctr,$ctr
+	vpaddd		.Lvaes_ctr(%rip),$ctr,$ctr
+	vbroadcasti32x4	.Lfour_lsb(%rip),$inc
+	vmovdqu		($Xip),$xlo		# load Xi
+	vpshufb		.Lbswap_mask(%rip),$xlo,$xlo
+___
+}
+
+sub vaes_done {
+    $code.=<<___;
+	vpshufb		.Lbswap_mask(%rip),$xlo,$xlo
+	vmovdqu		$xlo,($Xip)		# output Xi
+	vpshufb		$bswap,$ctr,$ctr
+	vmovdqu		%xmm8,($ivp)		# output counter
+	ret
+___
+}
+
+$code.=<<___;
+.type	_aesni_gcm_encrypt_vaes,\@abi-omnipotent
+.align	32
+_aesni_gcm_encrypt_vaes:
+___
+	&vaes_setup();
+	&emit(&aes_init(), &aes_rounds(), &aes_tail());
+$code.=<<___;
+	lea		0x100($inp),$inp
+	lea		0x100($out),$out
+	sub		\$0x100,$len
+	jz		.Lenc_vaes_tail
+	jmp		.Loop_enc_vaes
+
+.align	32
+.Loop_enc_vaes:
+___
+	&emit(&aes_init(),
+	      &interleave([&aes_rounds()],[&ghash16($out,-0x100)]),
+	      &aes_tail(), &fold_reduce());
+$code.=<<___;
+	lea		0x100($inp),$inp
+	lea		0x100($out),$out
+	sub		\$0x100,$len
+	jnz		.Loop_enc_vaes
+
+.Lenc_vaes_tail:
+___
+	&emit(&ghash16($out,-0x100), &fold_reduce());
+	&vaes_done();
+$code.=<<___;
+.size	_aesni_gcm_encrypt_vaes,.-_aesni_gcm_encrypt_vaes
+
+.type	_aesni_gcm_decrypt_vaes,\@abi-omnipotent
+.align	32
+_aesni_gcm_decrypt_vaes:
+___
+	&vaes_setup();
+$code.=<<___;
+	jmp		.Loop_dec_vaes
+
+.align	32
+.Loop_dec_vaes:
+___
+	&emit(&aes_init(),
+	      &interleave([&aes_rounds()],[&ghash16($inp,0)]),
+	      &aes_tail(), &fold_reduce());
+$code.=<<___;
+	lea		0x100($inp),$inp
+	lea		0x100($out),$out
+	sub		\$0x100,$len
+	jnz		.Loop_dec_vaes
+
+___
+	&vaes_done();
+$code.=<<___;
+.size	_aesni_gcm_decrypt_vaes,.-_aesni_gcm_decrypt_vaes
+___
+}
+######################################################################
+#
 # size_t aesni_gcm_[en|de]crypt(const void *inp, void *out, size_t len,
 #		const AES_KEY *key, unsigned char iv[16],
 #		struct { u128 Xi,H,Htbl[9]; } *Xip);
@@ -461,6 +750,18 @@ $code.=<<___ if ($win64);
 	movaps	%xmm15,-0x48(%rax)
 .Lgcm_dec_body:
 ___
+$code.=<<___ if ($avx>2);
+	cmp	\$0x100,$len
+	jb	.Lgcm_dec_no_vaes
+	mov	OPENSSL_ia32cap_P+8(%rip),%r11
+	mov	\$`1<<16|1<<30|1<<(32+9)|1<<(32+10)`,%r12
+	and	%r12,%r11		# AVX512F, AVX512BW, VAES, VPCLMULQDQ
+	cmp	%r12,%r11
+	jne	.Lgcm_dec_no_vaes
+	call	_aesni_gcm_decrypt_vaes
+	jmp	.Lgcm_dec_done
+.Lgcm_dec_no_vaes:
+___
 $code.=<<___;
 	vzeroupper
 
@@ -529,6 +830,7 @@ $code.=<<___;
 	vpshufb		($const),$Xi,$Xi	# .Lbswap_mask
 	vmovdqu		$Xi,-0x40($Xip)		# output Xi
 
+.Lgcm_dec_done:
 	vzeroupper
 ___
 $code.=<<___ if ($win64);
@@ -699,6 +1001,16 @@ $code.=<<___ if ($win64);
 	movaps	%xmm15,-0x48(%rax)
 .Lgcm_enc_body:
 ___
+$code.=<<___ if ($avx>2);
+	mov	OPENSSL_ia32cap_P+8(%rip),%r11
+	mov	\$`1<<16|1<<30|1<<(32+9)|1<<(32+10)`,%r12
+	and	%r12,%r11		# AVX512F, AVX512BW, VAES, VPCLMULQDQ
+	cmp	%r12,%r11
+	jne	.Lgcm_enc_no_vaes
+	call	_aesni_gcm_encrypt_vaes
+	jmp	.Lgcm_enc_done
+.Lgcm_enc_no_vaes:
+___
 $code.=<<___;
 	vzeroupper
 
@@ -939,6 +1251,7 @@ $code.=<<___;
 	vpshufb		($const),$Xi,$Xi	# .Lbswap_mask
 	vmovdqu		$Xi,-0x40($Xip)		# output Xi
 
+.Lgcm_enc_done:
 	vzeroupper
 ___
 $code.=<<___ if ($win64);
@@ -987,6 +1300,10 @@ $code.=<<___;
 	.byte	2,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0
 .Lone_lsb:
 	.byte	1,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0
+.Lfour_lsb:
+	.byte	4,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0
+.Lvaes_ctr:
+	.long	0,0,0,0, 1,0,0,0, 2,0,0,0, 3,0,0,0
 .asciz	"AES-NI GCM module for x86_64, CRYPTOGAMS by <appro\@openssl.org>"
 .align	64
 ___
@@ -10,7 +10,7 @@
  */
 
 /* Serialized OID's */
-static const unsigned char so[6900] = {
+static const unsigned char so[6957] = {
     0x2A,0x86,0x48,0x86,0xF7,0x0D,                 /* [    0] OBJ_rsadsi */
     0x2A,0x86,0x48,0x86,0xF7,0x0D,0x01,            /* [    6] OBJ_pkcs */
     0x2A,0x86,0x48,0x86,0xF7,0x0D,0x02,0x02,       /* [   13] OBJ_md2 */
@@ -976,9 +976,16 @@ static const unsigned char so[6900] = {
     0x2A,0x83,0x1A,0x8C,0x9A,0x6E,0x01,0x01,0x0D,  /* [ 6872] OBJ_aria_256_cfb128 */
     0x2A,0x83,0x1A,0x8C,0x9A,0x6E,0x01,0x01,0x0E,  /* [ 6881] OBJ_aria_256_ofb128 */
     0x2A,0x83,0x1A,0x8C,0x9A,0x6E,0x01,0x01,0x0F,  /* [ 6890] OBJ_aria_256_ctr */
+    0x2B,0x65,0x70,                                /* [ 6899] OBJ_ED25519 */
+    0x60,0x86,0x48,0x01,0x65,0x03,0x04,0x02,0x07,  /* [ 6902] OBJ_sha3_224 */
+    0x60,0x86,0x48,0x01,0x65,0x03,0x04,0x02,0x08,  /* [ 6911] OBJ_sha3_256 */
+    0x60,0x86,0x48,0x01,0x65,0x03,0x04,0x02,0x09,  /* [ 6920] OBJ_sha3_384 */
+    0x60,0x86,0x48,0x01,0x65,0x03,0x04,0x02,0x0A,  /* [ 6929] OBJ_sha3_512 */
+    0x60,0x86,0x48,0x01,0x65,0x03,0x04,0x02,0x0B,  /* [ 6938] OBJ_shake128 */
+    0x60,0x86,0x48,0x01,0x65,0x03,0x04,0x02,0x0C,  /* [ 6947] OBJ_shake256 */
 };
 
-#define NUM_NID 1086
+#define NUM_NID 1100
 static const ASN1_OBJECT nid_objs[NUM_NID] = {
     {"UNDEF", "undefined", NID_undef},
     {"rsadsi", "RSA Data Security, Inc.", NID_rsadsi, 6, &so[0]},
@@ -2066,9 +2073,23 @@ static const ASN1_OBJECT nid_objs[NUM_NID] = {
     {"ARIA-128-CFB8", "aria-128-cfb8", NID_aria_128_cfb8},
     {"ARIA-192-CFB8", "aria-192-cfb8", NID_aria_192_cfb8},
     {"ARIA-256-CFB8", "aria-256-cfb8", NID_aria_256_cfb8},
+    {"ED25519", "ED25519", NID_ED25519, 3, &so[6899]},
+    {"SHA3-224", "sha3-224", NID_sha3_224, 9, &so[6902]},
+    {"SHA3-256", "sha3-256", NID_sha3_256, 9, &so[6911]},
+    {"SHA3-384", "sha3-384", NID_sha3_384, 9, &so[6920]},
+    {"SHA3-512", "sha3-512", NID_sha3_512, 9, &so[6929]},
+    {"SHAKE128", "shake128", NID_shake128, 9, &so[6938]},
+    {"SHAKE256", "shake256", NID_shake256, 9, &so[6947]},
+    {"BLAKE2BMAC", "blake2bmac", NID_blake2bmac},
+    {"BLAKE2SMAC", "blake2smac", NID_blake2smac},
+    {"ffdhe2048", "ffdhe2048", NID_ffdhe2048},
+    {"ffdhe3072", "ffdhe3072", NID_ffdhe3072},
+    {"ffdhe4096", "ffdhe4096", NID_ffdhe4096},
+    {"ffdhe6144", "ffdhe6144", NID_ffdhe6144},
+    {"ffdhe8192", "ffdhe8192", NID_ffdhe8192},
 };
 
-#define NUM_SN 1077
+#define NUM_SN 1091
 static const unsigned int sn_objs[NUM_SN] = {
      364,    /* "AD_DVCS" */
      419,    /* "AES-128-CBC" */
@@ -2137,6 +2158,8 @@ static const unsigned int sn_objs[NUM_SN] = {
       93,    /* "BF-CFB" */
       92,    /* "BF-ECB" */
       94,    /* "BF-OFB" */
+    1093,    /* "BLAKE2BMAC" */
+    1094,    /* "BLAKE2SMAC" */
     1056,    /* "BLAKE2b512" */
     1057,    /* "BLAKE2s256" */
       14,    /* "C" */
@@ -2207,6 +2230,7 @@ static const unsigned int sn_objs[NUM_SN] = {
       70,    /* "DSA-SHA1-old" */
       67,    /* "DSA-old" */
      297,    /* "DVCS" */
+    1086,    /* "ED25519" */
       99,    /* "GN" */
     1036,    /* "HKDF" */
      855,    /* "HMAC" */
@@ -2310,8 +2334,14 @@ static const unsigned int sn_objs[NUM_SN] = {
       64,    /* "SHA1" */
      675,    /* "SHA224" */
      672,    /* "SHA256" */
+    1087,    /* "SHA3-224" */
+    1088,    /* "SHA3-256" */
+    1089,    /* "SHA3-384" */
+    1090,    /* "SHA3-512" */
      673,    /* "SHA384" */
      674,    /* "SHA512" */
+    1091,    /* "SHAKE128" */
+    1092,    /* "SHAKE256" */
      188,    /* "SMIME" */
      167,    /* "SMIME-CAPS" */
      100,    /* "SN" */
@@ -2474,6 +2504,11 @@ static const unsigned int sn_objs[NUM_SN] = {
      372,    /* "extendedStatus" */
      867,    /* "facsimileTelephoneNumber" */
      462,    /* "favouriteDrink" */
+    1095,    /* "ffdhe2048" */
+    1096,    /* "ffdhe3072" */
+    1097,    /* "ffdhe4096" */
+    1098,    /* "ffdhe6144" */
+    1099,    /* "ffdhe8192" */
      857,    /* "freshestCRL" */
      453,    /* "friendlyCountry" */
      490,    /* "friendlyCountryName" */
@@ -3149,7 +3184,7 @@ static const unsigned int sn_objs[NUM_SN] = {
      160,    /* "x509Crl" */
 };
 
-#define NUM_LN 1077
+#define NUM_LN 1091
 static const unsigned int ln_objs[NUM_LN] = {
      363,    /* "AD Time Stamping" */
      405,    /* "ANSI X9.62" */
@@ -3172,6 +3207,7 @@ static const unsigned int ln_objs[NUM_LN] = {
      382,    /* "Directory" */
      392,    /* "Domain" */
      132,    /* "E-mail Protection" */
+    1086,    /* "ED25519" */
      389,    /* "Enterprises" */
      384,    /* "Experimental" */
      372,    /* "Extended OCSP Status" */
@@ -3407,7 +3443,9 @@ static const unsigned int ln_objs[NUM_LN] = {
       92,    /* "bf-ecb" */
       94,    /* "bf-ofb" */
     1056,    /* "blake2b512" */
+    1093,    /* "blake2bmac" */
     1057,    /* "blake2s256" */
+    1094,    /* "blake2smac" */
      921,    /* "brainpoolP160r1" */
      922,    /* "brainpoolP160t1" */
      923,    /* "brainpoolP192r1" */
@@ -3577,6 +3615,11 @@ static const unsigned int ln_objs[NUM_LN] = {
       56,    /* "extendedCertificateAttributes" */
      867,    /* "facsimileTelephoneNumber" */
      462,    /* "favouriteDrink" */
+    1095,    /* "ffdhe2048" */
+    1096,    /* "ffdhe3072" */
+    1097,    /* "ffdhe4096" */
+    1098,    /* "ffdhe6144" */
+    1099,    /* "ffdhe8192" */
      453,    /* "friendlyCountry" */
      490,    /* "friendlyCountryName" */
      156,    /* "friendlyName" */
@@ -4174,11 +4217,17 @@ static const unsigned int ln_objs[NUM_LN] = {
      671,    /* "sha224WithRSAEncryption" */
      672,    /* "sha256" */
      668,    /* "sha256WithRSAEncryption" */
+    1087,    /* "sha3-224" */
+    1088,    /* "sha3-256" */
+    1089,    /* "sha3-384" */
+    1090,    /* "sha3-512" */
      673,    /* "sha384" */
      669,    /* "sha384WithRSAEncryption" */
      674,    /* "sha512" */
      670,    /* "sha512WithRSAEncryption" */
       42,    /* "shaWithRSAEncryption" */
+    1091,    /* "shake128" */
+    1092,    /* "shake256" */
       52,    /* "signingTime" */
      454,    /* "simpleSecurityObject" */
      496,    /* "singleLevelQuality" */
@@ -4230,7 +4279,7 @@ static const unsigned int ln_objs[NUM_LN] = {
      125,    /* "zlib compression" */
 };
 
-#define NUM_OBJ 971
+#define NUM_OBJ 978
 static const unsigned int obj_objs[NUM_OBJ] = {
        0,    /* OBJ_undef                        0 */
      181,    /* OBJ_iso                          1 */
@@ -4255,6 +4304,7 @@ static const unsigned int obj_objs[NUM_OBJ] = {
      381,    /* OBJ_iana                         1 3 6 1 */
     1034,    /* OBJ_X25519                       1 3 101 110 */
     1035,    /* OBJ_X448                         1 3 101 111 */
+    1086,    /* OBJ_ED25519                      1 3 101 112 */
      677,    /* OBJ_certicom_arc                 1 3 132 */
      394,    /* OBJ_selected_attribute_types     2 5 1 5 */
       13,    /* OBJ_commonName                   2 5 4 3 */
@@ -5013,6 +5063,12 @@ static const unsigned int obj_objs[NUM_OBJ] = {
      673,    /* OBJ_sha384                       2 16 840 1 101 3 4 2 2 */
      674,    /* OBJ_sha512                       2 16 840 1 101 3 4 2 3 */
      675,    /* OBJ_sha224                       2 16 840 1 101 3 4 2 4 */
+    1087,    /* OBJ_sha3_224                     2 16 840 1 101 3 4 2 7 */
+    1088,    /* OBJ_sha3_256                     2 16 840 1 101 3 4 2 8 */
+    1089,    /* OBJ_sha3_384                     2 16 840 1 101 3 4 2 9 */
+    1090,    /* OBJ_sha3_512                     2 16 840 1 101 3 4 2 10 */
+    1091,    /* OBJ_shake128                     2 16 840 1 101 3 4 2 11 */
+    1092,    /* OBJ_shake256                     2 16 840 1 101 3 4 2 12 */
      802,    /* OBJ_dsa_with_SHA224              2 16 840 1 101 3 4 3 1 */
      803,    /* OBJ_dsa_with_SHA256              2 16 840 1 101 3 4 3 2 */
       71,    /* OBJ_netscape_cert_type           2 16 840 1 113730 1 1 */
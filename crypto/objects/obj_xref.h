@@ -73,6 +73,7 @@ static const nid_triple sigoid_srt[] = {
      NID_id_GostR3410_2012_256},
     {NID_id_tc26_signwithdigest_gost3410_2012_512, NID_id_GostR3411_2012_512,
      NID_id_GostR3410_2012_512},
+    {NID_ED25519, NID_undef, NID_ED25519},
 };
 
 static const nid_triple *const sigoid_srt_xref[] = {
@@ -0,0 +1,155 @@
+/*
+ * Copyright 2017 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the OpenSSL license (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+#include <string.h>
+#include "internal/cryptlib.h"
+#include <openssl/evp.h>
+#include "rand_lcl.h"
+
+/*
+ * CTR_DRBG from NIST SP 800-90A, section 10.2.1, with AES-256 and no
+ * derivation function.
+ *
+ * Every block the DRBG encrypts is E(K, V + i) for consecutive i, which is
+ * exactly the AES-256-CTR keystream with V + 1 as the initial counter.  The
+ * key schedule of K is kept in |drbg->ctx| between calls, so a request
+ * costs one key schedule for the new K plus one block per 16 bytes of
+ * output and three blocks for the update.
+ */
+
+/* V += n, as a 128-bit big-endian number */
+static void ctr_add(unsigned char V[DRBG_CTR_BLOCKLEN], size_t n)
+{
+    int i;
+
+    for (i = DRBG_CTR_BLOCKLEN - 1; i >= 0 && n != 0; i--) {
+        n += V[i];
+        V[i] = (unsigned char)n;
+        n >>= 8;
+    }
+}
+
+/* Writes the keystream starting at V + 1 to |out| and advances V */
+static int ctr_keystream(RAND_DRBG *drbg, unsigned char *out, size_t outlen)
+{
+    unsigned char iv[DRBG_CTR_BLOCKLEN];
+    int outl;
+
+    memcpy(iv, drbg->V, sizeof(iv));
+    ctr_add(iv, 1);
+    if (!EVP_EncryptInit_ex(drbg->ctx, NULL, NULL, NULL, iv))
+        return 0;
+    memset(out, 0, outlen);
+    if (!EVP_EncryptUpdate(drbg->ctx, out, &outl, out, (int)outlen))
+        return 0;
+    ctr_add(drbg->V, (outlen + DRBG_CTR_BLOCKLEN - 1) / DRBG_CTR_BLOCKLEN);
+    return 1;
+}
+
+/* CTR_DRBG_Update(), |provided| is DRBG_CTR_SEEDLEN bytes or NULL */
+static int ctr_update(RAND_DRBG *drbg, const unsigned char *provided)
+{
+    unsigned char temp[DRBG_CTR_SEEDLEN];
+    size_t i;
+    int ret = 0;
+
+    if (!ctr_keystream(drbg, temp, sizeof(temp)))
+        goto err;
+    if (provided != NULL) {
+        for (i = 0; i < sizeof(temp); i++)
+            temp[i] ^= provided[i];
+    }
+    memcpy(drbg->K, temp, DRBG_CTR_KEYLEN);
+    memcpy(drbg->V, temp + DRBG_CTR_KEYLEN, DRBG_CTR_BLOCKLEN);
+    ret = EVP_EncryptInit_ex(drbg->ctx, NULL, NULL, drbg->K, NULL);
+ err:
+    OPENSSL_cleanse(temp, sizeof(temp));
+    return ret;
+}
+
+/*
+ * Without a derivation function additional input is limited to the seed
+ * length, so longer input is folded into DRBG_CTR_SEEDLEN bytes.
+ */
+static void ctr_fold(unsigned char out[DRBG_CTR_SEEDLEN],
+                     const unsigned char *in, size_t inlen)
+{
+    size_t i;
+
+    memset(out, 0, DRBG_CTR_SEEDLEN);
+    for (i = 0; i < inlen; i++)
+        out[i % DRBG_CTR_SEEDLEN] ^= in[i];
+}
+
+int drbg_ctr_init(RAND_DRBG *drbg)
+{
+    if (drbg->ctx == NULL && (drbg->ctx = EVP_CIPHER_CTX_new()) == NULL)
+        return 0;
+    return 1;
+}
+
+int drbg_ctr_instantiate(RAND_DRBG *drbg,
+                         const unsigned char seed[DRBG_CTR_SEEDLEN])
+{
+    memset(drbg->K, 0, sizeof(drbg->K));
+    memset(drbg->V, 0, sizeof(drbg->V));
+    if (!EVP_EncryptInit_ex(drbg->ctx, EVP_aes_256_ctr(), NULL, drbg->K,
+                            NULL)
+        || !ctr_update(drbg, seed))
+        return 0;
+    drbg->generate_counter = 0;
+    drbg->instantiated = 1;
+    return 1;
+}
+
+int drbg_ctr_reseed(RAND_DRBG *drbg,
+                    const unsigned char seed[DRBG_CTR_SEEDLEN])
+{
+    if (!ctr_update(drbg, seed))
+        return 0;
+    drbg->generate_counter = 0;
+    return 1;
+}
+
+int drbg_ctr_generate(RAND_DRBG *drbg, unsigned char *out, size_t outlen,
+                      const unsigned char *adin, size_t adinlen)
+{
+    unsigned char ad[DRBG_CTR_SEEDLEN];
+    int ret = 0;
+
+    if (outlen > DRBG_CTR_MAX_REQUEST)
+        return 0;
+
+    if (adin != NULL && adinlen > 0) {
+        ctr_fold(ad, adin, adinlen);
+        if (!ctr_update(drbg, ad))
+            goto err;
+    } else {
+        adin = NULL;
+    }
+
+    /* A request for no output just mixes in the additional input */
+    if ((outlen > 0 && !ctr_keystream(drbg, out, outlen))
+        || !ctr_update(drbg, adin != NULL ? ad : NULL))
+        goto err;
+    drbg->generate_counter++;
+    ret = 1;
+ err:
+    OPENSSL_cleanse(ad, sizeof(ad));
+    return ret;
+}
+
+void drbg_ctr_uninstantiate(RAND_DRBG *drbg)
+{
+    EVP_CIPHER_CTX_free(drbg->ctx);
+    drbg->ctx = NULL;
+    OPENSSL_cleanse(drbg->K, sizeof(drbg->K));
+    OPENSSL_cleanse(drbg->V, sizeof(drbg->V));
+    drbg->instantiated = 0;
+}
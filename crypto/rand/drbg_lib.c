@@ -0,0 +1,377 @@
+/*
+ * Copyright 2017 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the OpenSSL license (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+#include <string.h>
+#include "e_os.h"
+#include "internal/cryptlib_int.h"
+#include "internal/thread_once.h"
+#include "internal/rand.h"
+#include <openssl/async.h>
+#include <openssl/err.h>
+#include "rand_lcl.h"
+
+/*
+ * The default RAND method.
+ *
+ * A master DRBG, protected by a lock, feeds two DRBGs in each thread: one
+ * for RAND_bytes() and one for RAND_priv_bytes().  Only the owning thread
+ * ever touches these, so a request takes no lock unless the instance has to
+ * be (re)seeded from the master, which happens after a number of requests or
+ * seconds, see RAND_DRBG_set_reseed_defaults().  The master reseeds on the
+ * same terms with its own limits, from md_rand pool output combined with
+ * entropy read from the operating system for each (re)seed.
+ *
+ * Every instance records the fork generation it was seeded in, and reseeds
+ * before producing any output in a child of that process.  As the master
+ * then reads fresh entropy, the parent and child of a fork() never share a
+ * stream.  The generation is counted by a pthread_atfork() handler where
+ * there is one, which saves a getpid() call per request, and is the
+ * process id elsewhere.
+ *
+ * RAND_add() input is mixed into the public DRBG of the calling thread as
+ * additional input.  Input that carries entropy, or arrives before that
+ * DRBG exists, also goes to the pool for later seeding.
+ */
+
+#define DRBG_RESEED_INTERVAL                (1 << 16)
+#define DRBG_MASTER_RESEED_INTERVAL         (1 << 8)
+#define DRBG_RESEED_TIME_INTERVAL           (7 * 60)
+#define DRBG_MASTER_RESEED_TIME_INTERVAL    (60 * 60)
+#define DRBG_MAX_RESEED_INTERVAL            (1 << 24)
+#define DRBG_MAX_RESEED_TIME_INTERVAL       (1 << 20)
+
+typedef struct {
+    RAND_DRBG *pub;
+    RAND_DRBG *priv;
+} DRBG_THREAD;
+
+static RAND_DRBG drbg_master;
+static CRYPTO_ONCE drbg_init = CRYPTO_ONCE_STATIC_INIT;
+static CRYPTO_THREAD_LOCAL drbg_thread_local;
+static int drbg_inited = 0;
+
+/* Zero disables the respective trigger */
+static unsigned int master_reseed_interval = DRBG_MASTER_RESEED_INTERVAL;
+static unsigned int thread_reseed_interval = DRBG_RESEED_INTERVAL;
+static time_t master_reseed_time_interval = DRBG_MASTER_RESEED_TIME_INTERVAL;
+static time_t thread_reseed_time_interval = DRBG_RESEED_TIME_INTERVAL;
+
+/* Incremented in the child after each fork(), if |drbg_fork_handlers| */
+static unsigned int drbg_fork_count = 0;
+static int drbg_fork_handlers = 0;
+
+DEFINE_RUN_ONCE_STATIC(do_drbg_init)
+{
+    OPENSSL_init_crypto(0, NULL);
+    drbg_fork_handlers = ossl_init_fork_handlers();
+    if ((drbg_master.lock = CRYPTO_THREAD_lock_new()) == NULL)
+        return 0;
+    if (!drbg_ctr_init(&drbg_master)
+        || !CRYPTO_THREAD_init_local(&drbg_thread_local, NULL)) {
+        drbg_ctr_uninstantiate(&drbg_master);
+        CRYPTO_THREAD_lock_free(drbg_master.lock);
+        drbg_master.lock = NULL;
+        return 0;
+    }
+    drbg_inited = 1;
+    return 1;
+}
+
+void rand_fork(void)
+{
+    drbg_fork_count++;
+}
+
+static long drbg_fork_id(void)
+{
+    if (drbg_fork_handlers)
+        return (long)drbg_fork_count;
+#ifndef GETPID_IS_MEANINGLESS
+    return (long)getpid();
+#else
+    return 0;
+#endif
+}
+
+static int drbg_reseed_needed(const RAND_DRBG *drbg, long fork_id)
+{
+    unsigned int interval = thread_reseed_interval;
+    time_t time_interval = thread_reseed_time_interval, now;
+
+    if (!drbg->instantiated || drbg->fork_id != fork_id)
+        return 1;
+    if (drbg->parent == NULL) {
+        interval = master_reseed_interval;
+        time_interval = master_reseed_time_interval;
+    }
+    if (interval > 0 && drbg->generate_counter >= interval)
+        return 1;
+    if (time_interval > 0) {
+        now = time(NULL);
+        /* Also reseed if the clock went backwards */
+        if (now < drbg->reseed_time || now - drbg->reseed_time >= time_interval)
+            return 1;
+    }
+    return 0;
+}
+
+static int drbg_generate(RAND_DRBG *drbg, unsigned char *out, size_t outlen);
+
+/*
+ * Fills |seed| from the parent of |drbg|.  The master gets pool output
+ * XORed with fresh entropy from the operating system, which is not passed
+ * through RAND_add(): that would feed it to a thread DRBG that may be the
+ * one being reseeded.
+ */
+static int drbg_get_seed(RAND_DRBG *drbg, unsigned char *seed)
+{
+    unsigned char fresh[DRBG_CTR_SEEDLEN];
+    int i, n;
+
+    if (drbg->parent != NULL)
+        return drbg_generate(drbg->parent, seed, DRBG_CTR_SEEDLEN);
+
+    if (rand_md_method()->bytes(seed, DRBG_CTR_SEEDLEN) != 1)
+        return 0;
+    n = rand_os_entropy(fresh, sizeof(fresh));
+    for (i = 0; i < n; i++)
+        seed[i] ^= fresh[i];
+    OPENSSL_cleanse(fresh, sizeof(fresh));
+    return 1;
+}
+
+static int drbg_generate(RAND_DRBG *drbg, unsigned char *out, size_t outlen)
+{
+    unsigned char seed[DRBG_CTR_SEEDLEN];
+    long fork_id = drbg_fork_id();
+    size_t n;
+    int ret = 0;
+
+    if (drbg->lock != NULL) {
+        CRYPTO_THREAD_write_lock(drbg->lock);
+        /* We could end up in an async engine while holding this lock */
+        ASYNC_block_pause();
+    }
+
+    if (drbg_reseed_needed(drbg, fork_id)) {
+        if (!drbg_get_seed(drbg, seed)
+            || !(drbg->instantiated ? drbg_ctr_reseed(drbg, seed)
+                                    : drbg_ctr_instantiate(drbg, seed))) {
+            RANDerr(RAND_F_DRBG_GENERATE, RAND_R_ERROR_INSTANTIATING_DRBG);
+            drbg->instantiated = 0;
+            goto err;
+        }
+        drbg->fork_id = fork_id;
+        drbg->reseed_time = time(NULL);
+        drbg->reseed_count++;
+    }
+
+    for (; outlen > 0; out += n, outlen -= n) {
+        n = outlen > DRBG_CTR_MAX_REQUEST ? DRBG_CTR_MAX_REQUEST : outlen;
+        if (!drbg_ctr_generate(drbg, out, n, NULL, 0)) {
+            RANDerr(RAND_F_DRBG_GENERATE, ERR_R_EVP_LIB);
+            drbg->instantiated = 0;
+            goto err;
+        }
+    }
+    ret = 1;
+
+ err:
+    OPENSSL_cleanse(seed, sizeof(seed));
+    if (drbg->lock != NULL) {
+        ASYNC_unblock_pause();
+        CRYPTO_THREAD_unlock(drbg->lock);
+    }
+    return ret;
+}
+
+static RAND_DRBG *drbg_new(RAND_DRBG *parent)
+{
+    RAND_DRBG *drbg = OPENSSL_zalloc(sizeof(*drbg));
+
+    if (drbg == NULL || !drbg_ctr_init(drbg)) {
+        RANDerr(RAND_F_DRBG_NEW, ERR_R_MALLOC_FAILURE);
+        OPENSSL_free(drbg);
+        return NULL;
+    }
+    drbg->parent = parent;
+    return drbg;
+}
+
+static void drbg_free(RAND_DRBG *drbg)
+{
+    if (drbg == NULL)
+        return;
+    drbg_ctr_uninstantiate(drbg);
+    OPENSSL_free(drbg);
+}
+
+/*
+ * Returns the public or private DRBG of the calling thread.  If |create| is
+ * zero, no new instance is set up.
+ */
+static RAND_DRBG *drbg_thread_instance(int priv, int create)
+{
+    DRBG_THREAD *t;
+    RAND_DRBG **pdrbg;
+
+    if (create) {
+        if (!RUN_ONCE(&drbg_init, do_drbg_init))
+            return NULL;
+    }
+    if (!drbg_inited)
+        return NULL;
+
+    t = CRYPTO_THREAD_get_local(&drbg_thread_local);
+    if (t == NULL) {
+        if (!create)
+            return NULL;
+        t = OPENSSL_zalloc(sizeof(*t));
+        if (t == NULL)
+            return NULL;
+        if (!CRYPTO_THREAD_set_local(&drbg_thread_local, t)) {
+            OPENSSL_free(t);
+            return NULL;
+        }
+        /* Ignore failures from these */
+        OPENSSL_init_crypto(0, NULL);
+        ossl_init_thread_start(OPENSSL_INIT_THREAD_RAND_DRBG);
+    }
+
+    pdrbg = priv ? &t->priv : &t->pub;
+    if (*pdrbg == NULL && create)
+        *pdrbg = drbg_new(&drbg_master);
+    return *pdrbg;
+}
+
+/* For the tests: the instances behind the default method */
+RAND_DRBG *rand_drbg_get0_master(void)
+{
+    return drbg_inited ? &drbg_master : NULL;
+}
+
+RAND_DRBG *rand_drbg_get0_thread(int priv)
+{
+    return drbg_thread_instance(priv, 1);
+}
+
+int RAND_DRBG_set_reseed_defaults(unsigned int master_interval,
+                                  unsigned int thread_interval,
+                                  time_t master_time_interval,
+                                  time_t thread_time_interval)
+{
+    if (master_interval > DRBG_MAX_RESEED_INTERVAL
+        || thread_interval > DRBG_MAX_RESEED_INTERVAL
+        || master_time_interval < 0
+        || master_time_interval > DRBG_MAX_RESEED_TIME_INTERVAL
+        || thread_time_interval < 0
+        || thread_time_interval > DRBG_MAX_RESEED_TIME_INTERVAL)
+        return 0;
+
+    master_reseed_interval = master_interval;
+    thread_reseed_interval = thread_interval;
+    master_reseed_time_interval = master_time_interval;
+    thread_reseed_time_interval = thread_time_interval;
+    return 1;
+}
+
+static int drbg_thread_bytes(int priv, unsigned char *out, int num)
+{
+    RAND_DRBG *drbg;
+
+    if (num <= 0)
+        return 1;
+    if ((drbg = drbg_thread_instance(priv, 1)) == NULL)
+        return 0;
+    return drbg_generate(drbg, out, (size_t)num);
+}
+
+static int drbg_bytes(unsigned char *out, int num)
+{
+    return drbg_thread_bytes(0, out, num);
+}
+
+int rand_drbg_priv_bytes(unsigned char *out, int num)
+{
+    return drbg_thread_bytes(1, out, num);
+}
+
+static int drbg_add(const void *buf, int num, double entropy)
+{
+    RAND_DRBG *drbg = drbg_thread_instance(0, 0);
+    int mixed = 0;
+
+    if (num <= 0)
+        return 1;
+
+    /* A generate request for no output with |buf| as additional input */
+    if (drbg != NULL && drbg->instantiated) {
+        mixed = drbg_ctr_generate(drbg, NULL, 0, buf, (size_t)num);
+        if (!mixed)
+            drbg->instantiated = 0;
+    }
+    if (mixed && entropy <= 0)
+        return 1;
+    return rand_md_method()->add(buf, num, entropy);
+}
+
+static int drbg_seed(const void *buf, int num)
+{
+    return drbg_add(buf, num, (double)num);
+}
+
+static int drbg_status(void)
+{
+    if (drbg_master.instantiated)
+        return 1;
+    return rand_md_method()->status();
+}
+
+void rand_drbg_thread_cleanup(void)
+{
+    DRBG_THREAD *t;
+
+    if (!drbg_inited)
+        return;
+
+    t = CRYPTO_THREAD_get_local(&drbg_thread_local);
+    if (t == NULL)
+        return;
+    CRYPTO_THREAD_set_local(&drbg_thread_local, NULL);
+    drbg_free(t->pub);
+    drbg_free(t->priv);
+    OPENSSL_free(t);
+}
+
+static void drbg_cleanup(void)
+{
+    if (drbg_inited) {
+        rand_drbg_thread_cleanup();
+        CRYPTO_THREAD_cleanup_local(&drbg_thread_local);
+        drbg_ctr_uninstantiate(&drbg_master);
+        CRYPTO_THREAD_lock_free(drbg_master.lock);
+        drbg_master.lock = NULL;
+        drbg_inited = 0;
+    }
+    rand_md_method()->cleanup();
+}
+
+static RAND_METHOD rand_drbg_meth = {
+    drbg_seed,
+    drbg_bytes,
+    drbg_cleanup,
+    drbg_add,
+    drbg_bytes,
+    drbg_status
+};
+
+RAND_METHOD *RAND_OpenSSL(void)
+{
+    return &rand_drbg_meth;
+}
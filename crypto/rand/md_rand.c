@@ -91,7 +91,8 @@ DEFINE_RUN_ONCE_STATIC(do_rand_lock_init)
     return rand_lock != NULL && rand_tmp_lock != NULL;
 }
 
-RAND_METHOD *RAND_OpenSSL(void)
+/* The entropy pool that seeds the master DRBG, see drbg_lib.c */
+RAND_METHOD *rand_md_method(void)
 {
     return (&rand_meth);
 }
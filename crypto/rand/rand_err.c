@@ -19,11 +19,15 @@
 # define ERR_REASON(reason) ERR_PACK(ERR_LIB_RAND,0,reason)
 
 static ERR_STRING_DATA RAND_str_functs[] = {
+    {ERR_FUNC(RAND_F_DRBG_GENERATE), "drbg_generate"},
+    {ERR_FUNC(RAND_F_DRBG_NEW), "drbg_new"},
     {ERR_FUNC(RAND_F_RAND_BYTES), "RAND_bytes"},
     {0, NULL}
 };
 
 static ERR_STRING_DATA RAND_str_reasons[] = {
+    {ERR_REASON(RAND_R_ERROR_INSTANTIATING_DRBG),
+     "error instantiating drbg"},
     {ERR_REASON(RAND_R_PRNG_NOT_SEEDED), "PRNG not seeded"},
     {0, NULL}
 };
@@ -16,6 +16,7 @@
 #  define USE_SHA1_RAND
 # endif
 
+# include <time.h>
 # include <openssl/evp.h>
 # define MD_Update(a,b,c)        EVP_DigestUpdate(a,b,c)
 # define MD_Final(a,b)           EVP_DigestFinal_ex(a,b,NULL)
@@ -43,4 +44,51 @@
 
 void rand_hw_xor(unsigned char *buf, size_t num);
 
+/* The md_rand pool, which collects entropy and seeds the master DRBG */
+RAND_METHOD *rand_md_method(void);
+/* Entropy straight from the operating system, see rand_unix.c */
+int rand_os_entropy(unsigned char *buf, int num);
+
+/*
+ * NIST SP 800-90A CTR_DRBG with AES-256 and no derivation function.  Seed
+ * material is DRBG_CTR_SEEDLEN bytes of full entropy input.
+ */
+# define DRBG_CTR_KEYLEN         32
+# define DRBG_CTR_BLOCKLEN       16
+# define DRBG_CTR_SEEDLEN        (DRBG_CTR_KEYLEN + DRBG_CTR_BLOCKLEN)
+/* Largest request for a single generate call */
+# define DRBG_CTR_MAX_REQUEST    (1 << 16)
+
+typedef struct rand_drbg_st RAND_DRBG;
+
+struct rand_drbg_st {
+    /* Only set for the shared master instance */
+    CRYPTO_RWLOCK *lock;
+    /* Source of seed material, or NULL to use the md_rand pool */
+    RAND_DRBG *parent;
+    int instantiated;
+    /* Generate requests since the last (re)seed, and number of (re)seeds */
+    unsigned int generate_counter;
+    unsigned int reseed_count;
+    /* Time of the last (re)seed */
+    time_t reseed_time;
+    /* Fork generation, or pid, of the last (re)seed */
+    long fork_id;
+    EVP_CIPHER_CTX *ctx;
+    unsigned char K[DRBG_CTR_KEYLEN];
+    unsigned char V[DRBG_CTR_BLOCKLEN];
+};
+
+int drbg_ctr_init(RAND_DRBG *drbg);
+int drbg_ctr_instantiate(RAND_DRBG *drbg,
+                         const unsigned char seed[DRBG_CTR_SEEDLEN]);
+int drbg_ctr_reseed(RAND_DRBG *drbg,
+                    const unsigned char seed[DRBG_CTR_SEEDLEN]);
+int drbg_ctr_generate(RAND_DRBG *drbg, unsigned char *out, size_t outlen,
+                      const unsigned char *adin, size_t adinlen);
+void drbg_ctr_uninstantiate(RAND_DRBG *drbg);
+
+RAND_DRBG *rand_drbg_get0_master(void);
+RAND_DRBG *rand_drbg_get0_thread(int priv);
+
 #endif
@@ -53,7 +53,15 @@ int RAND_set_rand_method(const RAND_METHOD *meth)
 
 const RAND_METHOD *RAND_get_rand_method(void)
 {
-    const RAND_METHOD *tmp_meth = NULL;
+    /*
+     * Once published, the method is only replaced by RAND_set_rand_method(),
+     * so the common case is a plain read without any lock.  Only the first
+     * call has to set up the default.
+     */
+    const RAND_METHOD *tmp_meth = default_RAND_meth;
+
+    if (tmp_meth != NULL)
+        return tmp_meth;
 
     if (!RUN_ONCE(&rand_lock_init, do_rand_lock_init))
         return NULL;
@@ -140,6 +148,22 @@ int RAND_bytes(unsigned char *buf, int num)
     return (-1);
 }
 
+/*
+ * Like RAND_bytes(), but for values that must stay secret.  The default
+ * method draws these from a separate DRBG, so that they share no state
+ * with output that may be disclosed.
+ */
+int RAND_priv_bytes(unsigned char *buf, int num)
+{
+    const RAND_METHOD *meth = RAND_get_rand_method();
+
+    if (meth == RAND_OpenSSL())
+        return rand_drbg_priv_bytes(buf, num);
+    if (meth && meth->bytes)
+        return meth->bytes(buf, num);
+    return (-1);
+}
+
 #if OPENSSL_API_COMPAT < 0x10100000L
 int RAND_pseudo_bytes(unsigned char *buf, int num)
 {
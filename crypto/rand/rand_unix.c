@@ -28,6 +28,12 @@
                                  * everywhere */
 #  include <poll.h>
 # endif
+# if defined(__linux)
+#  include <sys/syscall.h>
+#  ifdef SYS_getrandom
+#   define HAVE_GETRANDOM
+#  endif
+# endif
 # include <limits.h>
 # ifndef FD_SETSIZE
 #  define FD_SETSIZE (8*sizeof(fd_set))
@@ -138,24 +144,56 @@ int RAND_poll(void)
 
     return 1;
 }
+
+int rand_os_entropy(unsigned char *buf, int num)
+{
+    arc4random_buf(buf, num);
+    return num;
+}
 # else                          /* !defined(__OpenBSD__) */
-int RAND_poll(void)
+#  ifdef HAVE_GETRANDOM
+/*
+ * Reads up to |num| bytes from the kernel pool with getrandom(2), which
+ * blocks only until the pool has been initialised at boot and needs no
+ * file descriptor.  Returns the number of bytes obtained, which is 0 on
+ * kernels older than 3.17.
+ */
+static int rand_getrandom(unsigned char *buf, int num)
 {
-    unsigned long l;
-    pid_t curr_pid = getpid();
-#  if defined(DEVRANDOM) || (!defined(OPENSS_NO_EGD) && defined(DEVRANDOM_EGD))
-    unsigned char tmpbuf[ENTROPY_NEEDED];
     int n = 0;
+    long r;
+
+    while (n < num) {
+        r = syscall(SYS_getrandom, buf + n, (size_t)(num - n), 0);
+        if (r > 0)
+            n += (int)r;
+        else if (r < 0 && errno == EINTR)
+            continue;
+        else
+            break;
+    }
+    return n;
+}
 #  endif
+
+/*
+ * Reads up to |num| bytes of entropy from the kernel: with getrandom(2)
+ * where there is one, and from the random devices otherwise.  Returns the
+ * number of bytes obtained.
+ */
+int rand_os_entropy(unsigned char *buf, int num)
+{
+    int n = 0;
 #  ifdef DEVRANDOM
     static const char *randomfiles[] = { DEVRANDOM };
     struct stat randomstats[OSSL_NELEM(randomfiles)];
     int fd;
     unsigned int i;
 #  endif
-#  if !defined(OPENSSL_NO_EGD) && defined(DEVRANDOM_EGD)
-    static const char *egdsockets[] = { DEVRANDOM_EGD, NULL };
-    const char **egdsocket = NULL;
+
+#  ifdef HAVE_GETRANDOM
+    /* If this is enough, the devices below are not even opened */
+    n = rand_getrandom(buf, num);
 #  endif
 
 #  ifdef DEVRANDOM
@@ -166,7 +204,7 @@ int RAND_poll(void)
      * out of random entries.
      */
 
-    for (i = 0; (i < OSSL_NELEM(randomfiles)) && (n < ENTROPY_NEEDED); i++) {
+    for (i = 0; (i < OSSL_NELEM(randomfiles)) && (n < num); i++) {
         if ((fd = open(randomfiles[i], O_RDONLY
 #   ifdef O_NONBLOCK
                        | O_NONBLOCK
@@ -245,8 +283,7 @@ int RAND_poll(void)
 #   endif
 
                 if (try_read) {
-                    r = read(fd, (unsigned char *)tmpbuf + n,
-                             ENTROPY_NEEDED - n);
+                    r = read(fd, buf + n, num - n);
                     if (r > 0)
                         n += r;
                 } else
@@ -263,13 +300,34 @@ int RAND_poll(void)
             }
             while ((r > 0 ||
                     (errno == EINTR || errno == EAGAIN)) && usec != 0
-                   && n < ENTROPY_NEEDED);
+                   && n < num);
 
             close(fd);
         }
     }
 #  endif                        /* defined(DEVRANDOM) */
 
+    return n;
+}
+
+int RAND_poll(void)
+{
+    unsigned long l;
+    pid_t curr_pid = getpid();
+#  if defined(HAVE_GETRANDOM) || defined(DEVRANDOM) \
+      || (!defined(OPENSS_NO_EGD) && defined(DEVRANDOM_EGD))
+    unsigned char tmpbuf[ENTROPY_NEEDED];
+    int n = 0;
+#  endif
+#  if !defined(OPENSSL_NO_EGD) && defined(DEVRANDOM_EGD)
+    static const char *egdsockets[] = { DEVRANDOM_EGD, NULL };
+    const char **egdsocket = NULL;
+#  endif
+
+#  if defined(HAVE_GETRANDOM) || defined(DEVRANDOM)
+    n = rand_os_entropy(tmpbuf, ENTROPY_NEEDED);
+#  endif
+
 #  if !defined(OPENSSL_NO_EGD) && defined(DEVRANDOM_EGD)
     /*
      * Use an EGD socket to read entropy from an EGD or PRNGD entropy
@@ -287,7 +345,8 @@ int RAND_poll(void)
     }
 #  endif                        /* defined(DEVRANDOM_EGD) */
 
-#  if defined(DEVRANDOM) || (!defined(OPENSSL_NO_EGD) && defined(DEVRANDOM_EGD))
+#  if defined(HAVE_GETRANDOM) || defined(DEVRANDOM) \
+      || (!defined(OPENSSL_NO_EGD) && defined(DEVRANDOM_EGD))
     if (n > 0) {
         RAND_add(tmpbuf, sizeof tmpbuf, (double)n);
         OPENSSL_cleanse(tmpbuf, n);
@@ -303,7 +362,8 @@ int RAND_poll(void)
     l = time(NULL);
     RAND_add(&l, sizeof(l), 0.0);
 
-#  if defined(DEVRANDOM) || (!defined(OPENSSL_NO_EGD) && defined(DEVRANDOM_EGD))
+#  if defined(HAVE_GETRANDOM) || defined(DEVRANDOM) \
+      || (!defined(OPENSSL_NO_EGD) && defined(DEVRANDOM_EGD))
     return 1;
 #  else
     return 0;
@@ -322,3 +382,11 @@ int RAND_poll(void)
     return 0;
 }
 #endif
+
+#if defined(OPENSSL_SYS_WINDOWS) || defined(OPENSSL_SYS_WIN32) || defined(OPENSSL_SYS_VMS) || defined(OPENSSL_SYS_VXWORKS) || defined(OPENSSL_SYS_UEFI) || defined(OPENSSL_SYS_VOS)
+/* There is no direct source here, so the DRBGs reseed from the pool alone */
+int rand_os_entropy(unsigned char *buf, int num)
+{
+    return 0;
+}
+#endif
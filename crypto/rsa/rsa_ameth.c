@@ -311,7 +311,7 @@ static int pkey_rsa_print(BIO *bp, const EVP_PKEY *pkey, int off, int priv)
     const RSA *x = pkey->pkey.rsa;
     char *str;
     const char *s;
-    int ret = 0, mod_len = 0;
+    int ret = 0, mod_len = 0, ex_primes, idx;
 
     if (x->n != NULL)
         mod_len = BN_num_bits(x->n);
@@ -322,7 +322,14 @@ static int pkey_rsa_print(BIO *bp, const EVP_PKEY *pkey, int off, int priv)
     if (BIO_printf(bp, "%s ", pkey_is_pss(pkey) ?  "RSA-PSS" : "RSA") <= 0)
         goto err;
 
-    if (priv && x->d) {
+    ex_primes = RSA_get_multi_prime_extra_count(x);
+    if (priv && x->d && ex_primes > 0) {
+        if (BIO_printf(bp, "Private-Key: (%d bit, %d primes)\n",
+                       mod_len, ex_primes + 2) <= 0)
+            goto err;
+        str = "modulus:";
+        s = "publicExponent:";
+    } else if (priv && x->d) {
         if (BIO_printf(bp, "Private-Key: (%d bit)\n", mod_len) <= 0)
             goto err;
         str = "modulus:";
@@ -350,6 +357,21 @@ static int pkey_rsa_print(BIO *bp, const EVP_PKEY *pkey, int off, int priv)
             goto err;
         if (!ASN1_bn_print(bp, "coefficient:", x->iqmp, NULL, off))
             goto err;
+        for (idx = 0; idx < ex_primes; idx++) {
+            RSA_PRIME_INFO *pinfo = sk_RSA_PRIME_INFO_value(x->prime_infos,
+                                                            idx);
+            char label[20];
+
+            BIO_snprintf(label, sizeof(label), "prime%d:", idx + 3);
+            if (!ASN1_bn_print(bp, label, pinfo->r, NULL, off))
+                goto err;
+            BIO_snprintf(label, sizeof(label), "exponent%d:", idx + 3);
+            if (!ASN1_bn_print(bp, label, pinfo->d, NULL, off))
+                goto err;
+            BIO_snprintf(label, sizeof(label), "coefficient%d:", idx + 3);
+            if (!ASN1_bn_print(bp, label, pinfo->t, NULL, off))
+                goto err;
+        }
     }
     if (pkey_is_pss(pkey) && !rsa_pss_param_print(bp, 1, x->pss, off))
         goto err;
@@ -27,10 +27,35 @@ static int rsa_cb(int operation, ASN1_VALUE **pval, const ASN1_ITEM *it,
         RSA_free((RSA *)*pval);
         *pval = NULL;
         return 2;
+    } else if (operation == ASN1_OP_D2I_POST) {
+        RSA *rsa = (RSA *)*pval;
+
+        /* otherPrimeInfos must be present iff version is multi */
+        if (rsa->version != RSA_ASN1_VERSION_MULTI)
+            return rsa->prime_infos == NULL;
+        return rsa_multip_calc_product(rsa) == 1;
+    }
+    return 1;
+}
+
+/* Free up the CRT helpers that are not part of the encoding */
+static int rsa_pinfo_cb(int operation, ASN1_VALUE **pval,
+                        const ASN1_ITEM *it, void *exarg)
+{
+    if (operation == ASN1_OP_FREE_PRE) {
+        rsa_multip_info_free((RSA_PRIME_INFO *)*pval);
+        *pval = NULL;
+        return 2;
     }
     return 1;
 }
 
+ASN1_SEQUENCE_cb(RSA_PRIME_INFO, rsa_pinfo_cb) = {
+        ASN1_SIMPLE(RSA_PRIME_INFO, r, CBIGNUM),
+        ASN1_SIMPLE(RSA_PRIME_INFO, d, CBIGNUM),
+        ASN1_SIMPLE(RSA_PRIME_INFO, t, CBIGNUM),
+} ASN1_SEQUENCE_END_cb(RSA_PRIME_INFO, RSA_PRIME_INFO)
+
 ASN1_SEQUENCE_cb(RSAPrivateKey, rsa_cb) = {
         ASN1_EMBED(RSA, version, INT32),
         ASN1_SIMPLE(RSA, n, BIGNUM),
@@ -40,7 +65,8 @@ ASN1_SEQUENCE_cb(RSAPrivateKey, rsa_cb) = {
         ASN1_SIMPLE(RSA, q, CBIGNUM),
         ASN1_SIMPLE(RSA, dmp1, CBIGNUM),
         ASN1_SIMPLE(RSA, dmq1, CBIGNUM),
-        ASN1_SIMPLE(RSA, iqmp, CBIGNUM)
+        ASN1_SIMPLE(RSA, iqmp, CBIGNUM),
+        ASN1_SEQUENCE_OF_OPT(RSA, prime_infos, RSA_PRIME_INFO)
 } ASN1_SEQUENCE_END_cb(RSA, RSAPrivateKey)
 
 
@@ -0,0 +1,149 @@
+/*
+ * Copyright 2017 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the OpenSSL license (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+#include "internal/cryptlib_int.h"
+#include "internal/thread_once.h"
+#include "internal/rsa.h"
+#include "rsa_locl.h"
+
+/*
+ * Per-thread blinding.
+ *
+ * A single RSA key is typically shared by all worker threads of a server.
+ * Only the thread that created rsa->blinding can use it without locking;
+ * every other thread used to fall back to rsa->mt_blinding, which needs
+ * rsa->lock to find and BN_BLINDING_lock() for each conversion.
+ *
+ * Instead, each thread keeps a small cache of BN_BLINDINGs it owns, keyed
+ * by the RSA object.  Since an RSA object may be freed and another one
+ * allocated at the same address, entries are also tagged with a process
+ * wide identifier assigned in RSA_new_method().  Entries for keys that
+ * have gone away are never matched again and are simply evicted.  Only
+ * the owning thread ever touches a cache, so no locks are needed.
+ */
+
+#define RSA_THREAD_BLINDING_SLOTS       8
+
+typedef struct {
+    const RSA *rsa;
+    int id;
+    BN_BLINDING *blinding;
+} RSA_THREAD_BLINDING;
+
+typedef struct {
+    RSA_THREAD_BLINDING slot[RSA_THREAD_BLINDING_SLOTS];
+    /* next slot to evict when all are in use */
+    unsigned int next;
+} RSA_THREAD_BLINDING_CACHE;
+
+static CRYPTO_ONCE rsa_blinding_init = CRYPTO_ONCE_STATIC_INIT;
+static CRYPTO_THREAD_LOCAL rsa_blinding_local;
+static CRYPTO_RWLOCK *rsa_blinding_id_lock = NULL;
+static int rsa_blinding_inited = 0;
+static int rsa_blinding_next_id = 0;
+
+DEFINE_RUN_ONCE_STATIC(do_rsa_blinding_init)
+{
+    rsa_blinding_id_lock = CRYPTO_THREAD_lock_new();
+    if (rsa_blinding_id_lock == NULL)
+        return 0;
+    if (!CRYPTO_THREAD_init_local(&rsa_blinding_local, NULL)) {
+        CRYPTO_THREAD_lock_free(rsa_blinding_id_lock);
+        rsa_blinding_id_lock = NULL;
+        return 0;
+    }
+    rsa_blinding_inited = 1;
+    return 1;
+}
+
+int rsa_blinding_new_id(int *id)
+{
+    if (!RUN_ONCE(&rsa_blinding_init, do_rsa_blinding_init))
+        return 0;
+    return CRYPTO_atomic_add(&rsa_blinding_next_id, 1, id,
+                             rsa_blinding_id_lock);
+}
+
+BN_BLINDING *rsa_get_thread_blinding(RSA *rsa, BN_CTX *ctx)
+{
+    RSA_THREAD_BLINDING_CACHE *cache;
+    RSA_THREAD_BLINDING *ent;
+    BN_BLINDING *b;
+    size_t i;
+
+    if (!RUN_ONCE(&rsa_blinding_init, do_rsa_blinding_init))
+        return NULL;
+
+    cache = CRYPTO_THREAD_get_local(&rsa_blinding_local);
+    if (cache == NULL) {
+        cache = OPENSSL_zalloc(sizeof(*cache));
+        if (cache == NULL)
+            return NULL;
+        if (!CRYPTO_THREAD_set_local(&rsa_blinding_local, cache)) {
+            OPENSSL_free(cache);
+            return NULL;
+        }
+        /* Ignore failures from these */
+        OPENSSL_init_crypto(0, NULL);
+        ossl_init_thread_start(OPENSSL_INIT_THREAD_RSA_BLINDING);
+    }
+
+    for (i = 0; i < RSA_THREAD_BLINDING_SLOTS; i++) {
+        ent = &cache->slot[i];
+        if (ent->rsa == rsa && ent->id == rsa->blinding_id
+                && ent->blinding != NULL)
+            return ent->blinding;
+    }
+
+    if ((b = RSA_setup_blinding(rsa, ctx)) == NULL)
+        return NULL;
+
+    /* Prefer an empty slot, otherwise evict round-robin */
+    for (i = 0; i < RSA_THREAD_BLINDING_SLOTS; i++)
+        if (cache->slot[i].blinding == NULL)
+            break;
+    if (i == RSA_THREAD_BLINDING_SLOTS) {
+        i = cache->next;
+        cache->next = (cache->next + 1) % RSA_THREAD_BLINDING_SLOTS;
+    }
+    ent = &cache->slot[i];
+    BN_BLINDING_free(ent->blinding);
+    ent->rsa = rsa;
+    ent->id = rsa->blinding_id;
+    ent->blinding = b;
+
+    return b;
+}
+
+void rsa_thread_blinding_cleanup(void)
+{
+    RSA_THREAD_BLINDING_CACHE *cache;
+    size_t i;
+
+    if (!rsa_blinding_inited)
+        return;
+
+    cache = CRYPTO_THREAD_get_local(&rsa_blinding_local);
+    if (cache == NULL)
+        return;
+    CRYPTO_THREAD_set_local(&rsa_blinding_local, NULL);
+    for (i = 0; i < RSA_THREAD_BLINDING_SLOTS; i++)
+        BN_BLINDING_free(cache->slot[i].blinding);
+    OPENSSL_free(cache);
+}
+
+void rsa_cleanup_int(void)
+{
+    if (!rsa_blinding_inited)
+        return;
+    CRYPTO_THREAD_cleanup_local(&rsa_blinding_local);
+    CRYPTO_THREAD_lock_free(rsa_blinding_id_lock);
+    rsa_blinding_id_lock = NULL;
+    rsa_blinding_inited = 0;
+}
@@ -37,6 +37,52 @@ int RSA_private_encrypt(int flen, const unsigned char *from,
     return (rsa->meth->rsa_priv_enc(flen, from, to, rsa, padding));
 }
 
+int RSA_private_encrypt_batch(size_t n, const int flen[],
+                              const unsigned char *const from[],
+                              unsigned char *const to[], int tlen[], RSA *rsa,
+                              int padding)
+{
+    size_t i;
+    int ret = 1;
+
+    if (rsa->meth->rsa_priv_enc_batch != NULL)
+        return rsa->meth->rsa_priv_enc_batch(n, flen, from, to, tlen, rsa,
+                                             padding);
+
+    for (i = 0; i < n; i++) {
+        tlen[i] = rsa->meth->rsa_priv_enc(flen[i], from[i], to[i], rsa,
+                                          padding);
+        if (tlen[i] <= 0) {
+            tlen[i] = -1;
+            ret = 0;
+        }
+    }
+    return ret;
+}
+
+int RSA_public_decrypt_batch(size_t n, const int flen[],
+                             const unsigned char *const from[],
+                             unsigned char *const to[], int tlen[], RSA *rsa,
+                             int padding)
+{
+    size_t i;
+    int ret = 1;
+
+    if (rsa->meth->rsa_pub_dec_batch != NULL)
+        return rsa->meth->rsa_pub_dec_batch(n, flen, from, to, tlen, rsa,
+                                            padding);
+
+    for (i = 0; i < n; i++) {
+        tlen[i] = rsa->meth->rsa_pub_dec(flen[i], from[i], to[i], rsa,
+                                         padding);
+        if (tlen[i] < 0) {
+            tlen[i] = -1;
+            ret = 0;
+        }
+    }
+    return ret;
+}
+
 int RSA_private_decrypt(int flen, const unsigned char *from,
                         unsigned char *to, RSA *rsa, int padding)
 {
@@ -40,10 +40,20 @@ static ERR_STRING_DATA RSA_str_functs[] = {
     {ERR_FUNC(RSA_F_RSA_METH_NEW), "RSA_meth_new"},
     {ERR_FUNC(RSA_F_RSA_METH_SET1_NAME), "RSA_meth_set1_name"},
     {ERR_FUNC(RSA_F_RSA_MGF1_TO_MD), "rsa_mgf1_to_md"},
+    {ERR_FUNC(RSA_F_RSA_MULTIP_CALC_PRODUCT), "rsa_multip_calc_product"},
+    {ERR_FUNC(RSA_F_RSA_MULTIP_INFO_NEW), "rsa_multip_info_new"},
     {ERR_FUNC(RSA_F_RSA_NEW_METHOD), "RSA_new_method"},
     {ERR_FUNC(RSA_F_RSA_OSSL_PRIVATE_DECRYPT), "rsa_ossl_private_decrypt"},
     {ERR_FUNC(RSA_F_RSA_OSSL_PRIVATE_ENCRYPT), "rsa_ossl_private_encrypt"},
+    {ERR_FUNC(RSA_F_RSA_OSSL_PRIVATE_ENCRYPT_BATCH),
+     "rsa_ossl_private_encrypt_batch"},
+    {ERR_FUNC(RSA_F_RSA_OSSL_PRIVATE_ENCRYPT_PAD),
+     "rsa_ossl_private_encrypt_pad"},
+    {ERR_FUNC(RSA_F_RSA_OSSL_PRIVATE_OP), "rsa_ossl_private_op"},
+    {ERR_FUNC(RSA_F_RSA_OSSL_PUBLIC_CHECK), "rsa_ossl_public_check"},
     {ERR_FUNC(RSA_F_RSA_OSSL_PUBLIC_DECRYPT), "rsa_ossl_public_decrypt"},
+    {ERR_FUNC(RSA_F_RSA_OSSL_PUBLIC_DECRYPT_BATCH),
+     "rsa_ossl_public_decrypt_batch"},
     {ERR_FUNC(RSA_F_RSA_OSSL_PUBLIC_ENCRYPT), "rsa_ossl_public_encrypt"},
     {ERR_FUNC(RSA_F_RSA_PADDING_ADD_NONE), "RSA_padding_add_none"},
     {ERR_FUNC(RSA_F_RSA_PADDING_ADD_PKCS1_OAEP),
@@ -123,6 +133,7 @@ static ERR_STRING_DATA RSA_str_reasons[] = {
     {ERR_REASON(RSA_R_INVALID_LABEL), "invalid label"},
     {ERR_REASON(RSA_R_INVALID_MESSAGE_LENGTH), "invalid message length"},
     {ERR_REASON(RSA_R_INVALID_MGF1_MD), "invalid mgf1 md"},
+    {ERR_REASON(RSA_R_INVALID_MULTI_PRIME_KEY), "invalid multi prime key"},
     {ERR_REASON(RSA_R_INVALID_OAEP_PARAMETERS), "invalid oaep parameters"},
     {ERR_REASON(RSA_R_INVALID_PADDING), "invalid padding"},
     {ERR_REASON(RSA_R_INVALID_PADDING_MODE), "invalid padding mode"},
@@ -132,13 +143,21 @@ static ERR_STRING_DATA RSA_str_reasons[] = {
     {ERR_REASON(RSA_R_INVALID_TRAILER), "invalid trailer"},
     {ERR_REASON(RSA_R_INVALID_X931_DIGEST), "invalid x931 digest"},
     {ERR_REASON(RSA_R_IQMP_NOT_INVERSE_OF_Q), "iqmp not inverse of q"},
+    {ERR_REASON(RSA_R_KEY_PRIME_NUM_INVALID), "key prime num invalid"},
     {ERR_REASON(RSA_R_KEY_SIZE_TOO_SMALL), "key size too small"},
     {ERR_REASON(RSA_R_LAST_OCTET_INVALID), "last octet invalid"},
     {ERR_REASON(RSA_R_MGF1_DIGEST_NOT_ALLOWED), "mgf1 digest not allowed"},
     {ERR_REASON(RSA_R_MODULUS_TOO_LARGE), "modulus too large"},
+    {ERR_REASON(RSA_R_MP_COEFFICIENT_NOT_INVERSE_OF_R),
+     "mp coefficient not inverse of r"},
+    {ERR_REASON(RSA_R_MP_EXPONENT_NOT_CONGRUENT_TO_D),
+     "mp exponent not congruent to d"},
+    {ERR_REASON(RSA_R_MP_R_NOT_PRIME), "mp r not prime"},
     {ERR_REASON(RSA_R_NO_PUBLIC_EXPONENT), "no public exponent"},
     {ERR_REASON(RSA_R_NULL_BEFORE_BLOCK_MISSING),
      "null before block missing"},
+    {ERR_REASON(RSA_R_N_DOES_NOT_EQUAL_PRODUCT_OF_PRIMES),
+     "n does not equal product of primes"},
     {ERR_REASON(RSA_R_N_DOES_NOT_EQUAL_P_Q), "n does not equal p q"},
     {ERR_REASON(RSA_R_OAEP_DECODING_ERROR), "oaep decoding error"},
     {ERR_REASON(RSA_R_OPERATION_NOT_SUPPORTED_FOR_THIS_KEYTYPE),
@@ -19,7 +19,13 @@
 #include <openssl/bn.h>
 #include "rsa_locl.h"
 
-static int rsa_builtin_keygen(RSA *rsa, int bits, BIGNUM *e_value,
+/*
+ * How often the last prime is regenerated before the whole set of primes
+ * is, when their product comes out a bit short.
+ */
+#define RSA_MAX_KEYGEN_RETRIES  4
+
+static int rsa_builtin_keygen(RSA *rsa, int bits, int primes, BIGNUM *e_value,
                               BN_GENCB *cb);
 
 /*
@@ -33,14 +39,34 @@ int RSA_generate_key_ex(RSA *rsa, int bits, BIGNUM *e_value, BN_GENCB *cb)
 {
     if (rsa->meth->rsa_keygen)
         return rsa->meth->rsa_keygen(rsa, bits, e_value, cb);
-    return rsa_builtin_keygen(rsa, bits, e_value, cb);
+    return RSA_generate_multi_prime_key(rsa, bits, RSA_DEFAULT_PRIME_NUM,
+                                        e_value, cb);
+}
+
+int RSA_generate_multi_prime_key(RSA *rsa, int bits, int primes,
+                                 BIGNUM *e_value, BN_GENCB *cb)
+{
+    if (rsa->meth->rsa_multi_prime_keygen)
+        return rsa->meth->rsa_multi_prime_keygen(rsa, bits, primes,
+                                                 e_value, cb);
+    /* a method with its own two-prime key-gen can't do more primes */
+    if (rsa->meth->rsa_keygen) {
+        if (primes == RSA_DEFAULT_PRIME_NUM)
+            return rsa->meth->rsa_keygen(rsa, bits, e_value, cb);
+        RSAerr(RSA_F_RSA_BUILTIN_KEYGEN, RSA_R_KEY_PRIME_NUM_INVALID);
+        return 0;
+    }
+    return rsa_builtin_keygen(rsa, bits, primes, e_value, cb);
 }
 
-static int rsa_builtin_keygen(RSA *rsa, int bits, BIGNUM *e_value,
+static int rsa_builtin_keygen(RSA *rsa, int bits, int primes, BIGNUM *e_value,
                               BN_GENCB *cb)
 {
-    BIGNUM *r0 = NULL, *r1 = NULL, *r2 = NULL, *r3 = NULL, *tmp;
-    int bitsp, bitsq, ok = -1, n = 0;
+    BIGNUM *r0 = NULL, *r1 = NULL, *r2 = NULL, *tmp, *prime;
+    int bitsr[RSA_MAX_PRIME_NUM];
+    int i, j, ok = -1, n = 0, retries = 0, restart = 0;
+    STACK_OF(RSA_PRIME_INFO) *prime_infos = NULL;
+    RSA_PRIME_INFO *pinfo;
     BN_CTX *ctx = NULL;
 
     /*
@@ -53,6 +79,12 @@ static int rsa_builtin_keygen(RSA *rsa, int bits, BIGNUM *e_value,
         goto err;
     }
 
+    if (primes < RSA_DEFAULT_PRIME_NUM || primes > rsa_multip_cap(bits)) {
+        ok = 0;             /* we set our own err */
+        RSAerr(RSA_F_RSA_BUILTIN_KEYGEN, RSA_R_KEY_PRIME_NUM_INVALID);
+        goto err;
+    }
+
     ctx = BN_CTX_new();
     if (ctx == NULL)
         goto err;
@@ -60,12 +92,12 @@ static int rsa_builtin_keygen(RSA *rsa, int bits, BIGNUM *e_value,
     r0 = BN_CTX_get(ctx);
     r1 = BN_CTX_get(ctx);
     r2 = BN_CTX_get(ctx);
-    r3 = BN_CTX_get(ctx);
-    if (r3 == NULL)
+    if (r2 == NULL)
         goto err;
 
-    bitsp = (bits + 1) / 2;
-    bitsq = bits - bitsp;
+    /* divide bits into 'primes' pieces evenly, the first ones get the rest */
+    for (i = 0; i < primes; i++)
+        bitsr[i] = bits / primes + (i < bits % primes ? 1 : 0);
 
     /* We need the RSA components non-NULL */
     if (!rsa->n && ((rsa->n = BN_new()) == NULL))
@@ -85,48 +117,101 @@ static int rsa_builtin_keygen(RSA *rsa, int bits, BIGNUM *e_value,
     if (!rsa->iqmp && ((rsa->iqmp = BN_secure_new()) == NULL))
         goto err;
 
-    if (BN_copy(rsa->e, e_value) == NULL)
-        goto err;
-
-    /* generate p and q */
-    for (;;) {
-        if (!BN_generate_prime_ex(rsa->p, bitsp, 0, NULL, NULL, cb))
-            goto err;
-        if (!BN_sub(r2, rsa->p, BN_value_one()))
-            goto err;
-        if (!BN_gcd(r1, r2, rsa->e, ctx))
-            goto err;
-        if (BN_is_one(r1))
-            break;
-        if (!BN_GENCB_call(cb, 2, n++))
+    /* the extra primes, if any, are kept in RSA_PRIME_INFO */
+    if (primes > RSA_DEFAULT_PRIME_NUM) {
+        if ((prime_infos = sk_RSA_PRIME_INFO_new_null()) == NULL)
             goto err;
+        for (i = RSA_DEFAULT_PRIME_NUM; i < primes; i++) {
+            if ((pinfo = rsa_multip_info_new()) == NULL)
+                goto err;
+            if (!sk_RSA_PRIME_INFO_push(prime_infos, pinfo)) {
+                rsa_multip_info_free(pinfo);
+                goto err;
+            }
+        }
     }
-    if (!BN_GENCB_call(cb, 3, 0))
+
+    if (BN_copy(rsa->e, e_value) == NULL)
         goto err;
-    for (;;) {
-        do {
-            if (!BN_generate_prime_ex(rsa->q, bitsq, 0, NULL, NULL, cb))
+
+    /* generate p, q and other primes (if any) */
+    for (i = 0; i < primes; i++) {
+        if (i == 0) {
+            prime = rsa->p;
+        } else if (i == 1) {
+            prime = rsa->q;
+        } else {
+            pinfo = sk_RSA_PRIME_INFO_value(prime_infos, i - 2);
+            prime = pinfo->r;
+        }
+
+        for (;;) {
+ redo:
+            if (!BN_generate_prime_ex(prime, bitsr[i], 0, NULL, NULL, cb))
                 goto err;
-        } while (BN_cmp(rsa->p, rsa->q) == 0);
-        if (!BN_sub(r2, rsa->q, BN_value_one()))
-            goto err;
-        if (!BN_gcd(r1, r2, rsa->e, ctx))
-            goto err;
-        if (BN_is_one(r1))
-            break;
-        if (!BN_GENCB_call(cb, 2, n++))
+            /* all primes must be distinct */
+            for (j = 0; j < i; j++) {
+                if (j == 0)
+                    tmp = rsa->p;
+                else if (j == 1)
+                    tmp = rsa->q;
+                else
+                    tmp = sk_RSA_PRIME_INFO_value(prime_infos, j - 2)->r;
+                if (BN_cmp(prime, tmp) == 0)
+                    goto redo;
+            }
+            if (!BN_sub(r2, prime, BN_value_one()))
+                goto err;
+            if (!BN_gcd(r1, r2, rsa->e, ctx))
+                goto err;
+            if (BN_is_one(r1)) {
+                if (i == 0) {
+                    if (BN_copy(r0, prime) == NULL)
+                        goto err;
+                    break;
+                }
+                if (!BN_mul(r1, r0, prime, ctx))
+                    goto err;
+                /*
+                 * Two primes with their top two bits set always multiply
+                 * to |bits|, with more the product can come out a bit short.
+                 */
+                if (i < primes - 1 || BN_num_bits(r1) == bits) {
+                    if (BN_copy(r0, r1) == NULL)
+                        goto err;
+                    break;
+                }
+                /*
+                 * If the other primes are too small, no last prime can
+                 * make up for them, so start over with all of them.
+                 */
+                if (++retries == RSA_MAX_KEYGEN_RETRIES) {
+                    retries = 0;
+                    restart = 1;
+                    if (!BN_GENCB_call(cb, 2, n++))
+                        goto err;
+                    break;
+                }
+            }
+            if (!BN_GENCB_call(cb, 2, n++))
+                goto err;
+        }
+        if (restart) {
+            restart = 0;
+            i = -1;
+            continue;
+        }
+        if (!BN_GENCB_call(cb, 3, i))
             goto err;
     }
-    if (!BN_GENCB_call(cb, 3, 1))
-        goto err;
     if (BN_cmp(rsa->p, rsa->q) < 0) {
         tmp = rsa->p;
         rsa->p = rsa->q;
         rsa->q = tmp;
     }
 
-    /* calculate n */
-    if (!BN_mul(rsa->n, rsa->p, rsa->q, ctx))
+    /* n is the product of all primes */
+    if (BN_copy(rsa->n, r0) == NULL)
         goto err;
 
     /* calculate d */
@@ -136,6 +221,13 @@ static int rsa_builtin_keygen(RSA *rsa, int bits, BIGNUM *e_value,
         goto err;               /* q-1 */
     if (!BN_mul(r0, r1, r2, ctx))
         goto err;               /* (p-1)(q-1) */
+    for (i = 0; i < primes - RSA_DEFAULT_PRIME_NUM; i++) {
+        pinfo = sk_RSA_PRIME_INFO_value(prime_infos, i);
+        if (!BN_sub(r2, pinfo->r, BN_value_one()))
+            goto err;
+        if (!BN_mul(r0, r0, r2, ctx))
+            goto err;           /* (p-1)(q-1)...(r_i-1) */
+    }
     {
         BIGNUM *pr0 = BN_new();
 
@@ -158,12 +250,24 @@ static int rsa_builtin_keygen(RSA *rsa, int bits, BIGNUM *e_value,
         BN_with_flags(d, rsa->d, BN_FLG_CONSTTIME);
 
         if (   /* calculate d mod (p-1) */
-               !BN_mod(rsa->dmp1, d, r1, ctx)
+               !BN_sub(r1, rsa->p, BN_value_one())
+            || !BN_mod(rsa->dmp1, d, r1, ctx)
                /* calculate d mod (q-1) */
+            || !BN_sub(r2, rsa->q, BN_value_one())
             || !BN_mod(rsa->dmq1, d, r2, ctx)) {
             BN_free(d);
             goto err;
         }
+
+        /* calculate d mod (r_i-1) for the extra primes */
+        for (i = 0; i < primes - RSA_DEFAULT_PRIME_NUM; i++) {
+            pinfo = sk_RSA_PRIME_INFO_value(prime_infos, i);
+            if (!BN_sub(r1, pinfo->r, BN_value_one())
+                || !BN_mod(pinfo->d, d, r1, ctx)) {
+                BN_free(d);
+                goto err;
+            }
+        }
         /* We MUST free d before any further use of rsa->d */
         BN_free(d);
     }
@@ -184,12 +288,41 @@ static int rsa_builtin_keygen(RSA *rsa, int bits, BIGNUM *e_value,
         BN_free(p);
     }
 
+    /* install the extra primes, replacing any the key had before */
+    sk_RSA_PRIME_INFO_pop_free(rsa->prime_infos, rsa_multip_info_free);
+    rsa->prime_infos = prime_infos;
+    prime_infos = NULL;
+    rsa->version = RSA_ASN1_VERSION_DEFAULT;
+
+    if (rsa->prime_infos != NULL) {
+        rsa->version = RSA_ASN1_VERSION_MULTI;
+        if (!rsa_multip_calc_product(rsa))
+            goto err;
+
+        /* calculate the inverse of the product of the previous primes */
+        for (i = 0; i < primes - RSA_DEFAULT_PRIME_NUM; i++) {
+            BIGNUM *r = BN_new();
+
+            if (r == NULL)
+                goto err;
+            pinfo = sk_RSA_PRIME_INFO_value(rsa->prime_infos, i);
+            BN_with_flags(r, pinfo->r, BN_FLG_CONSTTIME);
+            if (!BN_mod_inverse(pinfo->t, pinfo->pp, r, ctx)) {
+                BN_free(r);
+                goto err;
+            }
+            /* We MUST free r before any further use of pinfo->r */
+            BN_free(r);
+        }
+    }
+
     ok = 1;
  err:
     if (ok == -1) {
         RSAerr(RSA_F_RSA_BUILTIN_KEYGEN, ERR_LIB_BN);
         ok = 0;
     }
+    sk_RSA_PRIME_INFO_pop_free(prime_infos, rsa_multip_info_free);
     if (ctx != NULL)
         BN_CTX_end(ctx);
     BN_CTX_free(ctx);
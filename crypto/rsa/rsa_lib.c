@@ -64,6 +64,13 @@ RSA *RSA_new_method(ENGINE *engine)
         return NULL;
     }
 
+    if (!rsa_blinding_new_id(&ret->blinding_id)) {
+        RSAerr(RSA_F_RSA_NEW_METHOD, ERR_R_INTERNAL_ERROR);
+        CRYPTO_THREAD_lock_free(ret->lock);
+        OPENSSL_free(ret);
+        return NULL;
+    }
+
     ret->meth = RSA_get_default_method();
 #ifndef OPENSSL_NO_ENGINE
     ret->flags = ret->meth->flags & ~RSA_FLAG_NON_FIPS_ALLOW;
@@ -132,6 +139,7 @@ void RSA_free(RSA *r)
     BN_clear_free(r->dmp1);
     BN_clear_free(r->dmq1);
     BN_clear_free(r->iqmp);
+    sk_RSA_PRIME_INFO_pop_free(r->prime_infos, rsa_multip_info_free);
     RSA_PSS_PARAMS_free(r->pss);
     BN_BLINDING_free(r->blinding);
     BN_BLINDING_free(r->mt_blinding);
@@ -239,6 +247,62 @@ int RSA_set0_crt_params(RSA *r, BIGNUM *dmp1, BIGNUM *dmq1, BIGNUM *iqmp)
     return 1;
 }
 
+/*
+ * Set the extra primes of a multi-prime key, p and q being set with
+ * RSA_set0_factors(). On success ownership of all the passed BIGNUMs is
+ * transferred to |r|, on failure none of them is freed.
+ */
+int RSA_set0_multi_prime_params(RSA *r, BIGNUM *primes[], BIGNUM *exps[],
+                                BIGNUM *coeffs[], int pnum)
+{
+    STACK_OF(RSA_PRIME_INFO) *prime_infos, *old;
+    RSA_PRIME_INFO *pinfo;
+    int i;
+
+    if (primes == NULL || exps == NULL || coeffs == NULL || pnum <= 0
+            || pnum + 2 > RSA_MAX_PRIME_NUM)
+        return 0;
+
+    prime_infos = sk_RSA_PRIME_INFO_new_null();
+    if (prime_infos == NULL)
+        return 0;
+
+    for (i = 0; i < pnum; i++) {
+        if (primes[i] == NULL || exps[i] == NULL || coeffs[i] == NULL)
+            goto err;
+        pinfo = OPENSSL_zalloc(sizeof(*pinfo));
+        if (pinfo == NULL)
+            goto err;
+        pinfo->r = primes[i];
+        pinfo->d = exps[i];
+        pinfo->t = coeffs[i];
+        if (!sk_RSA_PRIME_INFO_push(prime_infos, pinfo)) {
+            OPENSSL_free(pinfo);
+            goto err;
+        }
+    }
+
+    old = r->prime_infos;
+    r->prime_infos = prime_infos;
+    if (!rsa_multip_calc_product(r)) {
+        r->prime_infos = old;
+        goto err;
+    }
+
+    sk_RSA_PRIME_INFO_pop_free(old, rsa_multip_info_free);
+    r->version = RSA_ASN1_VERSION_MULTI;
+
+    return 1;
+ err:
+    /* the caller still owns r, d and t */
+    for (i = 0; i < sk_RSA_PRIME_INFO_num(prime_infos); i++) {
+        pinfo = sk_RSA_PRIME_INFO_value(prime_infos, i);
+        pinfo->r = pinfo->d = pinfo->t = NULL;
+    }
+    sk_RSA_PRIME_INFO_pop_free(prime_infos, rsa_multip_info_free);
+    return 0;
+}
+
 void RSA_get0_key(const RSA *r,
                   const BIGNUM **n, const BIGNUM **e, const BIGNUM **d)
 {
@@ -270,6 +334,53 @@ void RSA_get0_crt_params(const RSA *r,
         *iqmp = r->iqmp;
 }
 
+int RSA_get_multi_prime_extra_count(const RSA *r)
+{
+    int pnum;
+
+    pnum = sk_RSA_PRIME_INFO_num(r->prime_infos);
+    if (pnum <= 0)
+        pnum = 0;
+    return pnum;
+}
+
+int RSA_get0_multi_prime_factors(const RSA *r, const BIGNUM *primes[])
+{
+    int pnum, i;
+    RSA_PRIME_INFO *pinfo;
+
+    if ((pnum = RSA_get_multi_prime_extra_count(r)) == 0)
+        return 0;
+
+    /* |primes| must have room for RSA_get_multi_prime_extra_count() */
+    for (i = 0; i < pnum; i++) {
+        pinfo = sk_RSA_PRIME_INFO_value(r->prime_infos, i);
+        primes[i] = pinfo->r;
+    }
+
+    return 1;
+}
+
+int RSA_get0_multi_prime_crt_params(const RSA *r, const BIGNUM *exps[],
+                                    const BIGNUM *coeffs[])
+{
+    int pnum, i;
+    RSA_PRIME_INFO *pinfo;
+
+    if ((pnum = RSA_get_multi_prime_extra_count(r)) == 0)
+        return 0;
+
+    for (i = 0; i < pnum; i++) {
+        pinfo = sk_RSA_PRIME_INFO_value(r->prime_infos, i);
+        if (exps != NULL)
+            exps[i] = pinfo->d;
+        if (coeffs != NULL)
+            coeffs[i] = pinfo->t;
+    }
+
+    return 1;
+}
+
 void RSA_clear_flags(RSA *r, int flags)
 {
     r->flags &= ~flags;
@@ -290,6 +401,12 @@ ENGINE *RSA_get0_engine(const RSA *r)
     return r->engine;
 }
 
+int RSA_get_version(RSA *r)
+{
+    /* { two-prime(0), multi(1) } */
+    return r->version;
+}
+
 int RSA_pkey_ctx_ctrl(EVP_PKEY_CTX *ctx, int optype, int cmd, int p1, void *p2)
 {
     /* If key type not RSA or RSA-PSS return error */
@@ -10,6 +10,18 @@
 #include <openssl/rsa.h>
 #include "internal/refcount.h"
 
+typedef struct rsa_prime_info_st {
+    BIGNUM *r;
+    BIGNUM *d;
+    BIGNUM *t;
+    /* product of primes prior to this one */
+    BIGNUM *pp;
+    BN_MONT_CTX *m;
+} RSA_PRIME_INFO;
+
+DECLARE_ASN1_ITEM(RSA_PRIME_INFO)
+DEFINE_STACK_OF(RSA_PRIME_INFO)
+
 struct rsa_st {
     /*
      * The first parameter is used to pickup errors where this is passed
@@ -28,6 +40,8 @@ struct rsa_st {
     BIGNUM *dmp1;
     BIGNUM *dmq1;
     BIGNUM *iqmp;
+    /* for multi-prime RSA, defined in RFC 8017 */
+    STACK_OF(RSA_PRIME_INFO) *prime_infos;
     /* If a PSS only key this contains the parameter restrictions */
     RSA_PSS_PARAMS *pss;
     /* be careful using this if the RSA structure is shared */
@@ -45,6 +59,8 @@ struct rsa_st {
     char *bignum_data;
     BN_BLINDING *blinding;
     BN_BLINDING *mt_blinding;
+    /* Identifies this object in the per-thread blinding caches */
+    int blinding_id;
     CRYPTO_RWLOCK *lock;
 };
 
@@ -91,8 +107,38 @@ struct rsa_meth_st {
      * things as "builtin software" implementations.
      */
     int (*rsa_keygen) (RSA *rsa, int bits, BIGNUM *e, BN_GENCB *cb);
+    /*
+     * Can be null: RSA_private_encrypt_batch() then falls back to calling
+     * rsa_priv_enc once per input.
+     */
+    int (*rsa_priv_enc_batch) (size_t n, const int flen[],
+                               const unsigned char *const from[],
+                               unsigned char *const to[], int tlen[],
+                               RSA *rsa, int padding);
+    /*
+     * Can be null: RSA_public_decrypt_batch() then falls back to calling
+     * rsa_pub_dec once per input.
+     */
+    int (*rsa_pub_dec_batch) (size_t n, const int flen[],
+                              const unsigned char *const from[],
+                              unsigned char *const to[], int tlen[],
+                              RSA *rsa, int padding);
+    /*
+     * If this callback is NULL, RSA_generate_multi_prime_key() uses
+     * rsa_keygen for two primes and the builtin key-gen otherwise.
+     */
+    int (*rsa_multi_prime_keygen) (RSA *rsa, int bits, int primes,
+                                   BIGNUM *e, BN_GENCB *cb);
 };
 
+int rsa_blinding_new_id(int *id);
+
+RSA_PRIME_INFO *rsa_multip_info_new(void);
+void rsa_multip_info_free(RSA_PRIME_INFO *pinfo);
+int rsa_multip_calc_product(RSA *rsa);
+int rsa_multip_cap(int bits);
+BN_BLINDING *rsa_get_thread_blinding(RSA *rsa, BN_CTX *ctx);
+
 extern int int_rsa_verify(int dtype, const unsigned char *m,
                           unsigned int m_len, unsigned char *rm,
                           size_t *prm_len, const unsigned char *sigbuf,
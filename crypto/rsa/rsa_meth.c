@@ -271,3 +271,60 @@ int RSA_meth_set_keygen(RSA_METHOD *meth,
     return 1;
 }
 
+
+int (*RSA_meth_get_priv_enc_batch(const RSA_METHOD *meth))
+    (size_t n, const int flen[], const unsigned char *const from[],
+     unsigned char *const to[], int tlen[], RSA *rsa, int padding)
+{
+    return meth->rsa_priv_enc_batch;
+}
+
+int RSA_meth_set_priv_enc_batch(RSA_METHOD *meth,
+                                int (*priv_enc_batch) (size_t n,
+                                                       const int flen[],
+                                                       const unsigned char
+                                                       *const from[],
+                                                       unsigned char
+                                                       *const to[],
+                                                       int tlen[], RSA *rsa,
+                                                       int padding))
+{
+    meth->rsa_priv_enc_batch = priv_enc_batch;
+    return 1;
+}
+
+int (*RSA_meth_get_pub_dec_batch(const RSA_METHOD *meth))
+    (size_t n, const int flen[], const unsigned char *const from[],
+     unsigned char *const to[], int tlen[], RSA *rsa, int padding)
+{
+    return meth->rsa_pub_dec_batch;
+}
+
+int RSA_meth_set_pub_dec_batch(RSA_METHOD *meth,
+                               int (*pub_dec_batch) (size_t n,
+                                                     const int flen[],
+                                                     const unsigned char
+                                                     *const from[],
+                                                     unsigned char
+                                                     *const to[],
+                                                     int tlen[], RSA *rsa,
+                                                     int padding))
+{
+    meth->rsa_pub_dec_batch = pub_dec_batch;
+    return 1;
+}
+
+int (*RSA_meth_get_multi_prime_keygen(const RSA_METHOD *meth))
+    (RSA *rsa, int bits, int primes, BIGNUM *e, BN_GENCB *cb)
+{
+    return meth->rsa_multi_prime_keygen;
+}
+
+int RSA_meth_set_multi_prime_keygen(RSA_METHOD *meth,
+                                    int (*keygen) (RSA *rsa, int bits,
+                                                   int primes, BIGNUM *e,
+                                                   BN_GENCB *cb))
+{
+    meth->rsa_multi_prime_keygen = keygen;
+    return 1;
+}
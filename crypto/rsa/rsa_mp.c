@@ -0,0 +1,108 @@
+/*
+ * Copyright 2017 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the OpenSSL license (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+#include <openssl/bn.h>
+#include <openssl/err.h>
+#include "rsa_locl.h"
+
+void rsa_multip_info_free(RSA_PRIME_INFO *pinfo)
+{
+    if (pinfo == NULL)
+        return;
+    BN_clear_free(pinfo->r);
+    BN_clear_free(pinfo->d);
+    BN_clear_free(pinfo->t);
+    BN_clear_free(pinfo->pp);
+    BN_MONT_CTX_free(pinfo->m);
+    OPENSSL_free(pinfo);
+}
+
+RSA_PRIME_INFO *rsa_multip_info_new(void)
+{
+    RSA_PRIME_INFO *pinfo;
+
+    /* create a RSA_PRIME_INFO structure */
+    if ((pinfo = OPENSSL_zalloc(sizeof(*pinfo))) == NULL) {
+        RSAerr(RSA_F_RSA_MULTIP_INFO_NEW, ERR_R_MALLOC_FAILURE);
+        return NULL;
+    }
+    if ((pinfo->r = BN_secure_new()) == NULL
+            || (pinfo->d = BN_secure_new()) == NULL
+            || (pinfo->t = BN_secure_new()) == NULL
+            || (pinfo->pp = BN_secure_new()) == NULL) {
+        RSAerr(RSA_F_RSA_MULTIP_INFO_NEW, ERR_R_MALLOC_FAILURE);
+        rsa_multip_info_free(pinfo);
+        return NULL;
+    }
+    return pinfo;
+}
+
+/*
+ * Refill pinfo->pp, the product of all primes before the one in pinfo,
+ * for every extra prime. These are needed by the CRT in rsa_ossl.c.
+ */
+int rsa_multip_calc_product(RSA *rsa)
+{
+    RSA_PRIME_INFO *pinfo;
+    BIGNUM *p1, *p2;
+    BN_CTX *ctx = NULL;
+    int i, rv = 0, ex_primes;
+
+    ex_primes = sk_RSA_PRIME_INFO_num(rsa->prime_infos);
+    if (ex_primes <= 0 || ex_primes + 2 > RSA_MAX_PRIME_NUM
+            || rsa->p == NULL || rsa->q == NULL) {
+        RSAerr(RSA_F_RSA_MULTIP_CALC_PRODUCT, RSA_R_INVALID_MULTI_PRIME_KEY);
+        return 0;
+    }
+
+    if ((ctx = BN_CTX_new()) == NULL) {
+        RSAerr(RSA_F_RSA_MULTIP_CALC_PRODUCT, ERR_R_MALLOC_FAILURE);
+        return 0;
+    }
+
+    p1 = rsa->p;
+    p2 = rsa->q;
+    for (i = 0; i < ex_primes; i++) {
+        pinfo = sk_RSA_PRIME_INFO_value(rsa->prime_infos, i);
+        if (pinfo->pp == NULL && (pinfo->pp = BN_secure_new()) == NULL) {
+            RSAerr(RSA_F_RSA_MULTIP_CALC_PRODUCT, ERR_R_MALLOC_FAILURE);
+            goto err;
+        }
+        if (!BN_mul(pinfo->pp, p1, p2, ctx)) {
+            RSAerr(RSA_F_RSA_MULTIP_CALC_PRODUCT, ERR_R_BN_LIB);
+            goto err;
+        }
+        p1 = pinfo->pp;
+        p2 = pinfo->r;
+    }
+
+    rv = 1;
+ err:
+    BN_CTX_free(ctx);
+    return rv;
+}
+
+/*
+ * The largest number of primes a |bits| modulus may have: with more, the
+ * factors get small enough for ECM to find them faster than the NFS can
+ * factor the modulus.
+ */
+int rsa_multip_cap(int bits)
+{
+    int cap = RSA_MAX_PRIME_NUM;
+
+    if (bits < 1024)
+        cap = 2;
+    else if (bits < 4096)
+        cap = 3;
+    else if (bits < 8192)
+        cap = 4;
+
+    return cap;
+}
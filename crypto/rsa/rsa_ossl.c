@@ -15,8 +15,16 @@ static int rsa_ossl_public_encrypt(int flen, const unsigned char *from,
                                   unsigned char *to, RSA *rsa, int padding);
 static int rsa_ossl_private_encrypt(int flen, const unsigned char *from,
                                    unsigned char *to, RSA *rsa, int padding);
+static int rsa_ossl_private_encrypt_batch(size_t n, const int flen[],
+                                          const unsigned char *const from[],
+                                          unsigned char *const to[],
+                                          int tlen[], RSA *rsa, int padding);
 static int rsa_ossl_public_decrypt(int flen, const unsigned char *from,
                                   unsigned char *to, RSA *rsa, int padding);
+static int rsa_ossl_public_decrypt_batch(size_t n, const int flen[],
+                                         const unsigned char *const from[],
+                                         unsigned char *const to[],
+                                         int tlen[], RSA *rsa, int padding);
 static int rsa_ossl_private_decrypt(int flen, const unsigned char *from,
                                    unsigned char *to, RSA *rsa, int padding);
 static int rsa_ossl_mod_exp(BIGNUM *r0, const BIGNUM *i, RSA *rsa,
@@ -38,7 +46,10 @@ static RSA_METHOD rsa_pkcs1_ossl_meth = {
     NULL,
     0,                          /* rsa_sign */
     0,                          /* rsa_verify */
-    NULL                        /* rsa_keygen */
+    NULL,                       /* rsa_keygen */
+    rsa_ossl_private_encrypt_batch,
+    rsa_ossl_public_decrypt_batch,
+    NULL                        /* rsa_multi_prime_keygen */
 };
 
 static const RSA_METHOD *default_RSA_meth = &rsa_pkcs1_ossl_meth;
@@ -132,7 +143,7 @@ static int rsa_ossl_public_encrypt(int flen, const unsigned char *from,
     }
 
     if (rsa->flags & RSA_FLAG_CACHE_PUBLIC)
-        if (!BN_MONT_CTX_set_locked
+        if (!bn_mont_ctx_set_locked_cached
             (&rsa->_method_mod_n, rsa->lock, rsa->n, ctx))
             goto err;
 
@@ -162,6 +173,16 @@ static BN_BLINDING *rsa_get_blinding(RSA *rsa, int *local, BN_CTX *ctx)
 {
     BN_BLINDING *ret;
 
+    /*
+     * The common case: a blinding private to this thread, found without
+     * taking any lock.
+     */
+    if ((ret = rsa_get_thread_blinding(rsa, ctx)) != NULL) {
+        *local = 1;
+        return ret;
+    }
+
+    /* Otherwise fall back to the blindings shared through the RSA object */
     CRYPTO_THREAD_write_lock(rsa->lock);
 
     if (rsa->blinding == NULL) {
@@ -233,6 +254,85 @@ static int rsa_blinding_invert(BN_BLINDING *b, BIGNUM *f, BIGNUM *unblind,
     return BN_BLINDING_invert_ex(f, unblind, b, ctx);
 }
 
+/*
+ * Apply signature padding to |from| and convert the result into |f|, using
+ * |buf| (|num| bytes) as scratch space.
+ */
+static int rsa_ossl_private_encrypt_pad(BIGNUM *f, unsigned char *buf,
+                                        int num, int flen,
+                                        const unsigned char *from,
+                                        const RSA *rsa, int padding)
+{
+    int i;
+
+    switch (padding) {
+    case RSA_PKCS1_PADDING:
+        i = RSA_padding_add_PKCS1_type_1(buf, num, from, flen);
+        break;
+    case RSA_X931_PADDING:
+        i = RSA_padding_add_X931(buf, num, from, flen);
+        break;
+    case RSA_NO_PADDING:
+        i = RSA_padding_add_none(buf, num, from, flen);
+        break;
+    case RSA_SSLV23_PADDING:
+    default:
+        RSAerr(RSA_F_RSA_OSSL_PRIVATE_ENCRYPT_PAD, RSA_R_UNKNOWN_PADDING_TYPE);
+        return 0;
+    }
+    if (i <= 0)
+        return 0;
+
+    if (BN_bin2bn(buf, num, f) == NULL)
+        return 0;
+
+    if (BN_ucmp(f, rsa->n) >= 0) {
+        /* usually the padding functions would catch this */
+        RSAerr(RSA_F_RSA_OSSL_PRIVATE_ENCRYPT_PAD,
+               RSA_R_DATA_TOO_LARGE_FOR_MODULUS);
+        return 0;
+    }
+    return 1;
+}
+
+/*
+ * Perform the raw private key operation |ret| = |f|^d mod n, with |f| and
+ * |ret| already blinded/unblinded by the caller as appropriate.
+ */
+static int rsa_ossl_private_op(BIGNUM *ret, BIGNUM *f, RSA *rsa, BN_CTX *ctx)
+{
+    BIGNUM *d;
+
+    if ((rsa->flags & RSA_FLAG_EXT_PKEY) ||
+        ((rsa->p != NULL) &&
+         (rsa->q != NULL) &&
+         (rsa->dmp1 != NULL) && (rsa->dmq1 != NULL) && (rsa->iqmp != NULL)))
+        return rsa->meth->rsa_mod_exp(ret, f, rsa, ctx);
+
+    d = BN_new();
+    if (d == NULL) {
+        RSAerr(RSA_F_RSA_OSSL_PRIVATE_OP, ERR_R_MALLOC_FAILURE);
+        return 0;
+    }
+    BN_with_flags(d, rsa->d, BN_FLG_CONSTTIME);
+
+    if (rsa->flags & RSA_FLAG_CACHE_PUBLIC)
+        if (!BN_MONT_CTX_set_locked
+            (&rsa->_method_mod_n, rsa->lock, rsa->n, ctx)) {
+            BN_free(d);
+            return 0;
+        }
+
+    if (!rsa->meth->bn_mod_exp(ret, f, d, rsa->n, ctx,
+                               rsa->_method_mod_n)) {
+        BN_free(d);
+        return 0;
+    }
+    /* We MUST free d before any further use of rsa->d */
+    BN_free(d);
+    return 1;
+}
+
 /* signing */
 static int rsa_ossl_private_encrypt(int flen, const unsigned char *from,
                                    unsigned char *to, RSA *rsa, int padding)
@@ -262,34 +362,9 @@ static int rsa_ossl_private_encrypt(int flen, const unsigned char *from,
         goto err;
     }
 
-    switch (padding) {
-    case RSA_PKCS1_PADDING:
-        i = RSA_padding_add_PKCS1_type_1(buf, num, from, flen);
-        break;
-    case RSA_X931_PADDING:
-        i = RSA_padding_add_X931(buf, num, from, flen);
-        break;
-    case RSA_NO_PADDING:
-        i = RSA_padding_add_none(buf, num, from, flen);
-        break;
-    case RSA_SSLV23_PADDING:
-    default:
-        RSAerr(RSA_F_RSA_OSSL_PRIVATE_ENCRYPT, RSA_R_UNKNOWN_PADDING_TYPE);
-        goto err;
-    }
-    if (i <= 0)
-        goto err;
-
-    if (BN_bin2bn(buf, num, f) == NULL)
+    if (!rsa_ossl_private_encrypt_pad(f, buf, num, flen, from, rsa, padding))
         goto err;
 
-    if (BN_ucmp(f, rsa->n) >= 0) {
-        /* usually the padding functions would catch this */
-        RSAerr(RSA_F_RSA_OSSL_PRIVATE_ENCRYPT,
-               RSA_R_DATA_TOO_LARGE_FOR_MODULUS);
-        goto err;
-    }
-
     if (!(rsa->flags & RSA_FLAG_NO_BLINDING)) {
         blinding = rsa_get_blinding(rsa, &local_blinding, ctx);
         if (blinding == NULL) {
@@ -307,35 +382,8 @@ static int rsa_ossl_private_encrypt(int flen, const unsigned char *from,
             goto err;
     }
 
-    if ((rsa->flags & RSA_FLAG_EXT_PKEY) ||
-        ((rsa->p != NULL) &&
-         (rsa->q != NULL) &&
-         (rsa->dmp1 != NULL) && (rsa->dmq1 != NULL) && (rsa->iqmp != NULL))) {
-        if (!rsa->meth->rsa_mod_exp(ret, f, rsa, ctx))
-            goto err;
-    } else {
-        BIGNUM *d = BN_new();
-        if (d == NULL) {
-            RSAerr(RSA_F_RSA_OSSL_PRIVATE_ENCRYPT, ERR_R_MALLOC_FAILURE);
-            goto err;
-        }
-        BN_with_flags(d, rsa->d, BN_FLG_CONSTTIME);
-
-        if (rsa->flags & RSA_FLAG_CACHE_PUBLIC)
-            if (!BN_MONT_CTX_set_locked
-                (&rsa->_method_mod_n, rsa->lock, rsa->n, ctx)) {
-                BN_free(d);
-                goto err;
-            }
-
-        if (!rsa->meth->bn_mod_exp(ret, f, d, rsa->n, ctx,
-                                   rsa->_method_mod_n)) {
-            BN_free(d);
-            goto err;
-        }
-        /* We MUST free d before any further use of rsa->d */
-        BN_free(d);
-    }
+    if (!rsa_ossl_private_op(ret, f, rsa, ctx))
+        goto err;
 
     if (blinding)
         if (!rsa_blinding_invert(blinding, ret, unblind, ctx))
@@ -368,6 +416,133 @@ static int rsa_ossl_private_encrypt(int flen, const unsigned char *from,
     return (r);
 }
 
+/*
+ * Sign a batch of |n| inputs under the same key.  The per-call setup that
+ * dominates small signatures (BN_CTX, blinding lookup under rsa->lock and,
+ * for shared blinding, BN_BLINDING_lock) is paid once for the whole batch
+ * rather than once per signature.  The private key operations themselves
+ * still run one after another.  Each output is RSA_size(rsa) bytes and
+ * tlen[i] receives its length, or -1 if input i could not be signed.
+ */
+static int rsa_ossl_private_encrypt_batch(size_t n, const int flen[],
+                                          const unsigned char *const from[],
+                                          unsigned char *const to[],
+                                          int tlen[], RSA *rsa, int padding)
+{
+    BIGNUM **f = NULL, **unblind = NULL, *ret, *res;
+    int i, j, k, num = 0, r = 0, done = 0;
+    size_t idx;
+    unsigned char *buf = NULL;
+    BN_CTX *ctx = NULL;
+    int local_blinding = 0;
+    BN_BLINDING *blinding = NULL;
+
+    for (idx = 0; idx < n; idx++)
+        tlen[idx] = -1;
+    if (n == 0)
+        return 1;
+
+    if ((ctx = BN_CTX_new()) == NULL)
+        goto err;
+    BN_CTX_start(ctx);
+    ret = BN_CTX_get(ctx);
+    num = BN_num_bytes(rsa->n);
+    buf = OPENSSL_malloc(num);
+    f = OPENSSL_zalloc(sizeof(*f) * n);
+    unblind = OPENSSL_zalloc(sizeof(*unblind) * n);
+    if (ret == NULL || buf == NULL || f == NULL || unblind == NULL) {
+        RSAerr(RSA_F_RSA_OSSL_PRIVATE_ENCRYPT_BATCH, ERR_R_MALLOC_FAILURE);
+        goto err;
+    }
+
+    /* An input that cannot be padded fails on its own; tlen[] marks it */
+    r = 1;
+    for (idx = 0; idx < n; idx++) {
+        if ((f[idx] = BN_CTX_get(ctx)) == NULL
+                || (unblind[idx] = BN_CTX_get(ctx)) == NULL) {
+            RSAerr(RSA_F_RSA_OSSL_PRIVATE_ENCRYPT_BATCH, ERR_R_MALLOC_FAILURE);
+            goto err;
+        }
+        if (rsa_ossl_private_encrypt_pad(f[idx], buf, num, flen[idx],
+                                         from[idx], rsa, padding))
+            tlen[idx] = 0;
+        else
+            r = 0;
+    }
+
+    if (!(rsa->flags & RSA_FLAG_NO_BLINDING)) {
+        blinding = rsa_get_blinding(rsa, &local_blinding, ctx);
+        if (blinding == NULL) {
+            RSAerr(RSA_F_RSA_OSSL_PRIVATE_ENCRYPT_BATCH, ERR_R_INTERNAL_ERROR);
+            goto err;
+        }
+    }
+
+    if (blinding != NULL) {
+        /*
+         * The unblinding factors are always kept outside the BN_BLINDING
+         * here, since several conversions are outstanding at once.  A shared
+         * blinding is locked once for the whole batch.
+         */
+        int ok = 1;
+
+        if (!local_blinding)
+            BN_BLINDING_lock(blinding);
+        for (idx = 0; ok && idx < n; idx++)
+            if (tlen[idx] == 0)
+                ok = BN_BLINDING_convert_ex(f[idx], unblind[idx], blinding,
+                                            ctx);
+        if (!local_blinding)
+            BN_BLINDING_unlock(blinding);
+        if (!ok)
+            goto err;
+    }
+
+    for (idx = 0; idx < n; idx++) {
+        if (tlen[idx] < 0)
+            continue;
+        if (!rsa_ossl_private_op(ret, f[idx], rsa, ctx))
+            goto err;
+
+        if (blinding)
+            if (!BN_BLINDING_invert_ex(ret, unblind[idx], blinding, ctx))
+                goto err;
+
+        if (padding == RSA_X931_PADDING) {
+            BN_sub(f[idx], rsa->n, ret);
+            if (BN_cmp(ret, f[idx]) > 0)
+                res = f[idx];
+            else
+                res = ret;
+        } else
+            res = ret;
+
+        j = BN_num_bytes(res);
+        i = BN_bn2bin(res, &(to[idx][num - j]));
+        for (k = 0; k < (num - i); k++)
+            to[idx][k] = 0;
+    }
+
+    /* Only report lengths once the whole batch has gone through */
+    for (idx = 0; idx < n; idx++)
+        if (tlen[idx] == 0)
+            tlen[idx] = num;
+    done = 1;
+ err:
+    if (!done) {
+        for (idx = 0; idx < n; idx++)
+            tlen[idx] = -1;
+        r = 0;
+    }
+    if (ctx != NULL)
+        BN_CTX_end(ctx);
+    BN_CTX_free(ctx);
+    OPENSSL_free(f);
+    OPENSSL_free(unblind);
+    OPENSSL_clear_free(buf, num);
+    return (r);
+}
+
 static int rsa_ossl_private_decrypt(int flen, const unsigned char *from,
                                    unsigned char *to, RSA *rsa, int padding)
 {
@@ -435,34 +610,8 @@ static int rsa_ossl_private_decrypt(int flen, const unsigned char *from,
     }
 
     /* do the decrypt */
-    if ((rsa->flags & RSA_FLAG_EXT_PKEY) ||
-        ((rsa->p != NULL) &&
-         (rsa->q != NULL) &&
-         (rsa->dmp1 != NULL) && (rsa->dmq1 != NULL) && (rsa->iqmp != NULL))) {
-        if (!rsa->meth->rsa_mod_exp(ret, f, rsa, ctx))
-            goto err;
-    } else {
-        BIGNUM *d = BN_new();
-        if (d == NULL) {
-            RSAerr(RSA_F_RSA_OSSL_PRIVATE_DECRYPT, ERR_R_MALLOC_FAILURE);
-            goto err;
-        }
-        BN_with_flags(d, rsa->d, BN_FLG_CONSTTIME);
-
-        if (rsa->flags & RSA_FLAG_CACHE_PUBLIC)
-            if (!BN_MONT_CTX_set_locked
-                (&rsa->_method_mod_n, rsa->lock, rsa->n, ctx)) {
-                BN_free(d);
-                goto err;
-            }
-        if (!rsa->meth->bn_mod_exp(ret, f, d, rsa->n, ctx,
-                                   rsa->_method_mod_n)) {
-            BN_free(d);
-            goto err;
-        }
-        /* We MUST free d before any further use of rsa->d */
-        BN_free(d);
-    }
+    if (!rsa_ossl_private_op(ret, f, rsa, ctx))
+        goto err;
 
     if (blinding)
         if (!rsa_blinding_invert(blinding, ret, unblind, ctx))
@@ -500,78 +649,77 @@ static int rsa_ossl_private_decrypt(int flen, const unsigned char *from,
 }
 
 /* signature verification */
-static int rsa_ossl_public_decrypt(int flen, const unsigned char *from,
-                                  unsigned char *to, RSA *rsa, int padding)
+/* Checks that the public key of |rsa| is usable for public operations */
+static int rsa_ossl_public_check(RSA *rsa)
 {
-    BIGNUM *f, *ret;
-    int i, num = 0, r = -1;
-    unsigned char *p;
-    unsigned char *buf = NULL;
-    BN_CTX *ctx = NULL;
-
     if (BN_num_bits(rsa->n) > OPENSSL_RSA_MAX_MODULUS_BITS) {
-        RSAerr(RSA_F_RSA_OSSL_PUBLIC_DECRYPT, RSA_R_MODULUS_TOO_LARGE);
-        return -1;
+        RSAerr(RSA_F_RSA_OSSL_PUBLIC_CHECK, RSA_R_MODULUS_TOO_LARGE);
+        return 0;
     }
 
     if (BN_ucmp(rsa->n, rsa->e) <= 0) {
-        RSAerr(RSA_F_RSA_OSSL_PUBLIC_DECRYPT, RSA_R_BAD_E_VALUE);
-        return -1;
+        RSAerr(RSA_F_RSA_OSSL_PUBLIC_CHECK, RSA_R_BAD_E_VALUE);
+        return 0;
     }
 
     /* for large moduli, enforce exponent limit */
     if (BN_num_bits(rsa->n) > OPENSSL_RSA_SMALL_MODULUS_BITS) {
         if (BN_num_bits(rsa->e) > OPENSSL_RSA_MAX_PUBEXP_BITS) {
-            RSAerr(RSA_F_RSA_OSSL_PUBLIC_DECRYPT, RSA_R_BAD_E_VALUE);
-            return -1;
+            RSAerr(RSA_F_RSA_OSSL_PUBLIC_CHECK, RSA_R_BAD_E_VALUE);
+            return 0;
         }
     }
+    return 1;
+}
 
-    if ((ctx = BN_CTX_new()) == NULL)
-        goto err;
-    BN_CTX_start(ctx);
-    f = BN_CTX_get(ctx);
-    ret = BN_CTX_get(ctx);
-    num = BN_num_bytes(rsa->n);
-    buf = OPENSSL_malloc(num);
-    if (f == NULL || ret == NULL || buf == NULL) {
-        RSAerr(RSA_F_RSA_OSSL_PUBLIC_DECRYPT, ERR_R_MALLOC_FAILURE);
-        goto err;
-    }
-
+/*
+ * Loads one signature into |f| and checks that it is smaller than the
+ * modulus.  If |quiet| is set no error is raised, so the caller can retry the
+ * input through rsa_ossl_public_decrypt_one().
+ */
+static int rsa_ossl_public_decrypt_load(BIGNUM *f, int flen,
+                                        const unsigned char *from, RSA *rsa,
+                                        int quiet)
+{
     /*
      * This check was for equality but PGP does evil things and chops off the
      * top '0' bytes
      */
-    if (flen > num) {
-        RSAerr(RSA_F_RSA_OSSL_PUBLIC_DECRYPT, RSA_R_DATA_GREATER_THAN_MOD_LEN);
-        goto err;
+    if (flen > BN_num_bytes(rsa->n)) {
+        if (!quiet)
+            RSAerr(RSA_F_RSA_OSSL_PUBLIC_DECRYPT,
+                   RSA_R_DATA_GREATER_THAN_MOD_LEN);
+        return 0;
     }
 
     if (BN_bin2bn(from, flen, f) == NULL)
-        goto err;
+        return 0;
 
     if (BN_ucmp(f, rsa->n) >= 0) {
-        RSAerr(RSA_F_RSA_OSSL_PUBLIC_DECRYPT,
-               RSA_R_DATA_TOO_LARGE_FOR_MODULUS);
-        goto err;
+        if (!quiet)
+            RSAerr(RSA_F_RSA_OSSL_PUBLIC_DECRYPT,
+                   RSA_R_DATA_TOO_LARGE_FOR_MODULUS);
+        return 0;
     }
+    return 1;
+}
 
-    if (rsa->flags & RSA_FLAG_CACHE_PUBLIC)
-        if (!BN_MONT_CTX_set_locked
-            (&rsa->_method_mod_n, rsa->lock, rsa->n, ctx))
-            goto err;
-
-    if (!rsa->meth->bn_mod_exp(ret, f, rsa->e, rsa->n, ctx,
-                               rsa->_method_mod_n))
-        goto err;
+/*
+ * Removes the padding from |ret|, the signature raised to the public
+ * exponent.  |buf| holds BN_num_bytes(rsa->n) bytes.  Returns the length of
+ * the recovered data or -1.
+ */
+static int rsa_ossl_public_decrypt_finish(BIGNUM *ret, unsigned char *to,
+                                          RSA *rsa, int padding,
+                                          unsigned char *buf)
+{
+    int i, num = BN_num_bytes(rsa->n), r = -1;
 
     if ((padding == RSA_X931_PADDING) && ((bn_get_words(ret)[0] & 0xf) != 12))
         if (!BN_sub(ret, rsa->n, ret))
-            goto err;
+            return -1;
 
-    p = buf;
-    i = BN_bn2bin(ret, p);
+    i = BN_bn2bin(ret, buf);
 
     switch (padding) {
     case RSA_PKCS1_PADDING:
@@ -585,29 +733,198 @@ static int rsa_ossl_public_decrypt(int flen, const unsigned char *from,
         break;
     default:
         RSAerr(RSA_F_RSA_OSSL_PUBLIC_DECRYPT, RSA_R_UNKNOWN_PADDING_TYPE);
-        goto err;
+        return -1;
     }
     if (r < 0)
         RSAerr(RSA_F_RSA_OSSL_PUBLIC_DECRYPT, RSA_R_PADDING_CHECK_FAILED);
+    return r;
+}
+
+/*
+ * Recovers the data from one signature once the key has been checked.  |buf|
+ * holds BN_num_bytes(rsa->n) bytes.  Returns the length of the recovered
+ * data or -1.
+ */
+static int rsa_ossl_public_decrypt_one(int flen, const unsigned char *from,
+                                       unsigned char *to, RSA *rsa,
+                                       int padding, unsigned char *buf,
+                                       BN_CTX *ctx)
+{
+    BIGNUM *f, *ret;
+    int r = -1;
+
+    BN_CTX_start(ctx);
+    f = BN_CTX_get(ctx);
+    ret = BN_CTX_get(ctx);
+    if (ret == NULL) {
+        RSAerr(RSA_F_RSA_OSSL_PUBLIC_DECRYPT, ERR_R_MALLOC_FAILURE);
+        goto err;
+    }
+
+    if (!rsa_ossl_public_decrypt_load(f, flen, from, rsa, 0))
+        goto err;
+
+    if (!rsa->meth->bn_mod_exp(ret, f, rsa->e, rsa->n, ctx,
+                               rsa->_method_mod_n))
+        goto err;
+
+    r = rsa_ossl_public_decrypt_finish(ret, to, rsa, padding, buf);
+
+ err:
+    BN_CTX_end(ctx);
+    return r;
+}
+
+/*
+ * Recovers the data from two signatures, raising both to the exponent 65537
+ * together with bn_mod_exp_mont_f4_x2().  Only to be called
+ * when the exponent is 65537, the method uses BN_mod_exp_mont() and the
+ * Montgomery context of the modulus is cached.  Returns 0, without having
+ * touched tlen[], if the pair has to be processed one input at a time.
+ */
+static int rsa_ossl_public_decrypt_pair(const int flen[],
+                                        const unsigned char *const from[],
+                                        unsigned char *const to[],
+                                        int tlen[], RSA *rsa, int padding,
+                                        unsigned char *buf, BN_CTX *ctx)
+{
+    BIGNUM *f0, *f1, *ret0, *ret1;
+    int ok = 0;
+
+    BN_CTX_start(ctx);
+    f0 = BN_CTX_get(ctx);
+    f1 = BN_CTX_get(ctx);
+    ret0 = BN_CTX_get(ctx);
+    ret1 = BN_CTX_get(ctx);
+    if (ret1 == NULL
+        || !rsa_ossl_public_decrypt_load(f0, flen[0], from[0], rsa, 1)
+        || !rsa_ossl_public_decrypt_load(f1, flen[1], from[1], rsa, 1)
+        || bn_mod_exp_mont_f4_x2(ret0, f0, ret1, f1, rsa->_method_mod_n) <= 0)
+        goto err;
+
+    tlen[0] = rsa_ossl_public_decrypt_finish(ret0, to[0], rsa, padding, buf);
+    tlen[1] = rsa_ossl_public_decrypt_finish(ret1, to[1], rsa, padding, buf);
+    ok = 1;
+
+ err:
+    BN_CTX_end(ctx);
+    return ok;
+}
+
+static int rsa_ossl_public_decrypt(int flen, const unsigned char *from,
+                                  unsigned char *to, RSA *rsa, int padding)
+{
+    int num = 0, r = -1;
+    unsigned char *buf = NULL;
+    BN_CTX *ctx = NULL;
+
+    if (!rsa_ossl_public_check(rsa))
+        return -1;
+
+    if ((ctx = BN_CTX_new()) == NULL)
+        goto err;
+    num = BN_num_bytes(rsa->n);
+    buf = OPENSSL_malloc(num);
+    if (buf == NULL) {
+        RSAerr(RSA_F_RSA_OSSL_PUBLIC_DECRYPT, ERR_R_MALLOC_FAILURE);
+        goto err;
+    }
+
+    if (rsa->flags & RSA_FLAG_CACHE_PUBLIC)
+        if (!bn_mont_ctx_set_locked_cached
+            (&rsa->_method_mod_n, rsa->lock, rsa->n, ctx))
+            goto err;
+
+    r = rsa_ossl_public_decrypt_one(flen, from, to, rsa, padding, buf, ctx);
 
  err:
-    if (ctx != NULL)
-        BN_CTX_end(ctx);
     BN_CTX_free(ctx);
     OPENSSL_clear_free(buf, num);
     return (r);
 }
 
+/*
+ * Recovers the data from |n| signatures made with the same key.  The key
+ * checks, the Montgomery setup of the modulus and the scratch space are
+ * shared by the whole batch; tlen[i] receives what RSA_public_decrypt()
+ * would have returned for input i, and is -1 for every input if the batch
+ * could not be started.
+ */
+static int rsa_ossl_public_decrypt_batch(size_t n, const int flen[],
+                                         const unsigned char *const from[],
+                                         unsigned char *const to[],
+                                         int tlen[], RSA *rsa, int padding)
+{
+    int num = 0, r = 0, pair;
+    size_t i;
+    unsigned char *buf = NULL;
+    BN_CTX *ctx = NULL;
+
+    for (i = 0; i < n; i++)
+        tlen[i] = -1;
+    if (n == 0)
+        return 1;
+
+    if (!rsa_ossl_public_check(rsa)
+        || (ctx = BN_CTX_new()) == NULL)
+        goto err;
+    num = BN_num_bytes(rsa->n);
+    buf = OPENSSL_malloc(num);
+    if (buf == NULL) {
+        RSAerr(RSA_F_RSA_OSSL_PUBLIC_DECRYPT_BATCH, ERR_R_MALLOC_FAILURE);
+        goto err;
+    }
+
+    if (rsa->flags & RSA_FLAG_CACHE_PUBLIC)
+        if (!bn_mont_ctx_set_locked_cached
+            (&rsa->_method_mod_n, rsa->lock, rsa->n, ctx))
+            goto err;
+
+    /*
+     * With the usual exponent and the default exponentiation, the inputs
+     * are raised to 65537 two at a time.
+     */
+    pair = rsa->meth->bn_mod_exp == BN_mod_exp_mont
+           && rsa->_method_mod_n != NULL && BN_is_word(rsa->e, RSA_F4);
+
+    r = 1;
+    for (i = 0; i < n; i++) {
+        if (pair && i + 1 < n
+            && rsa_ossl_public_decrypt_pair(flen + i, from + i, to + i,
+                                            tlen + i, rsa, padding, buf,
+                                            ctx)) {
+            if (tlen[i] < 0 || tlen[i + 1] < 0)
+                r = 0;
+            i++;
+            continue;
+        }
+        tlen[i] = rsa_ossl_public_decrypt_one(flen[i], from[i], to[i], rsa,
+                                              padding, buf, ctx);
+        if (tlen[i] < 0)
+            r = 0;
+    }
+
+ err:
+    BN_CTX_free(ctx);
+    OPENSSL_clear_free(buf, num);
+    return r;
+}
+
 static int rsa_ossl_mod_exp(BIGNUM *r0, const BIGNUM *I, RSA *rsa, BN_CTX *ctx)
 {
     BIGNUM *r1, *m1, *vrfy;
-    int ret = 0;
+    RSA_PRIME_INFO *pinfo;
+    int ret = 0, i, ex_primes;
 
     BN_CTX_start(ctx);
 
     r1 = BN_CTX_get(ctx);
     m1 = BN_CTX_get(ctx);
     vrfy = BN_CTX_get(ctx);
+    if (vrfy == NULL)
+        goto err;
+
+    ex_primes = RSA_get_multi_prime_extra_count(rsa);
 
     {
         BIGNUM *p = BN_new(), *q = BN_new();
@@ -641,6 +958,23 @@ static int rsa_ossl_mod_exp(BIGNUM *r0, const BIGNUM *I, RSA *rsa, BN_CTX *ctx)
         BN_free(q);
     }
 
+    if ((rsa->flags & RSA_FLAG_CACHE_PRIVATE) && ex_primes > 0) {
+        BIGNUM *r = BN_new();
+
+        if (r == NULL)
+            goto err;
+        for (i = 0; i < ex_primes; i++) {
+            pinfo = sk_RSA_PRIME_INFO_value(rsa->prime_infos, i);
+            BN_with_flags(r, pinfo->r, BN_FLG_CONSTTIME);
+            if (!BN_MONT_CTX_set_locked(&pinfo->m, rsa->lock, r, ctx)) {
+                BN_free(r);
+                goto err;
+            }
+        }
+        /* We MUST free r before any further use of the extra primes */
+        BN_free(r);
+    }
+
     if (rsa->flags & RSA_FLAG_CACHE_PUBLIC)
         if (!BN_MONT_CTX_set_locked
             (&rsa->_method_mod_n, rsa->lock, rsa->n, ctx))
@@ -744,6 +1078,60 @@ static int rsa_ossl_mod_exp(BIGNUM *r0, const BIGNUM *I, RSA *rsa, BN_CTX *ctx)
     if (!BN_add(r0, r1, m1))
         goto err;
 
+    /*
+     * r0 is now I^d mod p*q. Lift it to the modulus of each extra prime in
+     * turn (Garner's algorithm, RFC 8017 section 5.1.2):
+     *     h = (I^d_i mod r_i - r0) * t_i mod r_i
+     *     r0 = r0 + pp_i * h
+     */
+    for (i = 0; i < ex_primes; i++) {
+        BIGNUM *c = BN_new(), *di = BN_new();
+
+        if (c == NULL || di == NULL) {
+            BN_free(c);
+            BN_free(di);
+            goto err;
+        }
+        pinfo = sk_RSA_PRIME_INFO_value(rsa->prime_infos, i);
+        BN_with_flags(c, I, BN_FLG_CONSTTIME);
+        BN_with_flags(di, pinfo->d, BN_FLG_CONSTTIME);
+
+        /* compute (I mod r_i)^d_i mod r_i */
+        if (!BN_mod(r1, c, pinfo->r, ctx)
+            || !rsa->meth->bn_mod_exp(m1, r1, di, pinfo->r, ctx, pinfo->m)) {
+            BN_free(c);
+            BN_free(di);
+            goto err;
+        }
+        /* We MUST free c and di before any further use of I and pinfo->d */
+        BN_free(c);
+        BN_free(di);
+
+        if (!BN_sub(m1, m1, r0))
+            goto err;
+        if (!BN_mul(r1, m1, pinfo->t, ctx))
+            goto err;
+
+        {
+            BIGNUM *pr1 = BN_new();
+            if (pr1 == NULL)
+                goto err;
+            BN_with_flags(pr1, r1, BN_FLG_CONSTTIME);
+
+            if (!BN_nnmod(m1, pr1, pinfo->r, ctx)) {
+                BN_free(pr1);
+                goto err;
+            }
+            /* We MUST free pr1 before any further use of r1 */
+            BN_free(pr1);
+        }
+
+        if (!BN_mul(r1, m1, pinfo->pp, ctx))
+            goto err;
+        if (!BN_add(r0, r0, r1))
+            goto err;
+    }
+
     if (rsa->e && rsa->n) {
         if (!rsa->meth->bn_mod_exp(vrfy, r0, rsa->e, rsa->n, ctx,
                                    rsa->_method_mod_n))
@@ -796,8 +1184,16 @@ static int rsa_ossl_init(RSA *rsa)
 
 static int rsa_ossl_finish(RSA *rsa)
 {
+    int i;
+    RSA_PRIME_INFO *pinfo;
+
     BN_MONT_CTX_free(rsa->_method_mod_n);
     BN_MONT_CTX_free(rsa->_method_mod_p);
     BN_MONT_CTX_free(rsa->_method_mod_q);
+    for (i = 0; i < RSA_get_multi_prime_extra_count(rsa); i++) {
+        pinfo = sk_RSA_PRIME_INFO_value(rsa->prime_infos, i);
+        BN_MONT_CTX_free(pinfo->m);
+        pinfo->m = NULL;
+    }
     return (1);
 }
@@ -0,0 +1,502 @@
+#! /usr/bin/env perl
+# Copyright 2017 The OpenSSL Project Authors. All Rights Reserved.
+#
+# Licensed under the OpenSSL license (the "License").  You may not use
+# this file except in compliance with the License.  You can obtain a copy
+# in the file LICENSE in the source distribution or at
+# https://www.openssl.org/source/license.html
+
+#
+# Keccak-1600 for x86_64.
+#
+# SHA3_absorb and SHA3_squeeze with the same interface as the C code in
+# keccak1600.c, i.e.
+#
+# size_t SHA3_absorb(uint64_t A[5][5], const unsigned char *inp,
+#                    size_t len, size_t r);
+# void   SHA3_squeeze(uint64_t A[5][5], unsigned char *out,
+#                     size_t len, size_t r);
+#
+# The permutation is scalar. The state stays in memory and each round
+# is computed from one copy of the state into the other: the column
+# parities are summed into five registers and turned into the five
+# Theta values, then every output plane is produced from the five lanes
+# that Pi moves into it, with Rho, Chi and Iota applied on the way out.
+# Two rounds are unrolled per loop iteration, so that the state ends up
+# where it started. Chi is computed with andn on processors with BMI1
+# and with not+and otherwise; the choice is made at run time from
+# OPENSSL_ia32cap_P.
+#
+# Throughput absorbing a large buffer at the SHA3-256 rate, relative to
+# the default C code compiled with -O2 on the same processor:
+#
+#			not+and	andn
+# Xeon (BMI1)		~1.0x	~1.2x
+#
+# The not+and path is only on par with the compiler output, and the
+# gain comes from andn fusing the complement into Chi. Processors
+# without BMI1 therefore do not benefit much.
+
+$flavour = shift;
+$output  = shift;
+if ($flavour =~ /\./) { $output = $flavour; undef $flavour; }
+
+$win64=0; $win64=1 if ($flavour =~ /[nm]asm|mingw64/ || $output =~ /\.asm$/);
+
+$0 =~ m/(.*[\/\\])[^\/\\]+$/; $dir=$1;
+( $xlate="${dir}x86_64-xlate.pl" and -f $xlate ) or
+( $xlate="${dir}../../perlasm/x86_64-xlate.pl" and -f $xlate) or
+die "can't locate x86_64-xlate.pl";
+
+# andn is a BMI1 instruction, which came with the same assembler
+# versions as AVX2.
+if (`$ENV{CC} -Wa,-v -c -o /dev/null -x assembler /dev/null 2>&1`
+		=~ /GNU assembler version ([2-9]\.[0-9]+)/) {
+	$bmi = ($1>=2.22);
+}
+
+if (!$bmi && $win64 && ($flavour =~ /nasm/ || $ENV{ASM} =~ /nasm/) &&
+	   `nasm -v 2>&1` =~ /NASM version ([2-9]\.[0-9]+)/) {
+	$bmi = ($1>=2.10);
+}
+
+if (!$bmi && $win64 && ($flavour =~ /masm/ || $ENV{ASM} =~ /ml64/) &&
+	   `ml64 2>&1` =~ /Version ([0-9]+)\./) {
+	$bmi = ($1>=11);
+}
+
+if (!$bmi && `$ENV{CC} -v 2>&1` =~ /((?:^clang|LLVM) version|.*based on LLVM) ([3-9]\.[0-9]+)/) {
+	$bmi = ($2>=3.1);
+}
+
+open OUT,"| \"$^X\" \"$xlate\" $flavour \"$output\"";
+*STDOUT=*OUT;
+
+# Lanes are numbered 5*y+x, x and y being the usual coordinates.
+# For every output plane y, the input lanes and rotation amounts that
+# Rho and Pi bring to positions x=0..4.
+my @rhotates = ([  0,  1, 62, 28, 27 ],
+                [ 36, 44,  6, 55, 20 ],
+                [  3, 10, 43, 25, 39 ],
+                [ 41, 45, 15, 21,  8 ],
+                [ 18,  2, 61, 56, 14 ]);
+my @plane;
+for (my $y=0; $y<5; $y++) {
+    for (my $x=0; $x<5; $x++) {
+	# B[y'][x'] = ROL(A[y][x], rho[y][x]) with x'=y, y'=2x+3y
+	my ($xo,$yo) = ($y, (2*$x+3*$y)%5);
+	$plane[$yo][$xo] = [5*$y+$x, $x, $rhotates[$y][$x]];
+    }
+}
+
+my ($A,$E,$iotas)=("%rdi","%rsi","%r15");
+my @C=("%rax","%rbx","%rcx","%rdx","%rbp");
+my @D=("%r8","%r9","%r10","%r11","%r12");
+my @B=@C;
+my $T="%r13";
+
+# One round from the state at $src into the one at $dst. Iota uses the
+# constant at $iota($iotas).
+sub Round {
+my ($src,$dst,$iota,$andn)=@_;
+my ($x,$y);
+
+    $code.="	# Theta: column parities\n";
+    for ($x=0; $x<5; $x++) {
+	$code.="	mov	".(8*$x)."($src),$C[$x]\n";
+    }
+    for ($y=1; $y<5; $y++) {
+	for ($x=0; $x<5; $x++) {
+	    $code.="	xor	".(8*(5*$y+$x))."($src),$C[$x]\n";
+	}
+    }
+    for ($x=0; $x<5; $x++) {
+	$code.="	mov	$C[($x+1)%5],$D[$x]\n";
+	$code.="	rol	\$1,$D[$x]\n";
+    }
+    for ($x=0; $x<5; $x++) {
+	$code.="	xor	$C[($x+4)%5],$D[$x]\n";
+    }
+
+    for ($y=0; $y<5; $y++) {
+	$code.="	# plane $y: Theta, Rho and Pi\n";
+	for ($x=0; $x<5; $x++) {
+	    my ($lane,$col,$rot)=@{$plane[$y][$x]};
+	    $code.="	mov	".(8*$lane)."($src),$B[$x]\n";
+	    $code.="	xor	$D[$col],$B[$x]\n";
+	    $code.="	rol	\$$rot,$B[$x]\n"	if ($rot);
+	}
+	$code.="	# plane $y: Chi".($y?"":" and Iota")."\n";
+	for ($x=0; $x<5; $x++) {
+	    if ($andn) {
+		$code.="	andn	$B[($x+2)%5],$B[($x+1)%5],$T\n";
+	    } else {
+		$code.="	mov	$B[($x+1)%5],$T\n";
+		$code.="	not	$T\n";
+		$code.="	and	$B[($x+2)%5],$T\n";
+	    }
+	    $code.="	xor	$B[$x],$T\n";
+	    $code.="	xor	$iota($iotas),$T\n"	if ($y==0 && $x==0);
+	    $code.="	mov	$T,".(8*(5*$y+$x))."($dst)\n";
+	}
+    }
+}
+
+# __KeccakF1600[_bmi1] permutes the state at %rdi, using 200 bytes at
+# %rsi as scratch space. Only %rdi, %rsi and %rsp are preserved.
+sub KeccakF1600 {
+my ($suffix,$andn)=@_;
+
+$code.=<<___;
+.type	__KeccakF1600$suffix,\@abi-omnipotent
+.align	32
+__KeccakF1600$suffix:
+	lea	iotas(%rip),$iotas
+	jmp	.Loop$suffix
+
+.align	32
+.Loop$suffix:
+___
+    &Round($A,$E,0,$andn);
+    &Round($E,$A,8,$andn);
+$code.=<<___;
+	lea	16($iotas),$iotas
+	lea	iotas+8*24(%rip),$T
+	cmp	$T,$iotas
+	jne	.Loop$suffix
+
+	ret
+.size	__KeccakF1600$suffix,.-__KeccakF1600$suffix
+
+___
+}
+
+$code.=<<___;
+.text
+
+.extern	OPENSSL_ia32cap_P
+
+___
+&KeccakF1600("",0);
+&KeccakF1600("_bmi1",1)	if ($bmi);
+
+# Stack frame of SHA3_absorb and SHA3_squeeze above the pushed registers:
+# the scratch copy of the state, the pointer to the chosen permutation
+# and the arguments, which do not survive the call to it.
+my $frame=200+8*5;
+my ($perm,$ptr,$len,$bsz,$idx)=map(200+8*$_,(0..4));
+
+# Selects the permutation routine and stores its address at $perm(%rsp).
+sub pick_permutation {
+$code.=<<___;
+	lea	__KeccakF1600(%rip),%rax
+___
+$code.=<<___	if ($bmi);
+	mov	OPENSSL_ia32cap_P+8(%rip),%r10d
+	lea	__KeccakF1600_bmi1(%rip),%r11
+	test	\$`1<<3`,%r10d		# BMI1?
+	cmovnz	%r11,%rax
+___
+$code.=<<___;
+	mov	%rax,$perm(%rsp)
+___
+}
+
+sub prologue {
+my $name=shift;
+$code.=<<___;
+	push	%rbx
+.cfi_push	%rbx
+	push	%rbp
+.cfi_push	%rbp
+	push	%r12
+.cfi_push	%r12
+	push	%r13
+.cfi_push	%r13
+	push	%r14
+.cfi_push	%r14
+	push	%r15
+.cfi_push	%r15
+	lea	-$frame(%rsp),%rsp
+.cfi_adjust_cfa_offset	$frame
+.L${name}_body:
+___
+}
+
+sub epilogue {
+my $name=shift;
+$code.=<<___;
+	lea	$frame(%rsp),%rsp
+.cfi_adjust_cfa_offset	-$frame
+	pop	%r15
+.cfi_pop	%r15
+	pop	%r14
+.cfi_pop	%r14
+	pop	%r13
+.cfi_pop	%r13
+	pop	%r12
+.cfi_pop	%r12
+	pop	%rbp
+.cfi_pop	%rbp
+	pop	%rbx
+.cfi_pop	%rbx
+.L${name}_epilogue:
+	ret
+___
+}
+
+{
+my ($inp,$len_,$bsz_)=("%rsi","%rdx","%rcx");
+
+$code.=<<___;
+.globl	SHA3_absorb
+.type	SHA3_absorb,\@function,4
+.align	32
+SHA3_absorb:
+.cfi_startproc
+___
+&prologue("absorb");
+&pick_permutation();
+$code.=<<___;
+	mov	$bsz_,$bsz(%rsp)
+	shr	\$3,$bsz_			# r/8, lanes per block
+	jmp	.Loop_absorb_check
+
+.align	32
+.Loop_absorb:
+	xor	%rax,%rax
+.Loop_absorb_xor:
+	mov	($inp,%rax,8),%r8
+	xor	%r8,($A,%rax,8)
+	inc	%rax
+	cmp	$bsz_,%rax
+	jne	.Loop_absorb_xor
+
+	lea	($inp,%rax,8),$inp
+	sub	$bsz(%rsp),$len_
+	mov	$inp,$ptr(%rsp)
+	mov	$len_,$len(%rsp)
+	mov	%rsp,%rsi
+	call	*$perm(%rsp)
+	mov	$ptr(%rsp),$inp
+	mov	$len(%rsp),$len_
+	mov	$bsz(%rsp),$bsz_
+	shr	\$3,$bsz_
+
+.Loop_absorb_check:
+	mov	$bsz_,%rax
+	shl	\$3,%rax
+	cmp	%rax,$len_
+	jae	.Loop_absorb
+
+	mov	$len_,%rax			# return the unprocessed length
+___
+&epilogue("absorb");
+$code.=<<___;
+.cfi_endproc
+.size	SHA3_absorb,.-SHA3_absorb
+___
+}
+{
+my ($out,$len_,$bsz_)=("%rsi","%rdx","%rcx");
+
+$code.=<<___;
+.globl	SHA3_squeeze
+.type	SHA3_squeeze,\@function,4
+.align	32
+SHA3_squeeze:
+.cfi_startproc
+___
+&prologue("squeeze");
+&pick_permutation();
+$code.=<<___;
+	shr	\$3,$bsz_			# r/8, lanes per block
+	xor	%rax,%rax			# lane index
+	test	$len_,$len_
+	jz	.Ldone_squeeze
+
+.align	32
+.Loop_squeeze:
+	cmp	$bsz_,%rax
+	jne	.Lnext_lane
+
+	mov	$out,$ptr(%rsp)
+	mov	$len_,$len(%rsp)
+	mov	$bsz_,$bsz(%rsp)
+	mov	%rsp,%rsi
+	call	*$perm(%rsp)
+	mov	$ptr(%rsp),$out
+	mov	$len(%rsp),$len_
+	mov	$bsz(%rsp),$bsz_
+	xor	%rax,%rax
+
+.Lnext_lane:
+	mov	($A,%rax,8),%r8
+	cmp	\$8,$len_
+	jb	.Ltail_squeeze
+	mov	%r8,($out)
+	lea	8($out),$out
+	inc	%rax
+	sub	\$8,$len_
+	jnz	.Loop_squeeze
+	jmp	.Ldone_squeeze
+
+.Ltail_squeeze:
+	mov	%r8b,($out)
+	lea	1($out),$out
+	shr	\$8,%r8
+	dec	$len_
+	jnz	.Ltail_squeeze
+
+.Ldone_squeeze:
+___
+&epilogue("squeeze");
+$code.=<<___;
+.cfi_endproc
+.size	SHA3_squeeze,.-SHA3_squeeze
+
+.align	64
+iotas:
+	.quad	0x0000000000000001, 0x0000000000008082
+	.quad	0x800000000000808a, 0x8000000080008000
+	.quad	0x000000000000808b, 0x0000000080000001
+	.quad	0x8000000080008081, 0x8000000000008009
+	.quad	0x000000000000008a, 0x0000000000000088
+	.quad	0x0000000080008009, 0x000000008000000a
+	.quad	0x000000008000808b, 0x800000000000008b
+	.quad	0x8000000000008089, 0x8000000000008003
+	.quad	0x8000000000008002, 0x8000000000000080
+	.quad	0x000000000000800a, 0x800000008000000a
+	.quad	0x8000000080008081, 0x8000000000008080
+	.quad	0x0000000080000001, 0x8000000080008008
+.asciz	"Keccak-1600 absorb and squeeze for x86_64, CRYPTOGAMS by <appro\@openssl.org>"
+___
+}
+
+# EXCEPTION_DISPOSITION handler (EXCEPTION_RECORD *rec,ULONG64 frame,
+#		CONTEXT *context,DISPATCHER_CONTEXT *disp)
+if ($win64) {
+$rec="%rcx";
+$frame_="%rdx";
+$context="%r8";
+$disp="%r9";
+
+$code.=<<___;
+.extern	__imp_RtlVirtualUnwind
+.type	se_handler,\@abi-omnipotent
+.align	16
+se_handler:
+	push	%rsi
+	push	%rdi
+	push	%rbx
+	push	%rbp
+	push	%r12
+	push	%r13
+	push	%r14
+	push	%r15
+	pushfq
+	sub	\$64,%rsp
+
+	mov	120($context),%rax	# pull context->Rax
+	mov	248($context),%rbx	# pull context->Rip
+
+	mov	8($disp),%rsi		# disp->ImageBase
+	mov	56($disp),%r11		# disp->HandlerData
+
+	mov	0(%r11),%r10d		# HandlerData[0]
+	lea	(%rsi,%r10),%r10	# prologue label
+	cmp	%r10,%rbx		# context->Rip<prologue label
+	jb	.Lcommon_seh_tail
+
+	mov	152($context),%rax	# pull context->Rsp
+
+	mov	4(%r11),%r10d		# HandlerData[1]
+	lea	(%rsi,%r10),%r10	# epilogue label
+	cmp	%r10,%rbx		# context->Rip>=epilogue label
+	jae	.Lcommon_seh_tail
+
+	lea	$frame+48(%rax),%rax
+
+	mov	-8(%rax),%rbx
+	mov	-16(%rax),%rbp
+	mov	-24(%rax),%r12
+	mov	-32(%rax),%r13
+	mov	-40(%rax),%r14
+	mov	-48(%rax),%r15
+	mov	%rbx,144($context)	# restore context->Rbx
+	mov	%rbp,160($context)	# restore context->Rbp
+	mov	%r12,216($context)	# restore context->R12
+	mov	%r13,224($context)	# restore context->R13
+	mov	%r14,232($context)	# restore context->R14
+	mov	%r15,240($context)	# restore context->R15
+
+.Lcommon_seh_tail:
+	mov	8(%rax),%rdi
+	mov	16(%rax),%rsi
+	mov	%rax,152($context)	# restore context->Rsp
+	mov	%rsi,168($context)	# restore context->Rsi
+	mov	%rdi,176($context)	# restore context->Rdi
+
+	mov	40($disp),%rdi		# disp->ContextRecord
+	mov	$context,%rsi		# context
+	mov	\$154,%ecx		# sizeof(CONTEXT)
+	.long	0xa548f3fc		# cld; rep movsq
+
+	mov	$disp,%rsi
+	xor	%rcx,%rcx		# arg1, UNW_FLAG_NHANDLER
+	mov	8(%rsi),%rdx		# arg2, disp->ImageBase
+	mov	0(%rsi),%r8		# arg3, disp->ControlPc
+	mov	16(%rsi),%r9		# arg4, disp->FunctionEntry
+	mov	40(%rsi),%r10		# disp->ContextRecord
+	lea	56(%rsi),%r11		# &disp->HandlerData
+	lea	24(%rsi),%r12		# &disp->EstablisherFrame
+	mov	%r10,32(%rsp)		# arg5
+	mov	%r11,40(%rsp)		# arg6
+	mov	%r12,48(%rsp)		# arg7
+	mov	%rcx,56(%rsp)		# arg8, (NULL)
+	call	*__imp_RtlVirtualUnwind(%rip)
+
+	mov	\$1,%eax		# ExceptionContinueSearch
+	add	\$64,%rsp
+	popfq
+	pop	%r15
+	pop	%r14
+	pop	%r13
+	pop	%r12
+	pop	%rbp
+	pop	%rbx
+	pop	%rdi
+	pop	%rsi
+	ret
+.size	se_handler,.-se_handler
+
+.section	.pdata
+.align	4
+	.rva	.LSEH_begin_SHA3_absorb
+	.rva	.LSEH_end_SHA3_absorb
+	.rva	.LSEH_info_SHA3_absorb
+
+	.rva	.LSEH_begin_SHA3_squeeze
+	.rva	.LSEH_end_SHA3_squeeze
+	.rva	.LSEH_info_SHA3_squeeze
+
+.section	.xdata
+.align	8
+.LSEH_info_SHA3_absorb:
+	.byte	9,0,0,0
+	.rva	se_handler
+	.rva	.Labsorb_body,.Labsorb_epilogue		# HandlerData[]
+.LSEH_info_SHA3_squeeze:
+	.byte	9,0,0,0
+	.rva	se_handler
+	.rva	.Lsqueeze_body,.Lsqueeze_epilogue	# HandlerData[]
+___
+}
+
+foreach (split("\n",$code)) {
+	s/\`([^\`]*)\`/eval $1/ge;
+
+	print $_,"\n";
+}
+
+close STDOUT;
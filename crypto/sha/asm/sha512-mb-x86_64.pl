@@ -0,0 +1,579 @@
+#! /usr/bin/env perl
+# Copyright 2017 The OpenSSL Project Authors. All Rights Reserved.
+#
+# Licensed under the OpenSSL license (the "License").  You may not use
+# this file except in compliance with the License.  You can obtain a copy
+# in the file LICENSE in the source distribution or at
+# https://www.openssl.org/source/license.html
+
+
+# Multi-buffer SHA512 procedure processes n buffers in parallel by
+# placing buffer data to designated lane of SIMD register. Since
+# SHA512 operates on 64-bit words, n is 4 on AVX2-capable processors,
+# and there is no point in supporting anything narrower, because
+# 2-way 128-bit code would be slower than sha512-x86_64 itself. The
+# procedure processes either 4 or 8 buffers, the latter in two passes,
+# and returns 0 without touching anything if AVX2 is not available,
+# in which case caller is expected to fall back to sha512_block_data_order.
+#
+# Aggregate throughput of n=4 is about twice that of the AVX2+BMI code
+# path in sha512-x86_64 on contemporary Intel processors.
+
+$flavour = shift;
+$output  = shift;
+if ($flavour =~ /\./) { $output = $flavour; undef $flavour; }
+
+$win64=0; $win64=1 if ($flavour =~ /[nm]asm|mingw64/ || $output =~ /\.asm$/);
+
+$0 =~ m/(.*[\/\\])[^\/\\]+$/; $dir=$1;
+( $xlate="${dir}x86_64-xlate.pl" and -f $xlate ) or
+( $xlate="${dir}../../perlasm/x86_64-xlate.pl" and -f $xlate) or
+die "can't locate x86_64-xlate.pl";
+
+$avx=0;
+
+if (`$ENV{CC} -Wa,-v -c -o /dev/null -x assembler /dev/null 2>&1`
+		=~ /GNU assembler version ([2-9]\.[0-9]+)/) {
+	$avx = ($1>=2.19) + ($1>=2.22);
+}
+
+if (!$avx && $win64 && ($flavour =~ /nasm/ || $ENV{ASM} =~ /nasm/) &&
+	   `nasm -v 2>&1` =~ /NASM version ([2-9]\.[0-9]+)/) {
+	$avx = ($1>=2.09) + ($1>=2.10);
+}
+
+if (!$avx && $win64 && ($flavour =~ /masm/ || $ENV{ASM} =~ /ml64/) &&
+	   `ml64 2>&1` =~ /Version ([0-9]+)\./) {
+	$avx = ($1>=10) + ($1>=11);
+}
+
+if (!$avx && `$ENV{CC} -v 2>&1` =~ /((?:^clang|LLVM) version|.*based on LLVM) ([3-9]\.[0-9]+)/) {
+	$avx = ($2>=3.0) + ($2>3.0);
+}
+
+open OUT,"| \"$^X\" \"$xlate\" $flavour \"$output\"";
+*STDOUT=*OUT;
+
+# int sha512_multi_block (
+#     struct {	unsigned __int64 A[8];
+#		unsigned __int64 B[8];
+#		unsigned __int64 C[8];
+#		unsigned __int64 D[8];
+#		unsigned __int64 E[8];
+#		unsigned __int64 F[8];
+#		unsigned __int64 G[8];
+#		unsigned __int64 H[8];	} *ctx,
+#     struct {	void *ptr; int blocks;	} inp[8],
+#     int num);		/* 1 or 2 */
+#
+$ctx="%rdi";	# 1st arg
+$inp="%rsi";	# 2nd arg
+$num="%edx";	# 3rd arg
+@ptr=map("%r$_",(8..11));
+$Tbl="%rbp";
+
+@V=($A,$B,$C,$D,$E,$F,$G,$H)=map("%ymm$_",(8..15));
+($t1,$t2,$t3,$axb,$bxc,$Xi,$Xn,$sigma)=map("%ymm$_",(0..7));
+
+$REG_SZ=32;
+
+sub Xi_off {
+my $off = shift;
+
+    $off %= 16; $off *= $REG_SZ;
+    $off<256 ? "$off-128(%rax)" : "$off-256-128(%rbx)";
+}
+
+sub ROUND_00_15_avx2 {
+my ($i,$a,$b,$c,$d,$e,$f,$g,$h)=@_;
+
+$code.=<<___ if ($i<15);
+	vmovq		`8*$i`(@ptr[0]),$Xi
+	vmovq		`8*$i`(@ptr[2]),$t1
+	vpinsrq		\$1,`8*$i`(@ptr[1]),$Xi,$Xi
+	vpinsrq		\$1,`8*$i`(@ptr[3]),$t1,$t1
+	vinserti128	$t1,$Xi,$Xi
+	vpshufb		$Xn,$Xi,$Xi
+___
+$code.=<<___ if ($i==15);
+	vmovq		`8*$i`(@ptr[0]),$Xi
+	 lea		`16*8`(@ptr[0]),@ptr[0]
+	vmovq		`8*$i`(@ptr[2]),$t1
+	 lea		`16*8`(@ptr[2]),@ptr[2]
+	vpinsrq		\$1,`8*$i`(@ptr[1]),$Xi,$Xi
+	 lea		`16*8`(@ptr[1]),@ptr[1]
+	vpinsrq		\$1,`8*$i`(@ptr[3]),$t1,$t1
+	 lea		`16*8`(@ptr[3]),@ptr[3]
+	vinserti128	$t1,$Xi,$Xi
+	vpshufb		$Xn,$Xi,$Xi
+___
+$code.=<<___;
+	vpsrlq	\$14,$e,$sigma
+	vpsllq	\$23,$e,$t3
+	vmovdqu	$Xi,`&Xi_off($i)`
+	 vpaddq	$h,$Xi,$Xi			# Xi+=h
+
+	vpsrlq	\$18,$e,$t2
+	vpxor	$t3,$sigma,$sigma
+	vpsllq	\$46,$e,$t3
+	 vpaddq	`32*($i%8)-128`($Tbl),$Xi,$Xi	# Xi+=K[round]
+	vpxor	$t2,$sigma,$sigma
+
+	vpsrlq	\$41,$e,$t2
+	vpxor	$t3,$sigma,$sigma
+	 `"prefetcht0	127(@ptr[0])"		if ($i==15)`
+	vpsllq	\$50,$e,$t3
+	 vpandn	$g,$e,$t1
+	 vpand	$f,$e,$axb			# borrow $axb
+	 `"prefetcht0	127(@ptr[1])"		if ($i==15)`
+	vpxor	$t2,$sigma,$sigma
+
+	vpsrlq	\$28,$a,$h			# borrow $h
+	vpxor	$t3,$sigma,$sigma		# Sigma1(e)
+	 `"prefetcht0	127(@ptr[2])"		if ($i==15)`
+	vpsllq	\$25,$a,$t2
+	 vpxor	$axb,$t1,$t1			# Ch(e,f,g)
+	 vpxor	$a,$b,$axb			# a^b, b^c in next round
+	 `"prefetcht0	127(@ptr[3])"		if ($i==15)`
+	vpxor	$t2,$h,$h
+	vpaddq	$sigma,$Xi,$Xi			# Xi+=Sigma1(e)
+
+	vpsrlq	\$34,$a,$t2
+	vpsllq	\$30,$a,$t3
+	 vpaddq	$t1,$Xi,$Xi			# Xi+=Ch(e,f,g)
+	 vpand	$axb,$bxc,$bxc
+	vpxor	$t2,$h,$sigma
+
+	vpsrlq	\$39,$a,$t2
+	vpxor	$t3,$sigma,$sigma
+	vpsllq	\$36,$a,$t3
+	 vpxor	$bxc,$b,$h			# h=Maj(a,b,c)=Ch(a^b,c,b)
+	 vpaddq	$Xi,$d,$d			# d+=Xi
+	vpxor	$t2,$sigma,$sigma
+	vpxor	$t3,$sigma,$sigma		# Sigma0(a)
+
+	vpaddq	$Xi,$h,$h			# h+=Xi
+	vpaddq	$sigma,$h,$h			# h+=Sigma0(a)
+___
+$code.=<<___ if (($i%8)==7);
+	add	\$`32*8`,$Tbl
+___
+	($axb,$bxc)=($bxc,$axb);
+}
+
+sub ROUND_16_XX_avx2 {
+my $i=shift;
+
+$code.=<<___;
+	vmovdqu	`&Xi_off($i+1)`,$Xn
+	vpaddq	`&Xi_off($i+9)`,$Xi,$Xi		# Xi+=X[i+9]
+
+	vpsrlq	\$7,$Xn,$sigma
+	vpsrlq	\$1,$Xn,$t2
+	vpsllq	\$56,$Xn,$t3
+	vpxor	$t2,$sigma,$sigma
+	vpsrlq	\$8,$Xn,$t2
+	vpxor	$t3,$sigma,$sigma
+	vpsllq	\$63,$Xn,$t3
+	vmovdqu	`&Xi_off($i+14)`,$t1
+	vpsrlq	\$6,$t1,$axb			# borrow $axb
+
+	vpxor	$t2,$sigma,$sigma
+	vpsrlq	\$19,$t1,$t2
+	vpxor	$t3,$sigma,$sigma		# sigma0(X[i+1])
+	vpsllq	\$3,$t1,$t3
+	 vpaddq	$sigma,$Xi,$Xi			# Xi+=sigma0(e)
+	vpxor	$t2,$axb,$sigma
+	vpsrlq	\$61,$t1,$t2
+	vpxor	$t3,$sigma,$sigma
+	vpsllq	\$45,$t1,$t3
+	vpxor	$t2,$sigma,$sigma
+	vpxor	$t3,$sigma,$sigma		# sigma1(X[i+14])
+	vpaddq	$sigma,$Xi,$Xi			# Xi+=sigma1(X[i+14])
+___
+	&ROUND_00_15_avx2($i,@_);
+	($Xi,$Xn)=($Xn,$Xi);
+}
+
+$code.=<<___;
+.text
+
+.extern	OPENSSL_ia32cap_P
+
+.globl	sha512_multi_block
+.type	sha512_multi_block,\@function,3
+.align	32
+sha512_multi_block:
+.cfi_startproc
+___
+$code.=<<___ if ($avx>1);
+	mov	OPENSSL_ia32cap_P+8(%rip),%ecx
+	test	\$`1<<5`,%ecx			# check AVX2 bit
+	jnz	_avx2_shortcut
+___
+$code.=<<___;
+	xor	%eax,%eax			# not processed
+	ret
+.cfi_endproc
+.size	sha512_multi_block,.-sha512_multi_block
+___
+						if ($avx>1) {{{
+my ($sigma_x,$t1_x,$Xn_x)=map("%xmm$_",(7,0,6));
+
+$code.=<<___;
+.type	sha512_multi_block_avx2,\@function,3
+.align	32
+sha512_multi_block_avx2:
+.cfi_startproc
+_avx2_shortcut:
+	mov	%rsp,%rax
+.cfi_def_cfa_register	%rax
+	push	%rbx
+.cfi_push	%rbx
+	push	%rbp
+.cfi_push	%rbp
+___
+$code.=<<___ if ($win64);
+	lea	-0xa8(%rsp),%rsp
+	movaps	%xmm6,(%rsp)
+	movaps	%xmm7,0x10(%rsp)
+	movaps	%xmm8,0x20(%rsp)
+	movaps	%xmm9,0x30(%rsp)
+	movaps	%xmm10,-0x78(%rax)
+	movaps	%xmm11,-0x68(%rax)
+	movaps	%xmm12,-0x58(%rax)
+	movaps	%xmm13,-0x48(%rax)
+	movaps	%xmm14,-0x38(%rax)
+	movaps	%xmm15,-0x28(%rax)
+___
+$code.=<<___;
+	sub	\$`$REG_SZ*18`, %rsp
+	and	\$-256,%rsp
+	mov	%rax,`$REG_SZ*17`(%rsp)		# original %rsp
+.cfi_cfa_expression	%rsp+`$REG_SZ*17`,deref,+8
+.Lbody_avx2:
+	lea	K512+128(%rip),$Tbl
+
+.Loop_grande_avx2:
+	mov	$num,`$REG_SZ*17+8`(%rsp)	# original $num
+	xor	$num,$num
+	lea	`$REG_SZ*16`(%rsp),%rbx
+___
+for($i=0;$i<4;$i++) {
+    $code.=<<___;
+	mov	`16*$i+0`($inp),@ptr[$i]	# input pointer
+	mov	`16*$i+8`($inp),%ecx		# number of blocks
+	cmp	$num,%ecx
+	cmovg	%ecx,$num			# find maximum
+	test	%ecx,%ecx
+	mov	%ecx,`4*$i`(%rbx)		# initialize counters
+	cmovle	$Tbl,@ptr[$i]			# cancel input
+___
+}
+$code.=<<___;
+	test	$num,$num
+	jz	.Lnext_grande_avx2
+
+	vmovdqu	0x000($ctx),$A			# load context
+	 lea	128(%rsp),%rax
+	vmovdqu	0x040($ctx),$B
+	 lea	256+128(%rsp),%rbx
+	vmovdqu	0x080($ctx),$C
+	vmovdqu	0x0c0($ctx),$D
+	vmovdqu	0x100($ctx),$E
+	vmovdqu	0x140($ctx),$F
+	vmovdqu	0x180($ctx),$G
+	vmovdqu	0x1c0($ctx),$H
+	vmovdqu	.Lpbswap(%rip),$Xn
+	jmp	.Loop_avx2
+
+.align	32
+.Loop_avx2:
+	vpxor	$B,$C,$bxc			# magic seed
+___
+for($i=0;$i<16;$i++)	{ &ROUND_00_15_avx2($i,@V); unshift(@V,pop(@V)); }
+$code.=<<___;
+	vmovdqu	`&Xi_off($i)`,$Xi
+	mov	\$4,%ecx
+	jmp	.Loop_16_xx_avx2
+.align	32
+.Loop_16_xx_avx2:
+___
+for(;$i<32;$i++)	{ &ROUND_16_XX_avx2($i,@V); unshift(@V,pop(@V)); }
+$code.=<<___;
+	dec	%ecx
+	jnz	.Loop_16_xx_avx2
+
+	mov	\$1,%ecx
+	lea	`$REG_SZ*16`(%rsp),%rbx
+	lea	K512+128(%rip),$Tbl
+___
+for($i=0;$i<4;$i++) {
+    $code.=<<___;
+	cmp	`4*$i`(%rbx),%ecx		# examine counters
+	cmovge	$Tbl,@ptr[$i]			# cancel input
+___
+}
+$code.=<<___;
+	vmovdqa	(%rbx),$sigma_x			# pull counters
+	vpxor	$t1,$t1,$t1
+	vpcmpgtd $t1_x,$sigma_x,$Xn_x		# mask value
+	vpaddd	$Xn_x,$sigma_x,$sigma_x		# counters--
+	vmovdqa	$sigma_x,(%rbx)			# save counters
+	vpmovsxdq $Xn_x,$Xn			# widen mask to 64 bits
+
+	vmovdqu	0x000($ctx),$t1
+	vpand	$Xn,$A,$A
+	vmovdqu	0x040($ctx),$t2
+	vpand	$Xn,$B,$B
+	vmovdqu	0x080($ctx),$t3
+	vpand	$Xn,$C,$C
+	vmovdqu	0x0c0($ctx),$Xi
+	vpand	$Xn,$D,$D
+	vpaddq	$t1,$A,$A
+	vmovdqu	0x100($ctx),$t1
+	vpand	$Xn,$E,$E
+	vpaddq	$t2,$B,$B
+	vmovdqu	0x140($ctx),$t2
+	vpand	$Xn,$F,$F
+	vpaddq	$t3,$C,$C
+	vmovdqu	0x180($ctx),$t3
+	vpand	$Xn,$G,$G
+	vpaddq	$Xi,$D,$D
+	vmovdqu	0x1c0($ctx),$Xi
+	vpand	$Xn,$H,$H
+	vpaddq	$t1,$E,$E
+	vpaddq	$t2,$F,$F
+	vmovdqu	$A,0x000($ctx)
+	vpaddq	$t3,$G,$G
+	vmovdqu	$B,0x040($ctx)
+	vpaddq	$Xi,$H,$H
+	vmovdqu	$C,0x080($ctx)
+	vmovdqu	$D,0x0c0($ctx)
+	vmovdqu	$E,0x100($ctx)
+	vmovdqu	$F,0x140($ctx)
+	vmovdqu	$G,0x180($ctx)
+	vmovdqu	$H,0x1c0($ctx)
+
+	lea	256+128(%rsp),%rbx
+	vmovdqu	.Lpbswap(%rip),$Xn
+	dec	$num
+	jnz	.Loop_avx2
+
+.Lnext_grande_avx2:
+	mov	`$REG_SZ*17+8`(%rsp),$num
+	lea	$REG_SZ($ctx),$ctx
+	lea	`16*4`($inp),$inp
+	dec	$num
+	jnz	.Loop_grande_avx2
+
+	mov	`$REG_SZ*17`(%rsp),%rax		# original %rsp
+.cfi_def_cfa	%rax,8
+	vzeroupper
+___
+$code.=<<___ if ($win64);
+	movaps	-0xb8(%rax),%xmm6
+	movaps	-0xa8(%rax),%xmm7
+	movaps	-0x98(%rax),%xmm8
+	movaps	-0x88(%rax),%xmm9
+	movaps	-0x78(%rax),%xmm10
+	movaps	-0x68(%rax),%xmm11
+	movaps	-0x58(%rax),%xmm12
+	movaps	-0x48(%rax),%xmm13
+	movaps	-0x38(%rax),%xmm14
+	movaps	-0x28(%rax),%xmm15
+___
+$code.=<<___;
+	mov	-16(%rax),%rbp
+.cfi_restore	%rbp
+	mov	-8(%rax),%rbx
+.cfi_restore	%rbx
+	lea	(%rax),%rsp
+.cfi_def_cfa_register	%rsp
+	mov	\$1,%eax			# processed
+.Lepilogue_avx2:
+	ret
+.cfi_endproc
+.size	sha512_multi_block_avx2,.-sha512_multi_block_avx2
+___
+$code.=<<___;
+.align	256
+K512:
+___
+sub TABLE {
+    foreach (@_) {
+	$code.=<<___;
+	.quad	$_,$_,$_,$_
+___
+    }
+}
+&TABLE(	0x428a2f98d728ae22,0x7137449123ef65cd,
+	0xb5c0fbcfec4d3b2f,0xe9b5dba58189dbbc,
+	0x3956c25bf348b538,0x59f111f1b605d019,
+	0x923f82a4af194f9b,0xab1c5ed5da6d8118,
+	0xd807aa98a3030242,0x12835b0145706fbe,
+	0x243185be4ee4b28c,0x550c7dc3d5ffb4e2,
+	0x72be5d74f27b896f,0x80deb1fe3b1696b1,
+	0x9bdc06a725c71235,0xc19bf174cf692694,
+	0xe49b69c19ef14ad2,0xefbe4786384f25e3,
+	0x0fc19dc68b8cd5b5,0x240ca1cc77ac9c65,
+	0x2de92c6f592b0275,0x4a7484aa6ea6e483,
+	0x5cb0a9dcbd41fbd4,0x76f988da831153b5,
+	0x983e5152ee66dfab,0xa831c66d2db43210,
+	0xb00327c898fb213f,0xbf597fc7beef0ee4,
+	0xc6e00bf33da88fc2,0xd5a79147930aa725,
+	0x06ca6351e003826f,0x142929670a0e6e70,
+	0x27b70a8546d22ffc,0x2e1b21385c26c926,
+	0x4d2c6dfc5ac42aed,0x53380d139d95b3df,
+	0x650a73548baf63de,0x766a0abb3c77b2a8,
+	0x81c2c92e47edaee6,0x92722c851482353b,
+	0xa2bfe8a14cf10364,0xa81a664bbc423001,
+	0xc24b8b70d0f89791,0xc76c51a30654be30,
+	0xd192e819d6ef5218,0xd69906245565a910,
+	0xf40e35855771202a,0x106aa07032bbd1b8,
+	0x19a4c116b8d2d0c8,0x1e376c085141ab53,
+	0x2748774cdf8eeb99,0x34b0bcb5e19b48a8,
+	0x391c0cb3c5c95a63,0x4ed8aa4ae3418acb,
+	0x5b9cca4f7763e373,0x682e6ff3d6b2b8a3,
+	0x748f82ee5defb2fc,0x78a5636f43172f60,
+	0x84c87814a1f0ab72,0x8cc702081a6439ec,
+	0x90befffa23631e28,0xa4506cebde82bde9,
+	0xbef9a3f7b2c67915,0xc67178f2e372532b,
+	0xca273eceea26619c,0xd186b8c721c0c207,
+	0xeada7dd6cde0eb1e,0xf57d4f7fee6ed178,
+	0x06f067aa72176fba,0x0a637dc5a2c898a6,
+	0x113f9804bef90dae,0x1b710b35131c471b,
+	0x28db77f523047d84,0x32caab7b40c72493,
+	0x3c9ebe0a15c9bebc,0x431d67c49c100d4c,
+	0x4cc5d4becb3e42b6,0x597f299cfc657e2a,
+	0x5fcb6fab3ad6faec,0x6c44198c4a475817 );
+$code.=<<___;
+.Lpbswap:
+	.quad	0x0001020304050607,0x08090a0b0c0d0e0f	# pbswap
+	.quad	0x0001020304050607,0x08090a0b0c0d0e0f	# pbswap
+___
+						}}}
+$code.=<<___;
+	.asciz	"SHA512 multi-block transform for x86_64, CRYPTOGAMS by <appro\@openssl.org>"
+___
+
+if ($win64 && $avx>1) {
+# EXCEPTION_DISPOSITION handler (EXCEPTION_RECORD *rec,ULONG64 frame,
+#		CONTEXT *context,DISPATCHER_CONTEXT *disp)
+$rec="%rcx";
+$frame="%rdx";
+$context="%r8";
+$disp="%r9";
+
+$code.=<<___;
+.extern	__imp_RtlVirtualUnwind
+.type	avx2_handler,\@abi-omnipotent
+.align	16
+avx2_handler:
+	push	%rsi
+	push	%rdi
+	push	%rbx
+	push	%rbp
+	push	%r12
+	push	%r13
+	push	%r14
+	push	%r15
+	pushfq
+	sub	\$64,%rsp
+
+	mov	120($context),%rax	# pull context->Rax
+	mov	248($context),%rbx	# pull context->Rip
+
+	mov	8($disp),%rsi		# disp->ImageBase
+	mov	56($disp),%r11		# disp->HandlerData
+
+	mov	0(%r11),%r10d		# HandlerData[0]
+	lea	(%rsi,%r10),%r10	# end of prologue label
+	cmp	%r10,%rbx		# context->Rip<.Lbody
+	jb	.Lin_prologue
+
+	mov	152($context),%rax	# pull context->Rsp
+
+	mov	4(%r11),%r10d		# HandlerData[1]
+	lea	(%rsi,%r10),%r10	# epilogue label
+	cmp	%r10,%rbx		# context->Rip>=.Lepilogue
+	jae	.Lin_prologue
+
+	mov	`32*17`(%rax),%rax	# pull saved stack pointer
+
+	mov	-8(%rax),%rbx
+	mov	-16(%rax),%rbp
+	mov	%rbx,144($context)	# restore context->Rbx
+	mov	%rbp,160($context)	# restore context->Rbp
+
+	lea	-24-10*16(%rax),%rsi
+	lea	512($context),%rdi	# &context.Xmm6
+	mov	\$20,%ecx
+	.long	0xa548f3fc		# cld; rep movsq
+
+.Lin_prologue:
+	mov	8(%rax),%rdi
+	mov	16(%rax),%rsi
+	mov	%rax,152($context)	# restore context->Rsp
+	mov	%rsi,168($context)	# restore context->Rsi
+	mov	%rdi,176($context)	# restore context->Rdi
+
+	mov	40($disp),%rdi		# disp->ContextRecord
+	mov	$context,%rsi		# context
+	mov	\$154,%ecx		# sizeof(CONTEXT)
+	.long	0xa548f3fc		# cld; rep movsq
+
+	mov	$disp,%rsi
+	xor	%rcx,%rcx		# arg1, UNW_FLAG_NHANDLER
+	mov	8(%rsi),%rdx		# arg2, disp->ImageBase
+	mov	0(%rsi),%r8		# arg3, disp->ControlPc
+	mov	16(%rsi),%r9		# arg4, disp->FunctionEntry
+	mov	40(%rsi),%r10		# disp->ContextRecord
+	lea	56(%rsi),%r11		# &disp->HandlerData
+	lea	24(%rsi),%r12		# &disp->EstablisherFrame
+	mov	%r10,32(%rsp)		# arg5
+	mov	%r11,40(%rsp)		# arg6
+	mov	%r12,48(%rsp)		# arg7
+	mov	%rcx,56(%rsp)		# arg8, (NULL)
+	call	*__imp_RtlVirtualUnwind(%rip)
+
+	mov	\$1,%eax		# ExceptionContinueSearch
+	add	\$64,%rsp
+	popfq
+	pop	%r15
+	pop	%r14
+	pop	%r13
+	pop	%r12
+	pop	%rbp
+	pop	%rbx
+	pop	%rdi
+	pop	%rsi
+	ret
+.size	avx2_handler,.-avx2_handler
+
+.section	.pdata
+.align	4
+	.rva	.LSEH_begin_sha512_multi_block_avx2
+	.rva	.LSEH_end_sha512_multi_block_avx2
+	.rva	.LSEH_info_sha512_multi_block_avx2
+
+.section	.xdata
+.align	8
+.LSEH_info_sha512_multi_block_avx2:
+	.byte	9,0,0,0
+	.rva	avx2_handler
+	.rva	.Lbody_avx2,.Lepilogue_avx2		# HandlerData[]
+___
+}
+
+foreach (split("\n",$code)) {
+	s/\`([^\`]*)\`/eval($1)/ge;
+
+	s/\b(vmov[dq])\b(.+)%ymm([0-9]+)/$1$2%xmm$3/go		or
+	s/\b(vpinsr[qd])\b(.+)%ymm([0-9]+),%ymm([0-9]+)/$1$2%xmm$3,%xmm$4/go	or
+	s/\b(vinserti128)\b(\s+)%ymm/$1$2\$1,%xmm/go;
+
+	print $_,"\n";
+}
+
+close STDOUT;
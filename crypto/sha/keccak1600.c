@@ -1,5 +1,5 @@
 /*
- * Copyright 2016 The OpenSSL Project Authors. All Rights Reserved.
+ * Copyright 2016-2017 The OpenSSL Project Authors. All Rights Reserved.
  *
  * Licensed under the OpenSSL license (the "License").  You may not use
  * this file except in compliance with the License.  You can obtain a copy
@@ -414,7 +414,7 @@ void KeccakF1600(uint64_t A[5][5])
     }
 }
 
-#else
+#elif defined(KECCAK_4X)
 /*
  * This implementation is KECCAK_1X from above combined 4 times with
  * a twist that allows to omit temporary storage and perform in-place
@@ -729,6 +729,129 @@ void KeccakF1600(uint64_t A[5][5])
     }
 }
 
+#else
+/*
+ * This implementation is KECCAK_2X from above with the 25 lanes of the
+ * state and of the temporary copy held in scalar variables rather than
+ * arrays, and rounds fully unrolled within pairs. Referring to lanes by
+ * name removes all indexing arithmetic and gives the compiler freedom
+ * to allocate registers across the whole round, which is what makes
+ * this the fastest of the portable variants on 64-bit processors with
+ * 16 or more general-purpose registers. Lane names follow "Keccak
+ * implementation overview": first letter is b, g, k, m or s for y=0..4,
+ * second letter is a, e, i, o or u for x=0..4.
+ */
+static const uint64_t iotas[] = {
+    0x0000000000000001U, 0x0000000000008082U, 0x800000000000808aU,
+    0x8000000080008000U, 0x000000000000808bU, 0x0000000080000001U,
+    0x8000000080008081U, 0x8000000000008009U, 0x000000000000008aU,
+    0x0000000000000088U, 0x0000000080008009U, 0x000000008000000aU,
+    0x000000008000808bU, 0x800000000000008bU, 0x8000000000008089U,
+    0x8000000000008003U, 0x8000000000008002U, 0x8000000000000080U,
+    0x000000000000800aU, 0x800000008000000aU, 0x8000000080008081U,
+    0x8000000000008080U, 0x0000000080000001U, 0x8000000080008008U
+};
+
+/*
+ * Theta, Rho, Pi, Chi and Iota applied to lanes A.. producing lanes
+ * E.., with A.. clobbered. Each group of five output lanes is a row
+ * computed from the five input lanes that Pi moves into it.
+ */
+#define KECCAK_ROUND(A, E, i) do { \
+    Ca = A##ba ^ A##ga ^ A##ka ^ A##ma ^ A##sa; \
+    Ce = A##be ^ A##ge ^ A##ke ^ A##me ^ A##se; \
+    Ci = A##bi ^ A##gi ^ A##ki ^ A##mi ^ A##si; \
+    Co = A##bo ^ A##go ^ A##ko ^ A##mo ^ A##so; \
+    Cu = A##bu ^ A##gu ^ A##ku ^ A##mu ^ A##su; \
+    Da = Cu ^ ROL64(Ce, 1); \
+    De = Ca ^ ROL64(Ci, 1); \
+    Di = Ce ^ ROL64(Co, 1); \
+    Do = Ci ^ ROL64(Cu, 1); \
+    Du = Co ^ ROL64(Ca, 1); \
+    \
+    Ba = A##ba ^ Da; \
+    Be = ROL64(A##ge ^ De, 44); \
+    Bi = ROL64(A##ki ^ Di, 43); \
+    Bo = ROL64(A##mo ^ Do, 21); \
+    Bu = ROL64(A##su ^ Du, 14); \
+    E##ba = Ba ^ (~Be & Bi) ^ iotas[i]; \
+    E##be = Be ^ (~Bi & Bo); \
+    E##bi = Bi ^ (~Bo & Bu); \
+    E##bo = Bo ^ (~Bu & Ba); \
+    E##bu = Bu ^ (~Ba & Be); \
+    \
+    Ba = ROL64(A##bo ^ Do, 28); \
+    Be = ROL64(A##gu ^ Du, 20); \
+    Bi = ROL64(A##ka ^ Da, 3); \
+    Bo = ROL64(A##me ^ De, 45); \
+    Bu = ROL64(A##si ^ Di, 61); \
+    E##ga = Ba ^ (~Be & Bi); \
+    E##ge = Be ^ (~Bi & Bo); \
+    E##gi = Bi ^ (~Bo & Bu); \
+    E##go = Bo ^ (~Bu & Ba); \
+    E##gu = Bu ^ (~Ba & Be); \
+    \
+    Ba = ROL64(A##be ^ De, 1); \
+    Be = ROL64(A##gi ^ Di, 6); \
+    Bi = ROL64(A##ko ^ Do, 25); \
+    Bo = ROL64(A##mu ^ Du, 8); \
+    Bu = ROL64(A##sa ^ Da, 18); \
+    E##ka = Ba ^ (~Be & Bi); \
+    E##ke = Be ^ (~Bi & Bo); \
+    E##ki = Bi ^ (~Bo & Bu); \
+    E##ko = Bo ^ (~Bu & Ba); \
+    E##ku = Bu ^ (~Ba & Be); \
+    \
+    Ba = ROL64(A##bu ^ Du, 27); \
+    Be = ROL64(A##ga ^ Da, 36); \
+    Bi = ROL64(A##ke ^ De, 10); \
+    Bo = ROL64(A##mi ^ Di, 15); \
+    Bu = ROL64(A##so ^ Do, 56); \
+    E##ma = Ba ^ (~Be & Bi); \
+    E##me = Be ^ (~Bi & Bo); \
+    E##mi = Bi ^ (~Bo & Bu); \
+    E##mo = Bo ^ (~Bu & Ba); \
+    E##mu = Bu ^ (~Ba & Be); \
+    \
+    Ba = ROL64(A##bi ^ Di, 62); \
+    Be = ROL64(A##go ^ Do, 55); \
+    Bi = ROL64(A##ku ^ Du, 39); \
+    Bo = ROL64(A##ma ^ Da, 41); \
+    Bu = ROL64(A##se ^ De, 2); \
+    E##sa = Ba ^ (~Be & Bi); \
+    E##se = Be ^ (~Bi & Bo); \
+    E##si = Bi ^ (~Bo & Bu); \
+    E##so = Bo ^ (~Bu & Ba); \
+    E##su = Bu ^ (~Ba & Be); \
+    } while (0)
+
+void KeccakF1600(uint64_t A[5][5])
+{
+    uint64_t Aba = A[0][0], Abe = A[0][1], Abi = A[0][2], Abo = A[0][3];
+    uint64_t Abu = A[0][4], Aga = A[1][0], Age = A[1][1], Agi = A[1][2];
+    uint64_t Ago = A[1][3], Agu = A[1][4], Aka = A[2][0], Ake = A[2][1];
+    uint64_t Aki = A[2][2], Ako = A[2][3], Aku = A[2][4], Ama = A[3][0];
+    uint64_t Ame = A[3][1], Ami = A[3][2], Amo = A[3][3], Amu = A[3][4];
+    uint64_t Asa = A[4][0], Ase = A[4][1], Asi = A[4][2], Aso = A[4][3];
+    uint64_t Asu = A[4][4];
+    uint64_t Eba, Ebe, Ebi, Ebo, Ebu, Ega, Ege, Egi, Ego, Egu;
+    uint64_t Eka, Eke, Eki, Eko, Eku, Ema, Eme, Emi, Emo, Emu;
+    uint64_t Esa, Ese, Esi, Eso, Esu;
+    uint64_t Ba, Be, Bi, Bo, Bu, Ca, Ce, Ci, Co, Cu, Da, De, Di, Do, Du;
+    size_t i;
+
+    for (i = 0; i < 24; i += 2) {
+        KECCAK_ROUND(A, E, i);
+        KECCAK_ROUND(E, A, i + 1);
+    }
+
+    A[0][0] = Aba; A[0][1] = Abe; A[0][2] = Abi; A[0][3] = Abo; A[0][4] = Abu;
+    A[1][0] = Aga; A[1][1] = Age; A[1][2] = Agi; A[1][3] = Ago; A[1][4] = Agu;
+    A[2][0] = Aka; A[2][1] = Ake; A[2][2] = Aki; A[2][3] = Ako; A[2][4] = Aku;
+    A[3][0] = Ama; A[3][1] = Ame; A[3][2] = Ami; A[3][3] = Amo; A[3][4] = Amu;
+    A[4][0] = Asa; A[4][1] = Ase; A[4][2] = Asi; A[4][3] = Aso; A[4][4] = Asu;
+}
+
 #endif
 
 /*
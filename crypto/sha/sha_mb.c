@@ -0,0 +1,270 @@
+/*
+ * Copyright 2017 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the OpenSSL license (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+#include <string.h>
+#include <limits.h>
+
+#include <openssl/crypto.h>
+#include <openssl/sha.h>
+#include <openssl/obj_mac.h>
+#include "internal/sha.h"
+
+#if defined(SHA256_ASM) && (defined(__x86_64) || defined(_M_AMD64) || \
+                            defined(_M_X64))
+
+/*
+ * The multi-buffer procedures keep up to 8 interleaved states, each state
+ * word being a row of 8 lanes, and hash one message per lane.
+ */
+typedef struct {
+    unsigned int A[8], B[8], C[8], D[8], E[8];
+} SHA1_MB_CTX;
+typedef struct {
+    unsigned int A[8], B[8], C[8], D[8], E[8], F[8], G[8], H[8];
+} SHA256_MB_CTX;
+typedef struct {
+    SHA_LONG64 A[8], B[8], C[8], D[8], E[8], F[8], G[8], H[8];
+} SHA512_MB_CTX;
+typedef struct {
+    const unsigned char *ptr;
+    int blocks;
+} HASH_DESC;
+
+void sha1_multi_block(SHA1_MB_CTX *, const HASH_DESC *, int);
+void sha256_multi_block(SHA256_MB_CTX *, const HASH_DESC *, int);
+int sha512_multi_block(SHA512_MB_CTX *, const HASH_DESC *, int);
+
+# define MB_LANES       8
+
+typedef struct {
+    size_t block_size;          /* in bytes */
+    size_t length_size;         /* length field at the end of last block */
+    size_t word_size;           /* 4 or 8 */
+    size_t words;               /* number of chaining words */
+    size_t md_size;
+    const void *iv;
+    int (*multi_block) (void *ctx, const HASH_DESC *desc, int num);
+} SHA_MB_METHOD;
+
+static int sha1_mb(void *ctx, const HASH_DESC *desc, int num)
+{
+    sha1_multi_block(ctx, desc, num);
+    return 1;
+}
+
+static int sha256_mb(void *ctx, const HASH_DESC *desc, int num)
+{
+    sha256_multi_block(ctx, desc, num);
+    return 1;
+}
+
+static int sha512_mb(void *ctx, const HASH_DESC *desc, int num)
+{
+    return sha512_multi_block(ctx, desc, num);
+}
+
+static const unsigned int sha1_iv[5] = {
+    0x67452301U, 0xefcdab89U, 0x98badcfeU, 0x10325476U, 0xc3d2e1f0U
+};
+
+static const unsigned int sha224_iv[8] = {
+    0xc1059ed8U, 0x367cd507U, 0x3070dd17U, 0xf70e5939U,
+    0xffc00b31U, 0x68581511U, 0x64f98fa7U, 0xbefa4fa4U
+};
+
+static const unsigned int sha256_iv[8] = {
+    0x6a09e667U, 0xbb67ae85U, 0x3c6ef372U, 0xa54ff53aU,
+    0x510e527fU, 0x9b05688cU, 0x1f83d9abU, 0x5be0cd19U
+};
+
+static const SHA_LONG64 sha384_iv[8] = {
+    U64(0xcbbb9d5dc1059ed8), U64(0x629a292a367cd507),
+    U64(0x9159015a3070dd17), U64(0x152fecd8f70e5939),
+    U64(0x67332667ffc00b31), U64(0x8eb44a8768581511),
+    U64(0xdb0c2e0d64f98fa7), U64(0x47b5481dbefa4fa4)
+};
+
+static const SHA_LONG64 sha512_iv[8] = {
+    U64(0x6a09e667f3bcc908), U64(0xbb67ae8584caa73b),
+    U64(0x3c6ef372fe94f82b), U64(0xa54ff53a5f1d36f1),
+    U64(0x510e527fade682d1), U64(0x9b05688c2b3e6c1f),
+    U64(0x1f83d9abfb41bd6b), U64(0x5be0cd19137e2179)
+};
+
+static const SHA_MB_METHOD sha1_mb_meth = {
+    SHA_CBLOCK, 8, 4, 5, SHA_DIGEST_LENGTH, sha1_iv, sha1_mb
+};
+static const SHA_MB_METHOD sha224_mb_meth = {
+    SHA256_CBLOCK, 8, 4, 8, SHA224_DIGEST_LENGTH, sha224_iv, sha256_mb
+};
+static const SHA_MB_METHOD sha256_mb_meth = {
+    SHA256_CBLOCK, 8, 4, 8, SHA256_DIGEST_LENGTH, sha256_iv, sha256_mb
+};
+static const SHA_MB_METHOD sha384_mb_meth = {
+    SHA512_CBLOCK, 16, 8, 8, SHA384_DIGEST_LENGTH, sha384_iv, sha512_mb
+};
+static const SHA_MB_METHOD sha512_mb_meth = {
+    SHA512_CBLOCK, 16, 8, 8, SHA512_DIGEST_LENGTH, sha512_iv, sha512_mb
+};
+
+/*
+ * Hash up to MB_LANES messages, one per lane. Bulk blocks are taken
+ * directly from input, the padded tail of each message, one or two
+ * blocks, is assembled in |tail| and hashed in a final pass.
+ *
+ * The procedures stop at the first pair or quadruple of lanes that has
+ * nothing to do, and AVX2 ones expect at least one lane to have work.
+ * Therefore messages are assigned to lanes longest first, so that busy
+ * lanes always precede idle ones, and idle calls are skipped.
+ */
+static int sha_mb_lanes(const SHA_MB_METHOD *meth, void *ctx,
+                        const void *const data[], const size_t count[],
+                        unsigned char *const md[], size_t lanes)
+{
+    unsigned char tail[MB_LANES][2 * SHA512_CBLOCK];
+    HASH_DESC desc[MB_LANES];
+    size_t left[MB_LANES], idx[MB_LANES];
+    size_t bsz = meth->block_size, wsz = meth->word_size;
+    size_t i, j, k, rem, busy;
+    int ret = 0;
+    unsigned int *st32 = ctx;
+    SHA_LONG64 *st64 = ctx, bits;
+
+    for (i = 0; i < meth->words; i++) {
+        for (j = 0; j < MB_LANES; j++) {
+            if (wsz == 4)
+                st32[i * MB_LANES + j] = ((const unsigned int *)meth->iv)[i];
+            else
+                st64[i * MB_LANES + j] = ((const SHA_LONG64 *)meth->iv)[i];
+        }
+    }
+
+    /* insertion sort, longest message first */
+    for (i = 0; i < lanes; i++) {
+        for (j = i; j > 0 && count[idx[j - 1]] < count[i]; j--)
+            idx[j] = idx[j - 1];
+        idx[j] = i;
+    }
+
+    memset(desc, 0, sizeof(desc));
+    for (i = 0; i < lanes; i++) {
+        desc[i].ptr = data[idx[i]];
+        left[i] = count[idx[i]] / bsz;
+    }
+
+    /* hash whole blocks, |blocks| being int limits the stride */
+    for (;;) {
+        for (busy = 0, i = 0; i < lanes; i++) {
+            desc[i].blocks = left[i] > INT_MAX / 2 ? INT_MAX / 2 : (int)left[i];
+            left[i] -= desc[i].blocks;
+            if (desc[i].blocks != 0)
+                busy = i + 1;
+        }
+        if (busy == 0)
+            break;
+        if (!meth->multi_block(ctx, desc, busy > MB_LANES / 2 ? 2 : 1))
+            goto err;
+        for (i = 0; i < busy; i++)
+            desc[i].ptr += (size_t)desc[i].blocks * bsz;
+    }
+
+    /* pad and hash the tails */
+    memset(tail, 0, sizeof(tail));
+    for (i = 0; i < lanes; i++) {
+        rem = count[idx[i]] % bsz;
+        memcpy(tail[i], desc[i].ptr, rem);
+        tail[i][rem] = 0x80;
+        desc[i].ptr = tail[i];
+        desc[i].blocks = rem + 1 + meth->length_size <= bsz ? 1 : 2;
+
+        k = desc[i].blocks * bsz;
+        bits = (SHA_LONG64)count[idx[i]] << 3;
+        for (j = 1; j <= 8; j++, bits >>= 8)
+            tail[i][k - j] = (unsigned char)bits;
+        if (meth->length_size > 8)
+            tail[i][k - 9] = (unsigned char)((SHA_LONG64)count[idx[i]] >> 61);
+    }
+    if (!meth->multi_block(ctx, desc, lanes > MB_LANES / 2 ? 2 : 1))
+        goto err;
+
+    for (i = 0; i < lanes; i++) {
+        unsigned char *out = md[idx[i]];
+
+        for (j = 0; j < meth->md_size / wsz; j++) {
+            if (wsz == 4) {
+                unsigned int w = st32[j * MB_LANES + i];
+
+                for (k = 0; k < 4; k++)
+                    *out++ = (unsigned char)(w >> (24 - 8 * k));
+            } else {
+                SHA_LONG64 w = st64[j * MB_LANES + i];
+
+                for (k = 0; k < 8; k++)
+                    *out++ = (unsigned char)(w >> (56 - 8 * k));
+            }
+        }
+    }
+    ret = 1;
+
+ err:
+    OPENSSL_cleanse(tail, sizeof(tail));
+    return ret;
+}
+
+int sha_multi_block_digest(int nid, const void *const data[],
+                           const size_t count[], unsigned char *const md[],
+                           size_t n)
+{
+    const SHA_MB_METHOD *meth;
+    unsigned char storage[sizeof(SHA512_MB_CTX) + 32];
+    void *ctx;
+    size_t i, lanes;
+    int ret = 1;
+
+    switch (nid) {
+    case NID_sha1:
+        meth = &sha1_mb_meth;
+        break;
+    case NID_sha224:
+        meth = &sha224_mb_meth;
+        break;
+    case NID_sha256:
+        meth = &sha256_mb_meth;
+        break;
+    case NID_sha384:
+        meth = &sha384_mb_meth;
+        break;
+    case NID_sha512:
+        meth = &sha512_mb_meth;
+        break;
+    default:
+        return 0;
+    }
+
+    ctx = storage + 32 - ((size_t)storage % 32); /* align */
+
+    for (i = 0; i < n && ret; i += lanes) {
+        lanes = n - i < MB_LANES ? n - i : MB_LANES;
+        ret = sha_mb_lanes(meth, ctx, data + i, count + i, md + i, lanes);
+    }
+
+    OPENSSL_cleanse(storage, sizeof(storage));
+    return ret;
+}
+
+#else
+
+int sha_multi_block_digest(int nid, const void *const data[],
+                           const size_t count[], unsigned char *const md[],
+                           size_t n)
+{
+    return 0;
+}
+
+#endif
@@ -8,6 +8,7 @@
  */
 
 #include <openssl/crypto.h>
+#include "internal/cryptlib_int.h"
 
 #if !defined(OPENSSL_THREADS) || defined(CRYPTO_TDEBUG)
 
@@ -121,4 +122,19 @@ int CRYPTO_atomic_add(int *val, int amount, int *ret, CRYPTO_RWLOCK *lock)
     return 1;
 }
 
+OSSL_THREAD *ossl_thread_start(void (*start)(void *), void *arg)
+{
+    return NULL;
+}
+
+int ossl_thread_join(OSSL_THREAD *thread)
+{
+    return 0;
+}
+
+int ossl_init_fork_handlers(void)
+{
+    return 0;
+}
+
 #endif
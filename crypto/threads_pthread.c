@@ -8,6 +8,8 @@
  */
 
 #include <openssl/crypto.h>
+#include "internal/cryptlib_int.h"
+#include "internal/rand.h"
 
 #if defined(OPENSSL_THREADS) && !defined(CRYPTO_TDEBUG) && !defined(OPENSSL_SYS_WINDOWS)
 
@@ -168,4 +170,63 @@ int CRYPTO_atomic_add(int *val, int amount, int *ret, CRYPTO_RWLOCK *lock)
     return 1;
 }
 
+struct ossl_thread_st {
+    pthread_t thread;
+    void (*start)(void *);
+    void *arg;
+};
+
+static void *thread_start(void *arg)
+{
+    OSSL_THREAD *thread = arg;
+
+    thread->start(thread->arg);
+    OPENSSL_thread_stop();
+    return NULL;
+}
+
+OSSL_THREAD *ossl_thread_start(void (*start)(void *), void *arg)
+{
+    OSSL_THREAD *thread = OPENSSL_zalloc(sizeof(*thread));
+
+    if (thread == NULL)
+        return NULL;
+
+    thread->start = start;
+    thread->arg = arg;
+    if (pthread_create(&thread->thread, NULL, thread_start, thread) != 0) {
+        OPENSSL_free(thread);
+        return NULL;
+    }
+
+    return thread;
+}
+
+int ossl_thread_join(OSSL_THREAD *thread)
+{
+    int ret;
+
+    if (thread == NULL)
+        return 0;
+
+    ret = pthread_join(thread->thread, NULL) == 0;
+    OPENSSL_free(thread);
+
+    return ret;
+}
+
+static void fork_child(void)
+{
+    rand_fork();
+}
+
+int ossl_init_fork_handlers(void)
+{
+# ifdef OPENSSL_SYS_UNIX
+    return pthread_atfork(NULL, NULL, fork_child) == 0;
+# else
+    return 0;
+# endif
+}
+
 #endif
@@ -12,6 +12,7 @@
 #endif
 
 #include <openssl/crypto.h>
+#include "internal/cryptlib_int.h"
 
 #if defined(OPENSSL_THREADS) && !defined(CRYPTO_TDEBUG) && defined(OPENSSL_SYS_WINDOWS)
 
@@ -133,4 +134,56 @@ int CRYPTO_atomic_add(int *val, int amount, int *ret, CRYPTO_RWLOCK *lock)
     return 1;
 }
 
+struct ossl_thread_st {
+    HANDLE handle;
+    void (*start)(void *);
+    void *arg;
+};
+
+static DWORD WINAPI thread_start(LPVOID arg)
+{
+    OSSL_THREAD *thread = arg;
+
+    thread->start(thread->arg);
+    OPENSSL_thread_stop();
+    return 0;
+}
+
+OSSL_THREAD *ossl_thread_start(void (*start)(void *), void *arg)
+{
+    OSSL_THREAD *thread = OPENSSL_zalloc(sizeof(*thread));
+
+    if (thread == NULL)
+        return NULL;
+
+    thread->start = start;
+    thread->arg = arg;
+    thread->handle = CreateThread(NULL, 0, thread_start, thread, 0, NULL);
+    if (thread->handle == NULL) {
+        OPENSSL_free(thread);
+        return NULL;
+    }
+
+    return thread;
+}
+
+int ossl_thread_join(OSSL_THREAD *thread)
+{
+    int ret;
+
+    if (thread == NULL)
+        return 0;
+
+    ret = WaitForSingleObject(thread->handle, INFINITE) == WAIT_OBJECT_0;
+    CloseHandle(thread->handle);
+    OPENSSL_free(thread);
+
+    return ret;
+}
+
+int ossl_init_fork_handlers(void)
+{
+    return 0;
+}
+
 #endif
@@ -69,6 +69,7 @@ OPENSSL_ia32_cpuid:
 
 	xor	%eax,%eax
 	mov	%eax,8(%rdi)		# clear extended feature flags
+	mov	%eax,12(%rdi)
 	cpuid
 	mov	%eax,%r11d		# max value for standard query level
 
@@ -172,6 +173,7 @@ OPENSSL_ia32_cpuid:
 	xor	%ecx,%ecx
 	cpuid
 	mov	%ebx,8(%rdi)		# save extended feature flags
+	mov	%ecx,12(%rdi)
 .Lno_extended_info:
 
 	bt	\$27,%r9d		# check OSXSAVE bit
@@ -193,6 +195,7 @@ OPENSSL_ia32_cpuid:
 	and	%eax,%r9d		# clear AVX, FMA and AMD XOP bits
 	mov	\$0x3fdeffdf,%eax	# ~(1<<31|1<<30|1<<21|1<<16|1<<5)
 	and	%eax,8(%rdi)		# cleax AVX2 and AVX512* bits
+	andl	\$0xfffff9ff,12(%rdi)	# clear VAES and VPCLMULQDQ
 .Ldone:
 	shl	\$32,%r9
 	mov	%r10d,%eax
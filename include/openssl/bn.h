@@ -139,6 +139,9 @@ void *BN_GENCB_get_arg(BN_GENCB *cb);
                                 (b) >=  150 ? 18 : \
                                 /* b >= 100 */ 27)
 
+/* Upper bound for BN_set_prime_search_threads() */
+# define BN_MAX_PRIME_SEARCH_THREADS 64
+
 # define BN_num_bytes(a) ((BN_num_bits(a)+7)/8)
 
 int BN_abs_is_word(const BIGNUM *a, const BN_ULONG w);
@@ -162,6 +165,9 @@ char *BN_options(void);
 BN_CTX *BN_CTX_new(void);
 BN_CTX *BN_CTX_secure_new(void);
 void BN_CTX_free(BN_CTX *c);
+int BN_CTX_set_cache_size(size_t num);
+size_t BN_CTX_get_cache_size(void);
+void BN_CTX_get_cache_stats(uint64_t *hits, uint64_t *misses);
 void BN_CTX_start(BN_CTX *ctx);
 BIGNUM *BN_CTX_get(BN_CTX *ctx);
 void BN_CTX_end(BN_CTX *ctx);
@@ -301,6 +307,8 @@ DEPRECATEDIN_0_9_8(int
 /* Newer versions */
 int BN_generate_prime_ex(BIGNUM *ret, int bits, int safe, const BIGNUM *add,
                          const BIGNUM *rem, BN_GENCB *cb);
+int BN_set_prime_search_threads(int num);
+int BN_get_prime_search_threads(void);
 int BN_is_prime_ex(const BIGNUM *p, int nchecks, BN_CTX *ctx, BN_GENCB *cb);
 int BN_is_prime_fasttest_ex(const BIGNUM *p, int nchecks, BN_CTX *ctx,
                             int do_trial_division, BN_GENCB *cb);
@@ -327,6 +335,9 @@ int BN_MONT_CTX_set(BN_MONT_CTX *mont, const BIGNUM *mod, BN_CTX *ctx);
 BN_MONT_CTX *BN_MONT_CTX_copy(BN_MONT_CTX *to, BN_MONT_CTX *from);
 BN_MONT_CTX *BN_MONT_CTX_set_locked(BN_MONT_CTX **pmont, CRYPTO_RWLOCK *lock,
                                     const BIGNUM *mod, BN_CTX *ctx);
+int BN_MONT_CTX_set_cache_size(size_t num);
+size_t BN_MONT_CTX_get_cache_size(void);
+void BN_MONT_CTX_get_cache_stats(uint64_t *hits, uint64_t *misses);
 
 /* BN_BLINDING flags */
 # define BN_BLINDING_NO_UPDATE   0x00000001
@@ -510,6 +521,8 @@ int ERR_load_BN_strings(void);
 # define BN_F_BN_BLINDING_UPDATE                          103
 # define BN_F_BN_BN2DEC                                   104
 # define BN_F_BN_BN2HEX                                   105
+# define BN_F_BN_COMB_MOD_EXP                             147
+# define BN_F_BN_COMB_NEW                                 148
 # define BN_F_BN_COMPUTE_WNAF                             142
 # define BN_F_BN_CTX_GET                                  116
 # define BN_F_BN_CTX_NEW                                  106
@@ -90,6 +90,11 @@ const EC_METHOD *EC_GFp_nistp224_method(void);
  */
 const EC_METHOD *EC_GFp_nistp256_method(void);
 
+/** Returns 64-bit optimized methods for nistp384
+ *  \return  EC_METHOD object
+ */
+const EC_METHOD *EC_GFp_nistp384_method(void);
+
 /** Returns 64-bit optimized methods for nistp521
  *  \return  EC_METHOD object
  */
@@ -692,6 +697,20 @@ int EC_GROUP_precompute_mult(EC_GROUP *group, BN_CTX *ctx);
  */
 int EC_GROUP_have_precompute_mult(const EC_GROUP *group);
 
+/** Sets the number of teeth of the fixed-base comb used to multiply the
+ *  generator, which trades table memory for speed
+ *  \param  group  EC_GROUP object
+ *  \param  teeth  number of teeth, or 0 to disable the comb
+ *  \return 1 on success and 0 if an error occurred
+ */
+int EC_GROUP_set_comb_teeth(EC_GROUP *group, int teeth);
+
+/** Returns the number of teeth of the generator comb
+ *  \param  group  EC_GROUP object
+ *  \return number of teeth, or 0 if the comb is disabled
+ */
+int EC_GROUP_get_comb_teeth(const EC_GROUP *group);
+
 /********************************************************************/
 /*                       ASN1 stuff                                 */
 /********************************************************************/
@@ -1121,6 +1140,21 @@ ECDSA_SIG *ECDSA_do_sign_ex(const unsigned char *dgst, int dgstlen,
 int ECDSA_do_verify(const unsigned char *dgst, int dgst_len,
                     const ECDSA_SIG *sig, EC_KEY *eckey);
 
+/** Verifies several ECDSA signatures at once
+ *  \param  dgsts      hash values
+ *  \param  dgst_lens  lengths of the hash values
+ *  \param  sigs       ECDSA_SIG structures
+ *  \param  keys       EC_KEY objects containing the public keys
+ *  \param  num        number of signatures
+ *  \param  results    receives the result of ECDSA_do_verify for each
+ *                     signature (optional)
+ *  \return 1 if all signatures are valid, 0 if at least one is invalid
+ *          and -1 on error
+ */
+int ECDSA_do_verify_batch(const unsigned char *const dgsts[],
+                          const int dgst_lens[], const ECDSA_SIG *const sigs[],
+                          EC_KEY *const keys[], size_t num, int results[]);
+
 /** Precompute parts of the signing operation
  *  \param  eckey  EC_KEY object containing a private EC key
  *  \param  ctx    BN_CTX object (optional)
@@ -1130,6 +1164,23 @@ int ECDSA_do_verify(const unsigned char *dgst, int dgst_len,
  */
 int ECDSA_sign_setup(EC_KEY *eckey, BN_CTX *ctx, BIGNUM **kinv, BIGNUM **rp);
 
+/** Precomputes parts of the signing operation for several signatures and
+ *  keeps them in the EC_KEY object, where ECDSA_sign() and ECDSA_do_sign()
+ *  use them in place of a fresh ECDSA_sign_setup()
+ *  \param  eckey  EC_KEY object containing a private EC key
+ *  \param  ctx    BN_CTX object (optional)
+ *  \param  num    number of signatures to precompute
+ *  \return 1 on success and 0 otherwise
+ */
+int ECDSA_sign_setup_batch(EC_KEY *eckey, BN_CTX *ctx, size_t num);
+
+/** Returns the number of precomputed signing values left in an EC_KEY
+ *  \param  eckey  EC_KEY object
+ *  \return the number of values added by ECDSA_sign_setup_batch() that
+ *          have not been used yet
+ */
+size_t ECDSA_sign_setup_count(const EC_KEY *eckey);
+
 /** Computes ECDSA signature of a given hash value using the supplied
  *  private key (note: sig must point to ECDSA_size(eckey) bytes of memory).
  *  \param  type     this parameter is ignored
@@ -1379,10 +1430,15 @@ int ERR_load_EC_strings(void);
 # define EC_F_ECDH_SIMPLE_COMPUTE_KEY                     257
 # define EC_F_ECDSA_DO_SIGN_EX                            251
 # define EC_F_ECDSA_DO_VERIFY                             252
+# define EC_F_ECDSA_DO_VERIFY_BATCH                       280
 # define EC_F_ECDSA_SIGN_EX                               254
 # define EC_F_ECDSA_SIGN_SETUP                            248
+# define EC_F_ECDSA_SIGN_SETUP_BATCH                      287
 # define EC_F_ECDSA_SIG_NEW                               265
 # define EC_F_ECDSA_VERIFY                                253
+# define EC_F_ECDSA_VERIFY_CHECK                          285
+# define EC_F_ECDSA_VERIFY_SINV                           286
+# define EC_F_ECD_ITEM_VERIFY                             274
 # define EC_F_ECKEY_PARAM2TYPE                            223
 # define EC_F_ECKEY_PARAM_DECODE                          212
 # define EC_F_ECKEY_PRIV_DECODE                           213
@@ -1396,6 +1452,7 @@ int ERR_load_EC_strings(void);
 # define EC_F_ECPKPARAMETERS_PRINT_FP                     150
 # define EC_F_ECP_NISTZ256_GET_AFFINE                     240
 # define EC_F_ECP_NISTZ256_MULT_PRECOMPUTE                243
+# define EC_F_ECP_NISTZ256_MUL_PUBLIC                     281
 # define EC_F_ECP_NISTZ256_POINTS_MUL                     241
 # define EC_F_ECP_NISTZ256_PRE_COMP_NEW                   244
 # define EC_F_ECP_NISTZ256_WINDOWED_MUL                   242
@@ -1404,6 +1461,10 @@ int ERR_load_EC_strings(void);
 # define EC_F_ECX_PUB_ENCODE                              268
 # define EC_F_EC_ASN1_GROUP2CURVE                         153
 # define EC_F_EC_ASN1_GROUP2FIELDID                       154
+# define EC_F_EC_COMB_BUILD                               277
+# define EC_F_EC_COMB_BUILD_ODD                           282
+# define EC_F_EC_COMB_MUL                                 278
+# define EC_F_EC_COMB_NEW                                 279
 # define EC_F_EC_GF2M_MONTGOMERY_POINT_MULTIPLY           208
 # define EC_F_EC_GF2M_SIMPLE_GROUP_CHECK_DISCRIMINANT     159
 # define EC_F_EC_GF2M_SIMPLE_GROUP_SET_CURVE              195
@@ -1424,6 +1485,9 @@ int ERR_load_EC_strings(void);
 # define EC_F_EC_GFP_NISTP256_GROUP_SET_CURVE             230
 # define EC_F_EC_GFP_NISTP256_POINTS_MUL                  231
 # define EC_F_EC_GFP_NISTP256_POINT_GET_AFFINE_COORDINATES 232
+# define EC_F_EC_GFP_NISTP384_GROUP_SET_CURVE             270
+# define EC_F_EC_GFP_NISTP384_POINTS_MUL                  271
+# define EC_F_EC_GFP_NISTP384_POINT_GET_AFFINE_COORDINATES 272
 # define EC_F_EC_GFP_NISTP521_GROUP_SET_CURVE             233
 # define EC_F_EC_GFP_NISTP521_POINTS_MUL                  234
 # define EC_F_EC_GFP_NISTP521_POINT_GET_AFFINE_COORDINATES 235
@@ -1482,6 +1546,7 @@ int ERR_load_EC_strings(void);
 # define EC_F_EC_POINT_IS_AT_INFINITY                     118
 # define EC_F_EC_POINT_IS_ON_CURVE                        119
 # define EC_F_EC_POINT_MAKE_AFFINE                        120
+# define EC_F_EC_POINT_MUL_PUBLIC                         283
 # define EC_F_EC_POINT_NEW                                121
 # define EC_F_EC_POINT_OCT2POINT                          122
 # define EC_F_EC_POINT_POINT2OCT                          123
@@ -1500,12 +1565,18 @@ int ERR_load_EC_strings(void);
 # define EC_F_I2O_ECPUBLICKEY                             151
 # define EC_F_NISTP224_PRE_COMP_NEW                       227
 # define EC_F_NISTP256_PRE_COMP_NEW                       236
+# define EC_F_NISTP384_PRE_COMP_NEW                       273
 # define EC_F_NISTP521_PRE_COMP_NEW                       237
 # define EC_F_O2I_ECPUBLICKEY                             152
 # define EC_F_OLD_EC_PRIV_DECODE                          222
 # define EC_F_OSSL_ECDH_COMPUTE_KEY                       247
+# define EC_F_OSSL_ECDSA_SIGN_SETUP_BATCH                 288
 # define EC_F_OSSL_ECDSA_SIGN_SIG                         249
+# define EC_F_OSSL_ECDSA_VERIFY_BATCH                     284
 # define EC_F_OSSL_ECDSA_VERIFY_SIG                       250
+# define EC_F_PKEY_ECD_CTRL                               275
+# define EC_F_PKEY_ECD_DIGESTSIGN                         276
+# define EC_F_PKEY_ECD_DIGESTVERIFY                       289
 # define EC_F_PKEY_ECX_DERIVE                             269
 # define EC_F_PKEY_EC_CTRL                                197
 # define EC_F_PKEY_EC_CTRL_STR                            198
@@ -1532,6 +1603,7 @@ int ERR_load_EC_strings(void);
 # define EC_R_I2D_ECPKPARAMETERS_FAILURE                  121
 # define EC_R_INCOMPATIBLE_OBJECTS                        101
 # define EC_R_INVALID_ARGUMENT                            112
+# define EC_R_INVALID_COMB_TEETH                          136
 # define EC_R_INVALID_COMPRESSED_POINT                    110
 # define EC_R_INVALID_COMPRESSION_BIT                     109
 # define EC_R_INVALID_CURVE                               141
@@ -11,6 +11,7 @@
 # define HEADER_RAND_H
 
 # include <stdlib.h>
+# include <time.h>
 # include <openssl/ossl_typ.h>
 # include <openssl/e_os2.h>
 
@@ -44,6 +45,11 @@ RAND_METHOD *RAND_OpenSSL(void);
 # define RAND_cleanup() while(0) continue
 #endif
 int RAND_bytes(unsigned char *buf, int num);
+int RAND_priv_bytes(unsigned char *buf, int num);
+int RAND_DRBG_set_reseed_defaults(unsigned int master_interval,
+                                  unsigned int thread_interval,
+                                  time_t master_time_interval,
+                                  time_t thread_time_interval);
 DEPRECATEDIN_1_1_0(int RAND_pseudo_bytes(unsigned char *buf, int num))
 void RAND_seed(const void *buf, int num);
 #if defined(__ANDROID__) && defined(__NDK_FPABI__)
@@ -78,9 +84,12 @@ int ERR_load_RAND_strings(void);
 /* Error codes for the RAND functions. */
 
 /* Function codes. */
+# define RAND_F_DRBG_GENERATE                             101
+# define RAND_F_DRBG_NEW                                  102
 # define RAND_F_RAND_BYTES                                100
 
 /* Reason codes. */
+# define RAND_R_ERROR_INSTANTIATING_DRBG                  101
 # define RAND_R_PRNG_NOT_SEEDED                           100
 
 # ifdef  __cplusplus
@@ -230,6 +230,7 @@ typedef struct ssl_session_st SSL_SESSION;
 typedef struct tls_sigalgs_st TLS_SIGALGS;
 typedef struct ssl_conf_ctx_st SSL_CONF_CTX;
 typedef struct ssl_comp_st SSL_COMP;
+typedef struct ssl_anti_replay_st SSL_ANTI_REPLAY;
 
 STACK_OF(SSL_CIPHER);
 STACK_OF(SSL_COMP);
@@ -855,6 +856,18 @@ uint32_t SSL_CTX_get_max_early_data(const SSL_CTX *ctx);
 int SSL_set_max_early_data(SSL *s, uint32_t max_early_data);
 uint32_t SSL_get_max_early_data(const SSL *s);
 
+SSL_ANTI_REPLAY *SSL_ANTI_REPLAY_new(size_t max_entries, uint32_t window);
+int SSL_ANTI_REPLAY_up_ref(SSL_ANTI_REPLAY *ar);
+void SSL_ANTI_REPLAY_free(SSL_ANTI_REPLAY *ar);
+int SSL_ANTI_REPLAY_check(SSL_ANTI_REPLAY *ar, const unsigned char *id,
+                          size_t idlen);
+int SSL_CTX_set1_anti_replay(SSL_CTX *ctx, SSL_ANTI_REPLAY *ar);
+SSL_ANTI_REPLAY *SSL_CTX_get0_anti_replay(const SSL_CTX *ctx);
+typedef int (*SSL_anti_replay_cb_fn) (SSL *s, const unsigned char *id,
+                                      size_t idlen, void *arg);
+void SSL_CTX_set_anti_replay_cb(SSL_CTX *ctx, SSL_anti_replay_cb_fn cb,
+                                void *arg);
+
 #ifdef __cplusplus
 }
 #endif
@@ -1010,6 +1023,9 @@ int SSL_is_init_finished(SSL *s);
 size_t SSL_get_finished(const SSL *s, void *buf, size_t count);
 size_t SSL_get_peer_finished(const SSL *s, void *buf, size_t count);
 
+/* Approximate number of bytes held by this connection alone */
+size_t SSL_get_memory_usage(const SSL *s);
+
 /*
  * use either SSL_VERIFY_NONE or SSL_VERIFY_PEER, the last 2 options are
  * 'ored' with SSL_VERIFY_PEER if they are desired
@@ -2196,6 +2212,7 @@ int ERR_load_SSL_strings(void);
 # define SSL_F_ADD_KEY_SHARE                              512
 # define SSL_F_BYTES_TO_CIPHER_LIST                       519
 # define SSL_F_CHECK_SUITEB_CIPHER_LIST                   331
+# define SSL_F_COLLECT_EXTENSIONS                         543
 # define SSL_F_CREATE_SYNTHETIC_MESSAGE_HASH              539
 # define SSL_F_CT_MOVE_SCTS                               345
 # define SSL_F_CT_STRICT                                  349
@@ -2246,6 +2263,7 @@ int ERR_load_SSL_strings(void);
 # define SSL_F_SSL3_DIGEST_CACHED_RECORDS                 293
 # define SSL_F_SSL3_DO_CHANGE_CIPHER_SPEC                 292
 # define SSL_F_SSL3_FINAL_FINISH_MAC                      285
+# define SSL_F_SSL3_FINISH_MAC                            546
 # define SSL_F_SSL3_GENERATE_KEY_BLOCK                    238
 # define SSL_F_SSL3_GENERATE_MASTER_SECRET                388
 # define SSL_F_SSL3_GET_RECORD                            143
@@ -2269,6 +2287,7 @@ int ERR_load_SSL_strings(void);
 # define SSL_F_SSL_ADD_SERVERHELLO_RENEGOTIATE_EXT        299
 # define SSL_F_SSL_ADD_SERVERHELLO_TLSEXT                 278
 # define SSL_F_SSL_ADD_SERVERHELLO_USE_SRTP_EXT           308
+# define SSL_F_SSL_ANTI_REPLAY_NEW                        545
 # define SSL_F_SSL_BAD_METHOD                             160
 # define SSL_F_SSL_BUILD_CERT_CHAIN                       332
 # define SSL_F_SSL_BYTES_TO_CIPHER_LIST                   161
@@ -2396,6 +2415,7 @@ int ERR_load_SSL_strings(void);
 # define SSL_F_TLS1_SET_SERVER_SIGALGS                    335
 # define SSL_F_TLS_CHOOSE_SIGALG                          513
 # define SSL_F_TLS_CLIENT_KEY_EXCHANGE_POST_WORK          354
+# define SSL_F_TLS_COLLECT_CLIENT_HELLO_EXTENSIONS        544
 # define SSL_F_TLS_COLLECT_EXTENSIONS                     435
 # define SSL_F_TLS_CONSTRUCT_CERTIFICATE_AUTHORITIES      542
 # define SSL_F_TLS_CONSTRUCT_CERTIFICATE_REQUEST          372
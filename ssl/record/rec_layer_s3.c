@@ -101,6 +101,20 @@ int RECORD_LAYER_write_pending(const RECORD_LAYER *rl)
         && SSL3_BUFFER_get_left(&rl->wbuf[rl->numwpipes - 1]) != 0;
 }
 
+/* Returns the number of bytes currently allocated for record buffers */
+size_t RECORD_LAYER_get_memory_usage(const RECORD_LAYER *rl)
+{
+    size_t i, ret = 0;
+
+    if (SSL3_BUFFER_is_initialised(&rl->rbuf))
+        ret += rl->rbuf.len;
+    for (i = 0; i < rl->numwpipes; i++)
+        if (SSL3_BUFFER_is_initialised(&rl->wbuf[i]))
+            ret += rl->wbuf[i].len;
+
+    return ret;
+}
+
 void RECORD_LAYER_reset_read_sequence(RECORD_LAYER *rl)
 {
     memset(rl->read_sequence, 0, sizeof(rl->read_sequence));
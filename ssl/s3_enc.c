@@ -363,6 +363,12 @@ int ssl3_finish_mac(SSL *s, const unsigned char *buf, size_t len)
 {
     if (s->s3->handshake_dgst == NULL) {
         int ret;
+
+        /* The transcript is freed once a handshake is over */
+        if (s->s3->handshake_buffer == NULL) {
+            SSLerr(SSL_F_SSL3_FINISH_MAC, ERR_R_INTERNAL_ERROR);
+            return 0;
+        }
         /* Note: this writes to a memory BIO so a failure is a fatal error */
         if (len > INT_MAX)
             return 0;
@@ -2983,6 +2983,28 @@ void ssl3_clear(SSL *s)
 #endif
 }
 
+/*
+ * Release state that is only needed while a handshake is in progress, so
+ * that an established connection does not keep holding on to it. The
+ * transcript is dropped altogether: tls_setup_handshake() starts a new one
+ * for the next handshake, and post-handshake messages are not hashed.
+ */
+int ssl3_free_handshake_state(SSL *s)
+{
+    ssl3_free_digest_list(s);
+#if !defined(OPENSSL_NO_EC) || !defined(OPENSSL_NO_DH)
+    EVP_PKEY_free(s->s3->tmp.pkey);
+    s->s3->tmp.pkey = NULL;
+#endif
+    OPENSSL_clear_free(s->s3->tmp.pms, s->s3->tmp.pmslen);
+    s->s3->tmp.pms = NULL;
+    s->s3->tmp.pmslen = 0;
+    OPENSSL_free(s->s3->alpn_proposed);
+    s->s3->alpn_proposed = NULL;
+    s->s3->alpn_proposed_len = 0;
+    return 1;
+}
+
 #ifndef OPENSSL_NO_SRP
 static char *srp_password_from_info_cb(SSL *s, void *arg)
 {
@@ -3755,6 +3777,14 @@ const SSL_CIPHER *ssl3_choose_cipher(SSL *s, STACK_OF(SSL_CIPHER) *clnt,
             if (alg_k & SSL_kECDHE)
                 ok = ok && tls1_check_ec_tmp_key(s, c->id);
 #endif                          /* OPENSSL_NO_EC */
+#if !defined(OPENSSL_NO_DH) && !defined(OPENSSL_NO_EC)
+            /*
+             * A client offering RFC 7919 groups only gets DHE with one of
+             * them
+             */
+            if (alg_k & (SSL_kDHE | SSL_kDHEPSK))
+                ok = ok && tls1_shared_ffdhe_group(s, 0) >= 0;
+#endif
 
             if (!ok)
                 continue;
@@ -1016,6 +1016,8 @@ void SSL_free(SSL *s)
     OPENSSL_free(s->ext.ocsp.resp);
     OPENSSL_free(s->ext.alpn);
     OPENSSL_free(s->ext.tls13_cookie);
+    if (s->clienthello != NULL)
+        tls_free_client_hello_extensions(s->clienthello);
     OPENSSL_free(s->clienthello);
 
     sk_X509_NAME_pop_free(s->ca_names, X509_NAME_free);
@@ -1229,6 +1231,39 @@ size_t SSL_get_finished(const SSL *s, void *buf, size_t count)
     return ret;
 }
 
+/*
+ * Approximate number of bytes held by this connection itself, not counting
+ * objects shared with other connections such as the SSL_CTX or SSL_SESSION.
+ */
+size_t SSL_get_memory_usage(const SSL *s)
+{
+    size_t ret = sizeof(*s);
+
+    ret += RECORD_LAYER_get_memory_usage(&s->rlayer);
+    if (s->init_buf != NULL)
+        ret += s->init_buf->max;
+    if (s->cert != NULL)
+        ret += sizeof(*s->cert);
+    if (s->enc_read_ctx != NULL)
+        ret += EVP_CIPHER_impl_ctx_size(EVP_CIPHER_CTX_cipher(s->enc_read_ctx));
+    if (s->enc_write_ctx != NULL)
+        ret += EVP_CIPHER_impl_ctx_size(EVP_CIPHER_CTX_cipher(s->enc_write_ctx));
+    if (s->s3 != NULL) {
+        ret += sizeof(*s->s3);
+        if (s->s3->handshake_buffer != NULL)
+            ret += BIO_ctrl_pending(s->s3->handshake_buffer);
+        if (s->s3->handshake_dgst != NULL)
+            ret += EVP_MD_meth_get_app_datasize(
+                       EVP_MD_CTX_md(s->s3->handshake_dgst));
+        if (s->s3->tmp.key_block != NULL)
+            ret += s->s3->tmp.key_block_length;
+    }
+    if (s->d1 != NULL)
+        ret += sizeof(*s->d1);
+
+    return ret;
+}
+
 /* return length of latest Finished message we expected, copy to 'buf' */
 size_t SSL_get_peer_finished(const SSL *s, void *buf, size_t count)
 {
@@ -2832,6 +2867,7 @@ void SSL_CTX_free(SSL_CTX *a)
     OPENSSL_free(a->ext.supportedgroups);
 #endif
     OPENSSL_free(a->ext.alpn);
+    SSL_ANTI_REPLAY_free(a->anti_replay);
 
     CRYPTO_THREAD_lock_free(a->lock);
 
@@ -2985,6 +3021,11 @@ void ssl_set_masks(SSL *s)
         if (ecdsa_ok)
             mask_a |= SSL_aECDSA;
     }
+    /* Allow Ed25519 for TLS 1.2 if peer supports it */
+    if (!(mask_a & SSL_aECDSA) && ssl_has_cert(s, SSL_PKEY_ED25519)
+            && pvalid[SSL_PKEY_ED25519] & CERT_PKEY_EXPLICIT_SIGN
+            && TLS1_get_version(s) == TLS1_2_VERSION)
+        mask_a |= SSL_aECDSA;
 #endif
 
 #ifndef OPENSSL_NO_EC
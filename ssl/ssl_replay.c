@@ -0,0 +1,269 @@
+/*
+ * Copyright 2017 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the OpenSSL license (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+#include <openssl/rand.h>
+#include <openssl/sha.h>
+#include "ssl_locl.h"
+
+/*
+ * Anti-replay store for TLSv1.3 early data.
+ *
+ * Each ClientHello that would have its early data accepted is recorded
+ * (RFC 8446, section 8.2). A ClientHello older than the ticket age tolerance
+ * is already rejected by the freshness check in tls_parse_ctos_psk(), so
+ * identifiers only need to be remembered for that long. The store therefore
+ * keeps two generations of fixed size tables: the current one and the
+ * previous one. Once the current generation is |window| seconds old it
+ * becomes the previous one and the old previous one is discarded, so each
+ * identifier is kept for between |window| and 2 * |window| seconds with no
+ * per entry expiry.
+ *
+ * Identifiers are reduced to a 64 bit fingerprint using a hash keyed with a
+ * secret chosen when the store is created, so that clients cannot aim their
+ * identifiers at a single shard or probe sequence. A fingerprint collision
+ * only means that early data is rejected and a full handshake done, which is
+ * always safe. For the same reason a generation that has filled up rejects
+ * everything until it is rotated out.
+ *
+ * The store is split into shards that each have their own lock, so that
+ * concurrent handshakes rarely contend.
+ */
+
+#define ANTI_REPLAY_SHARDS          16
+#define ANTI_REPLAY_KEY_LEN         32
+/* Shortest window that still covers TICKET_AGE_ALLOWANCE plus rounding */
+#define ANTI_REPLAY_MIN_WINDOW      (TICKET_AGE_ALLOWANCE / 1000 + 1)
+
+typedef struct {
+    CRYPTO_RWLOCK *lock;
+    /* When the current generation was started */
+    time_t start;
+    /* Which of |gen| is the current generation */
+    int cur;
+    size_t count[2];
+    /* Open addressed tables of fingerprints, 0 marks an empty slot */
+    uint64_t *gen[2];
+} ANTI_REPLAY_SHARD;
+
+struct ssl_anti_replay_st {
+    uint32_t window;
+    /* Maximum fingerprints per shard per generation */
+    size_t limit;
+    /* Size of each table, a power of 2 */
+    size_t slots;
+    unsigned char key[ANTI_REPLAY_KEY_LEN];
+    ANTI_REPLAY_SHARD shard[ANTI_REPLAY_SHARDS];
+    CRYPTO_REF_COUNT references;
+    CRYPTO_RWLOCK *lock;
+};
+
+SSL_ANTI_REPLAY *SSL_ANTI_REPLAY_new(size_t max_entries, uint32_t window)
+{
+    SSL_ANTI_REPLAY *ar;
+    size_t i;
+
+    if (max_entries == 0) {
+        SSLerr(SSL_F_SSL_ANTI_REPLAY_NEW, ERR_R_PASSED_INVALID_ARGUMENT);
+        return NULL;
+    }
+
+    ar = OPENSSL_zalloc(sizeof(*ar));
+    if (ar == NULL) {
+        SSLerr(SSL_F_SSL_ANTI_REPLAY_NEW, ERR_R_MALLOC_FAILURE);
+        return NULL;
+    }
+    ar->references = 1;
+    ar->window = window < ANTI_REPLAY_MIN_WINDOW ? ANTI_REPLAY_MIN_WINDOW
+                                                 : window;
+    ar->limit = (max_entries + ANTI_REPLAY_SHARDS - 1) / ANTI_REPLAY_SHARDS;
+    if (ar->limit > ((size_t)-1 / sizeof(uint64_t)) / 4) {
+        SSLerr(SSL_F_SSL_ANTI_REPLAY_NEW, ERR_R_PASSED_INVALID_ARGUMENT);
+        goto err;
+    }
+    /* Keep the tables at most half full so that probe sequences stay short */
+    for (ar->slots = 4; ar->slots < 2 * ar->limit; ar->slots <<= 1)
+        continue;
+
+    ar->lock = CRYPTO_THREAD_lock_new();
+    if (ar->lock == NULL)
+        goto merr;
+    for (i = 0; i < ANTI_REPLAY_SHARDS; i++) {
+        ANTI_REPLAY_SHARD *sh = &ar->shard[i];
+
+        sh->lock = CRYPTO_THREAD_lock_new();
+        sh->gen[0] = OPENSSL_zalloc(ar->slots * sizeof(uint64_t));
+        sh->gen[1] = OPENSSL_zalloc(ar->slots * sizeof(uint64_t));
+        if (sh->lock == NULL || sh->gen[0] == NULL || sh->gen[1] == NULL)
+            goto merr;
+    }
+
+    if (RAND_bytes(ar->key, sizeof(ar->key)) <= 0)
+        goto err;
+
+    return ar;
+ merr:
+    SSLerr(SSL_F_SSL_ANTI_REPLAY_NEW, ERR_R_MALLOC_FAILURE);
+ err:
+    SSL_ANTI_REPLAY_free(ar);
+    return NULL;
+}
+
+int SSL_ANTI_REPLAY_up_ref(SSL_ANTI_REPLAY *ar)
+{
+    int i;
+
+    if (CRYPTO_UP_REF(&ar->references, &i, ar->lock) <= 0)
+        return 0;
+
+    REF_PRINT_COUNT("SSL_ANTI_REPLAY", ar);
+    REF_ASSERT_ISNT(i < 2);
+    return ((i > 1) ? 1 : 0);
+}
+
+void SSL_ANTI_REPLAY_free(SSL_ANTI_REPLAY *ar)
+{
+    int i;
+    size_t j;
+
+    if (ar == NULL)
+        return;
+
+    CRYPTO_DOWN_REF(&ar->references, &i, ar->lock);
+    REF_PRINT_COUNT("SSL_ANTI_REPLAY", ar);
+    if (i > 0)
+        return;
+    REF_ASSERT_ISNT(i < 0);
+
+    for (j = 0; j < ANTI_REPLAY_SHARDS; j++) {
+        CRYPTO_THREAD_lock_free(ar->shard[j].lock);
+        OPENSSL_free(ar->shard[j].gen[0]);
+        OPENSSL_free(ar->shard[j].gen[1]);
+    }
+    CRYPTO_THREAD_lock_free(ar->lock);
+    OPENSSL_cleanse(ar->key, sizeof(ar->key));
+    OPENSSL_free(ar);
+}
+
+/* Rotate the generations of |sh| as needed for the time |now| */
+static void anti_replay_rotate(const SSL_ANTI_REPLAY *ar,
+                               ANTI_REPLAY_SHARD *sh, time_t now)
+{
+    int prev = sh->cur ^ 1;
+
+    if (sh->start == 0 || now - sh->start >= 2 * (time_t)ar->window) {
+        /* Everything in both generations is older than the window */
+        memset(sh->gen[0], 0, ar->slots * sizeof(uint64_t));
+        memset(sh->gen[1], 0, ar->slots * sizeof(uint64_t));
+        sh->count[0] = sh->count[1] = 0;
+    } else if (now - sh->start >= (time_t)ar->window) {
+        memset(sh->gen[prev], 0, ar->slots * sizeof(uint64_t));
+        sh->count[prev] = 0;
+        sh->cur = prev;
+    } else {
+        return;
+    }
+    sh->start = now;
+}
+
+static int anti_replay_find(const SSL_ANTI_REPLAY *ar, const uint64_t *tab,
+                            uint64_t fp, size_t *pos)
+{
+    size_t mask = ar->slots - 1;
+    size_t i = (size_t)fp & mask;
+
+    /* Tables are never more than half full so this always terminates */
+    while (tab[i] != 0) {
+        if (tab[i] == fp)
+            return 1;
+        i = (i + 1) & mask;
+    }
+    *pos = i;
+    return 0;
+}
+
+int SSL_ANTI_REPLAY_check(SSL_ANTI_REPLAY *ar, const unsigned char *id,
+                          size_t idlen)
+{
+    time_t now = time(NULL);
+    unsigned char md[SHA256_DIGEST_LENGTH];
+    SHA256_CTX sha;
+    ANTI_REPLAY_SHARD *sh;
+    uint64_t fp = 0;
+    size_t i, pos;
+    int ret = 0;
+
+    SHA256_Init(&sha);
+    SHA256_Update(&sha, ar->key, sizeof(ar->key));
+    SHA256_Update(&sha, id, idlen);
+    SHA256_Final(md, &sha);
+
+    for (i = 0; i < sizeof(fp); i++)
+        fp = (fp << 8) | md[i];
+    if (fp == 0)
+        fp = 1;
+    sh = &ar->shard[md[sizeof(fp)] % ANTI_REPLAY_SHARDS];
+
+    if (!CRYPTO_THREAD_write_lock(sh->lock))
+        return 0;
+
+    anti_replay_rotate(ar, sh, now);
+    if (anti_replay_find(ar, sh->gen[sh->cur ^ 1], fp, &pos)
+            || anti_replay_find(ar, sh->gen[sh->cur], fp, &pos)
+            || sh->count[sh->cur] >= ar->limit)
+        goto end;
+
+    sh->gen[sh->cur][pos] = fp;
+    sh->count[sh->cur]++;
+    ret = 1;
+ end:
+    CRYPTO_THREAD_unlock(sh->lock);
+    return ret;
+}
+
+int SSL_CTX_set1_anti_replay(SSL_CTX *ctx, SSL_ANTI_REPLAY *ar)
+{
+    if (ar != NULL && !SSL_ANTI_REPLAY_up_ref(ar))
+        return 0;
+    SSL_ANTI_REPLAY_free(ctx->anti_replay);
+    ctx->anti_replay = ar;
+    return 1;
+}
+
+SSL_ANTI_REPLAY *SSL_CTX_get0_anti_replay(const SSL_CTX *ctx)
+{
+    return ctx->anti_replay;
+}
+
+void SSL_CTX_set_anti_replay_cb(SSL_CTX *ctx, SSL_anti_replay_cb_fn cb,
+                                void *arg)
+{
+    ctx->anti_replay_cb = cb;
+    ctx->anti_replay_cb_arg = arg;
+}
+
+/*
+ * Decide whether early data from the ClientHello being processed by |s| may
+ * be accepted as far as replay protection is concerned. The ClientHello is
+ * identified by its random: it is covered by the PSK binder, so a replayed
+ * ClientHello cannot have a different one. Returns 1 if the early data may be
+ * accepted and 0 otherwise.
+ */
+int ssl_anti_replay_ok(SSL *s)
+{
+    SSL_CTX *ctx = s->session_ctx;
+
+    if (ctx->anti_replay_cb != NULL)
+        return ctx->anti_replay_cb(s, s->s3->client_random,
+                                   SSL3_RANDOM_SIZE,
+                                   ctx->anti_replay_cb_arg) == 1;
+    if (ctx->anti_replay != NULL)
+        return SSL_ANTI_REPLAY_check(ctx->anti_replay, s->s3->client_random,
+                                     SSL3_RANDOM_SIZE);
+    return 1;
+}
@@ -346,6 +346,99 @@ static int validate_context(SSL *s, unsigned int extctx, unsigned int thisctx)
     return 1;
 }
 
+/*
+ * Find the index into ext_defs for the built-in extension |type|. This is on
+ * the path for every extension in every ClientHello, so avoid a linear scan of
+ * the table. Returns OSSL_NELEM(ext_defs) if |type| is not a built-in
+ * extension, or if it has been compiled out.
+ */
+static size_t ext_defs_index(unsigned int type)
+{
+    size_t idx;
+
+    switch (type) {
+    case TLSEXT_TYPE_renegotiate:
+        idx = TLSEXT_IDX_renegotiate;
+        break;
+    case TLSEXT_TYPE_server_name:
+        idx = TLSEXT_IDX_server_name;
+        break;
+    case TLSEXT_TYPE_srp:
+        idx = TLSEXT_IDX_srp;
+        break;
+    case TLSEXT_TYPE_ec_point_formats:
+        idx = TLSEXT_IDX_ec_point_formats;
+        break;
+    case TLSEXT_TYPE_supported_groups:
+        idx = TLSEXT_IDX_supported_groups;
+        break;
+    case TLSEXT_TYPE_session_ticket:
+        idx = TLSEXT_IDX_session_ticket;
+        break;
+    case TLSEXT_TYPE_signature_algorithms:
+        idx = TLSEXT_IDX_signature_algorithms;
+        break;
+    case TLSEXT_TYPE_status_request:
+        idx = TLSEXT_IDX_status_request;
+        break;
+#ifndef OPENSSL_NO_NEXTPROTONEG
+    case TLSEXT_TYPE_next_proto_neg:
+        idx = TLSEXT_IDX_next_proto_neg;
+        break;
+#endif
+    case TLSEXT_TYPE_application_layer_protocol_negotiation:
+        idx = TLSEXT_IDX_application_layer_protocol_negotiation;
+        break;
+    case TLSEXT_TYPE_use_srtp:
+        idx = TLSEXT_IDX_use_srtp;
+        break;
+    case TLSEXT_TYPE_encrypt_then_mac:
+        idx = TLSEXT_IDX_encrypt_then_mac;
+        break;
+    case TLSEXT_TYPE_signed_certificate_timestamp:
+        idx = TLSEXT_IDX_signed_certificate_timestamp;
+        break;
+    case TLSEXT_TYPE_extended_master_secret:
+        idx = TLSEXT_IDX_extended_master_secret;
+        break;
+    case TLSEXT_TYPE_supported_versions:
+        idx = TLSEXT_IDX_supported_versions;
+        break;
+    case TLSEXT_TYPE_psk_kex_modes:
+        idx = TLSEXT_IDX_psk_kex_modes;
+        break;
+    case TLSEXT_TYPE_key_share:
+        idx = TLSEXT_IDX_key_share;
+        break;
+    case TLSEXT_TYPE_cookie:
+        idx = TLSEXT_IDX_cookie;
+        break;
+    case TLSEXT_TYPE_cryptopro_bug:
+        idx = TLSEXT_IDX_cryptopro_bug;
+        break;
+    case TLSEXT_TYPE_early_data:
+        idx = TLSEXT_IDX_early_data;
+        break;
+    case TLSEXT_TYPE_certificate_authorities:
+        idx = TLSEXT_IDX_certificate_authorities;
+        break;
+    case TLSEXT_TYPE_padding:
+        idx = TLSEXT_IDX_padding;
+        break;
+    case TLSEXT_TYPE_psk:
+        idx = TLSEXT_IDX_psk;
+        break;
+    default:
+        return OSSL_NELEM(ext_defs);
+    }
+
+    /* Disabled extensions are left in ext_defs as INVALID_EXTENSION */
+    if (idx >= OSSL_NELEM(ext_defs) || ext_defs[idx].type != type)
+        return OSSL_NELEM(ext_defs);
+
+    return idx;
+}
+
 /*
  * Verify whether we are allowed to use the extension |type| in the current
  * |context|. Returns 1 to indicate the extension is allowed or unknown or 0 to
@@ -356,18 +449,15 @@ static int verify_extension(SSL *s, unsigned int context, unsigned int type,
                             custom_ext_methods *meths, RAW_EXTENSION *rawexlist,
                             RAW_EXTENSION **found)
 {
-    size_t i;
     size_t builtin_num = OSSL_NELEM(ext_defs);
-    const EXTENSION_DEFINITION *thisext;
+    size_t i = ext_defs_index(type);
 
-    for (i = 0, thisext = ext_defs; i < builtin_num; i++, thisext++) {
-        if (type == thisext->type) {
-            if (!validate_context(s, thisext->context, context))
-                return 0;
+    if (i < builtin_num) {
+        if (!validate_context(s, ext_defs[i].context, context))
+            return 0;
 
-            *found = &rawexlist[i];
-            return 1;
-        }
+        *found = &rawexlist[i];
+        return 1;
     }
 
     /* Check the custom extensions */
@@ -416,33 +506,18 @@ int extension_is_relevant(SSL *s, unsigned int extctx, unsigned int thisctx)
 }
 
 /*
- * Gather a list of all the extensions from the data in |packet]. |context|
- * tells us which message this extension is for. The raw extension data is
- * stored in |*res| on success. In the event of an error the alert type to use
- * is stored in |*al|. We don't actually process the content of the extensions
- * yet, except to check their types. This function also runs the initialiser
- * functions for all known extensions (whether we have collected them or not).
- * If successful the caller is responsible for freeing the contents of |*res|.
- *
- * Per http://tools.ietf.org/html/rfc5246#section-7.4.1.4, there may not be
- * more than one extension of the same type in a ClientHello or ServerHello.
- * This function returns 1 if all extensions are unique and we have parsed their
- * types, and 0 if the extensions contain duplicates, could not be successfully
- * found, or an internal error occurred. We only check duplicates for
- * extensions that we know about. We ignore others.
+ * Collect the extensions in |packet| into |raw_extensions|, which must have
+ * room for every built-in and custom extension, and run the initialisers. See
+ * tls_collect_extensions().
  */
-int tls_collect_extensions(SSL *s, PACKET *packet, unsigned int context,
-                           RAW_EXTENSION **res, int *al, size_t *len)
+static int collect_extensions(SSL *s, PACKET *packet, unsigned int context,
+                              RAW_EXTENSION *raw_extensions, int *al)
 {
     PACKET extensions = *packet;
     size_t i = 0;
-    size_t num_exts;
     custom_ext_methods *exts = &s->cert->custext;
-    RAW_EXTENSION *raw_extensions = NULL;
     const EXTENSION_DEFINITION *thisexd;
 
-    *res = NULL;
-
     /*
      * Initialise server side custom extensions. Client side is done during
      * construction of extensions for the ClientHello.
@@ -450,14 +525,6 @@ int tls_collect_extensions(SSL *s, PACKET *packet, unsigned int context,
     if ((context & SSL_EXT_CLIENT_HELLO) != 0)
         custom_ext_init(&s->cert->custext);
 
-    num_exts = OSSL_NELEM(ext_defs) + (exts != NULL ? exts->meths_count : 0);
-    raw_extensions = OPENSSL_zalloc(num_exts * sizeof(*raw_extensions));
-    if (raw_extensions == NULL) {
-        *al = SSL_AD_INTERNAL_ERROR;
-        SSLerr(SSL_F_TLS_COLLECT_EXTENSIONS, ERR_R_MALLOC_FAILURE);
-        return 0;
-    }
-
     while (PACKET_remaining(&extensions) > 0) {
         unsigned int type;
         PACKET extension;
@@ -465,9 +532,9 @@ int tls_collect_extensions(SSL *s, PACKET *packet, unsigned int context,
 
         if (!PACKET_get_net_2(&extensions, &type) ||
             !PACKET_get_length_prefixed_2(&extensions, &extension)) {
-            SSLerr(SSL_F_TLS_COLLECT_EXTENSIONS, SSL_R_BAD_EXTENSION);
+            SSLerr(SSL_F_COLLECT_EXTENSIONS, SSL_R_BAD_EXTENSION);
             *al = SSL_AD_DECODE_ERROR;
-            goto err;
+            return 0;
         }
         /*
          * Verify this extension is allowed. We only check duplicates for
@@ -479,9 +546,9 @@ int tls_collect_extensions(SSL *s, PACKET *packet, unsigned int context,
                 || (type == TLSEXT_TYPE_psk
                     && (context & SSL_EXT_CLIENT_HELLO) != 0
                     && PACKET_remaining(&extensions) != 0)) {
-            SSLerr(SSL_F_TLS_COLLECT_EXTENSIONS, SSL_R_BAD_EXTENSION);
+            SSLerr(SSL_F_COLLECT_EXTENSIONS, SSL_R_BAD_EXTENSION);
             *al = SSL_AD_ILLEGAL_PARAMETER;
-            goto err;
+            return 0;
         }
         if (thisex != NULL) {
             thisex->data = extension;
@@ -499,18 +566,94 @@ int tls_collect_extensions(SSL *s, PACKET *packet, unsigned int context,
                 && extension_is_relevant(s, thisexd->context, context)
                 && !thisexd->init(s, context)) {
             *al = SSL_AD_INTERNAL_ERROR;
-            goto err;
+            return 0;
         }
     }
 
+    return 1;
+}
+
+/*
+ * Gather a list of all the extensions from the data in |packet]. |context|
+ * tells us which message this extension is for. The raw extension data is
+ * stored in |*res| on success. In the event of an error the alert type to use
+ * is stored in |*al|. We don't actually process the content of the extensions
+ * yet, except to check their types. This function also runs the initialiser
+ * functions for all known extensions (whether we have collected them or not).
+ * If successful the caller is responsible for freeing the contents of |*res|.
+ *
+ * Per http://tools.ietf.org/html/rfc5246#section-7.4.1.4, there may not be
+ * more than one extension of the same type in a ClientHello or ServerHello.
+ * This function returns 1 if all extensions are unique and we have parsed their
+ * types, and 0 if the extensions contain duplicates, could not be successfully
+ * found, or an internal error occurred. We only check duplicates for
+ * extensions that we know about. We ignore others.
+ */
+int tls_collect_extensions(SSL *s, PACKET *packet, unsigned int context,
+                           RAW_EXTENSION **res, int *al, size_t *len)
+{
+    size_t num_exts;
+    RAW_EXTENSION *raw_extensions = NULL;
+
+    *res = NULL;
+
+    num_exts = OSSL_NELEM(ext_defs) + s->cert->custext.meths_count;
+    raw_extensions = OPENSSL_zalloc(num_exts * sizeof(*raw_extensions));
+    if (raw_extensions == NULL) {
+        *al = SSL_AD_INTERNAL_ERROR;
+        SSLerr(SSL_F_TLS_COLLECT_EXTENSIONS, ERR_R_MALLOC_FAILURE);
+        return 0;
+    }
+
+    if (!collect_extensions(s, packet, context, raw_extensions, al)) {
+        OPENSSL_free(raw_extensions);
+        return 0;
+    }
+
     *res = raw_extensions;
     if (len != NULL)
         *len = num_exts;
     return 1;
+}
 
- err:
-    OPENSSL_free(raw_extensions);
-    return 0;
+/*
+ * As tls_collect_extensions() but for the ClientHello in |hello|. This is done
+ * for every incoming connection, so unless there are custom extensions
+ * configured the results are stored in |hello| itself rather than in a
+ * separate allocation. Use tls_free_client_hello_extensions() to release them.
+ */
+int tls_collect_client_hello_extensions(SSL *s, CLIENTHELLO_MSG *hello,
+                                        int *al)
+{
+    PACKET extensions = hello->extensions;
+    size_t num_exts;
+    RAW_EXTENSION *raw_extensions;
+
+    num_exts = OSSL_NELEM(ext_defs) + s->cert->custext.meths_count;
+    if (num_exts <= OSSL_NELEM(hello->builtin_exts)) {
+        raw_extensions = hello->builtin_exts;
+        memset(raw_extensions, 0, num_exts * sizeof(*raw_extensions));
+    } else {
+        raw_extensions = OPENSSL_zalloc(num_exts * sizeof(*raw_extensions));
+        if (raw_extensions == NULL) {
+            *al = SSL_AD_INTERNAL_ERROR;
+            SSLerr(SSL_F_TLS_COLLECT_CLIENT_HELLO_EXTENSIONS, ERR_R_MALLOC_FAILURE);
+            return 0;
+        }
+    }
+    hello->pre_proc_exts = raw_extensions;
+    hello->pre_proc_exts_len = num_exts;
+
+    return collect_extensions(s, &extensions, SSL_EXT_CLIENT_HELLO,
+                              raw_extensions, al);
+}
+
+void tls_free_client_hello_extensions(CLIENTHELLO_MSG *hello)
+{
+    if (hello->pre_proc_exts != hello->builtin_exts)
+        OPENSSL_free(hello->pre_proc_exts);
+    hello->pre_proc_exts = NULL;
+    hello->pre_proc_exts_len = 0;
 }
 
 /*
@@ -1318,7 +1461,9 @@ static int final_early_data(SSL *s, unsigned int context, int sent, int *al)
             || s->s3->alpn_selected_len != s->session->ext.alpn_selected_len
             || (s->s3->alpn_selected_len > 0
                 && memcmp(s->s3->alpn_selected, s->session->ext.alpn_selected,
-                          s->s3->alpn_selected_len) != 0)) {
+                          s->s3->alpn_selected_len) != 0)
+            /* Must be last: only record ClientHellos we would accept */
+            || !ssl_anti_replay_ok(s)) {
         s->ext.early_data = SSL_EARLY_DATA_REJECTED;
     } else {
         s->ext.early_data = SSL_EARLY_DATA_ACCEPTED;
@@ -108,6 +108,30 @@ static int use_ecc(SSL *s)
     return 0;
 }
 
+# ifndef OPENSSL_NO_DH
+/* See if we offer any DHE cipher suites for TLS 1.2 or below */
+static int use_ffdhe(SSL *s)
+{
+    int i, end;
+    STACK_OF(SSL_CIPHER) *cipher_stack = NULL;
+
+    if (s->version == SSL3_VERSION)
+        return 0;
+
+    cipher_stack = SSL_get_ciphers(s);
+    end = sk_SSL_CIPHER_num(cipher_stack);
+    for (i = 0; i < end; i++) {
+        const SSL_CIPHER *c = sk_SSL_CIPHER_value(cipher_stack, i);
+
+        if ((c->algorithm_mkey & (SSL_kDHE | SSL_kDHEPSK))
+                && c->min_tls < TLS1_3_VERSION)
+            return 1;
+    }
+
+    return 0;
+}
+# endif
+
 int tls_construct_ctos_ec_pt_formats(SSL *s, WPACKET *pkt, unsigned int context,
                                      X509 *x, size_t chainidx, int *al)
 {
@@ -138,15 +162,21 @@ int tls_construct_ctos_supported_groups(SSL *s, WPACKET *pkt,
 {
     const unsigned char *pcurves = NULL, *pcurvestmp;
     size_t num_curves = 0, i;
+    int ecc = use_ecc(s), ffdhe = 0;
 
-    if (!use_ecc(s))
+# ifndef OPENSSL_NO_DH
+    ffdhe = use_ffdhe(s);
+# endif
+    if (!ecc && !ffdhe)
         return 1;
 
     /*
-     * Add TLS extension supported_groups to the ClientHello message
+     * Add TLS extension supported_groups to the ClientHello message: our
+     * curves if we offer ECC, followed by the RFC 7919 groups if we offer
+     * DHE cipher suites.
      */
-    /* TODO(TLS1.3): Add support for DHE groups */
-    if (!tls1_get_curvelist(s, 0, &pcurves, &num_curves)) {
+    /* TODO(TLS1.3): Add support for DHE key shares */
+    if (ecc && !tls1_get_curvelist(s, 0, &pcurves, &num_curves)) {
         SSLerr(SSL_F_TLS_CONSTRUCT_CTOS_SUPPORTED_GROUPS,
                ERR_R_INTERNAL_ERROR);
         return 0;
@@ -172,6 +202,13 @@ int tls_construct_ctos_supported_groups(SSL *s, WPACKET *pkt,
                 }
         }
     }
+# ifndef OPENSSL_NO_DH
+    if (ffdhe && !tls1_copy_ffdhe_groups(s, pkt)) {
+        SSLerr(SSL_F_TLS_CONSTRUCT_CTOS_SUPPORTED_GROUPS,
+               ERR_R_INTERNAL_ERROR);
+        return 0;
+    }
+# endif
     if (!WPACKET_close(pkt) || !WPACKET_close(pkt)) {
         SSLerr(SSL_F_TLS_CONSTRUCT_CTOS_SUPPORTED_GROUPS,
                ERR_R_INTERNAL_ERROR);
@@ -370,7 +370,9 @@ int dtls_get_message(SSL *s, int *mt, size_t *len)
         msg_len += DTLS1_HM_HEADER_LENGTH;
     }
 
-    if (!ssl3_finish_mac(s, p, msg_len))
+    /* HelloRequest is not part of the transcript */
+    if (msg_hdr->type != SSL3_MT_HELLO_REQUEST
+            && !ssl3_finish_mac(s, p, msg_len))
         return 0;
     if (s->msg_callback)
         s->msg_callback(0, s->version, SSL3_RT_HANDSHAKE,
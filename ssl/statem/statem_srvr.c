@@ -1252,7 +1252,7 @@ MSG_PROCESS_RETURN tls_process_client_hello(SSL *s, PACKET *pkt)
 {
     int al = SSL_AD_INTERNAL_ERROR;
     /* |cookie| will only be initialized for DTLS. */
-    PACKET session_id, compression, extensions, cookie;
+    PACKET session_id, compression, cookie;
     static const unsigned char null_compression = 0;
     CLIENTHELLO_MSG *clienthello;
 
@@ -1440,11 +1440,7 @@ MSG_PROCESS_RETURN tls_process_client_hello(SSL *s, PACKET *pkt)
         goto f_err;
     }
 
-    /* Preserve the raw extensions PACKET for later use */
-    extensions = clienthello->extensions;
-    if (!tls_collect_extensions(s, &extensions, SSL_EXT_CLIENT_HELLO,
-                                &clienthello->pre_proc_exts, &al,
-                                &clienthello->pre_proc_exts_len)) {
+    if (!tls_collect_client_hello_extensions(s, clienthello, &al)) {
         /* SSLerr already been called */
         goto f_err;
     }
@@ -1456,7 +1452,7 @@ MSG_PROCESS_RETURN tls_process_client_hello(SSL *s, PACKET *pkt)
  err:
     ossl_statem_set_error(s);
 
-    OPENSSL_free(clienthello->pre_proc_exts);
+    tls_free_client_hello_extensions(clienthello);
     OPENSSL_free(clienthello);
 
     return MSG_PROCESS_ERROR;
@@ -1875,7 +1871,7 @@ static int tls_early_post_process_client_hello(SSL *s, int *al)
 
     sk_SSL_CIPHER_free(ciphers);
     sk_SSL_CIPHER_free(scsvs);
-    OPENSSL_free(clienthello->pre_proc_exts);
+    tls_free_client_hello_extensions(clienthello);
     OPENSSL_free(s->clienthello);
     s->clienthello = NULL;
     return 1;
@@ -1884,7 +1880,7 @@ static int tls_early_post_process_client_hello(SSL *s, int *al)
 
     sk_SSL_CIPHER_free(ciphers);
     sk_SSL_CIPHER_free(scsvs);
-    OPENSSL_free(clienthello->pre_proc_exts);
+    tls_free_client_hello_extensions(clienthello);
     OPENSSL_free(s->clienthello);
     s->clienthello = NULL;
 
@@ -2199,8 +2195,24 @@ int tls_construct_server_key_exchange(SSL *s, WPACKET *pkt)
 
         EVP_PKEY *pkdhp = NULL;
         DH *dh;
-
-        if (s->cert->dh_tmp_auto) {
+        int nid = NID_undef;
+
+# ifndef OPENSSL_NO_EC
+        /* Use the RFC 7919 group negotiated with the client, if any */
+        nid = tls1_shared_ffdhe_group(s, 1);
+# endif
+        if (nid > 0) {
+            DH *dhp = DH_new_by_nid(nid);
+            pkdh = EVP_PKEY_new();
+            if (pkdh == NULL || dhp == NULL) {
+                DH_free(dhp);
+                SSLerr(SSL_F_TLS_CONSTRUCT_SERVER_KEY_EXCHANGE,
+                       ERR_R_INTERNAL_ERROR);
+                goto f_err;
+            }
+            EVP_PKEY_assign_DH(pkdh, dhp);
+            pkdhp = pkdh;
+        } else if (s->cert->dh_tmp_auto) {
             DH *dhp = ssl_get_auto_dh(s);
             pkdh = EVP_PKEY_new();
             if (pkdh == NULL || dhp == NULL) {
@@ -2421,11 +2433,12 @@ int tls_construct_server_key_exchange(SSL *s, WPACKET *pkt)
     /* not anonymous */
     if (lu != NULL) {
         EVP_PKEY *pkey = s->s3->tmp.cert->privatekey;
-        const EVP_MD *md = ssl_md(lu->hash_idx);
-        unsigned char *sigbytes1, *sigbytes2;
-        size_t siglen;
+        const EVP_MD *md;
+        unsigned char *sigbytes1, *sigbytes2, *tbs;
+        size_t siglen, tbslen;
+        int rv;
 
-        if (pkey == NULL || md == NULL) {
+        if (pkey == NULL || !tls1_lookup_md(lu, &md)) {
             /* Should never happen */
             al = SSL_AD_INTERNAL_ERROR;
             SSLerr(SSL_F_TLS_CONSTRUCT_SERVER_KEY_EXCHANGE,
@@ -2467,15 +2480,17 @@ int tls_construct_server_key_exchange(SSL *s, WPACKET *pkt)
                 goto f_err;
             }
         }
-        if (EVP_DigestSignUpdate(md_ctx, &(s->s3->client_random[0]),
-                                 SSL3_RANDOM_SIZE) <= 0
-            || EVP_DigestSignUpdate(md_ctx, &(s->s3->server_random[0]),
-                                        SSL3_RANDOM_SIZE) <= 0
-            || EVP_DigestSignUpdate(md_ctx,
-                                        s->init_buf->data + paramoffset,
-                                        paramlen) <= 0
-            || EVP_DigestSignFinal(md_ctx, sigbytes1, &siglen) <= 0
-            || !WPACKET_sub_allocate_bytes_u16(pkt, siglen, &sigbytes2)
+        tbslen = construct_key_exchange_tbs(s, &tbs,
+                                            s->init_buf->data + paramoffset,
+                                            paramlen);
+        if (tbslen == 0) {
+            SSLerr(SSL_F_TLS_CONSTRUCT_SERVER_KEY_EXCHANGE,
+                   ERR_R_MALLOC_FAILURE);
+            goto f_err;
+        }
+        rv = EVP_DigestSign(md_ctx, sigbytes1, &siglen, tbs, tbslen);
+        OPENSSL_free(tbs);
+        if (rv <= 0 || !WPACKET_sub_allocate_bytes_u16(pkt, siglen, &sigbytes2)
             || sigbytes1 != sigbytes2) {
             SSLerr(SSL_F_TLS_CONSTRUCT_SERVER_KEY_EXCHANGE,
                    ERR_R_INTERNAL_ERROR);
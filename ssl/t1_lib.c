@@ -164,6 +164,7 @@ static const tls_curve_info nid_list[] = {
     {NID_brainpoolP384r1, 192, TLS_CURVE_PRIME}, /* brainpoolP384r1 (27) */
     {NID_brainpoolP512r1, 256, TLS_CURVE_PRIME}, /* brainpool512r1 (28) */
     {NID_X25519, 128, TLS_CURVE_CUSTOM}, /* X25519 (29) */
+    {NID_X448, 224, TLS_CURVE_CUSTOM}, /* X448 (30) */
 };
 
 static const unsigned char ecformats_default[] = {
@@ -176,6 +177,7 @@ static const unsigned char ecformats_default[] = {
 static const unsigned char eccurves_default[] = {
     0, 29,                      /* X25519 (29) */
     0, 23,                      /* secp256r1 (23) */
+    0, 30,                      /* X448 (30) */
     0, 25,                      /* secp521r1 (25) */
     0, 24,                      /* secp384r1 (24) */
 };
@@ -669,6 +671,7 @@ static const uint16_t tls12_sigalgs[] = {
     TLSEXT_SIGALG_ecdsa_secp256r1_sha256,
     TLSEXT_SIGALG_ecdsa_secp384r1_sha384,
     TLSEXT_SIGALG_ecdsa_secp521r1_sha512,
+    TLSEXT_SIGALG_ed25519,
 #endif
 
     TLSEXT_SIGALG_rsa_pss_sha256,
@@ -710,6 +713,9 @@ static const SIGALG_LOOKUP sigalg_lookup_tbl[] = {
     {"ecdsa_secp521r1_sha512", TLSEXT_SIGALG_ecdsa_secp521r1_sha512,
      NID_sha512, SSL_MD_SHA512_IDX, EVP_PKEY_EC, SSL_PKEY_ECC,
      NID_ecdsa_with_SHA512, NID_secp521r1},
+    {"ed25519", TLSEXT_SIGALG_ed25519,
+     NID_undef, -1, EVP_PKEY_ED25519, SSL_PKEY_ED25519,
+     NID_undef, NID_undef},
     {NULL, TLSEXT_SIGALG_ecdsa_sha1,
      NID_sha1, SSL_MD_SHA1_IDX, EVP_PKEY_EC, SSL_PKEY_ECC,
      NID_ecdsa_with_SHA1, NID_undef},
@@ -782,7 +788,8 @@ static const uint16_t tls_default_sigalg[] = {
     TLSEXT_SIGALG_ecdsa_sha1, /* SSL_PKEY_ECC */
     TLSEXT_SIGALG_gostr34102001_gostr3411, /* SSL_PKEY_GOST01 */
     TLSEXT_SIGALG_gostr34102012_256_gostr34112012_256, /* SSL_PKEY_GOST12_256 */
-    TLSEXT_SIGALG_gostr34102012_512_gostr34112012_512 /* SSL_PKEY_GOST12_512 */
+    TLSEXT_SIGALG_gostr34102012_512_gostr34112012_512, /* SSL_PKEY_GOST12_512 */
+    0 /* SSL_PKEY_ED25519 */
 };
 
 /* Lookup TLS signature algorithm */
@@ -798,6 +805,30 @@ static const SIGALG_LOOKUP *tls1_lookup_sigalg(uint16_t sigalg)
     }
     return NULL;
 }
+
+/*
+ * Lookup the digest used by signature algorithm |lu|. Returns 0 if |lu| is
+ * NULL or its digest is not available. Otherwise returns 1 and sets |*pmd|,
+ * if |pmd| is not NULL, to the digest or to NULL if the algorithm signs the
+ * data directly without hashing it first.
+ */
+int tls1_lookup_md(const SIGALG_LOOKUP *lu, const EVP_MD **pmd)
+{
+    const EVP_MD *md;
+
+    if (lu == NULL)
+        return 0;
+    if (lu->hash == NID_undef) {
+        md = NULL;
+    } else {
+        md = ssl_md(lu->hash_idx);
+        if (md == NULL)
+            return 0;
+    }
+    if (pmd != NULL)
+        *pmd = md;
+    return 1;
+}
 /*
  * Return a signature algorithm for TLS < 1.2 where the signature type
  * is fixed by the certificate type.
@@ -809,9 +840,8 @@ static const SIGALG_LOOKUP *tls1_get_legacy_sigalg(const SSL *s, int idx)
     if (SSL_USE_SIGALGS(s) || idx != SSL_PKEY_RSA) {
         const SIGALG_LOOKUP *lu = tls1_lookup_sigalg(tls_default_sigalg[idx]);
 
-        if (lu == NULL || ssl_md(lu->hash_idx) == NULL) {
+        if (!tls1_lookup_md(lu, NULL))
             return NULL;
-        }
         return lu;
     }
     return &legacy_rsa_sigalg;
@@ -968,8 +998,7 @@ int tls12_check_peer_sigalg(SSL *s, uint16_t sig, EVP_PKEY *pkey)
         SSLerr(SSL_F_TLS12_CHECK_PEER_SIGALG, SSL_R_WRONG_SIGNATURE_TYPE);
         return 0;
     }
-    md = ssl_md(lu->hash_idx);
-    if (md == NULL) {
+    if (!tls1_lookup_md(lu, &md)) {
         SSLerr(SSL_F_TLS12_CHECK_PEER_SIGALG, SSL_R_UNKNOWN_DIGEST);
         return 0;
     }
@@ -980,7 +1009,7 @@ int tls12_check_peer_sigalg(SSL *s, uint16_t sig, EVP_PKEY *pkey)
     sigalgstr[0] = (sig >> 8) & 0xff;
     sigalgstr[1] = sig & 0xff;
     if (!ssl_security(s, SSL_SECOP_SIGALG_CHECK,
-                      EVP_MD_size(md) * 4, EVP_MD_type(md),
+                      md != NULL ? EVP_MD_size(md) * 4 : 128, lu->hash,
                       (void *)sigalgstr)) {
         SSLerr(SSL_F_TLS12_CHECK_PEER_SIGALG, SSL_R_WRONG_SIGNATURE_TYPE);
         return 0;
@@ -1365,6 +1394,9 @@ static int tls12_get_pkey_idx(int sig_nid)
 #ifndef OPENSSL_NO_EC
     case EVP_PKEY_EC:
         return SSL_PKEY_ECC;
+
+    case EVP_PKEY_ED25519:
+        return SSL_PKEY_ED25519;
 #endif
 #ifndef OPENSSL_NO_GOST
     case NID_id_GostR3410_2001:
@@ -1386,8 +1418,10 @@ static int tls12_sigalg_allowed(SSL *s, int op, const SIGALG_LOOKUP *lu)
     unsigned char sigalgstr[2];
     int secbits;
 
+    const EVP_MD *md;
+
     /* See if sigalgs is recognised and if hash is enabled */
-    if (lu == NULL || ssl_md(lu->hash_idx) == NULL)
+    if (!tls1_lookup_md(lu, &md))
         return 0;
     /* DSA is not allowed in TLS 1.3 */
     if (SSL_IS_TLS13(s) && lu->sig == EVP_PKEY_DSA)
@@ -1395,8 +1429,11 @@ static int tls12_sigalg_allowed(SSL *s, int op, const SIGALG_LOOKUP *lu)
     /* See if public key algorithm allowed */
     if (tls12_get_pkey_idx(lu->sig) == -1)
         return 0;
-    /* Security bits: half digest bits */
-    secbits = EVP_MD_size(ssl_md(lu->hash_idx)) * 4;
+    /*
+     * Security bits: half digest bits, or those of the curve for algorithms
+     * with no separate digest
+     */
+    secbits = md != NULL ? EVP_MD_size(md) * 4 : 128;
     /* Finally see if security callback allows it */
     sigalgstr[0] = (lu->sigalg >> 8) & 0xff;
     sigalgstr[1] = lu->sigalg & 0xff;
@@ -1441,6 +1478,8 @@ void ssl_set_sig_mask(uint32_t *pmask_a, SSL *s, int op)
             break;
 #endif
 #ifndef OPENSSL_NO_EC
+        /* Ed25519 can be used with ECDSA ciphersuites in TLS 1.2 */
+        case EVP_PKEY_ED25519:
         case EVP_PKEY_EC:
             if (!have_ecdsa && tls12_sigalg_allowed(s, op, lu))
                 have_ecdsa = 1;
@@ -1734,7 +1773,8 @@ static int sig_cb(const char *elem, int len, void *arg)
         get_sigorhash(&sig_alg, &hash_alg, p);
     }
 
-    if (sig_alg == NID_undef || hash_alg == NID_undef)
+    /* Algorithms such as Ed25519 named without a '+' have no hash */
+    if (sig_alg == NID_undef || (p != NULL && hash_alg == NID_undef))
         return 0;
 
     for (i = 0; i < sarg->sigalgcnt; i += 2) {
@@ -2108,21 +2148,24 @@ int SSL_check_chain(SSL *s, X509 *x, EVP_PKEY *pk, STACK_OF(X509) *chain)
 }
 
 #ifndef OPENSSL_NO_DH
+/* Security level wanted for the DH parameters of the current cipher */
+static int ssl_dh_security_bits(SSL *s)
+{
+    if (s->s3->tmp.new_cipher->algorithm_auth & (SSL_aNULL | SSL_aPSK))
+        return s->s3->tmp.new_cipher->strength_bits == 256 ? 128 : 80;
+    if (s->s3->tmp.cert == NULL)
+        return -1;
+    return EVP_PKEY_security_bits(s->s3->tmp.cert->privatekey);
+}
+
 DH *ssl_get_auto_dh(SSL *s)
 {
-    int dh_secbits = 80;
+    int dh_secbits;
+
     if (s->cert->dh_tmp_auto == 2)
         return DH_get_1024_160();
-    if (s->s3->tmp.new_cipher->algorithm_auth & (SSL_aNULL | SSL_aPSK)) {
-        if (s->s3->tmp.new_cipher->strength_bits == 256)
-            dh_secbits = 128;
-        else
-            dh_secbits = 80;
-    } else {
-        if (s->s3->tmp.cert == NULL)
-            return NULL;
-        dh_secbits = EVP_PKEY_security_bits(s->s3->tmp.cert->privatekey);
-    }
+    if ((dh_secbits = ssl_dh_security_bits(s)) < 0)
+        return NULL;
 
     if (dh_secbits >= 128) {
         DH *dhp = DH_new();
@@ -2148,6 +2191,83 @@ DH *ssl_get_auto_dh(SSL *s)
         return DH_get_2048_224();
     return DH_get_1024_160();
 }
+
+# ifndef OPENSSL_NO_EC
+typedef struct {
+    int nid;                    /* Group NID */
+    int secbits;                /* Bits of security (from SP800-57) */
+    unsigned int id;            /* TLS group id */
+} tls_ffdhe_info;
+
+/* The RFC 7919 groups, smallest first */
+static const tls_ffdhe_info ffdhe_list[] = {
+    {NID_ffdhe2048, 112, 0x0100}, /* ffdhe2048 (256) */
+    {NID_ffdhe3072, 128, 0x0101}, /* ffdhe3072 (257) */
+    {NID_ffdhe4096, 128, 0x0102}, /* ffdhe4096 (258) */
+    {NID_ffdhe6144, 128, 0x0103}, /* ffdhe6144 (259) */
+    {NID_ffdhe8192, 192, 0x0104}, /* ffdhe8192 (260) */
+};
+
+static int tls_ffdhe_allowed(SSL *s, const tls_ffdhe_info *finfo, int op)
+{
+    unsigned char group[2];
+
+    group[0] = (unsigned char)(finfo->id >> 8);
+    group[1] = (unsigned char)finfo->id;
+    return ssl_security(s, op, finfo->secbits, finfo->nid, group);
+}
+
+/* Appends the ids of the RFC 7919 groups we are willing to use to |pkt| */
+int tls1_copy_ffdhe_groups(SSL *s, WPACKET *pkt)
+{
+    size_t i;
+
+    for (i = 0; i < OSSL_NELEM(ffdhe_list); i++) {
+        if (tls_ffdhe_allowed(s, &ffdhe_list[i], SSL_SECOP_CURVE_SUPPORTED)
+                && !WPACKET_put_bytes_u16(pkt, ffdhe_list[i].id))
+            return 0;
+    }
+    return 1;
+}
+
+/*-
+ * Picks the RFC 7919 group to use with the client. Returns:
+ *  NID_undef if the client did not offer any, so that arbitrary
+ *            parameters may be used
+ *  -1        if none of the offered groups is acceptable, in which case
+ *            no DHE cipher suite may be used
+ *  the NID of the group otherwise.
+ * With |match_strength| set the group is the smallest offered one that
+ * matches the security level of the current cipher, or failing that the
+ * largest offered one; otherwise it is only checked that there is one.
+ */
+int tls1_shared_ffdhe_group(SSL *s, int match_strength)
+{
+    const unsigned char *groups;
+    size_t ngroups = s->session->ext.supportedgroups_len / 2, i, j;
+    int secbits = 0, offered = 0, ret = -1;
+
+    if (match_strength && (secbits = ssl_dh_security_bits(s)) < 0)
+        secbits = 80;
+
+    for (i = 0; i < OSSL_NELEM(ffdhe_list); i++) {
+        groups = s->session->ext.supportedgroups;
+        for (j = 0; j < ngroups; j++, groups += 2) {
+            if (bytestogroup(groups) == ffdhe_list[i].id)
+                break;
+        }
+        if (j == ngroups)
+            continue;
+        offered = 1;
+        if (!tls_ffdhe_allowed(s, &ffdhe_list[i], SSL_SECOP_CURVE_SHARED))
+            continue;
+        ret = ffdhe_list[i].nid;
+        if (ffdhe_list[i].secbits >= secbits)
+            break;
+    }
+    return offered ? ret : NID_undef;
+}
+# endif
 #endif
 
 static int ssl_security_cert_key(SSL *s, SSL_CTX *ctx, X509 *x, int op)
@@ -2265,7 +2385,7 @@ int tls_choose_sigalg(SSL *s, int *al)
             if (lu->hash == NID_sha1 || lu->sig == EVP_PKEY_DSA
                 || lu->sig == EVP_PKEY_RSA)
                 continue;
-            if (ssl_md(lu->hash_idx) == NULL)
+            if (!tls1_lookup_md(lu, NULL))
                 continue;
             idx = lu->sig_idx;
             if (!ssl_has_cert(s, idx))
@@ -2318,7 +2438,9 @@ int tls_choose_sigalg(SSL *s, int *al)
                     SSLerr(SSL_F_TLS_CHOOSE_SIGALG, ERR_R_INTERNAL_ERROR);
                     return 0;
                 }
-            } else if (!ssl_has_cert(s, idx)) {
+            } else if (!ssl_has_cert(s, idx)
+                       && (idx != SSL_PKEY_ECC
+                           || !ssl_has_cert(s, SSL_PKEY_ED25519))) {
                 if (al == NULL)
                     return 1;
                 *al = SSL_AD_INTERNAL_ERROR;
@@ -2339,7 +2461,7 @@ int tls_choose_sigalg(SSL *s, int *al)
                 int curve;
 
                 /* For Suite B need to match signature algorithm to curve */
-                if (tls1_suiteb(s)) {
+                if (tls1_suiteb(s) && ssl_has_cert(s, idx)) {
                     EC_KEY *ec = EVP_PKEY_get0_EC_KEY(s->cert->pkeys[idx].privatekey);
                     curve = EC_GROUP_get_curve_name(EC_KEY_get0_group(ec));
                 } else {
@@ -2357,9 +2479,19 @@ int tls_choose_sigalg(SSL *s, int *al)
                     if (lu->sig_idx == idx)
                         break;
 #else
-                    if (lu->sig_idx == idx
+                    if (lu->sig_idx == idx && ssl_has_cert(s, idx)
                         && (curve == -1 || lu->curve == curve))
                         break;
+                    /*
+                     * An Ed25519 certificate can be used with ECDSA
+                     * ciphersuites if the peer offered it
+                     */
+                    if (idx == SSL_PKEY_ECC
+                        && lu->sig_idx == SSL_PKEY_ED25519
+                        && ssl_has_cert(s, SSL_PKEY_ED25519)) {
+                        idx = SSL_PKEY_ED25519;
+                        break;
+                    }
 #endif
                     if (idx == SSL_PKEY_RSA && lu->sig == EVP_PKEY_RSA_PSS)
                         break;
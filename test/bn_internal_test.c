@@ -0,0 +1,123 @@
+/*
+ * Copyright 2017 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the OpenSSL license (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+/*
+ * Internal tests for the fixed-width exponentiation in crypto/bn/bn_fixed.c.
+ * BN_mod_exp_mont_consttime() only dispatches to it where the MONT5
+ * assembly is not available, so it is called directly here and the results
+ * are checked against BN_mod_exp_simple().
+ */
+
+#include <openssl/bn.h>
+#include "test_main.h"
+#include "testutil.h"
+#include "e_os.h"
+#include "../crypto/bn/bn_lcl.h"
+
+static const int fixed_bits[] = { 1024, 1536, 2048 };
+
+static int test_mod_exp_fixed(int idx)
+{
+    int bits = fixed_bits[idx];
+    BIGNUM *a = BN_new(), *p = BN_new(), *m = BN_new();
+    BIGNUM *d = BN_new(), *e = BN_new();
+    BN_MONT_CTX *mont = BN_MONT_CTX_new();
+    BN_CTX *ctx = BN_CTX_new();
+    int i, st = 0;
+
+    if (!TEST_ptr(a) || !TEST_ptr(p) || !TEST_ptr(m) || !TEST_ptr(d)
+            || !TEST_ptr(e) || !TEST_ptr(mont) || !TEST_ptr(ctx)
+            || !TEST_true(BN_bntest_rand(m, bits, 0, 1))
+            || !TEST_true(BN_MONT_CTX_set(mont, m, ctx)))
+        goto err;
+
+    for (i = 0; i < 8; i++) {
+        switch (i) {
+        case 0:
+            /* base and exponent of full width */
+            if (!TEST_true(BN_sub(a, m, BN_value_one()))
+                    || !TEST_ptr(BN_copy(p, a)))
+                goto err;
+            break;
+        case 1:
+            /* short exponent */
+            if (!TEST_true(BN_rand_range(a, m))
+                    || !TEST_true(BN_set_word(p, 65537)))
+                goto err;
+            break;
+        case 2:
+            BN_zero(a);
+            if (!TEST_true(BN_rand_range(p, m)))
+                goto err;
+            break;
+        case 3:
+            BN_zero(p);
+            if (!TEST_true(BN_rand_range(a, m)))
+                goto err;
+            break;
+        default:
+            if (!TEST_true(BN_rand_range(a, m))
+                    || !TEST_true(BN_rand_range(p, m)))
+                goto err;
+            break;
+        }
+        if (!TEST_int_eq(bn_mod_exp_mont_fixed(d, a, p, mont), 1)
+                || !TEST_true(BN_mod_exp_simple(e, a, p, m, ctx))
+                || !TEST_int_eq(BN_cmp(d, e), 0)) {
+            TEST_info("%d bits, case %d", bits, i);
+            goto err;
+        }
+    }
+
+    /* Operands the fixed code does not handle are left to the caller */
+    if (!TEST_int_eq(bn_mod_exp_mont_fixed(d, m, p, mont), -1)
+            || !TEST_true(BN_lshift1(p, m))
+            || !TEST_int_eq(bn_mod_exp_mont_fixed(d, a, p, mont), -1))
+        goto err;
+
+    st = 1;
+err:
+    BN_CTX_free(ctx);
+    BN_MONT_CTX_free(mont);
+    BN_free(a);
+    BN_free(p);
+    BN_free(m);
+    BN_free(d);
+    BN_free(e);
+    return st;
+}
+
+static int test_mod_exp_fixed_unsupported(void)
+{
+    BIGNUM *a = BN_new(), *m = BN_new(), *d = BN_new();
+    BN_MONT_CTX *mont = BN_MONT_CTX_new();
+    BN_CTX *ctx = BN_CTX_new();
+    int st = 0;
+
+    if (TEST_ptr(a) && TEST_ptr(m) && TEST_ptr(d) && TEST_ptr(mont)
+            && TEST_ptr(ctx)
+            && TEST_true(BN_bntest_rand(m, 1280, 0, 1))
+            && TEST_true(BN_MONT_CTX_set(mont, m, ctx))
+            && TEST_true(BN_rand_range(a, m))
+            && TEST_int_eq(bn_mod_exp_mont_fixed(d, a, a, mont), -1))
+        st = 1;
+
+    BN_CTX_free(ctx);
+    BN_MONT_CTX_free(mont);
+    BN_free(a);
+    BN_free(m);
+    BN_free(d);
+    return st;
+}
+
+void register_tests(void)
+{
+    ADD_ALL_TESTS(test_mod_exp_fixed, OSSL_NELEM(fixed_bits));
+    ADD_TEST(test_mod_exp_fixed_unsupported);
+}
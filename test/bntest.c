@@ -475,6 +475,136 @@ static int test_modexp_mont5()
     return 1;
 }
 
+/*
+ * Test constant-time modular exponentiation with the moduli sizes that have
+ * a fixed-width implementation, including short and extreme inputs.
+ */
+static int test_modexp_fixed()
+{
+    static const int kBits[] = { 1024, 1536, 2048 };
+    BIGNUM *a = BN_new(), *p = BN_new(), *m = BN_new();
+    BIGNUM *d = BN_new(), *e = BN_new();
+    BN_MONT_CTX *mont = BN_MONT_CTX_new();
+    int i, j, st = 0;
+
+    if (a == NULL || p == NULL || m == NULL || d == NULL || e == NULL
+            || mont == NULL)
+        goto err;
+
+    for (i = 0; i < (int)OSSL_NELEM(kBits); i++) {
+        if (!BN_bntest_rand(m, kBits[i], 0, 1)
+                || !BN_MONT_CTX_set(mont, m, ctx))
+            goto err;
+
+        for (j = 0; j < 4; j++) {
+            switch (j) {
+            case 0:
+                /* base and exponent of full width */
+                if (!BN_sub(a, m, BN_value_one()) || BN_copy(p, a) == NULL)
+                    goto err;
+                break;
+            case 1:
+                /* short exponent */
+                if (!BN_rand_range(a, m) || !BN_set_word(p, 65537))
+                    goto err;
+                break;
+            case 2:
+                BN_zero(a);
+                if (!BN_rand_range(p, m))
+                    goto err;
+                break;
+            default:
+                if (!BN_rand_range(a, m) || !BN_rand_range(p, m))
+                    goto err;
+                break;
+            }
+            if (!BN_mod_exp_mont_consttime(d, a, p, m, ctx, mont)
+                    || !BN_mod_exp_simple(e, a, p, m, ctx))
+                goto err;
+            if (BN_cmp(d, e) != 0) {
+                fprintf(stderr, "Modular exponentiation test failed"
+                        " (%d bits, case %d)!\n", kBits[i], j);
+                goto err;
+            }
+        }
+    }
+
+    st = 1;
+err:
+    BN_MONT_CTX_free(mont);
+    BN_free(a);
+    BN_free(p);
+    BN_free(m);
+    BN_free(d);
+    BN_free(e);
+    return st;
+}
+
+/*
+ * A released BN_CTX is handed out again by the next BN_CTX_new() on the
+ * same thread, with its temporaries cleared.
+ */
+static int test_ctx_cache()
+{
+    size_t size = BN_CTX_get_cache_size();
+    uint64_t hits, misses, hits2, misses2;
+    BN_CTX *c1, *c2 = NULL;
+    BIGNUM *t;
+    int i, st = 0;
+
+    if (!BN_CTX_set_cache_size(2) || BN_CTX_get_cache_size() != 2)
+        goto err;
+
+    /* Leave some values behind */
+    if ((c1 = BN_CTX_new()) == NULL)
+        goto err;
+    BN_CTX_start(c1);
+    for (i = 0; i < 20; i++) {
+        if ((t = BN_CTX_get(c1)) == NULL || !BN_set_word(t, i + 1)) {
+            BN_CTX_end(c1);
+            BN_CTX_free(c1);
+            goto err;
+        }
+    }
+    BN_CTX_end(c1);
+    BN_CTX_get_cache_stats(&hits, &misses);
+    BN_CTX_free(c1);
+
+    c2 = BN_CTX_new();
+    BN_CTX_get_cache_stats(&hits2, &misses2);
+    if (c2 != c1 || hits2 != hits + 1 || misses2 != misses) {
+        fprintf(stderr, "BN_CTX not taken from the cache\n");
+        goto err;
+    }
+    BN_CTX_start(c2);
+    for (i = 0; i < 20; i++) {
+        if ((t = BN_CTX_get(c2)) == NULL || !BN_is_zero(t)) {
+            fprintf(stderr, "Cached BN_CTX not cleared\n");
+            BN_CTX_end(c2);
+            goto err;
+        }
+    }
+    BN_CTX_end(c2);
+
+    /* With the cache disabled every context is new */
+    if (!BN_CTX_set_cache_size(0))
+        goto err;
+    BN_CTX_free(c2);
+    if ((c2 = BN_CTX_new()) == NULL)
+        goto err;
+    BN_CTX_get_cache_stats(&hits, &misses);
+    if (hits != hits2 || misses != misses2) {
+        fprintf(stderr, "BN_CTX cache used while disabled\n");
+        goto err;
+    }
+
+    st = 1;
+err:
+    BN_CTX_free(c2);
+    BN_CTX_set_cache_size(size);
+    return st;
+}
+
 #ifndef OPENSSL_NO_EC2M
 static int test_gf2m_add()
 {
@@ -2084,6 +2214,54 @@ err:
     return st;
 }
 
+static int test_prime_search()
+{
+    static const int kThreads[] = { 1, 4 };
+    BIGNUM *r = BN_new(), *q = BN_new(), *add = BN_new(), *rem = BN_new();
+    BN_CTX *ctx = BN_CTX_new();
+    int i, st = 0;
+
+    if (r == NULL || q == NULL || add == NULL || rem == NULL || ctx == NULL
+            || !BN_set_word(add, 24) || !BN_set_word(rem, 11))
+        goto err;
+
+    for (i = 0; i < (int)OSSL_NELEM(kThreads); i++) {
+        if (!BN_set_prime_search_threads(kThreads[i]))
+            goto err;
+
+        if (!BN_generate_prime_ex(r, 1024, 0, NULL, NULL, NULL)
+                || BN_num_bits(r) != 1024
+                || BN_is_prime_fasttest_ex(r, BN_prime_checks, ctx, 1,
+                                           NULL) != 1) {
+            fprintf(stderr, "Prime search failed (%d threads)\n",
+                    kThreads[i]);
+            goto err;
+        }
+
+        /* safe prime with p == 11 mod 24, as for DH generator 2 */
+        if (!BN_generate_prime_ex(r, 256, 1, add, rem, NULL)
+                || BN_num_bits(r) != 256
+                || BN_mod_word(r, 24) != 11
+                || !BN_rshift1(q, r)
+                || BN_is_prime_ex(r, BN_prime_checks, ctx, NULL) != 1
+                || BN_is_prime_ex(q, BN_prime_checks, ctx, NULL) != 1) {
+            fprintf(stderr, "Safe prime search failed (%d threads)\n",
+                    kThreads[i]);
+            goto err;
+        }
+    }
+
+    st = 1;
+err:
+    BN_set_prime_search_threads(1);
+    BN_free(r);
+    BN_free(q);
+    BN_free(add);
+    BN_free(rem);
+    BN_CTX_free(ctx);
+    return st;
+}
+
 
 /* Delete leading and trailing spaces from a string */
 static char *strip_spaces(char *p)
@@ -2228,6 +2406,8 @@ int test_main(int argc, char *argv[])
     ADD_TEST(test_div_recip);
     ADD_TEST(test_mod);
     ADD_TEST(test_modexp_mont5);
+    ADD_TEST(test_modexp_fixed);
+    ADD_TEST(test_ctx_cache);
     ADD_TEST(test_kronecker);
     ADD_TEST(test_rand);
     ADD_TEST(test_bn2padded);
@@ -2239,6 +2419,7 @@ int test_main(int argc, char *argv[])
     ADD_TEST(test_badmod);
     ADD_TEST(test_expmodzero);
     ADD_TEST(test_smallprime);
+    ADD_TEST(test_prime_search);
 #ifndef OPENSSL_NO_EC2M
     ADD_TEST(test_gf2m_add);
     ADD_TEST(test_gf2m_mod);
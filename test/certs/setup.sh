@@ -344,3 +344,6 @@ REQMASK=MASK:0x800 ./mkcert.sh req badalt7-key "O = Bad NC Test Certificate 7" \
     "DNS.1 = www.ok.good.com" "DNS.2 = bad.ok.good.com" \
     "email.1 = good@good.org" "email.2 = any@good.com" \
     "IP = 127.0.0.1" "IP = 192.168.0.1"
+
+# Ed25519 certificates
+OPENSSL_KEYALG=ed25519 ./mkcert.sh genee ed25519 server-ed25519-key server-ed25519-cert rootkey rootcert
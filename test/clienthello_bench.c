@@ -0,0 +1,195 @@
+/*
+ * Copyright 2017 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the OpenSSL license (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+/*
+ * Measure how many ClientHello messages per second a server can take in. A
+ * ClientHello is captured from a client once and then fed to a fresh server
+ * SSL object on each iteration. The server is stopped from the early callback,
+ * so what is timed is reading the record, parsing the message and collecting
+ * its extensions, without any of the key exchange that would follow.
+ *
+ * Usage: clienthello_bench [iterations]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <openssl/bio.h>
+#include <openssl/err.h>
+#include <openssl/ssl.h>
+
+#define DEFAULT_ITERATIONS  10000
+
+static const unsigned char alpn_protos[] = {
+    2, 'h', '2', 8, 'h', 't', 't', 'p', '/', '1', '.', '1'
+};
+
+static int early_cb(SSL *s, int *al, void *arg)
+{
+    size_t *seen = arg;
+
+    if (!SSL_early_get0_ext(s, TLSEXT_TYPE_server_name, NULL, NULL))
+        return 0;
+    (*seen)++;
+    /* Suspend the handshake: the rest is not what we are measuring */
+    return -1;
+}
+
+static int add_cb(SSL *s, unsigned int ext_type, const unsigned char **out,
+                  size_t *outlen, int *al, void *add_arg)
+{
+    static const unsigned char data = 1;
+
+    *out = &data;
+    *outlen = 1;
+    return 1;
+}
+
+static int parse_cb(SSL *s, unsigned int ext_type, const unsigned char *in,
+                    size_t inlen, int *al, void *parse_arg)
+{
+    return 1;
+}
+
+/* Capture the ClientHello record that |cctx| produces */
+static int get_client_hello(SSL_CTX *cctx, unsigned char **hello, long *len)
+{
+    SSL *c = NULL;
+    BIO *rbio = NULL, *wbio = NULL;
+    char *data;
+    int ret = 0;
+
+    if ((c = SSL_new(cctx)) == NULL
+            || (rbio = BIO_new(BIO_s_mem())) == NULL
+            || (wbio = BIO_new(BIO_s_mem())) == NULL) {
+        BIO_free(rbio);
+        BIO_free(wbio);
+        goto end;
+    }
+    SSL_set_bio(c, rbio, wbio);
+    if (!SSL_set_tlsext_host_name(c, "www.example.com"))
+        goto end;
+
+    /* This can't complete as there is no server */
+    if (SSL_connect(c) > 0)
+        goto end;
+
+    *len = BIO_get_mem_data(wbio, &data);
+    if (*len <= 0 || (*hello = OPENSSL_malloc(*len)) == NULL)
+        goto end;
+    memcpy(*hello, data, *len);
+    ret = 1;
+ end:
+    SSL_free(c);
+    return ret;
+}
+
+static int run_bench(SSL_CTX *sctx, const unsigned char *hello, long len,
+                     size_t iterations, const char *desc)
+{
+    size_t i, seen = 0;
+    clock_t start, end;
+    double secs;
+
+    SSL_CTX_set_early_cb(sctx, early_cb, &seen);
+
+    start = clock();
+    for (i = 0; i < iterations; i++) {
+        SSL *s;
+        BIO *rbio, *wbio;
+        int r;
+
+        if ((s = SSL_new(sctx)) == NULL)
+            return 0;
+        rbio = BIO_new_mem_buf(hello, (int)len);
+        wbio = BIO_new(BIO_s_mem());
+        if (rbio == NULL || wbio == NULL) {
+            BIO_free(rbio);
+            BIO_free(wbio);
+            SSL_free(s);
+            return 0;
+        }
+        SSL_set_bio(s, rbio, wbio);
+        r = SSL_accept(s);
+        if (r > 0 || SSL_get_error(s, r) != SSL_ERROR_WANT_EARLY) {
+            SSL_free(s);
+            return 0;
+        }
+        SSL_free(s);
+    }
+    end = clock();
+
+    if (seen != iterations) {
+        fprintf(stderr, "Early callback ran %lu times, expected %lu\n",
+                (unsigned long)seen, (unsigned long)iterations);
+        return 0;
+    }
+
+    secs = (double)(end - start) / CLOCKS_PER_SEC;
+    printf("%s: %lu ClientHellos of %ld bytes in %.2fs",
+           desc, (unsigned long)iterations, len, secs);
+    if (secs > 0)
+        printf(" (%.0f/s)", iterations / secs);
+    printf("\n");
+
+    return 1;
+}
+
+int main(int argc, char *argv[])
+{
+    SSL_CTX *sctx = NULL, *cctx = NULL;
+    unsigned char *hello = NULL;
+    long len = 0;
+    size_t iterations = DEFAULT_ITERATIONS;
+    int ret = EXIT_FAILURE;
+
+    if (argc > 1) {
+        long n = atol(argv[1]);
+
+        if (n <= 0) {
+            fprintf(stderr, "Usage: %s [iterations]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+        iterations = (size_t)n;
+    }
+
+    sctx = SSL_CTX_new(TLS_server_method());
+    cctx = SSL_CTX_new(TLS_client_method());
+    if (sctx == NULL || cctx == NULL)
+        goto end;
+
+    if (SSL_CTX_set_alpn_protos(cctx, alpn_protos, sizeof(alpn_protos)) != 0
+            || !SSL_CTX_add_client_custom_ext(cctx, 1000, add_cb, NULL, NULL,
+                                              parse_cb, NULL)
+            || !get_client_hello(cctx, &hello, &len))
+        goto end;
+
+    if (!run_bench(sctx, hello, len, iterations, "built-in extensions"))
+        goto end;
+
+    /*
+     * With a custom extension configured the collected extensions no longer
+     * fit in the ClientHello itself
+     */
+    if (!SSL_CTX_add_server_custom_ext(sctx, 1000, add_cb, NULL, NULL,
+                                       parse_cb, NULL)
+            || !run_bench(sctx, hello, len, iterations, "custom extension"))
+        goto end;
+
+    ret = EXIT_SUCCESS;
+ end:
+    if (ret != EXIT_SUCCESS)
+        ERR_print_errors_fp(stderr);
+    OPENSSL_free(hello);
+    SSL_CTX_free(sctx);
+    SSL_CTX_free(cctx);
+    return ret;
+}
@@ -18,6 +18,7 @@
 #include <openssl/bn.h>
 #include <openssl/rand.h>
 #include <openssl/err.h>
+#include <openssl/objects.h>
 
 #ifdef OPENSSL_NO_DH
 int main(int argc, char *argv[])
@@ -34,6 +35,7 @@ static const char rnd_seed[] =
     "string to make the random number generator think it has entropy";
 
 static int run_rfc5114_tests(void);
+static int run_rfc7919_tests(void);
 
 int main(int argc, char *argv[])
 {
@@ -148,6 +150,8 @@ int main(int argc, char *argv[])
         ret = 0;
     if (!run_rfc5114_tests())
         ret = 1;
+    if (!run_rfc7919_tests())
+        ret = 1;
  err:
     (void)BIO_flush(out);
     ERR_print_errors_fp(stderr);
@@ -595,4 +599,97 @@ static int run_rfc5114_tests(void)
     return 0;
 }
 
+static const int rfc7919_nids[] = {
+    NID_ffdhe2048, NID_ffdhe3072, NID_ffdhe4096, NID_ffdhe6144, NID_ffdhe8192
+};
+
+/*
+ * Checks the named groups: the nid is recognised again, keys generated
+ * through the precomputed tables match a plain exponentiation and both
+ * sides agree on the shared secret.
+ */
+static int run_rfc7919_tests(void)
+{
+    int i = 0, len;
+    DH *dhA = NULL, *dhB = NULL;
+    BN_CTX *ctx = NULL;
+    BIGNUM *y = NULL, *g = NULL;
+    const BIGNUM *p, *pubA, *privA, *pubB;
+    unsigned char *Z1 = NULL, *Z2 = NULL;
+
+    if ((ctx = BN_CTX_new()) == NULL || (y = BN_new()) == NULL)
+        goto bad_err;
+
+    for (i = 0; i < (int)OSSL_NELEM(rfc7919_nids); i++) {
+        dhA = DH_new_by_nid(rfc7919_nids[i]);
+        dhB = DH_new_by_nid(rfc7919_nids[i]);
+        if (dhA == NULL || dhB == NULL)
+            goto bad_err;
+        if (DH_get_nid(dhA) != rfc7919_nids[i])
+            goto err;
+
+        if (!DH_generate_key(dhA) || !DH_generate_key(dhB))
+            goto bad_err;
+        DH_get0_pqg(dhA, &p, NULL, NULL);
+        DH_get0_key(dhA, &pubA, &privA);
+        DH_get0_key(dhB, &pubB, NULL);
+        if (!BN_lshift1(y, BN_value_one())
+            || !BN_mod_exp(y, y, privA, p, ctx))
+            goto bad_err;
+        if (BN_cmp(y, pubA) != 0)
+            goto err;
+
+        len = DH_size(dhA);
+        Z1 = OPENSSL_malloc(len);
+        Z2 = OPENSSL_malloc(len);
+        if (Z1 == NULL || Z2 == NULL)
+            goto bad_err;
+        if (DH_compute_key_padded(Z1, pubB, dhA) != len
+            || DH_compute_key_padded(Z2, pubA, dhB) != len
+            || memcmp(Z1, Z2, len) != 0)
+            goto err;
+
+        printf("RFC7919 parameter test %d OK\n", i + 1);
+
+        DH_free(dhA);
+        DH_free(dhB);
+        OPENSSL_free(Z1);
+        OPENSSL_free(Z2);
+        dhA = dhB = NULL;
+        Z1 = Z2 = NULL;
+    }
+
+    /* Any other generator is not a named group */
+    dhA = DH_new_by_nid(NID_ffdhe2048);
+    if (dhA == NULL || (g = BN_new()) == NULL || !BN_set_word(g, 5)
+        || !DH_set0_pqg(dhA, NULL, NULL, g))
+        goto bad_err;
+    g = NULL;
+    if (DH_get_nid(dhA) != NID_undef || DH_new_by_nid(NID_undef) != NULL)
+        goto err;
+    ERR_clear_error();
+
+    printf("RFC7919 parameter test %d OK\n", i + 1);
+
+    DH_free(dhA);
+    BN_free(y);
+    BN_CTX_free(ctx);
+    return 1;
+ bad_err:
+    fprintf(stderr, "Initialisation error RFC7919 set %d\n", i + 1);
+    ERR_print_errors_fp(stderr);
+    goto end;
+ err:
+    fprintf(stderr, "Test failed RFC7919 set %d\n", i + 1);
+ end:
+    DH_free(dhA);
+    DH_free(dhB);
+    BN_free(g);
+    BN_free(y);
+    BN_CTX_free(ctx);
+    OPENSSL_free(Z1);
+    OPENSSL_free(Z2);
+    return 0;
+}
+
 #endif
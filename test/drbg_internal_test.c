@@ -0,0 +1,255 @@
+/*
+ * Copyright 2017 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the OpenSSL license (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+/*
+ * Internal tests for the CTR_DRBG behind the default RAND method.  The
+ * expected outputs were computed with a straightforward block-by-block
+ * implementation of SP 800-90A CTR_DRBG (AES-256, no derivation function)
+ * from arbitrary seed and additional input values.  Additional input
+ * longer than the seed length is folded as in drbg_ctr.c.
+ */
+
+#include <string.h>
+#include <openssl/opensslconf.h>
+#include <openssl/rand.h>
+#include "test_main.h"
+#include "testutil.h"
+#include "../crypto/rand/rand_lcl.h"
+
+#ifdef OPENSSL_SYS_UNIX
+# include <sys/types.h>
+# include <sys/wait.h>
+# include <unistd.h>
+#endif
+
+static const unsigned char drbg_seed[] = {
+    0x28, 0x55, 0x4f, 0xfd, 0xac, 0xce, 0xbd, 0x7e, 0xcb, 0x9f, 0x31, 0x3a,
+    0x72, 0xe2, 0x72, 0xe2, 0x7f, 0xe3, 0xf2, 0xc7, 0xb1, 0xd1, 0x5b, 0x1c,
+    0x6a, 0x7d, 0xf5, 0xa3, 0x61, 0x76, 0x9d, 0xd8, 0xdf, 0x9e, 0xcf, 0x4c,
+    0x79, 0xe5, 0xad, 0x77, 0x70, 0x1c, 0xfc, 0x88, 0xc1, 0x96, 0x63, 0x2b
+};
+static const unsigned char drbg_reseed[] = {
+    0xe1, 0x6a, 0x09, 0xea, 0x86, 0xc4, 0xc4, 0xc1, 0xef, 0x67, 0x60, 0x3e,
+    0xc8, 0x37, 0x1b, 0x79, 0x99, 0xb2, 0x97, 0xa2, 0xb2, 0x59, 0x62, 0x6b,
+    0xda, 0xac, 0xc6, 0xd8, 0xc0, 0xed, 0x6d, 0x07, 0x58, 0x78, 0xa9, 0x9c,
+    0x43, 0x63, 0xcb, 0xa0, 0x39, 0x37, 0xa7, 0xef, 0xf7, 0x1e, 0x41, 0x06
+};
+static const unsigned char drbg_adin1[] = {
+    0x35, 0xdb, 0x53, 0xca, 0xa0, 0xfe, 0xac, 0x1f, 0x14, 0x96, 0x96, 0xcc,
+    0x67, 0xca, 0x6a, 0x2b, 0x2e, 0xd0, 0x92, 0x5f, 0x02, 0xc0, 0x29, 0x6e,
+    0x09, 0xab, 0x26, 0xce, 0xdd, 0xfc, 0xb1, 0x96
+};
+static const unsigned char drbg_adin2[] = {
+    0xe2, 0x03, 0x30, 0x69, 0xf8, 0x5f, 0xd9, 0xda, 0xcf, 0xa5, 0x69, 0x71,
+    0x9b, 0xbe, 0x31, 0xdf, 0xfc, 0xa2, 0xec, 0x15, 0x32, 0x9e, 0x7d, 0x97,
+    0x94, 0xa5, 0x9d, 0x05, 0xe8, 0x56, 0x72, 0x47, 0xb9, 0x2c, 0x50, 0x8c,
+    0x12, 0xda, 0x61, 0x3c, 0x15, 0xcd, 0x04, 0x73, 0xb0, 0x04, 0xe8, 0x72,
+    0xb5, 0x59, 0x25, 0xf3, 0x50, 0x6a, 0x14, 0xf5, 0x6a, 0x1e, 0xa5, 0xe8,
+    0xfb, 0xb3, 0x03, 0xfa, 0x22, 0xb0, 0x21, 0x82, 0x9c, 0x79, 0x2d, 0x21,
+    0x18, 0xce, 0x48, 0xdd, 0x5a, 0x46, 0x3e, 0x68, 0x23, 0xaf, 0xc9, 0x98,
+    0xfd, 0x66, 0x1b, 0xe8, 0xfe, 0x30, 0xe2, 0xcc, 0x55, 0x35, 0x63, 0x5e,
+    0x68, 0x74, 0x8b, 0x4f
+};
+static const unsigned char drbg_out1[] = {
+    0x19, 0x97, 0xe6, 0x5d, 0x53, 0xf0, 0x7d, 0xe8, 0x0b, 0x8c, 0xba, 0x35,
+    0x91, 0x86, 0xa7, 0xd7, 0xdc, 0x81, 0x56, 0x83, 0x1e, 0xfb, 0xf8, 0x40,
+    0x87, 0xc0, 0x89, 0xb9, 0xe3, 0x30, 0x42, 0x4b, 0xa1, 0x70, 0xf0, 0xe0,
+    0xbf, 0x98, 0x36, 0xb4, 0x31, 0x72, 0x38, 0x99, 0x5b, 0x49, 0x4e, 0x29,
+    0xb0, 0xa8, 0xb2, 0xcb, 0xf7, 0xa9, 0xd8, 0x97, 0x76, 0x1a, 0x1a, 0xca,
+    0xc2, 0x8c, 0xeb, 0x2b
+};
+static const unsigned char drbg_out2[] = {
+    0x32, 0xcc, 0x29, 0xf5, 0x45, 0x4a, 0x14, 0xb0, 0x22, 0x42, 0x4c, 0xcf,
+    0xc7, 0xea, 0xad, 0x17, 0x1c, 0x3d, 0x9a, 0xdf, 0x94, 0x09, 0x4f, 0x7e,
+    0x6d, 0x2d, 0x6c, 0x34, 0x08, 0xb3, 0xa5, 0x02, 0xaf, 0x38, 0x58, 0x1a,
+    0xa0
+};
+static const unsigned char drbg_out3[] = {
+    0xdf, 0x20, 0xc4, 0xb1, 0xc9, 0x60, 0x22, 0x36, 0xa9, 0xac, 0x98, 0x31,
+    0x8c, 0x3e, 0x09, 0x15, 0x5c, 0xe5, 0x55, 0x77, 0x39, 0x6f, 0x88, 0x86,
+    0x53, 0x0e, 0xa1, 0x3b, 0xeb, 0x76, 0x22, 0x59, 0x00, 0x19, 0xc0, 0x77,
+    0x1e, 0xb9, 0xd8, 0x8a, 0x00, 0x04, 0x6f, 0x92, 0xce, 0x1b, 0x9f, 0x49,
+    0x9e, 0xd5, 0xcb, 0x6e, 0x31, 0x4c, 0xdd, 0x9b, 0x90, 0xa0, 0x48, 0xb5,
+    0x69, 0x61, 0xfa, 0x41
+};
+static const unsigned char drbg_out5[] = {
+    0xe5, 0xf4, 0xff, 0x77, 0xea, 0x37, 0xb3, 0xe0, 0xed, 0x75, 0x7e, 0xfb,
+    0x2b, 0x2d, 0x4e, 0x14, 0xe0, 0xc0, 0x5f, 0x53, 0xa7, 0xc0, 0x87, 0xfe,
+    0x50, 0x1e, 0x94, 0x0d, 0xa5, 0x62, 0x7b, 0x3f, 0x19, 0x35, 0x2d, 0x3c,
+    0x53, 0xc1, 0xe1, 0x8e, 0x0f, 0x16, 0xcd, 0x09, 0xe9, 0xee, 0x80, 0x3f,
+    0xd7, 0xfc, 0x5f, 0x39, 0x81, 0xe3, 0x4a, 0x0d, 0x9c, 0xa3, 0xe5, 0x83,
+    0x9b, 0x94, 0x52, 0x5c
+};
+
+static int test_drbg_ctr_kat(void)
+{
+    RAND_DRBG drbg;
+    unsigned char out[64];
+    int ret = 0;
+
+    memset(&drbg, 0, sizeof(drbg));
+    if (!TEST_true(drbg_ctr_init(&drbg))
+        || !TEST_true(drbg_ctr_instantiate(&drbg, drbg_seed))
+        || !TEST_true(drbg_ctr_generate(&drbg, out, sizeof(drbg_out1),
+                                        NULL, 0))
+        || !TEST_mem_eq(out, sizeof(drbg_out1), drbg_out1, sizeof(drbg_out1))
+        /* A request that ends in a partial block */
+        || !TEST_true(drbg_ctr_generate(&drbg, out, sizeof(drbg_out2),
+                                        NULL, 0))
+        || !TEST_mem_eq(out, sizeof(drbg_out2), drbg_out2, sizeof(drbg_out2))
+        || !TEST_true(drbg_ctr_reseed(&drbg, drbg_reseed))
+        || !TEST_true(drbg_ctr_generate(&drbg, out, sizeof(drbg_out3),
+                                        drbg_adin1, sizeof(drbg_adin1)))
+        || !TEST_mem_eq(out, sizeof(drbg_out3), drbg_out3, sizeof(drbg_out3))
+        /* No output, only folded additional input, as RAND_add() does */
+        || !TEST_true(drbg_ctr_generate(&drbg, NULL, 0,
+                                        drbg_adin2, sizeof(drbg_adin2)))
+        || !TEST_true(drbg_ctr_generate(&drbg, out, sizeof(drbg_out5),
+                                        NULL, 0))
+        || !TEST_mem_eq(out, sizeof(drbg_out5), drbg_out5, sizeof(drbg_out5))
+        || !TEST_uint_eq(drbg.generate_counter, 3))
+        goto err;
+    ret = 1;
+ err:
+    drbg_ctr_uninstantiate(&drbg);
+    return ret;
+}
+
+static int test_drbg_ctr_max_request(void)
+{
+    RAND_DRBG drbg;
+    unsigned char *buf = NULL;
+    int ret = 0;
+
+    memset(&drbg, 0, sizeof(drbg));
+    if (!TEST_ptr(buf = OPENSSL_malloc(DRBG_CTR_MAX_REQUEST + 1))
+        || !TEST_true(drbg_ctr_init(&drbg))
+        || !TEST_true(drbg_ctr_instantiate(&drbg, drbg_seed))
+        || !TEST_true(drbg_ctr_generate(&drbg, buf, DRBG_CTR_MAX_REQUEST,
+                                        NULL, 0))
+        || !TEST_false(drbg_ctr_generate(&drbg, buf, DRBG_CTR_MAX_REQUEST + 1,
+                                         NULL, 0)))
+        goto err;
+    ret = 1;
+ err:
+    drbg_ctr_uninstantiate(&drbg);
+    OPENSSL_free(buf);
+    return ret;
+}
+
+/* The public and the private streams must not repeat each other */
+static int test_rand_priv_bytes(void)
+{
+    unsigned char pub[32], priv[32];
+
+    return TEST_int_eq(RAND_bytes(pub, sizeof(pub)), 1)
+        && TEST_int_eq(RAND_priv_bytes(priv, sizeof(priv)), 1)
+        && TEST_mem_ne(pub, sizeof(pub), priv, sizeof(priv));
+}
+
+static int test_reseed_defaults(void)
+{
+    unsigned char buf[32];
+    RAND_DRBG *master, *pub;
+    unsigned int master_count, pub_count;
+    int ret = 0;
+
+    if (!TEST_false(RAND_DRBG_set_reseed_defaults((1 << 24) + 1, 1, 1, 1))
+        || !TEST_false(RAND_DRBG_set_reseed_defaults(1, 1, -1, 1))
+        || !TEST_false(RAND_DRBG_set_reseed_defaults(1, 1, 1, (1 << 20) + 1))
+        || !TEST_int_eq(RAND_bytes(buf, sizeof(buf)), 1)
+        || !TEST_ptr(master = rand_drbg_get0_master())
+        || !TEST_ptr(pub = rand_drbg_get0_thread(0)))
+        return 0;
+
+    /* Reseed on every request */
+    master_count = master->reseed_count;
+    pub_count = pub->reseed_count;
+    if (!TEST_true(RAND_DRBG_set_reseed_defaults(1, 1, 0, 0))
+        || !TEST_int_eq(RAND_bytes(buf, sizeof(buf)), 1)
+        || !TEST_int_eq(RAND_bytes(buf, sizeof(buf)), 1)
+        || !TEST_uint_eq(pub->reseed_count, pub_count + 2)
+        || !TEST_uint_eq(master->reseed_count, master_count + 2))
+        goto err;
+
+    /* Never reseed */
+    master_count = master->reseed_count;
+    pub_count = pub->reseed_count;
+    if (!TEST_true(RAND_DRBG_set_reseed_defaults(0, 0, 0, 0))
+        || !TEST_int_eq(RAND_bytes(buf, sizeof(buf)), 1)
+        || !TEST_int_eq(RAND_bytes(buf, sizeof(buf)), 1)
+        || !TEST_uint_eq(pub->reseed_count, pub_count)
+        || !TEST_uint_eq(master->reseed_count, master_count))
+        goto err;
+
+    /* Reseed once the time interval has passed */
+    if (!TEST_true(RAND_DRBG_set_reseed_defaults(0, 0, 0, 60))
+        || !TEST_int_eq(RAND_bytes(buf, sizeof(buf)), 1)
+        || !TEST_uint_eq(pub->reseed_count, pub_count))
+        goto err;
+    pub->reseed_time -= 61;
+    if (!TEST_int_eq(RAND_bytes(buf, sizeof(buf)), 1)
+        || !TEST_uint_eq(pub->reseed_count, pub_count + 1))
+        goto err;
+    ret = 1;
+
+ err:
+    RAND_DRBG_set_reseed_defaults(1 << 8, 1 << 16, 60 * 60, 7 * 60);
+    return ret;
+}
+
+#ifdef OPENSSL_SYS_UNIX
+/* The parent and the child of a fork() must not produce the same bytes */
+static int test_fork(void)
+{
+    unsigned char parent[32], child[32];
+    int fds[2], status = 0, n = 0, r;
+    pid_t pid;
+
+    /* Make sure every DRBG is instantiated before the fork */
+    if (!TEST_int_eq(RAND_bytes(parent, sizeof(parent)), 1)
+        || !TEST_int_eq(pipe(fds), 0))
+        return 0;
+
+    if ((pid = fork()) == 0) {
+        close(fds[0]);
+        if (RAND_bytes(child, sizeof(child)) == 1)
+            n = write(fds[1], child, sizeof(child));
+        close(fds[1]);
+        _exit(n == sizeof(child) ? 0 : 1);
+    }
+    close(fds[1]);
+    if (!TEST_int_gt(pid, 0)) {
+        close(fds[0]);
+        return 0;
+    }
+
+    while (n < (int)sizeof(child)
+           && (r = read(fds[0], child + n, sizeof(child) - n)) > 0)
+        n += r;
+    close(fds[0]);
+    waitpid(pid, &status, 0);
+
+    return TEST_int_eq(n, sizeof(child))
+        && TEST_true(WIFEXITED(status) && WEXITSTATUS(status) == 0)
+        && TEST_int_eq(RAND_bytes(parent, sizeof(parent)), 1)
+        && TEST_mem_ne(parent, sizeof(parent), child, sizeof(child));
+}
+#endif
+
+void register_tests(void)
+{
+    ADD_TEST(test_drbg_ctr_kat);
+    ADD_TEST(test_drbg_ctr_max_request);
+    ADD_TEST(test_rand_priv_bytes);
+    ADD_TEST(test_reseed_defaults);
+#ifdef OPENSSL_SYS_UNIX
+    ADD_TEST(test_fork);
+#endif
+}
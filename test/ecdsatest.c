@@ -53,6 +53,7 @@ static const char rnd_seed[] = "string to make the random number generator "
 int x9_62_tests(BIO *);
 int x9_62_test_internal(BIO *out, int nid, const char *r, const char *s);
 int test_builtin(BIO *);
+int test_batch(BIO *);
 
 /* functions to change the RAND_METHOD */
 int change_rand(void);
@@ -479,6 +480,165 @@ int test_builtin(BIO *out)
     return ret;
 }
 
+/*
+ * Verifies a batch of signatures made with keys on curves of different
+ * orders, then checks that bad signatures are reported individually.
+ */
+# define BATCH_SIZE         12
+# define NUM_BATCH_CURVES   3
+
+int test_batch(BIO *out)
+{
+    static const int nids[NUM_BATCH_CURVES] = {
+        NID_X9_62_prime256v1, NID_secp384r1, NID_brainpoolP256r1
+    };
+    EC_KEY *keys[NUM_BATCH_CURVES] = { NULL };
+    EC_KEY *batch_keys[BATCH_SIZE];
+    ECDSA_SIG *sigs[BATCH_SIZE] = { NULL };
+    unsigned char digests[BATCH_SIZE][32];
+    const unsigned char *dgsts[BATCH_SIZE];
+    int dgst_lens[BATCH_SIZE], results[BATCH_SIZE];
+    const BIGNUM *r, *s;
+    BIGNUM *bad_r = NULL, *bad_s = NULL;
+    size_t i;
+    int ret = 0;
+
+    BIO_printf(out, "\ntesting ECDSA_do_verify_batch(): ");
+
+    for (i = 0; i < NUM_BATCH_CURVES; i++) {
+        if ((keys[i] = EC_KEY_new_by_curve_name(nids[i])) == NULL
+            || !EC_KEY_generate_key(keys[i]))
+            goto batch_err;
+    }
+    for (i = 0; i < BATCH_SIZE; i++) {
+        batch_keys[i] = keys[i % NUM_BATCH_CURVES];
+        dgsts[i] = digests[i];
+        dgst_lens[i] = sizeof(digests[i]);
+        if (RAND_bytes(digests[i], sizeof(digests[i])) <= 0
+            || (sigs[i] = ECDSA_do_sign(digests[i], sizeof(digests[i]),
+                                        batch_keys[i])) == NULL)
+            goto batch_err;
+    }
+
+    if (ECDSA_do_verify_batch(dgsts, dgst_lens,
+                              (const ECDSA_SIG *const *)sigs, batch_keys,
+                              BATCH_SIZE, results) != 1)
+        goto batch_err;
+    for (i = 0; i < BATCH_SIZE; i++) {
+        if (results[i] != 1)
+            goto batch_err;
+    }
+    BIO_printf(out, ".");
+
+    /* Wrong digest for one signature, out of range s for another */
+    digests[5][0] ^= 1;
+    ECDSA_SIG_get0(sigs[7], &r, &s);
+    if ((bad_r = BN_dup(r)) == NULL
+        || (bad_s = BN_dup(EC_GROUP_get0_order(
+                               EC_KEY_get0_group(batch_keys[7])))) == NULL
+        || !ECDSA_SIG_set0(sigs[7], bad_r, bad_s)) {
+        BN_free(bad_r);
+        BN_free(bad_s);
+        goto batch_err;
+    }
+    if (ECDSA_do_verify_batch(dgsts, dgst_lens,
+                              (const ECDSA_SIG *const *)sigs, batch_keys,
+                              BATCH_SIZE, results) != 0)
+        goto batch_err;
+    for (i = 0; i < BATCH_SIZE; i++) {
+        if (results[i] != (i == 5 || i == 7 ? 0 : 1))
+            goto batch_err;
+    }
+    BIO_printf(out, ".");
+
+    /* An empty batch verifies */
+    if (ECDSA_do_verify_batch(NULL, NULL, NULL, NULL, 0, NULL) != 1)
+        goto batch_err;
+    BIO_printf(out, ". ok\n");
+
+    ERR_clear_error();
+    ret = 1;
+ batch_err:
+    if (!ret)
+        BIO_printf(out, " failed\n");
+    for (i = 0; i < BATCH_SIZE; i++)
+        ECDSA_SIG_free(sigs[i]);
+    for (i = 0; i < NUM_BATCH_CURVES; i++)
+        EC_KEY_free(keys[i]);
+    return ret;
+}
+
+/*
+ * Precomputes signing values for a few signatures, then checks that each
+ * signature uses up one set with a different r and still verifies.
+ */
+# define SETUP_BATCH_SIZE   5
+
+int test_sign_setup_batch(BIO *out)
+{
+    static const int nids[] = { NID_X9_62_prime256v1, NID_secp384r1 };
+    EC_KEY *eckey = NULL;
+    EC_GROUP *group = NULL;
+    ECDSA_SIG *sig = NULL;
+    BIGNUM *prev_r = NULL;
+    const BIGNUM *r;
+    unsigned char digest[32];
+    size_t i, j;
+    int ret = 0;
+
+    BIO_printf(out, "\ntesting ECDSA_sign_setup_batch(): ");
+
+    if (RAND_bytes(digest, sizeof(digest)) <= 0
+        || (prev_r = BN_new()) == NULL)
+        goto setup_err;
+
+    for (i = 0; i < sizeof(nids) / sizeof(nids[0]); i++) {
+        if ((eckey = EC_KEY_new_by_curve_name(nids[i])) == NULL
+            || !EC_KEY_generate_key(eckey)
+            || !ECDSA_sign_setup_batch(eckey, NULL, SETUP_BATCH_SIZE)
+            || ECDSA_sign_setup_count(eckey) != SETUP_BATCH_SIZE)
+            goto setup_err;
+
+        /* one more signature than precomputed sets */
+        for (j = 0; j <= SETUP_BATCH_SIZE; j++) {
+            if ((sig = ECDSA_do_sign(digest, sizeof(digest), eckey)) == NULL
+                || ECDSA_sign_setup_count(eckey)
+                   != (j < SETUP_BATCH_SIZE ? SETUP_BATCH_SIZE - j - 1 : 0)
+                || ECDSA_do_verify(digest, sizeof(digest), sig, eckey) != 1)
+                goto setup_err;
+            ECDSA_SIG_get0(sig, &r, NULL);
+            if (BN_cmp(r, prev_r) == 0 || BN_copy(prev_r, r) == NULL)
+                goto setup_err;
+            ECDSA_SIG_free(sig);
+            sig = NULL;
+            BIO_printf(out, ".");
+        }
+
+        /* changing the group discards the pool */
+        if (!ECDSA_sign_setup_batch(eckey, NULL, SETUP_BATCH_SIZE)
+            || (group = EC_GROUP_dup(EC_KEY_get0_group(eckey))) == NULL
+            || !EC_KEY_set_group(eckey, group)
+            || ECDSA_sign_setup_count(eckey) != 0)
+            goto setup_err;
+
+        EC_GROUP_free(group);
+        group = NULL;
+        EC_KEY_free(eckey);
+        eckey = NULL;
+    }
+    BIO_printf(out, " ok\n");
+
+    ret = 1;
+ setup_err:
+    if (!ret)
+        BIO_printf(out, " failed\n");
+    ECDSA_SIG_free(sig);
+    EC_GROUP_free(group);
+    EC_KEY_free(eckey);
+    BN_free(prev_r);
+    return ret;
+}
+
 int main(void)
 {
     int ret = 1;
@@ -499,6 +659,10 @@ int main(void)
         goto err;
     if (!test_builtin(out))
         goto err;
+    if (!test_batch(out))
+        goto err;
+    if (!test_sign_setup_batch(out))
+        goto err;
 
     ret = 0;
  err:
@@ -1523,6 +1523,29 @@ static const struct nistp_test_params nistp_tests_params[] = {
      /* d */
      "c477f9f65c22cce20657faa5b2d1d8122336f851a508a1ed04e479c34985bf96",
      },
+    {
+     /* P-384 (d is not from the above document, Q = d*G) */
+     EC_GFp_nistp384_method,
+     384,
+     /* p */
+     "fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffeffffffff0000000000000000ffffffff",
+     /* a */
+     "fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffeffffffff0000000000000000fffffffc",
+     /* b */
+     "b3312fa7e23ee7e4988e056be3f82d19181d9c6efe8141120314088f5013875ac656398d8a2ed19d2a85c8edd3ec2aef",
+     /* Qx */
+     "b1a582bffa189a33471dd7f0e6a9ea7d54bd88736c22aebf8c29e7dfd8015b59239b1fd5b9f00ee18c55b12947b5caf1",
+     /* Qy */
+     "f7a0a754b41f0bd68b2151c7009340945754fa33d483e540c9b301923d0f9da934f00aba8b603800d0021bdf4546bb72",
+     /* Gx */
+     "aa87ca22be8b05378eb1c71ef320ad746e1d3b628ba79b9859f741e082542a385502f25dbf55296c3a545e3872760ab7",
+     /* Gy */
+     "3617de4a96262c6f5d9e98bf9292dc29f8f41dbd289a147ce9da3113b5f0b8c00a60b1ce1d7e819d7a431d7c90ea0e5f",
+     /* order */
+     "ffffffffffffffffffffffffffffffffffffffffffffffffc7634d81f4372ddf581a0db248b0a77aecec196accc52973",
+     /* d */
+     "8656de516c87e45d4a0a88160248faaffd2ab58053d616f34ec5c094ccf43fa5a02feb605c5b7fa2ebd4a2147b279060",
+     },
     {
      /* P-521 */
      EC_GFp_nistp521_method,
@@ -1699,6 +1722,107 @@ static void nistp_single_test(const struct nistp_test_params *test)
     BN_CTX_free(ctx);
 }
 
+/*
+ * Checks that the named curve |nid| uses |meth|, and compares its results,
+ * which use the built-in precomputed multiples of the generator, with those
+ * of the generic implementation for random scalars.
+ */
+static void nistp_named_curve_test(int nid, const EC_METHOD *(*meth) (void))
+{
+    BN_CTX *ctx;
+    BIGNUM *p, *a, *b, *order, *k, *l, *x1, *y1, *x2, *y2;
+    EC_GROUP *NISTP, *REF;
+    EC_POINT *G, *P1, *P2, *R1, *R2;
+    int i;
+
+    fprintf(stdout, "\n%s (optimised implementation, named curve) ... ",
+            OBJ_nid2sn(nid));
+    ctx = BN_CTX_new();
+    p = BN_new();
+    a = BN_new();
+    b = BN_new();
+    order = BN_new();
+    k = BN_new();
+    l = BN_new();
+    x1 = BN_new();
+    y1 = BN_new();
+    x2 = BN_new();
+    y2 = BN_new();
+    if (ctx == NULL || p == NULL || a == NULL || b == NULL || order == NULL
+        || k == NULL || l == NULL || x1 == NULL || y1 == NULL || x2 == NULL
+        || y2 == NULL)
+        ABORT;
+
+    if ((NISTP = EC_GROUP_new_by_curve_name(nid)) == NULL)
+        ABORT;
+    if (EC_GROUP_method_of(NISTP) != meth())
+        ABORT;
+
+    /* The same curve with the generic Montgomery implementation */
+    if (!EC_GROUP_get_curve_GFp(NISTP, p, a, b, ctx)
+        || !EC_GROUP_get_order(NISTP, order, ctx))
+        ABORT;
+    if ((REF = EC_GROUP_new(EC_GFp_mont_method())) == NULL
+        || !EC_GROUP_set_curve_GFp(REF, p, a, b, ctx))
+        ABORT;
+    if ((G = EC_POINT_new(REF)) == NULL
+        || !EC_POINT_get_affine_coordinates_GFp(NISTP,
+                                                EC_GROUP_get0_generator(NISTP),
+                                                x1, y1, ctx)
+        || !EC_POINT_set_affine_coordinates_GFp(REF, G, x1, y1, ctx)
+        || !EC_GROUP_set_generator(REF, G, order, BN_value_one()))
+        ABORT;
+
+    if ((P1 = EC_POINT_new(NISTP)) == NULL || (P2 = EC_POINT_new(REF)) == NULL
+        || (R1 = EC_POINT_new(NISTP)) == NULL
+        || (R2 = EC_POINT_new(REF)) == NULL)
+        ABORT;
+
+    for (i = 0; i < 10; i++) {
+        /* A random point P = l * generator in each group */
+        if (!BN_rand_range(k, order) || !BN_rand_range(l, order))
+            ABORT;
+        if (!EC_POINT_mul(NISTP, P1, l, NULL, NULL, ctx)
+            || !EC_POINT_mul(REF, P2, l, NULL, NULL, ctx))
+            ABORT;
+        if (!EC_POINT_get_affine_coordinates_GFp(NISTP, P1, x1, y1, ctx)
+            || !EC_POINT_get_affine_coordinates_GFp(REF, P2, x2, y2, ctx))
+            ABORT;
+        if (BN_cmp(x1, x2) != 0 || BN_cmp(y1, y2) != 0)
+            ABORT;
+
+        /* R = k * generator + l * P */
+        if (!EC_POINT_mul(NISTP, R1, k, P1, l, ctx)
+            || !EC_POINT_mul(REF, R2, k, P2, l, ctx))
+            ABORT;
+        if (!EC_POINT_get_affine_coordinates_GFp(NISTP, R1, x1, y1, ctx)
+            || !EC_POINT_get_affine_coordinates_GFp(REF, R2, x2, y2, ctx))
+            ABORT;
+        if (BN_cmp(x1, x2) != 0 || BN_cmp(y1, y2) != 0)
+            ABORT;
+    }
+    fprintf(stdout, "ok\n");
+
+    EC_POINT_free(G);
+    EC_POINT_free(P1);
+    EC_POINT_free(P2);
+    EC_POINT_free(R1);
+    EC_POINT_free(R2);
+    EC_GROUP_free(NISTP);
+    EC_GROUP_free(REF);
+    BN_free(p);
+    BN_free(a);
+    BN_free(b);
+    BN_free(order);
+    BN_free(k);
+    BN_free(l);
+    BN_free(x1);
+    BN_free(y1);
+    BN_free(x2);
+    BN_free(y2);
+    BN_CTX_free(ctx);
+}
+
 static void nistp_tests()
 {
     unsigned i;
@@ -1706,9 +1830,118 @@ static void nistp_tests()
     for (i = 0; i < OSSL_NELEM(nistp_tests_params); i++) {
         nistp_single_test(&nistp_tests_params[i]);
     }
+    nistp_named_curve_test(NID_secp224r1, EC_GFp_nistp224_method);
+    nistp_named_curve_test(NID_secp384r1, EC_GFp_nistp384_method);
+    nistp_named_curve_test(NID_secp521r1, EC_GFp_nistp521_method);
 }
 # endif
 
+/*
+ * Compares multiples of the generator computed with the generator comb
+ * against the generic code, for every built-in curve over a prime field.
+ */
+static int comb_check(EC_GROUP *group, EC_GROUP *generic, const BIGNUM *k,
+                      BN_CTX *ctx)
+{
+    EC_POINT *p = EC_POINT_new(group), *q = EC_POINT_new(generic);
+    int ret = 0;
+
+    if (p != NULL && q != NULL
+        && EC_POINT_mul(group, p, k, NULL, NULL, ctx)
+        && EC_POINT_mul(generic, q, k, NULL, NULL, ctx)
+        && EC_POINT_cmp(group, p, q, ctx) == 0)
+        ret = 1;
+    EC_POINT_free(p);
+    EC_POINT_free(q);
+    return ret;
+}
+
+static void comb_test(void)
+{
+    EC_builtin_curve *curves = NULL;
+    size_t crv_len, n;
+    BN_CTX *ctx;
+    BIGNUM *k;
+    int i, teeth;
+
+    crv_len = EC_get_builtin_curves(NULL, 0);
+    curves = OPENSSL_malloc(sizeof(*curves) * crv_len);
+    ctx = BN_CTX_new();
+    k = BN_new();
+    if (curves == NULL || ctx == NULL || k == NULL
+        || !EC_get_builtin_curves(curves, crv_len))
+        ABORT;
+
+    fprintf(stdout, "testing generator comb: ");
+
+    for (n = 0; n < crv_len; n++) {
+        EC_GROUP *group, *generic;
+        const BIGNUM *order;
+
+        if ((group = EC_GROUP_new_by_curve_name(curves[n].nid)) == NULL)
+            ABORT;
+        if (EC_METHOD_get_field_type(EC_GROUP_method_of(group))
+            != NID_X9_62_prime_field) {
+            EC_GROUP_free(group);
+            continue;
+        }
+        if ((generic = EC_GROUP_dup(group)) == NULL
+            || EC_GROUP_get_comb_teeth(group) == 0
+            || !EC_GROUP_set_comb_teeth(generic, 0)
+            || EC_GROUP_get_comb_teeth(generic) != 0)
+            ABORT;
+        order = EC_GROUP_get0_order(group);
+
+        /* Every supported width for one curve, the default for the others */
+        for (teeth = 2; teeth <= 8; teeth++) {
+            if (curves[n].nid == NID_brainpoolP256r1
+                && !EC_GROUP_set_comb_teeth(group, teeth))
+                ABORT;
+
+            /* Small scalars, the order and the largest accepted scalar */
+            for (i = 0; i < 4; i++) {
+                if (!BN_set_word(k, i) || !comb_check(group, generic, k, ctx))
+                    ABORT;
+            }
+            if (!BN_copy(k, order) || !comb_check(group, generic, k, ctx)
+                || !BN_sub_word(k, 1) || !comb_check(group, generic, k, ctx)
+                || !BN_lshift1(k, order) || !comb_check(group, generic, k, ctx)
+                || !BN_set_word(k, 0)
+                || !BN_set_bit(k, BN_num_bits(order) + 1)
+                || !BN_sub_word(k, 1) || !comb_check(group, generic, k, ctx))
+                ABORT;
+
+            /* Random scalars padded to a fixed length as ECDSA does */
+            for (i = 0; i < 4; i++) {
+                if (!BN_rand_range(k, order)
+                    || !comb_check(group, generic, k, ctx)
+                    || !BN_add(k, k, order)
+                    || !comb_check(group, generic, k, ctx))
+                    ABORT;
+            }
+
+            if (curves[n].nid != NID_brainpoolP256r1)
+                break;
+        }
+
+        /* Out of range values are rejected */
+        if (EC_GROUP_set_comb_teeth(group, 1)
+            || EC_GROUP_set_comb_teeth(group, 9))
+            ABORT;
+        ERR_clear_error();
+
+        fprintf(stdout, ".");
+        fflush(stdout);
+        EC_GROUP_free(group);
+        EC_GROUP_free(generic);
+    }
+    fprintf(stdout, " ok\n\n");
+
+    BN_free(k);
+    BN_CTX_free(ctx);
+    OPENSSL_free(curves);
+}
+
 static void parameter_test(void)
 {
     EC_GROUP *group, *group2;
@@ -1761,6 +1994,8 @@ int main(int argc, char *argv[])
     /* test the internal curves */
     internal_curve_test();
 
+    comb_test();
+
     parameter_test();
 
 #ifndef OPENSSL_NO_CRYPTO_MDEBUG
@@ -0,0 +1,210 @@
+/*
+ * Copyright 2017 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the OpenSSL license (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+/* Internal tests for Ed25519 */
+
+#include <string.h>
+#include <openssl/evp.h>
+#include <openssl/x509.h>
+#include "test_main.h"
+#include "testutil.h"
+#include "../crypto/ec/ec_lcl.h"
+
+typedef struct {
+    uint8_t priv[32];
+    uint8_t pub[32];
+    uint8_t msg[2];
+    size_t msglen;
+    uint8_t sig[64];
+} ED25519_TEST;
+
+/* Test vectors from RFC 8032, section 7.1 */
+static const ED25519_TEST ed25519_tests[] = {
+    {
+        {
+            0x9d, 0x61, 0xb1, 0x9d, 0xef, 0xfd, 0x5a, 0x60,
+            0xba, 0x84, 0x4a, 0xf4, 0x92, 0xec, 0x2c, 0xc4,
+            0x44, 0x49, 0xc5, 0x69, 0x7b, 0x32, 0x69, 0x19,
+            0x70, 0x3b, 0xac, 0x03, 0x1c, 0xae, 0x7f, 0x60
+        },
+        {
+            0xd7, 0x5a, 0x98, 0x01, 0x82, 0xb1, 0x0a, 0xb7,
+            0xd5, 0x4b, 0xfe, 0xd3, 0xc9, 0x64, 0x07, 0x3a,
+            0x0e, 0xe1, 0x72, 0xf3, 0xda, 0xa6, 0x23, 0x25,
+            0xaf, 0x02, 0x1a, 0x68, 0xf7, 0x07, 0x51, 0x1a
+        },
+        { 0 },
+        0,
+        {
+            0xe5, 0x56, 0x43, 0x00, 0xc3, 0x60, 0xac, 0x72,
+            0x90, 0x86, 0xe2, 0xcc, 0x80, 0x6e, 0x82, 0x8a,
+            0x84, 0x87, 0x7f, 0x1e, 0xb8, 0xe5, 0xd9, 0x74,
+            0xd8, 0x73, 0xe0, 0x65, 0x22, 0x49, 0x01, 0x55,
+            0x5f, 0xb8, 0x82, 0x15, 0x90, 0xa3, 0x3b, 0xac,
+            0xc6, 0x1e, 0x39, 0x70, 0x1c, 0xf9, 0xb4, 0x6b,
+            0xd2, 0x5b, 0xf5, 0xf0, 0x59, 0x5b, 0xbe, 0x24,
+            0x65, 0x51, 0x41, 0x43, 0x8e, 0x7a, 0x10, 0x0b
+        }
+    },
+    {
+        {
+            0x4c, 0xcd, 0x08, 0x9b, 0x28, 0xff, 0x96, 0xda,
+            0x9d, 0xb6, 0xc3, 0x46, 0xec, 0x11, 0x4e, 0x0f,
+            0x5b, 0x8a, 0x31, 0x9f, 0x35, 0xab, 0xa6, 0x24,
+            0xda, 0x8c, 0xf6, 0xed, 0x4f, 0xb8, 0xa6, 0xfb
+        },
+        {
+            0x3d, 0x40, 0x17, 0xc3, 0xe8, 0x43, 0x89, 0x5a,
+            0x92, 0xb7, 0x0a, 0xa7, 0x4d, 0x1b, 0x7e, 0xbc,
+            0x9c, 0x98, 0x2c, 0xcf, 0x2e, 0xc4, 0x96, 0x8c,
+            0xc0, 0xcd, 0x55, 0xf1, 0x2a, 0xf4, 0x66, 0x0c
+        },
+        { 0x72 },
+        1,
+        {
+            0x92, 0xa0, 0x09, 0xa9, 0xf0, 0xd4, 0xca, 0xb8,
+            0x72, 0x0e, 0x82, 0x0b, 0x5f, 0x64, 0x25, 0x40,
+            0xa2, 0xb2, 0x7b, 0x54, 0x16, 0x50, 0x3f, 0x8f,
+            0xb3, 0x76, 0x22, 0x23, 0xeb, 0xdb, 0x69, 0xda,
+            0x08, 0x5a, 0xc1, 0xe4, 0x3e, 0x15, 0x99, 0x6e,
+            0x45, 0x8f, 0x36, 0x13, 0xd0, 0xf1, 0x1d, 0x8c,
+            0x38, 0x7b, 0x2e, 0xae, 0xb4, 0x30, 0x2a, 0xee,
+            0xb0, 0x0d, 0x29, 0x16, 0x12, 0xbb, 0x0c, 0x00
+        }
+    },
+    {
+        {
+            0xc5, 0xaa, 0x8d, 0xf4, 0x3f, 0x9f, 0x83, 0x7b,
+            0xed, 0xb7, 0x44, 0x2f, 0x31, 0xdc, 0xb7, 0xb1,
+            0x66, 0xd3, 0x85, 0x35, 0x07, 0x6f, 0x09, 0x4b,
+            0x85, 0xce, 0x3a, 0x2e, 0x0b, 0x44, 0x58, 0xf7
+        },
+        {
+            0xfc, 0x51, 0xcd, 0x8e, 0x62, 0x18, 0xa1, 0xa3,
+            0x8d, 0xa4, 0x7e, 0xd0, 0x02, 0x30, 0xf0, 0x58,
+            0x08, 0x16, 0xed, 0x13, 0xba, 0x33, 0x03, 0xac,
+            0x5d, 0xeb, 0x91, 0x15, 0x48, 0x90, 0x80, 0x25
+        },
+        { 0xaf, 0x82 },
+        2,
+        {
+            0x62, 0x91, 0xd6, 0x57, 0xde, 0xec, 0x24, 0x02,
+            0x48, 0x27, 0xe6, 0x9c, 0x3a, 0xbe, 0x01, 0xa3,
+            0x0c, 0xe5, 0x48, 0xa2, 0x84, 0x74, 0x3a, 0x44,
+            0x5e, 0x36, 0x80, 0xd7, 0xdb, 0x5a, 0xc3, 0xac,
+            0x18, 0xff, 0x9b, 0x53, 0x8d, 0x16, 0xf2, 0x90,
+            0xae, 0x67, 0xf7, 0x60, 0x98, 0x4d, 0xc6, 0x59,
+            0x4a, 0x7c, 0x15, 0xe9, 0x71, 0x6e, 0xd2, 0x8d,
+            0xc0, 0x27, 0xbe, 0xce, 0xea, 0x1e, 0xc4, 0x0a
+        }
+    }
+};
+
+/* The order of the base point, little endian */
+static const uint8_t order[32] = {
+    0xed, 0xd3, 0xf5, 0x5c, 0x1a, 0x63, 0x12, 0x58,
+    0xd6, 0x9c, 0xf7, 0xa2, 0xde, 0xf9, 0xde, 0x14,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10
+};
+
+/* PKCS#8 encoding of an Ed25519 private key, without the key itself */
+static const uint8_t pkcs8_prefix[] = {
+    0x30, 0x2e, 0x02, 0x01, 0x00, 0x30, 0x05, 0x06,
+    0x03, 0x2b, 0x65, 0x70, 0x04, 0x22, 0x04, 0x20
+};
+
+static int test_ed25519_vectors(int idx)
+{
+    const ED25519_TEST *t = &ed25519_tests[idx];
+    uint8_t pub[32], sig[64];
+
+    ED25519_public_from_private(pub, t->priv);
+    if (!TEST_mem_eq(pub, sizeof(pub), t->pub, sizeof(t->pub))
+            || !TEST_true(ED25519_sign(sig, t->msg, t->msglen, t->pub,
+                                       t->priv))
+            || !TEST_mem_eq(sig, sizeof(sig), t->sig, sizeof(t->sig))
+            || !TEST_true(ED25519_verify(t->msg, t->msglen, sig, t->pub)))
+        return 0;
+
+    /* A corrupted signature must not verify */
+    sig[5] ^= 1;
+    return TEST_false(ED25519_verify(t->msg, t->msglen, sig, t->pub));
+}
+
+/* Signatures whose S is not reduced modulo the order must be rejected */
+static int test_ed25519_non_canonical(void)
+{
+    const ED25519_TEST *t = &ed25519_tests[1];
+    uint8_t sig[64];
+    unsigned int carry = 0;
+    size_t i;
+
+    memcpy(sig, t->sig, sizeof(sig));
+    for (i = 0; i < 32; i++) {
+        carry += sig[32 + i] + order[i];
+        sig[32 + i] = (uint8_t)carry;
+        carry >>= 8;
+    }
+    return TEST_false(ED25519_verify(t->msg, t->msglen, sig, t->pub));
+}
+
+/* Sign and verify through EVP, which only supports one-shot operation */
+static int test_ed25519_evp(void)
+{
+    const ED25519_TEST *t = &ed25519_tests[2];
+    uint8_t der[sizeof(pkcs8_prefix) + 32], sig[64];
+    const uint8_t *p = der;
+    size_t siglen = sizeof(sig);
+    EVP_PKEY *pkey = NULL;
+    EVP_MD_CTX *ctx = NULL;
+    int ret = 0;
+
+    memcpy(der, pkcs8_prefix, sizeof(pkcs8_prefix));
+    memcpy(der + sizeof(pkcs8_prefix), t->priv, sizeof(t->priv));
+
+    if (!TEST_ptr(pkey = d2i_AutoPrivateKey(NULL, &p, sizeof(der)))
+            || !TEST_int_eq(EVP_PKEY_id(pkey), EVP_PKEY_ED25519)
+            || !TEST_int_eq(EVP_PKEY_size(pkey), sizeof(sig))
+            || !TEST_ptr(ctx = EVP_MD_CTX_new())
+            || !TEST_true(EVP_DigestSignInit(ctx, NULL, NULL, NULL, pkey))
+            || !TEST_false(EVP_DigestSignUpdate(ctx, t->msg, t->msglen))
+            || !TEST_true(EVP_DigestSign(ctx, sig, &siglen, t->msg,
+                                         t->msglen))
+            || !TEST_mem_eq(sig, siglen, t->sig, sizeof(t->sig))
+            || !TEST_true(EVP_MD_CTX_reset(ctx))
+            || !TEST_true(EVP_DigestVerifyInit(ctx, NULL, NULL, NULL, pkey))
+            || !TEST_int_eq(EVP_DigestVerify(ctx, sig, siglen, t->msg,
+                                             t->msglen), 1))
+        goto err;
+
+    sig[0] ^= 1;
+    if (!TEST_int_le(EVP_DigestVerify(ctx, sig, siglen, t->msg, t->msglen),
+                     0))
+        goto err;
+
+    /* A digest cannot be used with Ed25519 */
+    if (!TEST_true(EVP_MD_CTX_reset(ctx))
+            || !TEST_false(EVP_DigestSignInit(ctx, NULL, EVP_sha256(), NULL,
+                                              pkey)))
+        goto err;
+
+    ret = 1;
+ err:
+    EVP_MD_CTX_free(ctx);
+    EVP_PKEY_free(pkey);
+    return ret;
+}
+
+void register_tests(void)
+{
+    ADD_ALL_TESTS(test_ed25519_vectors, OSSL_NELEM(ed25519_tests));
+    ADD_TEST(test_ed25519_non_canonical);
+    ADD_TEST(test_ed25519_evp);
+}
@@ -9,6 +9,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <openssl/bio.h>
 #include <openssl/crypto.h>
 #include <openssl/err.h>
@@ -296,6 +297,150 @@ static int test_EVP_DigestVerifyInit(void)
     return ret;
 }
 
+/*
+ * Hash a batch of messages whose lengths straddle the padding boundaries
+ * of 64- and 128-byte blocks and compare with one-at-a-time digests.
+ */
+static int test_EVP_Digest_batch(const EVP_MD *md)
+{
+    static const size_t lens[] = {
+        0, 1, 3, 55, 56, 63, 64, 65, 111, 112, 119, 120, 127, 128, 129,
+        200, 255, 256, 1000, 4097
+    };
+    const size_t n = sizeof(lens) / sizeof(lens[0]);
+    unsigned char buf[4097 + 20];
+    const void *data[sizeof(lens) / sizeof(lens[0])];
+    unsigned char *out[sizeof(lens) / sizeof(lens[0])];
+    unsigned char mds[sizeof(lens) / sizeof(lens[0])][EVP_MAX_MD_SIZE];
+    unsigned char ref[EVP_MAX_MD_SIZE];
+    size_t i, m;
+    int ret = 0;
+
+    for (i = 0; i < sizeof(buf); i++)
+        buf[i] = (unsigned char)(i * 7 + 1);
+
+    /* try every batch size to cover partially filled lanes */
+    for (m = 1; m <= n; m++) {
+        for (i = 0; i < m; i++) {
+            data[i] = buf + i;
+            out[i] = mds[i];
+        }
+        if (!EVP_Digest_batch(data, lens, out, m, md, NULL))
+            goto out;
+        for (i = 0; i < m; i++) {
+            if (!EVP_Digest(data[i], lens[i], ref, NULL, md, NULL))
+                goto out;
+            if (memcmp(ref, mds[i], EVP_MD_size(md)) != 0) {
+                fprintf(stderr, "%s batch digest mismatch at %u/%u\n",
+                        OBJ_nid2sn(EVP_MD_type(md)), (unsigned int)i,
+                        (unsigned int)m);
+                goto out;
+            }
+        }
+    }
+    ret = 1;
+
+ out:
+    if (!ret) {
+        ERR_print_errors_fp(stderr);
+    }
+
+    return ret;
+}
+
+/*
+ * Encrypt and decrypt a long message with AES-GCM in chunks of various
+ * sizes, so that the bulk code is entered with a partial block pending and
+ * with a running GHASH, and compare with a single update.
+ */
+static int test_EVP_aes_gcm_chunked(const EVP_CIPHER *cipher)
+{
+    static const size_t splits[][6] = {
+        { 256, 0 },
+        { 1, 256, 0 },
+        { 255, 257, 0 },
+        { 300, 17, 1024, 16, 0 },
+        { 15, 2048, 511, 1, 0 },
+        { 4095, 0 },
+    };
+    static const unsigned char iv[12] = {
+        0xca, 0xfe, 0xba, 0xbe, 0xfa, 0xce, 0xdb, 0xad, 0xde, 0xca, 0xf8, 0x88
+    };
+    unsigned char key[32], aad[20];
+    unsigned char pt[4111], ref[sizeof(pt)], buf[sizeof(pt)];
+    unsigned char reftag[16], tag[16];
+    EVP_CIPHER_CTX *ctx = NULL;
+    size_t i, j, off, n;
+    int outl, ret = 0;
+
+    for (i = 0; i < sizeof(key); i++)
+        key[i] = (unsigned char)(i * 11 + 3);
+    for (i = 0; i < sizeof(aad); i++)
+        aad[i] = (unsigned char)(i * 5 + 2);
+    for (i = 0; i < sizeof(pt); i++)
+        pt[i] = (unsigned char)(i * 7 + 1);
+
+    if ((ctx = EVP_CIPHER_CTX_new()) == NULL
+        || !EVP_EncryptInit_ex(ctx, cipher, NULL, key, iv)
+        || !EVP_EncryptUpdate(ctx, NULL, &outl, aad, sizeof(aad))
+        || !EVP_EncryptUpdate(ctx, ref, &outl, pt, sizeof(pt))
+        || !EVP_EncryptFinal_ex(ctx, ref + outl, &outl)
+        || !EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_GET_TAG, sizeof(reftag),
+                                reftag))
+        goto out;
+
+    for (i = 0; i < sizeof(splits) / sizeof(splits[0]); i++) {
+        /* encrypt in chunks, the last one taking what is left */
+        if (!EVP_EncryptInit_ex(ctx, cipher, NULL, key, iv)
+            || !EVP_EncryptUpdate(ctx, NULL, &outl, aad, sizeof(aad)))
+            goto out;
+        for (off = 0, j = 0; off < sizeof(pt); off += n, j++) {
+            n = splits[i][j] != 0 ? splits[i][j] : sizeof(pt) - off;
+            if (!EVP_EncryptUpdate(ctx, buf + off, &outl, pt + off, (int)n)
+                || (size_t)outl != n)
+                goto out;
+        }
+        if (!EVP_EncryptFinal_ex(ctx, buf + off, &outl)
+            || !EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_GET_TAG, sizeof(tag),
+                                    tag))
+            goto out;
+        if (memcmp(buf, ref, sizeof(ref)) != 0
+            || memcmp(tag, reftag, sizeof(tag)) != 0) {
+            fprintf(stderr, "%s chunked encryption mismatch (split %u)\n",
+                    OBJ_nid2sn(EVP_CIPHER_nid(cipher)), (unsigned int)i);
+            goto out;
+        }
+
+        /* and decrypt the same way */
+        if (!EVP_DecryptInit_ex(ctx, cipher, NULL, key, iv)
+            || !EVP_DecryptUpdate(ctx, NULL, &outl, aad, sizeof(aad)))
+            goto out;
+        for (off = 0, j = 0; off < sizeof(pt); off += n, j++) {
+            n = splits[i][j] != 0 ? splits[i][j] : sizeof(pt) - off;
+            if (!EVP_DecryptUpdate(ctx, buf + off, &outl, ref + off, (int)n)
+                || (size_t)outl != n)
+                goto out;
+        }
+        if (!EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_SET_TAG, sizeof(reftag),
+                                 reftag)
+            || !EVP_DecryptFinal_ex(ctx, buf + off, &outl)
+            || memcmp(buf, pt, sizeof(pt)) != 0) {
+            fprintf(stderr, "%s chunked decryption mismatch (split %u)\n",
+                    OBJ_nid2sn(EVP_CIPHER_nid(cipher)), (unsigned int)i);
+            goto out;
+        }
+    }
+    ret = 1;
+
+ out:
+    if (!ret) {
+        ERR_print_errors_fp(stderr);
+    }
+    EVP_CIPHER_CTX_free(ctx);
+
+    return ret;
+}
+
 static int test_d2i_AutoPrivateKey(const unsigned char *input,
                                    size_t input_len, int expected_id)
 {
@@ -374,6 +519,23 @@ int main(void)
         return 1;
     }
 
+    if (!test_EVP_Digest_batch(EVP_sha1())
+        || !test_EVP_Digest_batch(EVP_sha224())
+        || !test_EVP_Digest_batch(EVP_sha256())
+        || !test_EVP_Digest_batch(EVP_sha384())
+        || !test_EVP_Digest_batch(EVP_sha512())
+        || !test_EVP_Digest_batch(EVP_sha3_256())) {
+        fprintf(stderr, "EVP_Digest_batch failed\n");
+        return 1;
+    }
+
+    if (!test_EVP_aes_gcm_chunked(EVP_aes_128_gcm())
+        || !test_EVP_aes_gcm_chunked(EVP_aes_192_gcm())
+        || !test_EVP_aes_gcm_chunked(EVP_aes_256_gcm())) {
+        fprintf(stderr, "AES-GCM chunked test failed\n");
+        return 1;
+    }
+
     if (!test_d2i_AutoPrivateKey(kExampleRSAKeyDER, sizeof(kExampleRSAKeyDER),
                                  EVP_PKEY_RSA)) {
         fprintf(stderr, "d2i_AutoPrivateKey(kExampleRSAKeyDER) failed\n");
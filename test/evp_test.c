@@ -756,6 +756,7 @@ static int digest_test_run(struct evp_test *t)
     const char *err = "INTERNAL_ERROR";
     EVP_MD_CTX *mctx;
     unsigned char md[EVP_MAX_MD_SIZE];
+    unsigned char *xof = NULL;
     unsigned int md_len;
     mctx = EVP_MD_CTX_new();
     if (!mctx)
@@ -769,6 +770,17 @@ static int digest_test_run(struct evp_test *t)
             goto err;
     }
     err = "DIGESTFINAL_ERROR";
+    if (EVP_MD_flags(mdata->digest) & EVP_MD_FLAG_XOF) {
+        md_len = mdata->output_len;
+        if ((xof = OPENSSL_malloc(md_len)) == NULL
+                || !EVP_DigestFinalXOF(mctx, xof, md_len))
+            goto err;
+        err = "DIGEST_MISMATCH";
+        if (check_output(t, mdata->output, xof, md_len))
+            goto err;
+        err = NULL;
+        goto err;
+    }
     if (!EVP_DigestFinal(mctx, md, &md_len))
         goto err;
     err = "DIGEST_LENGTH_MISMATCH";
@@ -779,6 +791,7 @@ static int digest_test_run(struct evp_test *t)
         goto err;
     err = NULL;
  err:
+    OPENSSL_free(xof);
     EVP_MD_CTX_free(mctx);
     t->err = err;
     return 1;
@@ -1212,6 +1225,20 @@ static int mac_test_init(struct evp_test *t, const char *alg)
 #else
         t->skip = 1;
         return 1;
+#endif
+    } else if (strcmp(alg, "BLAKE2BMAC") == 0) {
+#ifndef OPENSSL_NO_BLAKE2
+        type = EVP_PKEY_BLAKE2BMAC;
+#else
+        t->skip = 1;
+        return 1;
+#endif
+    } else if (strcmp(alg, "BLAKE2SMAC") == 0) {
+#ifndef OPENSSL_NO_BLAKE2
+        type = EVP_PKEY_BLAKE2SMAC;
+#else
+        t->skip = 1;
+        return 1;
 #endif
     } else
         return 0;
@@ -268,6 +268,258 @@ err:
     return ret;
 }
 
+static int test_rsa_sign_batch(int idx)
+{
+    int ret = 0;
+    RSA *key;
+    unsigned char ctext_ex[256];
+    unsigned char msg[4][20];
+    unsigned char sig[4][256], sig_ex[256], ptext[256];
+    const unsigned char *from[4];
+    unsigned char *to[4];
+    int flen[4], tlen[4];
+    int clen, num;
+    size_t i;
+
+    clen = rsa_setkey(&key, ctext_ex, idx);
+
+    for (i = 0; i < OSSL_NELEM(msg); i++) {
+        memset(msg[i], (int)i + 1, sizeof(msg[i]));
+        from[i] = msg[i];
+        to[i] = sig[i];
+        flen[i] = (int)sizeof(msg[i]) - (int)i;
+    }
+
+    if (!TEST_int_eq(RSA_private_encrypt_batch(OSSL_NELEM(msg), flen, from,
+                                               to, tlen, key,
+                                               RSA_PKCS1_PADDING), 1))
+        goto err;
+
+    /* Every batched signature must match its one-at-a-time counterpart */
+    for (i = 0; i < OSSL_NELEM(msg); i++) {
+        num = RSA_private_encrypt(flen[i], from[i], sig_ex, key,
+                                  RSA_PKCS1_PADDING);
+        if (!TEST_int_eq(tlen[i], clen)
+                || !TEST_mem_eq(sig[i], tlen[i], sig_ex, num))
+            goto err;
+        num = RSA_public_decrypt(clen, sig[i], ptext, key, RSA_PKCS1_PADDING);
+        if (!TEST_mem_eq(ptext, num, from[i], flen[i]))
+            goto err;
+    }
+
+    /* An input too long to pad fails on its own without affecting others */
+    flen[1] = clen;
+    if (!TEST_int_eq(RSA_private_encrypt_batch(OSSL_NELEM(msg), flen, from,
+                                               to, tlen, key,
+                                               RSA_PKCS1_PADDING), 0)
+        || !TEST_int_eq(tlen[1], -1)
+        || !TEST_int_eq(tlen[2], clen)
+        || !TEST_int_eq(RSA_public_decrypt(clen, sig[2], ptext, key,
+                                           RSA_PKCS1_PADDING), flen[2]))
+        goto err;
+    ERR_clear_error();
+
+    ret = 1;
+err:
+    RSA_free(key);
+    return ret;
+}
+
+static int test_rsa_verify_batch(int idx)
+{
+    int ret = 0;
+    RSA *key, *badkey = NULL;
+    const BIGNUM *n;
+    unsigned char ctext_ex[256];
+    unsigned char msg[4][20];
+    unsigned char sig[4][256], ptext[4][256];
+    const unsigned char *from[4];
+    unsigned char *to[4];
+    int flen[4], tlen[4];
+    int clen;
+    size_t i;
+
+    clen = rsa_setkey(&key, ctext_ex, idx);
+
+    for (i = 0; i < OSSL_NELEM(msg); i++) {
+        memset(msg[i], (int)i + 1, sizeof(msg[i]));
+        if (!TEST_int_eq(RSA_private_encrypt(sizeof(msg[i]) - i, msg[i],
+                                             sig[i], key, RSA_PKCS1_PADDING),
+                         clen))
+            goto err;
+        from[i] = sig[i];
+        to[i] = ptext[i];
+        flen[i] = clen;
+    }
+
+    if (!TEST_int_eq(RSA_public_decrypt_batch(OSSL_NELEM(msg), flen, from, to,
+                                              tlen, key, RSA_PKCS1_PADDING),
+                     1))
+        goto err;
+    for (i = 0; i < OSSL_NELEM(msg); i++) {
+        if (!TEST_mem_eq(ptext[i], tlen[i], msg[i], sizeof(msg[i]) - i))
+            goto err;
+    }
+
+    /* A bad signature fails on its own without affecting the others */
+    sig[2][clen - 1] ^= 1;
+    if (!TEST_int_eq(RSA_public_decrypt_batch(OSSL_NELEM(msg), flen, from, to,
+                                              tlen, key, RSA_PKCS1_PADDING),
+                     0)
+        || !TEST_int_eq(tlen[2], -1)
+        || !TEST_mem_eq(ptext[3], tlen[3], msg[3], sizeof(msg[3]) - 3))
+        goto err;
+    ERR_clear_error();
+
+    /* A key that cannot be used at all fails every entry */
+    RSA_get0_key(key, &n, NULL, NULL);
+    if (!TEST_ptr(badkey = RSA_new())
+        || !TEST_true(RSA_set0_key(badkey, BN_dup(n), BN_dup(n), NULL)))
+        goto err;
+    for (i = 0; i < OSSL_NELEM(msg); i++)
+        tlen[i] = 0;
+    if (!TEST_int_eq(RSA_public_decrypt_batch(OSSL_NELEM(msg), flen, from, to,
+                                              tlen, badkey,
+                                              RSA_PKCS1_PADDING), 0))
+        goto err;
+    for (i = 0; i < OSSL_NELEM(msg); i++) {
+        if (!TEST_int_eq(tlen[i], -1))
+            goto err;
+    }
+    ERR_clear_error();
+
+    ret = 1;
+err:
+    RSA_free(badkey);
+    RSA_free(key);
+    return ret;
+}
+
+/*
+ * With the exponent 65537 the batch raises the signatures to e two at a
+ * time.  An odd count leaves one for the single path, and an input that
+ * cannot be loaded sends its pair back to the single path as well.
+ */
+static int test_rsa_verify_batch_f4(void)
+{
+    int ret = 0;
+    RSA *key = NULL;
+    BIGNUM *e = NULL;
+    unsigned char msg[5][20];
+    unsigned char sig[5][256], ptext[5][256];
+    const unsigned char *from[5];
+    unsigned char *to[5];
+    int flen[5], tlen[5];
+    int clen;
+    size_t i;
+
+    if (!TEST_ptr(e = BN_new())
+            || !TEST_true(BN_set_word(e, RSA_F4))
+            || !TEST_ptr(key = RSA_new())
+            || !TEST_true(RSA_generate_key_ex(key, 2048, e, NULL)))
+        goto err;
+    clen = RSA_size(key);
+
+    for (i = 0; i < OSSL_NELEM(msg); i++) {
+        memset(msg[i], (int)i + 1, sizeof(msg[i]));
+        if (!TEST_int_eq(RSA_private_encrypt(sizeof(msg[i]) - i, msg[i],
+                                             sig[i], key, RSA_PKCS1_PADDING),
+                         clen))
+            goto err;
+        from[i] = sig[i];
+        to[i] = ptext[i];
+        flen[i] = clen;
+    }
+
+    if (!TEST_int_eq(RSA_public_decrypt_batch(OSSL_NELEM(msg), flen, from, to,
+                                              tlen, key, RSA_PKCS1_PADDING),
+                     1))
+        goto err;
+    for (i = 0; i < OSSL_NELEM(msg); i++) {
+        if (!TEST_mem_eq(ptext[i], tlen[i], msg[i], sizeof(msg[i]) - i))
+            goto err;
+    }
+
+    /* A bad signature fails on its own, also when paired with a good one */
+    sig[1][clen - 1] ^= 1;
+    flen[2] = clen + 1;
+    if (!TEST_int_eq(RSA_public_decrypt_batch(OSSL_NELEM(msg), flen, from, to,
+                                              tlen, key, RSA_PKCS1_PADDING),
+                     0)
+        || !TEST_mem_eq(ptext[0], tlen[0], msg[0], sizeof(msg[0]))
+        || !TEST_int_eq(tlen[1], -1)
+        || !TEST_int_eq(tlen[2], -1)
+        || !TEST_mem_eq(ptext[3], tlen[3], msg[3], sizeof(msg[3]) - 3)
+        || !TEST_mem_eq(ptext[4], tlen[4], msg[4], sizeof(msg[4]) - 4))
+        goto err;
+    ERR_clear_error();
+
+    ret = 1;
+err:
+    RSA_free(key);
+    BN_free(e);
+    return ret;
+}
+
+/*
+ * Fresh copies of a key pick up the cached Montgomery context of the
+ * modulus.  With room for one or two moduli, alternating between two keys
+ * exercises both eviction and cache hits.
+ */
+static int test_rsa_mont_cache(int idx)
+{
+    /*
+     * Two keys are used in turn, so a cache of one modulus never hits and
+     * one of two moduli hits for all but the first use of each.
+     */
+    static const struct {
+        size_t size;
+        unsigned long hits, misses;
+    } params[] = {
+        { 1, 0, 4 },
+        { 2, 2, 2 }
+    };
+    static unsigned char ptext_ex[] = "\x54\x85\x9b\x34\x2c\x49\xea\x2a";
+    int ret = 0, plen = sizeof(ptext_ex) - 1, clen, num, round;
+    RSA *key = NULL;
+    unsigned char ctext_ex[256], ctext[256], ptext[256];
+    size_t size = BN_MONT_CTX_get_cache_size(), i;
+    uint64_t hits, misses, hits2, misses2;
+
+    for (i = 0; i < OSSL_NELEM(params); i++) {
+        /* Start from an empty cache */
+        if (!TEST_true(BN_MONT_CTX_set_cache_size(0))
+            || !TEST_true(BN_MONT_CTX_set_cache_size(params[i].size))
+            || !TEST_size_t_eq(BN_MONT_CTX_get_cache_size(), params[i].size))
+            goto err;
+        BN_MONT_CTX_get_cache_stats(&hits, &misses);
+        for (round = 0; round < 4; round++) {
+            clen = rsa_setkey(&key, ctext_ex, (idx + round % 2) % 3);
+            num = RSA_public_encrypt(plen, ptext_ex, ctext, key,
+                                     RSA_PKCS1_PADDING);
+            if (!TEST_int_eq(num, clen))
+                goto err;
+            num = RSA_private_decrypt(num, ctext, ptext, key,
+                                      RSA_PKCS1_PADDING);
+            if (!TEST_mem_eq(ptext, num, ptext_ex, plen))
+                goto err;
+            RSA_free(key);
+            key = NULL;
+        }
+        BN_MONT_CTX_get_cache_stats(&hits2, &misses2);
+        if (!TEST_ulong_eq((unsigned long)(hits2 - hits), params[i].hits)
+            || !TEST_ulong_eq((unsigned long)(misses2 - misses),
+                              params[i].misses))
+            goto err;
+    }
+
+    ret = 1;
+err:
+    BN_MONT_CTX_set_cache_size(size);
+    RSA_free(key);
+    return ret;
+}
+
 static int test_rsa_oaep(int idx)
 {
     int ret = 0;
@@ -329,9 +581,185 @@ err:
     return ret;
 }
 
+static const struct {
+    int bits, primes;
+} mp_params[] = {
+    { 1024, 3 },
+    { 3072, 3 },
+    { 4096, 4 },
+};
+
+static int test_rsa_multi_prime(int idx)
+{
+    int ret = 0, bits = mp_params[idx].bits, primes = mp_params[idx].primes;
+    int i, ex_primes = primes - 2, num;
+    RSA *key = NULL, *key2 = NULL, *key3 = NULL;
+    BIGNUM *e = NULL;
+    const BIGNUM *n, *pe, *d, *p, *q, *dmp1, *dmq1, *iqmp;
+    const BIGNUM *r[RSA_MAX_PRIME_NUM], *dr[RSA_MAX_PRIME_NUM];
+    const BIGNUM *tr[RSA_MAX_PRIME_NUM];
+    BIGNUM *r2[RSA_MAX_PRIME_NUM] = { NULL };
+    BIGNUM *dr2[RSA_MAX_PRIME_NUM] = { NULL };
+    BIGNUM *tr2[RSA_MAX_PRIME_NUM] = { NULL };
+    unsigned char msg[20], sig[512], sig2[512], ptext[512];
+    unsigned char *der = NULL;
+    const unsigned char *pder;
+    int derlen, siglen;
+
+    memset(msg, 0xa5, sizeof(msg));
+
+    if (!TEST_ptr(e = BN_new())
+            || !TEST_true(BN_set_word(e, RSA_F4))
+            || !TEST_ptr(key = RSA_new())
+            || !TEST_false(RSA_generate_multi_prime_key(key, bits,
+                                                        RSA_MAX_PRIME_NUM + 1,
+                                                        e, NULL))
+            || !TEST_true(RSA_generate_multi_prime_key(key, bits, primes, e,
+                                                       NULL))
+            || !TEST_int_eq(RSA_bits(key), bits)
+            || !TEST_int_eq(RSA_get_version(key), RSA_ASN1_VERSION_MULTI)
+            || !TEST_int_eq(RSA_get_multi_prime_extra_count(key), ex_primes)
+            || !TEST_int_eq(RSA_check_key(key), 1))
+        goto err;
+
+    /* the CRT over all primes must agree with the public operation */
+    siglen = RSA_private_encrypt(sizeof(msg), msg, sig, key,
+                                 RSA_PKCS1_PADDING);
+    if (!TEST_int_eq(siglen, bits / 8))
+        goto err;
+    num = RSA_public_decrypt(siglen, sig, ptext, key, RSA_PKCS1_PADDING);
+    if (!TEST_mem_eq(ptext, num, msg, sizeof(msg)))
+        goto err;
+
+    /* OtherPrimeInfos survive an encoding round trip */
+    derlen = i2d_RSAPrivateKey(key, &der);
+    pder = der;
+    if (!TEST_int_gt(derlen, 0)
+            || !TEST_ptr(key2 = d2i_RSAPrivateKey(NULL, &pder, derlen))
+            || !TEST_int_eq(RSA_get_multi_prime_extra_count(key2), ex_primes)
+            || !TEST_int_eq(RSA_check_key(key2), 1))
+        goto err;
+    num = RSA_private_encrypt(sizeof(msg), msg, sig2, key2,
+                              RSA_PKCS1_PADDING);
+    if (!TEST_mem_eq(sig2, num, sig, siglen))
+        goto err;
+
+    /* and so do they when set through the accessors */
+    RSA_get0_key(key, &n, &pe, &d);
+    RSA_get0_factors(key, &p, &q);
+    RSA_get0_crt_params(key, &dmp1, &dmq1, &iqmp);
+    if (!TEST_true(RSA_get0_multi_prime_factors(key, r))
+            || !TEST_true(RSA_get0_multi_prime_crt_params(key, dr, tr))
+            || !TEST_ptr(key3 = RSA_new())
+            || !TEST_true(RSA_set0_key(key3, BN_dup(n), BN_dup(pe),
+                                       BN_dup(d)))
+            || !TEST_true(RSA_set0_factors(key3, BN_dup(p), BN_dup(q)))
+            || !TEST_true(RSA_set0_crt_params(key3, BN_dup(dmp1),
+                                              BN_dup(dmq1), BN_dup(iqmp))))
+        goto err;
+    for (i = 0; i < ex_primes; i++) {
+        if (!TEST_ptr(r2[i] = BN_dup(r[i]))
+                || !TEST_ptr(dr2[i] = BN_dup(dr[i]))
+                || !TEST_ptr(tr2[i] = BN_dup(tr[i])))
+            goto err;
+    }
+    if (!TEST_true(RSA_set0_multi_prime_params(key3, r2, dr2, tr2,
+                                               ex_primes)))
+        goto err;
+    for (i = 0; i < ex_primes; i++)
+        r2[i] = dr2[i] = tr2[i] = NULL;
+    num = RSA_private_encrypt(sizeof(msg), msg, sig2, key3,
+                              RSA_PKCS1_PADDING);
+    if (!TEST_mem_eq(sig2, num, sig, siglen)
+            || !TEST_int_eq(RSA_check_key(key3), 1))
+        goto err;
+
+    ret = 1;
+err:
+    for (i = 0; i < ex_primes; i++) {
+        BN_free(r2[i]);
+        BN_free(dr2[i]);
+        BN_free(tr2[i]);
+    }
+    OPENSSL_free(der);
+    RSA_free(key);
+    RSA_free(key2);
+    RSA_free(key3);
+    BN_free(e);
+    return ret;
+}
+
+/*
+ * Counts the primes regenerated since the last one was accepted and gives
+ * up once key generation is clearly stuck.
+ */
+static int mp_keygen_cb(int p, int n, BN_GENCB *cb)
+{
+    int *retries = BN_GENCB_get_arg(cb);
+
+    if (p == 2 && ++*retries > 100)
+        return 0;
+    if (p == 3)
+        *retries = 0;
+    return 1;
+}
+
+/*
+ * With more than two primes the product can come out too short for any
+ * last prime to make up, which must not keep key generation looping.
+ */
+static const struct {
+    int bits, primes, count;
+} mp_keygen_params[] = {
+    { 4096, 4, 50 },
+    { 8192, 5, 5 },
+};
+
+static int test_rsa_multi_prime_keygen(int idx)
+{
+    int ret = 0, retries, i;
+    int bits = mp_keygen_params[idx].bits;
+    int primes = mp_keygen_params[idx].primes;
+    RSA *key = NULL;
+    BIGNUM *e = NULL;
+    BN_GENCB *cb = NULL;
+
+    if (!TEST_ptr(e = BN_new())
+            || !TEST_true(BN_set_word(e, RSA_F4))
+            || !TEST_ptr(cb = BN_GENCB_new()))
+        goto err;
+    BN_GENCB_set(cb, mp_keygen_cb, &retries);
+
+    for (i = 0; i < mp_keygen_params[idx].count; i++) {
+        retries = 0;
+        if (!TEST_ptr(key = RSA_new())
+                || !TEST_true(RSA_generate_multi_prime_key(key, bits, primes,
+                                                           e, cb))
+                || !TEST_int_eq(RSA_bits(key), bits)
+                || !TEST_int_eq(RSA_get_multi_prime_extra_count(key),
+                                primes - 2))
+            goto err;
+        RSA_free(key);
+        key = NULL;
+    }
+
+    ret = 1;
+err:
+    RSA_free(key);
+    BN_GENCB_free(cb);
+    BN_free(e);
+    return ret;
+}
+
 void register_tests(void)
 {
     ADD_ALL_TESTS(test_rsa_pkcs1, 3);
     ADD_ALL_TESTS(test_rsa_oaep, 3);
+    ADD_ALL_TESTS(test_rsa_sign_batch, 3);
+    ADD_ALL_TESTS(test_rsa_verify_batch, 3);
+    ADD_TEST(test_rsa_verify_batch_f4);
+    ADD_ALL_TESTS(test_rsa_mont_cache, 3);
+    ADD_ALL_TESTS(test_rsa_multi_prime, OSSL_NELEM(mp_params));
+    ADD_ALL_TESTS(test_rsa_multi_prime_keygen, OSSL_NELEM(mp_keygen_params));
 }
 #endif
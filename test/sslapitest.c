@@ -19,6 +19,7 @@
 #include "testutil.h"
 #include "test_main_custom.h"
 #include "e_os.h"
+#include "../ssl/ssl_locl.h"
 
 static char *cert = NULL;
 static char *privkey = NULL;
@@ -675,6 +676,139 @@ static int test_large_message_dtls(void)
 }
 #endif
 
+static int handshake_state_released(SSL *s)
+{
+    return s->s3->handshake_buffer == NULL && s->s3->handshake_dgst == NULL
+#if !defined(OPENSSL_NO_EC) || !defined(OPENSSL_NO_DH)
+        && s->s3->tmp.pkey == NULL
+#endif
+        && s->s3->tmp.pms == NULL;
+}
+
+#ifndef OPENSSL_NO_TLS1_3
+/* Reads one byte, going past any post-handshake messages on the way */
+static int read_one_byte(SSL *s)
+{
+    unsigned char buf[1];
+    int i, ret;
+
+    for (i = 0; i < 5; i++) {
+        if ((ret = SSL_read(s, buf, sizeof(buf))) == 1)
+            return 1;
+        if (SSL_get_error(s, ret) != SSL_ERROR_WANT_READ)
+            break;
+    }
+    return 0;
+}
+#endif
+
+/*
+ * Exchanges handshake messages over an established connection: KeyUpdates
+ * with TLSv1.3, a renegotiation otherwise.
+ */
+static int post_handshake_exchange(SSL *clientssl, SSL *serverssl)
+{
+    unsigned char buf[1];
+
+#ifndef OPENSSL_NO_TLS1_3
+    if (SSL_version(clientssl) == TLS1_3_VERSION) {
+        return SSL_key_update(clientssl, SSL_KEY_UPDATE_REQUESTED)
+            && SSL_write(clientssl, "a", 1) == 1
+            && read_one_byte(serverssl)
+            && SSL_write(serverssl, "b", 1) == 1
+            && read_one_byte(clientssl);
+    }
+#endif
+    /* The server only sees the new ClientHello when it next reads */
+    if (!SSL_renegotiate(clientssl)
+        || SSL_do_handshake(clientssl) > 0
+        || SSL_read(serverssl, buf, sizeof(buf)) > 0)
+        return 0;
+    return create_ssl_connection(serverssl, clientssl, SSL_ERROR_NONE);
+}
+
+/*
+ * Check that an established connection gives back its handshake-only state,
+ * that it does not grow again with post-handshake messages, and that the
+ * record buffers are released when SSL_MODE_RELEASE_BUFFERS is set.  Also
+ * check that SSL_get_memory_usage() sees all of this.
+ */
+static int test_ssl_memory_usage(void)
+{
+    SSL_CTX *cctx = NULL, *sctx = NULL;
+    SSL *clientssl = NULL, *serverssl = NULL;
+    size_t before, full, released;
+    int testresult = 0, i;
+
+    if (!create_ssl_ctx_pair(TLS_server_method(), TLS_client_method(), &sctx,
+                             &cctx, cert, privkey)) {
+        printf("Unable to create SSL_CTX pair\n");
+        goto end;
+    }
+
+    if (!create_ssl_objects(sctx, cctx, &serverssl, &clientssl, NULL, NULL)) {
+        printf("Unable to create SSL objects\n");
+        goto end;
+    }
+    before = SSL_get_memory_usage(serverssl);
+
+    if (!create_ssl_connection(serverssl, clientssl, SSL_ERROR_NONE)) {
+        printf("Unable to create SSL connection\n");
+        goto end;
+    }
+    full = SSL_get_memory_usage(serverssl);
+    if (full <= before) {
+        printf("Memory usage did not grow during handshake\n");
+        goto end;
+    }
+    if (!handshake_state_released(serverssl)
+        || !handshake_state_released(clientssl)) {
+        printf("Handshake state not released\n");
+        goto end;
+    }
+
+    for (i = 0; i < 3; i++) {
+        if (!post_handshake_exchange(clientssl, serverssl)) {
+            printf("Post-handshake exchange failed\n");
+            goto end;
+        }
+        if (!handshake_state_released(serverssl)
+            || !handshake_state_released(clientssl)
+            || SSL_get_memory_usage(serverssl) > full) {
+            printf("Memory usage grew after post-handshake messages\n");
+            goto end;
+        }
+    }
+
+    SSL_free(serverssl);
+    SSL_free(clientssl);
+    serverssl = clientssl = NULL;
+
+    SSL_CTX_set_mode(sctx, SSL_MODE_RELEASE_BUFFERS);
+    if (!create_ssl_objects(sctx, cctx, &serverssl, &clientssl, NULL, NULL)) {
+        printf("Unable to create SSL objects\n");
+        goto end;
+    }
+    if (!create_ssl_connection(serverssl, clientssl, SSL_ERROR_NONE)) {
+        printf("Unable to create SSL connection\n");
+        goto end;
+    }
+    released = SSL_get_memory_usage(serverssl);
+    if (released >= full) {
+        printf("Memory usage not reduced by SSL_MODE_RELEASE_BUFFERS\n");
+        goto end;
+    }
+
+    testresult = 1;
+ end:
+    SSL_free(serverssl);
+    SSL_free(clientssl);
+    SSL_CTX_free(sctx);
+    SSL_CTX_free(cctx);
+
+    return testresult;
+}
+
 #ifndef OPENSSL_NO_OCSP
 static int ocsp_server_cb(SSL *s, void *arg)
 {
@@ -1537,6 +1671,69 @@ static int test_set_sigalgs(int idx)
     return testresult;
 }
 
+static int test_anti_replay(void)
+{
+    SSL_ANTI_REPLAY *ar = NULL;
+    SSL_CTX *ctx = NULL;
+    unsigned char id[SSL3_RANDOM_SIZE];
+    size_t i, accepted = 0;
+    int testresult = 0;
+
+    ar = SSL_ANTI_REPLAY_new(64, 0);
+    ctx = SSL_CTX_new(TLS_server_method());
+    if (ar == NULL || ctx == NULL) {
+        printf("Unable to create anti-replay store\n");
+        goto end;
+    }
+
+    /* The first sighting of an identifier is accepted, later ones are not */
+    memset(id, 0, sizeof(id));
+    if (!SSL_ANTI_REPLAY_check(ar, id, sizeof(id))
+            || SSL_ANTI_REPLAY_check(ar, id, sizeof(id))) {
+        printf("Replayed identifier was not detected\n");
+        goto end;
+    }
+    id[0] = 1;
+    if (!SSL_ANTI_REPLAY_check(ar, id, sizeof(id))) {
+        printf("Fresh identifier was rejected\n");
+        goto end;
+    }
+
+    /* Once full the store must refuse rather than forget identifiers */
+    for (i = 0; i < 1000; i++) {
+        id[1] = (unsigned char)(i >> 8);
+        id[2] = (unsigned char)i;
+        accepted += SSL_ANTI_REPLAY_check(ar, id, sizeof(id));
+    }
+    if (accepted == 0 || accepted > 64) {
+        printf("Unexpected number of identifiers accepted: %lu\n",
+               (unsigned long)accepted);
+        goto end;
+    }
+
+    /* The SSL_CTX holds its own reference */
+    if (!SSL_CTX_set1_anti_replay(ctx, ar)
+            || SSL_CTX_get0_anti_replay(ctx) != ar) {
+        printf("Unable to set anti-replay store\n");
+        goto end;
+    }
+    SSL_ANTI_REPLAY_free(ar);
+    ar = NULL;
+    memset(id, 0, sizeof(id));
+    if (SSL_ANTI_REPLAY_check(SSL_CTX_get0_anti_replay(ctx), id, sizeof(id))) {
+        printf("Replayed identifier was not detected (2)\n");
+        goto end;
+    }
+
+    testresult = 1;
+
+ end:
+    SSL_ANTI_REPLAY_free(ar);
+    SSL_CTX_free(ctx);
+
+    return testresult;
+}
+
 #ifndef OPENSSL_NO_TLS1_3
 
 #define MSG1    "Hello"
@@ -1957,6 +2154,86 @@ static int test_early_data_skip(int idx)
     return testresult;
 }
 
+/*
+ * Test that a server with an anti-replay store rejects the early data from a
+ * ClientHello that it has already seen
+ */
+static int test_early_data_replay(int idx)
+{
+    SSL_CTX *cctx = NULL, *sctx = NULL;
+    SSL *clientssl = NULL, *serverssl = NULL, *replayssl = NULL;
+    SSL_ANTI_REPLAY *ar = NULL;
+    BIO *rbio = NULL, *wbio = NULL;
+    int testresult = 0;
+    SSL_SESSION *sess = NULL;
+    unsigned char buf[20];
+    char *data;
+    long len;
+    size_t readbytes, written;
+
+    if (!setupearly_data_test(&cctx, &sctx, &clientssl, &serverssl, &sess, idx))
+        goto end;
+
+    ar = SSL_ANTI_REPLAY_new(1024, 0);
+    if (ar == NULL || !SSL_CTX_set1_anti_replay(sctx, ar)) {
+        printf("Unable to set anti-replay store\n");
+        goto end;
+    }
+
+    if (!SSL_write_early_data(clientssl, MSG1, strlen(MSG1), &written)
+            || written != strlen(MSG1)) {
+        printf("Failed writing early data message 1\n");
+        goto end;
+    }
+
+    /* Take a copy of the ClientHello and early data as an attacker would */
+    len = BIO_get_mem_data(SSL_get_wbio(clientssl), &data);
+    rbio = BIO_new_mem_buf(data, (int)len);
+    wbio = BIO_new(BIO_s_mem());
+    replayssl = SSL_new(sctx);
+    if (len <= 0 || rbio == NULL || wbio == NULL || replayssl == NULL) {
+        printf("Unable to set up replay\n");
+        goto end;
+    }
+    SSL_set_bio(replayssl, rbio, wbio);
+    rbio = wbio = NULL;
+
+    if (SSL_read_early_data(serverssl, buf, sizeof(buf), &readbytes)
+                != SSL_READ_EARLY_DATA_SUCCESS
+            || readbytes != strlen(MSG1)
+            || memcmp(MSG1, buf, strlen(MSG1))
+            || SSL_get_early_data_status(serverssl) != SSL_EARLY_DATA_ACCEPTED) {
+        printf("Failed reading early data message 1\n");
+        goto end;
+    }
+
+    /* The same ClientHello a second time must not get its early data in */
+    if (SSL_read_early_data(replayssl, buf, sizeof(buf), &readbytes)
+                == SSL_READ_EARLY_DATA_SUCCESS
+            || SSL_get_early_data_status(replayssl) != SSL_EARLY_DATA_REJECTED) {
+        printf("Replayed early data was not rejected\n");
+        goto end;
+    }
+    ERR_clear_error();
+
+    testresult = 1;
+
+ end:
+    if(!testresult)
+        ERR_print_errors_fp(stdout);
+    BIO_free(rbio);
+    BIO_free(wbio);
+    SSL_ANTI_REPLAY_free(ar);
+    SSL_SESSION_free(sess);
+    SSL_free(replayssl);
+    SSL_free(serverssl);
+    SSL_free(clientssl);
+    SSL_CTX_free(sctx);
+    SSL_CTX_free(cctx);
+
+    return testresult;
+}
+
 static int test_early_data_not_sent(int idx)
 {
     SSL_CTX *cctx = NULL, *sctx = NULL;
@@ -2574,6 +2851,7 @@ int test_main(int argc, char *argv[])
 #ifndef OPENSSL_NO_DTLS
     ADD_TEST(test_large_message_dtls);
 #endif
+    ADD_TEST(test_ssl_memory_usage);
 #ifndef OPENSSL_NO_OCSP
     ADD_TEST(test_tlsext_status_type);
 #endif
@@ -2587,6 +2865,7 @@ int test_main(int argc, char *argv[])
     ADD_TEST(test_ssl_bio_change_wbio);
     ADD_ALL_TESTS(test_set_sigalgs, OSSL_NELEM(testsigalgs) * 2);
     ADD_TEST(test_keylog);
+    ADD_TEST(test_anti_replay);
 #ifndef OPENSSL_NO_TLS1_3
     ADD_TEST(test_keylog_no_master_key);
 #endif
@@ -2596,6 +2875,7 @@ int test_main(int argc, char *argv[])
 #ifndef OPENSSL_NO_TLS1_3
     ADD_ALL_TESTS(test_early_data_read_write, 2);
     ADD_ALL_TESTS(test_early_data_skip, 2);
+    ADD_ALL_TESTS(test_early_data_replay, 2);
     ADD_ALL_TESTS(test_early_data_not_sent, 2);
     ADD_ALL_TESTS(test_early_data_not_expected, 2);
 # ifndef OPENSSL_NO_TLS1_2
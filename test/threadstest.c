@@ -11,7 +11,10 @@
 # include <windows.h>
 #endif
 
+#include <string.h>
 #include <openssl/crypto.h>
+#include <openssl/bn.h>
+#include <openssl/rsa.h>
 #include "test_main.h"
 #include "testutil.h"
 
@@ -185,9 +188,114 @@ static int test_thread_local(void)
     return 1;
 }
 
+static void bn_ctx_cache_shrink_thread_cb(void)
+{
+    BN_CTX_set_cache_size(1);
+}
+
+static int test_bn_ctx_cache_shrink(void)
+{
+    size_t size = BN_CTX_get_cache_size();
+    BN_CTX *c[3] = { NULL, NULL, NULL };
+    uint64_t hits, misses, hits2, misses2;
+    thread_t thread;
+    int i, ret = 0;
+
+    if (!TEST_true(BN_CTX_set_cache_size(3)))
+        goto err;
+    for (i = 0; i < 3; i++)
+        if (!TEST_ptr(c[i] = BN_CTX_new()))
+            goto err;
+
+    /* Leave two contexts in this thread's cache and shrink it elsewhere */
+    BN_CTX_free(c[0]);
+    BN_CTX_free(c[1]);
+    c[0] = c[1] = NULL;
+    if (!TEST_true(run_thread(&thread, bn_ctx_cache_shrink_thread_cb))
+        || !TEST_true(wait_for_thread(thread)))
+        goto err;
+
+    /* The next free here trims the cache down to one context */
+    BN_CTX_free(c[2]);
+    c[2] = NULL;
+    BN_CTX_get_cache_stats(&hits, &misses);
+    for (i = 0; i < 2; i++)
+        if (!TEST_ptr(c[i] = BN_CTX_new()))
+            goto err;
+    BN_CTX_get_cache_stats(&hits2, &misses2);
+    if (!TEST_true(hits2 == hits + 1)
+        || !TEST_true(misses2 == misses + 1))
+        goto err;
+
+    ret = 1;
+ err:
+    for (i = 0; i < 3; i++)
+        BN_CTX_free(c[i]);
+    BN_CTX_set_cache_size(size);
+    return ret;
+}
+
+#ifndef OPENSSL_NO_RSA
+static RSA *shared_rsa = NULL;
+static unsigned char shared_sig[128];
+static int shared_rsa_thread_cb_ok = 0;
+
+static const unsigned char shared_msg[] = "shared RSA key, private blinding";
+
+static void shared_rsa_thread_cb(void)
+{
+    unsigned char sig[sizeof(shared_sig)];
+    int i;
+
+    /* Repeat enough times to have the blinding refreshed in this thread */
+    for (i = 0; i < 40; i++) {
+        if (!TEST_int_eq(RSA_private_encrypt(sizeof(shared_msg), shared_msg,
+                                             sig, shared_rsa,
+                                             RSA_PKCS1_PADDING),
+                         (int)sizeof(sig))
+            || !TEST_mem_eq(sig, sizeof(sig), shared_sig, sizeof(shared_sig)))
+            return;
+    }
+    shared_rsa_thread_cb_ok = 1;
+}
+
+static int test_rsa_shared_key(void)
+{
+    thread_t thread;
+    BIGNUM *e = BN_new();
+    int ret = 0;
+
+    shared_rsa = RSA_new();
+    if (!TEST_ptr(e)
+        || !TEST_ptr(shared_rsa)
+        || !TEST_true(BN_set_word(e, RSA_F4))
+        || !TEST_true(RSA_generate_key_ex(shared_rsa, 1024, e, NULL))
+        || !TEST_int_eq(RSA_private_encrypt(sizeof(shared_msg), shared_msg,
+                                            shared_sig, shared_rsa,
+                                            RSA_PKCS1_PADDING),
+                        (int)sizeof(shared_sig)))
+        goto err;
+
+    if (!TEST_true(run_thread(&thread, shared_rsa_thread_cb))
+        || !TEST_true(wait_for_thread(thread))
+        || !TEST_int_eq(shared_rsa_thread_cb_ok, 1))
+        goto err;
+
+    ret = 1;
+ err:
+    RSA_free(shared_rsa);
+    BN_free(e);
+    return ret;
+}
+#endif
+
 void register_tests(void)
 {
     ADD_TEST(test_lock);
     ADD_TEST(test_once);
     ADD_TEST(test_thread_local);
+    ADD_TEST(test_bn_ctx_cache_shrink);
+#ifndef OPENSSL_NO_RSA
+    ADD_TEST(test_rsa_shared_key);
+#endif
 }
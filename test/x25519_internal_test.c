@@ -0,0 +1,167 @@
+/*
+ * Copyright 2017 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the OpenSSL license (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+/*
+ * Internal tests for X25519. The field arithmetic used for the Montgomery
+ * ladder depends on the platform, so results are also checked against the
+ * Edwards curve code used by X25519_public_from_private().
+ */
+
+#include <string.h>
+#include <openssl/rand.h>
+#include "test_main.h"
+#include "testutil.h"
+#include "../crypto/ec/ec_lcl.h"
+
+#define NUM_RANDOM_TESTS    64
+
+/* Test vectors from RFC 7748, section 5.2 */
+static const uint8_t scalar1[32] = {
+    0xa5, 0x46, 0xe3, 0x6b, 0xf0, 0x52, 0x7c, 0x9d,
+    0x3b, 0x16, 0x15, 0x4b, 0x82, 0x46, 0x5e, 0xdd,
+    0x62, 0x14, 0x4c, 0x0a, 0xc1, 0xfc, 0x5a, 0x18,
+    0x50, 0x6a, 0x22, 0x44, 0xba, 0x44, 0x9a, 0xc4
+};
+
+static const uint8_t u1[32] = {
+    0xe6, 0xdb, 0x68, 0x67, 0x58, 0x30, 0x30, 0xdb,
+    0x35, 0x94, 0xc1, 0xa4, 0x24, 0xb1, 0x5f, 0x7c,
+    0x72, 0x66, 0x24, 0xec, 0x26, 0xb3, 0x35, 0x3b,
+    0x10, 0xa9, 0x03, 0xa6, 0xd0, 0xab, 0x1c, 0x4c
+};
+
+static const uint8_t out1[32] = {
+    0xc3, 0xda, 0x55, 0x37, 0x9d, 0xe9, 0xc6, 0x90,
+    0x8e, 0x94, 0xea, 0x4d, 0xf2, 0x8d, 0x08, 0x4f,
+    0x32, 0xec, 0xcf, 0x03, 0x49, 0x1c, 0x71, 0xf7,
+    0x54, 0xb4, 0x07, 0x55, 0x77, 0xa2, 0x85, 0x52
+};
+
+static const uint8_t scalar2[32] = {
+    0x4b, 0x66, 0xe9, 0xd4, 0xd1, 0xb4, 0x67, 0x3c,
+    0x5a, 0xd2, 0x26, 0x91, 0x95, 0x7d, 0x6a, 0xf5,
+    0xc1, 0x1b, 0x64, 0x21, 0xe0, 0xea, 0x01, 0xd4,
+    0x2c, 0xa4, 0x16, 0x9e, 0x79, 0x18, 0xba, 0x0d
+};
+
+static const uint8_t u2[32] = {
+    0xe5, 0x21, 0x0f, 0x12, 0x78, 0x68, 0x11, 0xd3,
+    0xf4, 0xb7, 0x95, 0x9d, 0x05, 0x38, 0xae, 0x2c,
+    0x31, 0xdb, 0xe7, 0x10, 0x6f, 0xc0, 0x3c, 0x3e,
+    0xfc, 0x4c, 0xd5, 0x49, 0xc7, 0x15, 0xa4, 0x93
+};
+
+static const uint8_t out2[32] = {
+    0x95, 0xcb, 0xde, 0x94, 0x76, 0xe8, 0x90, 0x7d,
+    0x7a, 0xad, 0xe4, 0x5c, 0xb4, 0xb8, 0x73, 0xf8,
+    0x8b, 0x59, 0x5a, 0x68, 0x79, 0x9f, 0xa1, 0x52,
+    0xe6, 0xf8, 0xf7, 0x64, 0x7a, 0xac, 0x79, 0x57
+};
+
+static const uint8_t iter1[32] = {
+    0x42, 0x2c, 0x8e, 0x7a, 0x62, 0x27, 0xd7, 0xbc,
+    0xa1, 0x35, 0x0b, 0x3e, 0x2b, 0xb7, 0x27, 0x9f,
+    0x78, 0x97, 0xb8, 0x7b, 0xb6, 0x85, 0x4b, 0x78,
+    0x3c, 0x60, 0xe8, 0x03, 0x11, 0xae, 0x30, 0x79
+};
+
+static const uint8_t iter1000[32] = {
+    0x68, 0x4c, 0xf5, 0x9b, 0xa8, 0x33, 0x09, 0x55,
+    0x28, 0x00, 0xef, 0x56, 0x6f, 0x2f, 0x4d, 0x3c,
+    0x1c, 0x38, 0x87, 0xc4, 0x93, 0x60, 0xe3, 0x87,
+    0x5f, 0x2e, 0xb9, 0x4d, 0x99, 0x53, 0x2c, 0x51
+};
+
+static const uint8_t basepoint[32] = { 9 };
+
+static int test_x25519_vectors(void)
+{
+    uint8_t out[32];
+
+    return TEST_true(X25519(out, scalar1, u1))
+           && TEST_mem_eq(out, sizeof(out), out1, sizeof(out1))
+           && TEST_true(X25519(out, scalar2, u2))
+           && TEST_mem_eq(out, sizeof(out), out2, sizeof(out2));
+}
+
+static int test_x25519_iterated(void)
+{
+    uint8_t k[32], u[32], out[32];
+    int i;
+
+    memcpy(k, basepoint, sizeof(k));
+    memcpy(u, basepoint, sizeof(u));
+    for (i = 1; i <= 1000; i++) {
+        if (!TEST_true(X25519(out, k, u)))
+            return 0;
+        memcpy(u, k, sizeof(u));
+        memcpy(k, out, sizeof(k));
+        if (i == 1 && !TEST_mem_eq(k, sizeof(k), iter1, sizeof(iter1)))
+            return 0;
+    }
+    return TEST_mem_eq(k, sizeof(k), iter1000, sizeof(iter1000));
+}
+
+/*
+ * The top bit of the peer value is ignored and values of p and above are
+ * reduced (RFC 7748, section 5).
+ */
+static int test_x25519_non_canonical(void)
+{
+    uint8_t u[32], out[32], expected[32];
+
+    memset(u, 0, sizeof(u));
+    u[0] = 2;
+    if (!TEST_true(X25519(expected, scalar1, u)))
+        return 0;
+
+    /* 2 with the top bit set */
+    u[31] = 0x80;
+    if (!TEST_true(X25519(out, scalar1, u))
+            || !TEST_mem_eq(out, sizeof(out), expected, sizeof(expected)))
+        return 0;
+
+    /* p + 2 */
+    memset(u, 0xff, sizeof(u));
+    u[0] = 0xef;
+    u[31] = 0x7f;
+    return TEST_true(X25519(out, scalar1, u))
+           && TEST_mem_eq(out, sizeof(out), expected, sizeof(expected));
+}
+
+static int test_x25519_random(int n)
+{
+    uint8_t a[32], b[32], pub_a[32], pub_b[32], ladder[32];
+    uint8_t shared_a[32], shared_b[32];
+
+    if (!TEST_int_eq(RAND_bytes(a, sizeof(a)), 1)
+            || !TEST_int_eq(RAND_bytes(b, sizeof(b)), 1))
+        return 0;
+
+    X25519_public_from_private(pub_a, a);
+    X25519_public_from_private(pub_b, b);
+
+    /* The ladder on the base point must agree with the Edwards code */
+    if (!TEST_true(X25519(ladder, a, basepoint))
+            || !TEST_mem_eq(ladder, sizeof(ladder), pub_a, sizeof(pub_a)))
+        return 0;
+
+    return TEST_true(X25519(shared_a, a, pub_b))
+           && TEST_true(X25519(shared_b, b, pub_a))
+           && TEST_mem_eq(shared_a, sizeof(shared_a),
+                          shared_b, sizeof(shared_b));
+}
+
+void register_tests(void)
+{
+    ADD_TEST(test_x25519_vectors);
+    ADD_TEST(test_x25519_iterated);
+    ADD_TEST(test_x25519_non_canonical);
+    ADD_ALL_TESTS(test_x25519_random, NUM_RANDOM_TESTS);
+}
@@ -0,0 +1,190 @@
+/*
+ * Copyright 2017 The OpenSSL Project Authors. All Rights Reserved.
+ *
+ * Licensed under the OpenSSL license (the "License").  You may not use
+ * this file except in compliance with the License.  You can obtain a copy
+ * in the file LICENSE in the source distribution or at
+ * https://www.openssl.org/source/license.html
+ */
+
+/*
+ * Internal tests for X448. The field arithmetic uses 56-bit or 28-bit limbs
+ * depending on the platform; both must give the RFC 7748 results.
+ */
+
+#include <string.h>
+#include <openssl/rand.h>
+#include "test_main.h"
+#include "testutil.h"
+#include "../crypto/ec/ec_lcl.h"
+
+#define NUM_RANDOM_TESTS    16
+
+/* Test vectors from RFC 7748, section 5.2 */
+static const uint8_t scalar1[56] = {
+    0x3d, 0x26, 0x2f, 0xdd, 0xf9, 0xec, 0x8e, 0x88,
+    0x49, 0x52, 0x66, 0xfe, 0xa1, 0x9a, 0x34, 0xd2,
+    0x88, 0x82, 0xac, 0xef, 0x04, 0x51, 0x04, 0xd0,
+    0xd1, 0xaa, 0xe1, 0x21, 0x70, 0x0a, 0x77, 0x9c,
+    0x98, 0x4c, 0x24, 0xf8, 0xcd, 0xd7, 0x8f, 0xbf,
+    0xf4, 0x49, 0x43, 0xeb, 0xa3, 0x68, 0xf5, 0x4b,
+    0x29, 0x25, 0x9a, 0x4f, 0x1c, 0x60, 0x0a, 0xd3
+};
+
+static const uint8_t u1[56] = {
+    0x06, 0xfc, 0xe6, 0x40, 0xfa, 0x34, 0x87, 0xbf,
+    0xda, 0x5f, 0x6c, 0xf2, 0xd5, 0x26, 0x3f, 0x8a,
+    0xad, 0x88, 0x33, 0x4c, 0xbd, 0x07, 0x43, 0x7f,
+    0x02, 0x0f, 0x08, 0xf9, 0x81, 0x4d, 0xc0, 0x31,
+    0xdd, 0xbd, 0xc3, 0x8c, 0x19, 0xc6, 0xda, 0x25,
+    0x83, 0xfa, 0x54, 0x29, 0xdb, 0x94, 0xad, 0xa1,
+    0x8a, 0xa7, 0xa7, 0xfb, 0x4e, 0xf8, 0xa0, 0x86
+};
+
+static const uint8_t out1[56] = {
+    0xce, 0x3e, 0x4f, 0xf9, 0x5a, 0x60, 0xdc, 0x66,
+    0x97, 0xda, 0x1d, 0xb1, 0xd8, 0x5e, 0x6a, 0xfb,
+    0xdf, 0x79, 0xb5, 0x0a, 0x24, 0x12, 0xd7, 0x54,
+    0x6d, 0x5f, 0x23, 0x9f, 0xe1, 0x4f, 0xba, 0xad,
+    0xeb, 0x44, 0x5f, 0xc6, 0x6a, 0x01, 0xb0, 0x77,
+    0x9d, 0x98, 0x22, 0x39, 0x61, 0x11, 0x1e, 0x21,
+    0x76, 0x62, 0x82, 0xf7, 0x3d, 0xd9, 0x6b, 0x6f
+};
+
+static const uint8_t scalar2[56] = {
+    0x20, 0x3d, 0x49, 0x44, 0x28, 0xb8, 0x39, 0x93,
+    0x52, 0x66, 0x5d, 0xdc, 0xa4, 0x2f, 0x9d, 0xe8,
+    0xfe, 0xf6, 0x00, 0x90, 0x8e, 0x0d, 0x46, 0x1c,
+    0xb0, 0x21, 0xf8, 0xc5, 0x38, 0x34, 0x5d, 0xd7,
+    0x7c, 0x3e, 0x48, 0x06, 0xe2, 0x5f, 0x46, 0xd3,
+    0x31, 0x5c, 0x44, 0xe0, 0xa5, 0xb4, 0x37, 0x12,
+    0x82, 0xdd, 0x2c, 0x8d, 0x5b, 0xe3, 0x09, 0x5f
+};
+
+static const uint8_t u2[56] = {
+    0x0f, 0xbc, 0xc2, 0xf9, 0x93, 0xcd, 0x56, 0xd3,
+    0x30, 0x5b, 0x0b, 0x7d, 0x9e, 0x55, 0xd4, 0xc1,
+    0xa8, 0xfb, 0x5d, 0xbb, 0x52, 0xf8, 0xe9, 0xa1,
+    0xe9, 0xb6, 0x20, 0x1b, 0x16, 0x5d, 0x01, 0x58,
+    0x94, 0xe5, 0x6c, 0x4d, 0x35, 0x70, 0xbe, 0xe5,
+    0x2f, 0xe2, 0x05, 0xe2, 0x8a, 0x78, 0xb9, 0x1c,
+    0xdf, 0xbd, 0xe7, 0x1c, 0xe8, 0xd1, 0x57, 0xdb
+};
+
+static const uint8_t out2[56] = {
+    0x88, 0x4a, 0x02, 0x57, 0x62, 0x39, 0xff, 0x7a,
+    0x2f, 0x2f, 0x63, 0xb2, 0xdb, 0x6a, 0x9f, 0xf3,
+    0x70, 0x47, 0xac, 0x13, 0x56, 0x8e, 0x1e, 0x30,
+    0xfe, 0x63, 0xc4, 0xa7, 0xad, 0x1b, 0x3e, 0xe3,
+    0xa5, 0x70, 0x0d, 0xf3, 0x43, 0x21, 0xd6, 0x20,
+    0x77, 0xe6, 0x36, 0x33, 0xc5, 0x75, 0xc1, 0xc9,
+    0x54, 0x51, 0x4e, 0x99, 0xda, 0x7c, 0x17, 0x9d
+};
+
+
+static const uint8_t iter1[56] = {
+    0x3f, 0x48, 0x2c, 0x8a, 0x9f, 0x19, 0xb0, 0x1e,
+    0x6c, 0x46, 0xee, 0x97, 0x11, 0xd9, 0xdc, 0x14,
+    0xfd, 0x4b, 0xf6, 0x7a, 0xf3, 0x07, 0x65, 0xc2,
+    0xae, 0x2b, 0x84, 0x6a, 0x4d, 0x23, 0xa8, 0xcd,
+    0x0d, 0xb8, 0x97, 0x08, 0x62, 0x39, 0x49, 0x2c,
+    0xaf, 0x35, 0x0b, 0x51, 0xf8, 0x33, 0x86, 0x8b,
+    0x9b, 0xc2, 0xb3, 0xbc, 0xa9, 0xcf, 0x41, 0x13
+};
+
+static const uint8_t iter1000[56] = {
+    0xaa, 0x3b, 0x47, 0x49, 0xd5, 0x5b, 0x9d, 0xaf,
+    0x1e, 0x5b, 0x00, 0x28, 0x88, 0x26, 0xc4, 0x67,
+    0x27, 0x4c, 0xe3, 0xeb, 0xbd, 0xd5, 0xc1, 0x7b,
+    0x97, 0x5e, 0x09, 0xd4, 0xaf, 0x6c, 0x67, 0xcf,
+    0x10, 0xd0, 0x87, 0x20, 0x2d, 0xb8, 0x82, 0x86,
+    0xe2, 0xb7, 0x9f, 0xce, 0xea, 0x3e, 0xc3, 0x53,
+    0xef, 0x54, 0xfa, 0xa2, 0x6e, 0x21, 0x9f, 0x38
+};
+
+static const uint8_t basepoint[56] = { 5 };
+
+static int test_x448_vectors(void)
+{
+    uint8_t out[56];
+
+    return TEST_true(X448(out, scalar1, u1))
+           && TEST_mem_eq(out, sizeof(out), out1, sizeof(out1))
+           && TEST_true(X448(out, scalar2, u2))
+           && TEST_mem_eq(out, sizeof(out), out2, sizeof(out2));
+}
+
+static int test_x448_iterated(void)
+{
+    uint8_t k[56], u[56], out[56];
+    int i;
+
+    memcpy(k, basepoint, sizeof(k));
+    memcpy(u, basepoint, sizeof(u));
+    for (i = 1; i <= 1000; i++) {
+        if (!TEST_true(X448(out, k, u)))
+            return 0;
+        memcpy(u, k, sizeof(u));
+        memcpy(k, out, sizeof(k));
+        if (i == 1 && !TEST_mem_eq(k, sizeof(k), iter1, sizeof(iter1)))
+            return 0;
+    }
+    return TEST_mem_eq(k, sizeof(k), iter1000, sizeof(iter1000));
+}
+
+/* Values of p and above are reduced (RFC 7748, section 5) */
+static int test_x448_non_canonical(void)
+{
+    uint8_t u[56], out[56], expected[56];
+
+    memset(u, 0, sizeof(u));
+    u[0] = 2;
+    if (!TEST_true(X448(expected, scalar1, u)))
+        return 0;
+
+    /* p + 2 = 2^448 - 2^224 + 1 */
+    memset(u, 0, sizeof(u));
+    u[0] = 0x01;
+    memset(u + 28, 0xff, 28);
+    return TEST_true(X448(out, scalar1, u))
+           && TEST_mem_eq(out, sizeof(out), expected, sizeof(expected));
+}
+
+/* Points of small order give an all-zero result, which must be refused */
+static int test_x448_small_order(void)
+{
+    uint8_t u[56], out[56];
+
+    memset(u, 0, sizeof(u));
+    if (!TEST_false(X448(out, scalar1, u)))
+        return 0;
+    u[0] = 1;
+    return TEST_false(X448(out, scalar1, u));
+}
+
+static int test_x448_random(int n)
+{
+    uint8_t a[56], b[56], pub_a[56], pub_b[56];
+    uint8_t shared_a[56], shared_b[56];
+
+    if (!TEST_int_eq(RAND_bytes(a, sizeof(a)), 1)
+            || !TEST_int_eq(RAND_bytes(b, sizeof(b)), 1))
+        return 0;
+
+    X448_public_from_private(pub_a, a);
+    X448_public_from_private(pub_b, b);
+
+    return TEST_true(X448(shared_a, a, pub_b))
+           && TEST_true(X448(shared_b, b, pub_a))
+           && TEST_mem_eq(shared_a, sizeof(shared_a),
+                          shared_b, sizeof(shared_b));
+}
+
+void register_tests(void)
+{
+    ADD_TEST(test_x448_vectors);
+    ADD_TEST(test_x448_iterated);
+    ADD_TEST(test_x448_non_canonical);
+    ADD_TEST(test_x448_small_order);
+    ADD_ALL_TESTS(test_x448_random, NUM_RANDOM_TESTS);
+}